@@ -1,3 +0,0 @@
-#!/usr/bin/env bash
-
-arp -v -H ether -i enp0s7 -s 192.168.1.46 F4:6D:04:11:22:33
@@ -0,0 +1,115 @@
+// Reference model for src/nexys4ddr/ethernet/compress.vhd
+//
+// This generates random frames, and writes two files used by compress_tb.vhd:
+// * compress_tb_in.txt  : The input bytes.
+// * compress_tb_out.txt : The expected output bytes.
+// Each line contains "sof eof data" as decimal numbers.
+//
+// Usage: g++ -O2 -o compress_ref compress_ref.cpp && ./compress_ref [seed]
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct Byte
+{
+   int sof;
+   int eof;
+   int data;
+};
+
+typedef std::vector<int> Frame;
+
+// Run-length encode a single frame. Each token is the data byte followed by
+// the number of repetitions minus one.
+static void compress(const Frame& frame, std::vector<Byte>& out)
+{
+   std::vector<int> tokens;
+   size_t i = 0;
+   while (i < frame.size())
+   {
+      int cnt = 0;
+      while (i+cnt+1 < frame.size() && frame[i+cnt+1] == frame[i] && cnt < 255)
+      {
+         cnt++;
+      }
+      tokens.push_back(frame[i]);
+      tokens.push_back(cnt);
+      i += cnt+1;
+   }
+
+   for (size_t j = 0; j < tokens.size(); ++j)
+   {
+      Byte b = {j == 0, j == tokens.size()-1, tokens[j]};
+      out.push_back(b);
+   }
+}
+
+static void add_frame(const Frame& frame, std::vector<Byte>& in, std::vector<Byte>& out)
+{
+   for (size_t j = 0; j < frame.size(); ++j)
+   {
+      Byte b = {j == 0, j == frame.size()-1, frame[j]};
+      in.push_back(b);
+   }
+   compress(frame, out);
+}
+
+static void write_file(const char* name, const std::vector<Byte>& bytes)
+{
+   FILE* fp = fopen(name, "w");
+   if (!fp)
+   {
+      perror(name);
+      exit(1);
+   }
+   for (size_t i = 0; i < bytes.size(); ++i)
+   {
+      fprintf(fp, "%d %d %d\n", bytes[i].sof, bytes[i].eof, bytes[i].data);
+   }
+   fclose(fp);
+}
+
+int main(int argc, char* argv[])
+{
+   unsigned seed = argc > 1 ? atoi(argv[1]) : 1;
+   std::mt19937 rng(seed);
+
+   std::vector<Byte> in;
+   std::vector<Byte> out;
+
+   // Directed tests first. The last two frames used to make two fifo writes
+   // collide: A two-byte frame with different bytes, followed immediately by
+   // a one-byte frame.
+   add_frame(Frame{0x87, 0x87, 0x87}, in, out);
+   add_frame(Frame{0x87, 0x87, 0x78, 0x78}, in, out);
+   add_frame(Frame(300, 0x76), in, out);
+   add_frame(Frame(256, 0x76), in, out);
+   add_frame(Frame{0x12, 0x34}, in, out);
+   add_frame(Frame{0x56}, in, out);
+
+   // Random frames. The data consists of runs, like a VGA screen. Short
+   // frames are frequent, to exercise back-to-back SOF and EOF.
+   for (int f = 0; f < 500; ++f)
+   {
+      Frame frame;
+      size_t len = (rng() % 4 == 0) ? 1 + rng() % 3 : 1 + rng() % 1000;
+      while (frame.size() < len)
+      {
+         int run = (rng() % 16 == 0) ? 200 + rng() % 400 : 1 + rng() % 16;
+         int data = rng() % 4;    // Few values, so adjacent runs may be equal.
+         for (int i = 0; i < run && frame.size() < len; ++i)
+         {
+            frame.push_back(data);
+         }
+      }
+      add_frame(frame, in, out);
+   }
+
+   write_file("compress_tb_in.txt", in);
+   write_file("compress_tb_out.txt", out);
+
+   printf("%zu input bytes, %zu output bytes\n", in.size(), out.size());
+   return 0;
+}
@@ -0,0 +1,348 @@
+// This program loads a program image into the memory of the FPGA, using the
+// protocol described in src/nexys4ddr/ethernet/loader.vhd.
+//
+// The image is split into chunks, and up to 32 chunks are sent before waiting
+// for a reply. The replies tell which chunks are received, so only the
+// missing chunks are sent again. Finally, the CRC of the memory is read back
+// and compared with the image, before the CPU is released from reset.
+//
+// The FPGA answers ARP requests, so no static ARP entry is needed. The
+// replies are sent to port 4661 on 192.168.1.43, so this program must run
+// on that host.
+//
+// Build: g++ -O2 -o load load.cpp
+//
+// Usage: ./load [-f rom.bin] [-a 0xF000] [-i 192.168.1.46] [-p 9029] [-l 4661] [-c 1024] [-n]
+//
+// Options:
+// -f file : Image to load (default rom.bin).
+// -a addr : Load address (default 0xF000).
+// -i ip   : IP address of the FPGA.
+// -p port : UDP port of the FPGA.
+// -l port : Local UDP port, where the replies arrive.
+// -c size : Number of bytes in each chunk (16-1024).
+// -n      : Keep the CPU in reset after loading.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const uint8_t C_CMD_START  = 0x01;
+static const uint8_t C_CMD_DATA   = 0x02;
+static const uint8_t C_CMD_VERIFY = 0x03;
+static const uint8_t C_CMD_RUN    = 0x04;
+
+static const int    C_WINDOW     = 32;      // Must match loader.vhd
+static const int    C_REPLY_LEN  = 18;
+static const double C_RTO        = 0.020;   // Retransmit timeout, when no reply
+static const double C_HOLE_DELAY = 0.001;   // Minimum time before resending a hole
+static const double C_GIVE_UP    = 2.0;     // Abort when no progress for this long
+
+struct Reply
+{
+   uint8_t  cmd;
+   uint16_t base;
+   uint32_t bitmap;
+   uint8_t  crc_err;
+   uint16_t ver_crc;
+};
+
+static double now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// CRC-16 (CCITT), the same as loader.vhd.
+static uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF)
+{
+   for (size_t i = 0; i < len; ++i)
+   {
+      crc ^= data[i] << 8;
+      for (int j = 0; j < 8; ++j)
+      {
+         crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+   }
+   return crc;
+}
+
+class Loader
+{
+public:
+   Loader(int sock, const struct sockaddr_in& dst) : m_sock(sock), m_dst(dst),
+      m_sent(0), m_resent(0) {}
+
+   // Send a command. The CRC is appended most significant byte first.
+   void send(std::vector<uint8_t> pkt)
+   {
+      uint16_t crc = crc16(&pkt[0], pkt.size());
+      pkt.push_back(crc >> 8);
+      pkt.push_back(crc & 0xFF);
+      if (sendto(m_sock, &pkt[0], pkt.size(), 0, (const struct sockaddr*) &m_dst, sizeof(m_dst)) < 0)
+      {
+         perror("sendto");
+         exit(1);
+      }
+      m_sent++;
+   }
+
+   // Wait for a reply. Returns false on timeout.
+   bool receive(Reply& reply, double timeout)
+   {
+      struct pollfd pfd = {m_sock, POLLIN, 0};
+      if (poll(&pfd, 1, (int) (timeout * 1000)) <= 0)
+         return false;
+
+      uint8_t buf[256];
+      ssize_t len = recv(m_sock, buf, sizeof(buf), 0);
+      if (len < C_REPLY_LEN || !(buf[0] & 0x80))
+         return false;
+
+      reply.cmd     = buf[0] & 0x7F;
+      reply.base    = buf[1] | (buf[2] << 8);
+      reply.bitmap  = buf[3] | (buf[4] << 8) | (buf[5] << 16) | ((uint32_t) buf[6] << 24);
+      reply.crc_err = buf[7];
+      reply.ver_crc = buf[8] | (buf[9] << 8);
+      return true;
+   }
+
+   // Send a command, and retry until the matching reply arrives.
+   Reply command(const std::vector<uint8_t>& pkt, double timeout = 0.2)
+   {
+      for (int retry = 0; retry < 10; ++retry)
+      {
+         send(pkt);
+         double deadline = now() + timeout;
+         Reply reply;
+         while (now() < deadline)
+         {
+            if (receive(reply, deadline - now()) && reply.cmd == pkt[0])
+               return reply;
+         }
+      }
+      fprintf(stderr, "No reply to command 0x%02x\n", pkt[0]);
+      exit(1);
+   }
+
+   // Send the image in chunks, using a sliding window.
+   uint8_t transfer(const std::vector<uint8_t>& image, unsigned addr, unsigned chunk)
+   {
+      unsigned num = (image.size() + chunk - 1) / chunk;
+      std::vector<bool>   acked(num, false);
+      std::vector<double> last_sent(num, 0.0);
+      unsigned base    = 0;     // Oldest chunk not yet received
+      unsigned next    = 0;     // Next chunk to send for the first time
+      unsigned highest = 0;     // One more than the highest chunk received
+      uint8_t  crc_err = 0;
+      double   progress = now();
+
+      while (base < num)
+      {
+         double t = now();
+
+         // Send new chunks, as far as the window allows.
+         while (next < num && next < base + C_WINDOW)
+         {
+            send_chunk(image, addr, chunk, next);
+            last_sent[next++] = t;
+         }
+
+         // Resend chunks that are missing. A chunk below a received chunk is
+         // most likely lost, so it is resent quickly.
+         for (unsigned i = base; i < next; ++i)
+         {
+            double delay = (i < highest) ? C_HOLE_DELAY : C_RTO;
+            if (!acked[i] && t - last_sent[i] > delay)
+            {
+               send_chunk(image, addr, chunk, i);
+               last_sent[i] = t;
+               m_resent++;
+            }
+         }
+
+         Reply reply;
+         if (receive(reply, C_HOLE_DELAY))
+         {
+            crc_err = reply.crc_err;
+            if (reply.base > base && reply.base <= num)
+            {
+               for (unsigned i = base; i < reply.base; ++i)
+               {
+                  acked[i] = true;
+               }
+               base = reply.base;
+               progress = now();
+            }
+            for (unsigned i = 0; i < C_WINDOW; ++i)
+            {
+               unsigned seq = reply.base + i;
+               if ((reply.bitmap >> i) & 1 && seq < num)
+               {
+                  acked[seq] = true;
+                  if (seq >= highest)
+                     highest = seq + 1;
+               }
+            }
+            if (base > highest)
+               highest = base;
+         }
+
+         if (now() - progress > C_GIVE_UP)
+         {
+            fprintf(stderr, "Transfer stalled at chunk %u of %u\n", base, num);
+            exit(1);
+         }
+      }
+
+      return crc_err;
+   }
+
+   unsigned long sent() const   {return m_sent;}
+   unsigned long resent() const {return m_resent;}
+
+private:
+   void send_chunk(const std::vector<uint8_t>& image, unsigned addr, unsigned chunk, unsigned seq)
+   {
+      unsigned offset = seq * chunk;
+      unsigned len    = image.size() - offset < chunk ? image.size() - offset : chunk;
+      unsigned a      = addr + offset;
+
+      std::vector<uint8_t> pkt;
+      pkt.push_back(C_CMD_DATA);
+      pkt.push_back(seq & 0xFF);
+      pkt.push_back(seq >> 8);
+      pkt.push_back(a & 0xFF);
+      pkt.push_back((a >> 8) & 0xFF);
+      pkt.insert(pkt.end(), image.begin() + offset, image.begin() + offset + len);
+      send(pkt);
+   }
+
+   int                m_sock;
+   struct sockaddr_in m_dst;
+   unsigned long      m_sent;
+   unsigned long      m_resent;
+};
+
+int main(int argc, char* argv[])
+{
+   const char* filename = "rom.bin";
+   unsigned    addr     = 0xF000;
+   const char* ip       = "192.168.1.46";
+   int         port     = 9029;
+   int         local    = 4661;
+   unsigned    chunk    = 1024;
+   bool        hold     = false;
+
+   int opt;
+   while ((opt = getopt(argc, argv, "f:a:i:p:l:c:n")) != -1)
+   {
+      switch (opt)
+      {
+         case 'f': filename = optarg; break;
+         case 'a': addr  = strtoul(optarg, NULL, 0); break;
+         case 'i': ip    = optarg; break;
+         case 'p': port  = atoi(optarg); break;
+         case 'l': local = atoi(optarg); break;
+         case 'c': chunk = strtoul(optarg, NULL, 0); break;
+         case 'n': hold  = true; break;
+         default:
+            fprintf(stderr, "Usage: %s [-f file] [-a addr] [-i ip] [-p port] [-l port] [-c chunk] [-n]\n", argv[0]);
+            return 1;
+      }
+   }
+
+   // Read image
+   FILE* fp = fopen(filename, "rb");
+   if (!fp)
+   {
+      perror(filename);
+      return 1;
+   }
+   std::vector<uint8_t> image;
+   int c;
+   while ((c = fgetc(fp)) != EOF)
+   {
+      image.push_back(c);
+   }
+   fclose(fp);
+
+   if (image.empty() || addr + image.size() > 0x10000 || chunk < 16 || chunk > 1024)
+   {
+      fprintf(stderr, "Invalid image size %zu, address 0x%04x, or chunk size %u\n",
+            image.size(), addr, chunk);
+      return 1;
+   }
+
+   // Setup socket
+   int sock = socket(AF_INET, SOCK_DGRAM, 0);
+   if (sock < 0)
+   {
+      perror("socket");
+      return 1;
+   }
+   struct sockaddr_in src;
+   memset(&src, 0, sizeof(src));
+   src.sin_family      = AF_INET;
+   src.sin_addr.s_addr = htonl(INADDR_ANY);
+   src.sin_port        = htons(local);
+   if (bind(sock, (struct sockaddr*) &src, sizeof(src)) < 0)
+   {
+      perror("bind");
+      return 1;
+   }
+   struct sockaddr_in dst;
+   memset(&dst, 0, sizeof(dst));
+   dst.sin_family = AF_INET;
+   dst.sin_port   = htons(port);
+   if (inet_pton(AF_INET, ip, &dst.sin_addr) != 1)
+   {
+      fprintf(stderr, "Invalid IP address %s\n", ip);
+      return 1;
+   }
+
+   Loader loader(sock, dst);
+   double start = now();
+
+   // Hold the CPU in reset while loading.
+   loader.command(std::vector<uint8_t>{C_CMD_START, 0x01});
+
+   uint8_t crc_err = loader.transfer(image, addr, chunk);
+   double elapsed = now() - start;
+
+   // Read back the CRC of the memory.
+   unsigned len = image.size();
+   Reply reply = loader.command(std::vector<uint8_t>{C_CMD_VERIFY,
+         (uint8_t) (addr & 0xFF), (uint8_t) (addr >> 8),
+         (uint8_t) (len & 0xFF), (uint8_t) (len >> 8)}, 1.0);
+   uint16_t expected = crc16(&image[0], image.size());
+
+   printf("Loaded %zu bytes to 0x%04x in %.1f ms (%.2f MB/s)\n",
+         image.size(), addr, elapsed * 1000, image.size() / elapsed / 1e6);
+   printf("Packets sent: %lu, resent: %lu, CRC errors: %u\n",
+         loader.sent(), loader.resent(), crc_err);
+
+   if (reply.ver_crc != expected)
+   {
+      fprintf(stderr, "Verify failed: CRC is 0x%04x, expected 0x%04x\n", reply.ver_crc, expected);
+      return 1;
+   }
+   printf("Verify OK (CRC 0x%04x)\n", expected);
+
+   if (!hold)
+   {
+      loader.command(std::vector<uint8_t>{C_CMD_RUN, 0x00});
+   }
+
+   close(sock);
+   return 0;
+}
@@ -0,0 +1,480 @@
+// This program receives the compressed VGA stream from the FPGA, see
+// src/nexys4ddr/ethernet/convert.vhd, and writes the re-assembled frames.
+//
+// Each UDP datagram contains one block of 8 lines, run-length encoded as
+// pairs of (data, count-1). After decompression, the first byte contains
+// the line block number (0-59) in bits 5-0. Bit 7 is set in a key frame, and
+// bit 6 toggles for every frame. The remaining 5120 bytes are 8 lines of 640
+// pixels. Blocks that are unchanged since the previous frame are not sent.
+//
+// Datagrams are received in batches with recvmmsg(). Each is decompressed into
+// a separate block buffer, and copied into the current frame only if it has the
+// correct length. When a frame is complete, it is copied to a ring of
+// preallocated buffers, and written by a separate thread. So slow disk access
+// does not cause lost datagrams.
+//
+// Build: g++ -O2 -pthread -o receive receive.cpp
+//
+// Usage:
+// ./receive                  Write frame_00000.ppm, frame_00001.ppm, ...
+// ./receive -r | ffmpeg -f rawvideo -pix_fmt rgb24 -s 640x480 -r 60 -i - out.mp4
+// ./receive -f capture.pcap  Replay a capture instead of receiving.
+//
+// Options:
+// -p port  : UDP port (default 4660).
+// -r       : Write raw RGB frames to stdout instead of PPM files.
+// -f file  : Read datagrams from a pcap file (e.g. from tcpdump -w).
+// -n num   : Stop after this many frames.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdint.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int C_WIDTH      = 640;
+static const int C_HEIGHT     = 480;
+static const int C_BLOCK      = 8;                     // Lines per datagram
+static const int C_NUM_BLOCKS = C_HEIGHT / C_BLOCK;
+static const int C_BLOCK_SIZE = 1 + C_BLOCK*C_WIDTH;   // Including line number
+static const int C_RING_SIZE  = 16;                    // Frames waiting to be written
+static const int C_BATCH      = 64;                    // Datagrams per recvmmsg
+static const int C_MAX_LEN    = 2*C_BLOCK_SIZE;        // Largest datagram, when no bytes repeat
+
+struct Stats
+{
+   unsigned long datagrams;
+   unsigned long bytes;
+   unsigned long bad;            // Decompressed to the wrong length
+   unsigned long out_of_order;   // Block number lower than previous in same frame
+   unsigned long dropped_lines;  // Missing blocks in a key frame
+   unsigned long frames;         // Frames written
+   unsigned long dropped_frames; // Ring was full
+   unsigned long unsynced;       // Frames before the first key frame
+};
+
+static Stats g_stats;
+static volatile sig_atomic_t g_stop = 0;
+
+
+/////////////////////////////////////////////////////////////
+// Ring of frame buffers, shared with the writer thread.
+/////////////////////////////////////////////////////////////
+
+class Ring
+{
+public:
+   Ring() : m_bufs(C_RING_SIZE, std::vector<uint8_t>(C_WIDTH*C_HEIGHT)),
+            m_head(0), m_tail(0), m_done(false) {}
+
+   // Returns false if the ring is full.
+   bool push(const uint8_t* frame)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_head - m_tail == C_RING_SIZE)
+         return false;
+      memcpy(&m_bufs[m_head % C_RING_SIZE][0], frame, C_WIDTH*C_HEIGHT);
+      m_head++;
+      m_cond.notify_one();
+      return true;
+   }
+
+   // Returns NULL when there are no more frames.
+   const uint8_t* front()
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (m_head == m_tail && !m_done)
+         m_cond.wait(lock);
+      if (m_head == m_tail)
+         return NULL;
+      return &m_bufs[m_tail % C_RING_SIZE][0];
+   }
+
+   void pop()
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_tail++;
+   }
+
+   void done()
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done = true;
+      m_cond.notify_one();
+   }
+
+private:
+   std::vector<std::vector<uint8_t> > m_bufs;
+   unsigned long m_head;
+   unsigned long m_tail;
+   bool m_done;
+   std::mutex m_mutex;
+   std::condition_variable m_cond;
+};
+
+
+/////////////////////////////////////////////////////////////
+// Writer thread
+/////////////////////////////////////////////////////////////
+
+// The colour format is RRRGGGBB.
+static void make_palette(uint8_t palette[256][3])
+{
+   for (int i = 0; i < 256; ++i)
+   {
+      palette[i][0] = ((i >> 5) & 7) * 255 / 7;
+      palette[i][1] = ((i >> 2) & 7) * 255 / 7;
+      palette[i][2] = ( i       & 3) * 255 / 3;
+   }
+}
+
+static void writer(Ring* ring, bool raw)
+{
+   uint8_t palette[256][3];
+   make_palette(palette);
+
+   std::vector<uint8_t> rgb(C_WIDTH*C_HEIGHT*3);
+   unsigned num = 0;
+
+   while (const uint8_t* frame = ring->front())
+   {
+      for (int i = 0; i < C_WIDTH*C_HEIGHT; ++i)
+      {
+         memcpy(&rgb[3*i], palette[frame[i]], 3);
+      }
+      ring->pop();
+
+      if (raw)
+      {
+         if (fwrite(&rgb[0], rgb.size(), 1, stdout) != 1)
+         {
+            perror("stdout");
+            g_stop = 1;
+            break;
+         }
+      }
+      else
+      {
+         char name[32];
+         snprintf(name, sizeof(name), "frame_%05u.ppm", num);
+         FILE* fp = fopen(name, "wb");
+         if (!fp)
+         {
+            perror(name);
+            g_stop = 1;
+            break;
+         }
+         fprintf(fp, "P6\n%d %d\n255\n", C_WIDTH, C_HEIGHT);
+         fwrite(&rgb[0], rgb.size(), 1, fp);
+         fclose(fp);
+      }
+      num++;
+   }
+}
+
+
+/////////////////////////////////////////////////////////////
+// Frame assembly
+/////////////////////////////////////////////////////////////
+
+class Assembler
+{
+public:
+   Assembler(Ring* ring) : m_ring(ring), m_frame(C_WIDTH*C_HEIGHT),
+      m_block(C_BLOCK_SIZE), m_parity(-1), m_key(false), m_synced(false),
+      m_last_block(-1), m_seen(0) {}
+
+   void datagram(const uint8_t* data, size_t len)
+   {
+      g_stats.datagrams++;
+      g_stats.bytes += len;
+
+      // Decompress into a temporary block, so a bad datagram doesn't
+      // corrupt the frame.
+      size_t pos = 0;
+      for (size_t i = 0; i+1 < len; i += 2)
+      {
+         size_t cnt = data[i+1] + 1;
+         if (pos + cnt > (size_t) C_BLOCK_SIZE)
+         {
+            pos = 0;
+            break;
+         }
+         memset(&m_block[pos], data[i], cnt);
+         pos += cnt;
+      }
+      if ((len % 2) || pos != (size_t) C_BLOCK_SIZE || (m_block[0] & 0x3F) >= C_NUM_BLOCKS)
+      {
+         g_stats.bad++;
+         return;
+      }
+
+      int block  = m_block[0] & 0x3F;
+      bool key   = m_block[0] & 0x80;
+      int parity = (m_block[0] >> 6) & 1;
+
+      if (parity != m_parity)
+      {
+         // New frame started.
+         if (m_parity >= 0)
+            finish();
+         m_parity = parity;
+         m_key    = key;
+         m_last_block = -1;
+         m_seen   = 0;
+         if (key)
+            m_synced = true;
+      }
+
+      if (block <= m_last_block)
+         g_stats.out_of_order++;
+      m_last_block = block;
+      m_seen |= 1ULL << block;
+
+      memcpy(&m_frame[block*C_BLOCK*C_WIDTH], &m_block[1], C_BLOCK*C_WIDTH);
+   }
+
+   // Called when the current frame is complete.
+   void finish()
+   {
+      if (m_key)
+      {
+         for (int i = 0; i < C_NUM_BLOCKS; ++i)
+         {
+            if (!(m_seen & (1ULL << i)))
+               g_stats.dropped_lines += C_BLOCK;
+         }
+      }
+
+      if (!m_synced)
+         g_stats.unsynced++;
+      else if (m_ring->push(&m_frame[0]))
+         g_stats.frames++;
+      else
+         g_stats.dropped_frames++;
+   }
+
+private:
+   Ring*                m_ring;
+   std::vector<uint8_t> m_frame;
+   std::vector<uint8_t> m_block;
+   int                  m_parity;
+   bool                 m_key;
+   bool                 m_synced;
+   int                  m_last_block;
+   uint64_t             m_seen;
+};
+
+
+/////////////////////////////////////////////////////////////
+// Input from network
+/////////////////////////////////////////////////////////////
+
+static int receive_udp(Assembler& assembler, int port, unsigned long max_frames)
+{
+   int sock = socket(AF_INET, SOCK_DGRAM, 0);
+   if (sock < 0)
+   {
+      perror("socket");
+      return 1;
+   }
+
+   // A large socket buffer absorbs bursts while the CPU is busy.
+   int rcvbuf = 8 << 20;
+   setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+   struct sockaddr_in addr;
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family      = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_ANY);
+   addr.sin_port        = htons(port);
+   if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+   {
+      perror("bind");
+      close(sock);
+      return 1;
+   }
+
+   std::vector<uint8_t> bufs(C_BATCH*C_MAX_LEN);
+   struct mmsghdr msgs[C_BATCH];
+   struct iovec iovecs[C_BATCH];
+   memset(msgs, 0, sizeof(msgs));
+   for (int i = 0; i < C_BATCH; ++i)
+   {
+      iovecs[i].iov_base         = &bufs[i*C_MAX_LEN];
+      iovecs[i].iov_len          = C_MAX_LEN;
+      msgs[i].msg_hdr.msg_iov    = &iovecs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+   }
+
+   while (!g_stop && (max_frames == 0 || g_stats.frames < max_frames))
+   {
+      // Block until at least one datagram is received.
+      int n = recvmmsg(sock, msgs, C_BATCH, MSG_WAITFORONE, NULL);
+      if (n < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         perror("recvmmsg");
+         break;
+      }
+      for (int i = 0; i < n; ++i)
+      {
+         if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+         {
+            g_stats.bad++;
+            continue;
+         }
+         assembler.datagram(&bufs[i*C_MAX_LEN], msgs[i].msg_len);
+      }
+   }
+
+   close(sock);
+   return 0;
+}
+
+
+/////////////////////////////////////////////////////////////
+// Input from pcap file
+/////////////////////////////////////////////////////////////
+
+static uint32_t swap32(uint32_t x, bool swap)
+{
+   return swap ? __builtin_bswap32(x) : x;
+}
+
+static int replay_pcap(Assembler& assembler, const char* name, int port, unsigned long max_frames)
+{
+   FILE* fp = fopen(name, "rb");
+   if (!fp)
+   {
+      perror(name);
+      return 1;
+   }
+
+   // Global header
+   uint32_t hdr[6];
+   if (fread(hdr, sizeof(hdr), 1, fp) != 1)
+   {
+      fprintf(stderr, "%s: Too short\n", name);
+      fclose(fp);
+      return 1;
+   }
+   bool swap = (hdr[0] == 0xd4c3b2a1 || hdr[0] == 0x4d3cb2a1);
+   if (swap32(hdr[0], swap) != 0xa1b2c3d4 && swap32(hdr[0], swap) != 0xa1b23c4d)
+   {
+      fprintf(stderr, "%s: Not a pcap file\n", name);
+      fclose(fp);
+      return 1;
+   }
+   if (swap32(hdr[5], swap) != 1)
+   {
+      fprintf(stderr, "%s: Only Ethernet captures are supported\n", name);
+      fclose(fp);
+      return 1;
+   }
+
+   std::vector<uint8_t> pkt(65536);
+   uint32_t rec[4];
+   while (!g_stop && (max_frames == 0 || g_stats.frames < max_frames) &&
+          fread(rec, sizeof(rec), 1, fp) == 1)
+   {
+      uint32_t len = swap32(rec[2], swap);   // Captured length
+      if (len > pkt.size() || fread(&pkt[0], len, 1, fp) != 1)
+         break;
+
+      // Ethernet, IPv4 without fragmentation, UDP to our port.
+      const uint8_t* p = &pkt[0];
+      if (len < 14+20+8 || p[12] != 0x08 || p[13] != 0x00)
+         continue;
+      const uint8_t* ip = p + 14;
+      size_t ihl = (ip[0] & 0x0F) * 4;
+      if ((ip[0] >> 4) != 4 || ip[9] != 17 || ((ip[6] & 0x3F) | ip[7]) != 0)
+         continue;
+      if (len < 14 + ihl + 8)
+         continue;
+      const uint8_t* udp = ip + ihl;
+      if (((udp[2] << 8) | udp[3]) != port)
+         continue;
+      size_t udp_len = (udp[4] << 8) | udp[5];
+      if (udp_len < 8 || 14 + ihl + udp_len > len)
+         continue;
+
+      assembler.datagram(udp + 8, udp_len - 8);
+   }
+
+   // The last frame is complete at the end of the file.
+   assembler.finish();
+
+   fclose(fp);
+   return 0;
+}
+
+
+/////////////////////////////////////////////////////////////
+// Main
+/////////////////////////////////////////////////////////////
+
+static void stop(int)
+{
+   g_stop = 1;
+}
+
+int main(int argc, char* argv[])
+{
+   int port = 4660;
+   bool raw = false;
+   const char* pcap = NULL;
+   unsigned long max_frames = 0;
+
+   int opt;
+   while ((opt = getopt(argc, argv, "p:rf:n:")) != -1)
+   {
+      switch (opt)
+      {
+         case 'p': port = atoi(optarg); break;
+         case 'r': raw = true; break;
+         case 'f': pcap = optarg; break;
+         case 'n': max_frames = strtoul(optarg, NULL, 0); break;
+         default:
+            fprintf(stderr, "Usage: %s [-p port] [-r] [-f file.pcap] [-n frames]\n", argv[0]);
+            return 1;
+      }
+   }
+
+   // Don't use SA_RESTART, so recvmmsg() returns on Ctrl-C.
+   struct sigaction sa;
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = stop;
+   sigaction(SIGINT, &sa, NULL);
+   sigaction(SIGTERM, &sa, NULL);
+
+   Ring ring;
+   Assembler assembler(&ring);
+   std::thread thread(writer, &ring, raw);
+
+   int res = pcap ? replay_pcap(assembler, pcap, port, max_frames)
+                  : receive_udp(assembler, port, max_frames);
+
+   ring.done();
+   thread.join();
+
+   fprintf(stderr, "Datagrams:      %lu (%lu bytes)\n", g_stats.datagrams, g_stats.bytes);
+   fprintf(stderr, "Bad datagrams:  %lu\n", g_stats.bad);
+   fprintf(stderr, "Out of order:   %lu\n", g_stats.out_of_order);
+   fprintf(stderr, "Dropped lines:  %lu\n", g_stats.dropped_lines);
+   fprintf(stderr, "Frames written: %lu\n", g_stats.frames);
+   fprintf(stderr, "Frames dropped: %lu\n", g_stats.dropped_frames);
+   fprintf(stderr, "Before sync:    %lu\n", g_stats.unsynced);
+
+   return res;
+}
@@ -56,12 +56,12 @@ begin
       G_COL_SIZE  => 10,                 -- Number of bits in COL address
       G_FONT_SIZE => 12,                 -- Number of bits in FONT address
       G_MOB_SIZE  => 7,                  -- Number of bits in MOB address
-      G_CONF_SIZE => 5,                  -- Number of bits in CONF address
+      G_CONF_SIZE => 6,                  -- Number of bits in CONF address
       G_RAM_MASK  => X"0000",            -- Last address 0x07FF
       G_DISP_MASK => X"8000",            -- Last address 0x83FF
       G_COL_MASK  => X"8800",            -- Last address 0x8BFF
       G_MOB_MASK  => X"8400",            -- Last address 0x847F
-      G_CONF_MASK => X"8600",            -- Last address 0x861F
+      G_CONF_MASK => X"8600",            -- Last address 0x863F
       G_FONT_MASK => X"9000",            -- Last address 0x9FFF
       G_ROM_MASK  => X"F800",            -- Last address 0xFFFF
       G_ROM_FILE  => "rom.txt",          -- Contains the machine code
@@ -209,9 +209,9 @@ architecture Structural of ctl is
             C_INVALID,
             C_INVALID,
    -- 05 ORA d
-            C_INVALID,
-            C_INVALID,
-            C_INVALID,
+            C_READ_NEXT_BYTE,
+            C_WR_HOLD_LO + C_MEM_RD + C_WR_PC_INC,
+            C_WR_ADDR_HOLD + C_MEM_RD + C_WR_REG_OR + C_WR_SR_Z + C_WR_SR_S + C_LAST,
             C_INVALID,
             C_INVALID,
             C_INVALID,
@@ -499,9 +499,9 @@ architecture Structural of ctl is
             C_INVALID,
             C_INVALID,
    -- 25 AND d
-            C_INVALID,
-            C_INVALID,
-            C_INVALID,
+            C_READ_NEXT_BYTE,
+            C_WR_HOLD_LO + C_MEM_RD + C_WR_PC_INC,
+            C_WR_ADDR_HOLD + C_MEM_RD + C_WR_REG_AND + C_WR_SR_Z + C_WR_SR_S + C_LAST,
             C_INVALID,
             C_INVALID,
             C_INVALID,
@@ -40,10 +40,12 @@ entity hack is
       cpu_clk_i     : in  std_logic;
       cpu_rst_i     : in  std_logic;
       cpu_step_i    : in  std_logic;
-      -- ROM data received from Ethernet
+      -- ROM data received from Ethernet. The address is also used for reads.
       cpu_wr_addr_i : in  std_logic_vector(15 downto 0) := (others => '0');
       cpu_wr_en_i   : in  std_logic                     := '0';
       cpu_wr_data_i : in  std_logic_vector( 7 downto 0) := (others => '0');
+      cpu_rd_en_i   : in  std_logic                     := '0';
+      cpu_rd_data_o : out std_logic_vector( 7 downto 0);
       -- Output LEDs
       cpu_led_o     : out std_logic_vector( 7 downto 0);
 
@@ -83,6 +85,7 @@ architecture Structural of hack is
    signal mem_wren    : std_logic;
    signal mem_wrdata  : std_logic_vector(7 downto 0);
    signal mem_wait    : std_logic;
+   signal mem_rden    : std_logic;
 
    -- Signals connected to the VGA.
    signal vga_font_addr : std_logic_vector(11 downto 0);
@@ -99,7 +102,8 @@ architecture Structural of hack is
    signal vga_col       : std_logic_vector( 7 downto 0);
    signal vga_hcount    : std_logic_vector(10 downto 0);
    signal vga_vcount    : std_logic_vector(10 downto 0);
-   signal vga_collision : std_logic_vector( 3 downto 0);
+   signal vga_collision : std_logic_vector(13 downto 0);
+   signal vga_contact   : std_logic_vector(6*17-1 downto 0);
    signal vga_debug     : std_logic_vector(255 downto 0);
 
    -- Signals connected to the keyboard
@@ -147,6 +151,7 @@ begin
       hcount_o       => vga_hcount,
       vcount_o       => vga_vcount,
       collision_o    => vga_collision,
+      contact_o      => vga_contact,
       font_addr_o    => vga_font_addr,
       font_data_i    => vga_font_data,
       col_addr_o     => vga_col_addr,
@@ -171,6 +176,8 @@ begin
    vga_hcount_o <= vga_hcount;
    vga_vcount_o <= vga_vcount;
 
+   cpu_rd_data_o <= cpu_rddata;
+
 
    -------------------------------
    -- Instantiate multiplexer
@@ -181,14 +188,17 @@ begin
       lo_addr_i     => cpu_addr,
       lo_wr_en_i    => cpu_wren,
       lo_wr_data_i  => cpu_wrdata,
+      lo_rd_en_i    => cpu_rden,
       lo_wait_i     => cpu_wait,
       hi_addr_i     => cpu_wr_addr_i,
       hi_wr_en_i    => cpu_wr_en_i,
       hi_wr_data_i  => cpu_wr_data_i,
+      hi_rd_en_i    => cpu_rd_en_i,
       hi_wait_i     => '1',
       res_addr_o    => mem_addr,
       res_wr_en_o   => mem_wren,
       res_wr_data_o => mem_wrdata,
+      res_rd_en_o   => mem_rden,
       res_wait_o    => mem_wait
    );
 
@@ -224,7 +234,7 @@ begin
       a_addr_i    => mem_addr,
       a_wren_i    => mem_wren,
       a_data_i    => mem_wrdata,
-      a_rden_i    => cpu_rden,
+      a_rden_i    => mem_rden,
       a_data_o    => cpu_rddata,
       a_wait_o    => cpu_wait,
       a_irq_o     => cpu_irq,
@@ -244,6 +254,7 @@ begin
       b_mob_data_o  => vga_mob_data,
       b_config_o    => vga_config,
       b_collision_i => vga_collision,
+      b_contact_i   => vga_contact,
       b_vcount_i    => vga_vcount,
       b_hcount_i    => vga_hcount
   );
@@ -9,6 +9,7 @@ use ieee.numeric_std.all;
 -- * 0x08-0x0B Y-position (1 byte pr MOB)
 -- * 0x0C-0x0F Color      (1 byte pr MOB)
 -- * 0x10-0x13 Enable     (1 byte pr MOB)
+-- * 0x14-0x17 Clock cycle counter (read only). Reading 0x14 latches 0x15-0x17.
 -- * 0x18 Foreground text colour
 -- * 0x19 Background text colour
 -- * 0x1A Horizontal pixel shift
@@ -16,7 +17,22 @@ use ieee.numeric_std.all;
 -- * 0x1C IRQ status
 -- * 0x1D IRQ mask
 -- * 0x1E Keyboard
--- * 0x1F Collision
+-- * 0x1F Collision. Bits 3-0 : Sprite collided with another sprite.
+--
+-- The remaining addresses contain status information, and are not sent to the
+-- VGA module:
+-- * 0x20 Collision between each pair of sprites. Bits 5-0 : 0-1, 0-2, 0-3,
+--        1-2, 1-3, and 2-3.
+-- * 0x21 Collision with characters. Bits 3-0 : Sprite overlapped a character
+--        in the foreground.
+-- * 0x22-0x24 Report of prog/cpubench.c (write only). Writing to 0x24
+--        prints the opcode in 0x22, the cycles written to 0x24, and the NMOS
+--        6502 cycles in 0x23. This has no effect in hardware.
+-- * 0x28-0x3F Coordinates of the first contact of each pair of sprites in the
+--        most recent frame with a collision. Four bytes pr pair: X, X MSB, Y,
+--        and one unused byte.
+--
+-- The collision bits are latched, and are cleared by writing a one to them.
 
 entity conf_mem is
 
@@ -40,13 +56,15 @@ entity conf_mem is
       b_rst_i       : in  std_logic;
       b_vcount_i    : in  std_logic_vector(10 downto 0);
       b_hcount_i    : in  std_logic_vector(10 downto 0);
-      b_collision_i : in  std_logic_vector(3 downto 0);
-      b_config_o    : out std_logic_vector(2**(G_CONF_SIZE+3)-1 downto 0)
+      b_collision_i : in  std_logic_vector(13 downto 0);
+      b_contact_i   : in  std_logic_vector(6*17-1 downto 0);
+      b_config_o    : out std_logic_vector(32*8-1 downto 0)
   );
 end conf_mem;
 
 architecture Structural of conf_mem is
 
+   constant C_CYCLES    : integer := 20;
    constant C_FGCOL     : integer := 24;
    constant C_BGCOL     : integer := 25;
    constant C_YLINE     : integer := 27;
@@ -54,21 +72,50 @@ architecture Structural of conf_mem is
    constant C_IRQ_MASK  : integer := 29;
    constant C_KBD       : integer := 30;
    constant C_COLLISION : integer := 31;
+   constant C_COLL_PAIR : integer := 32;
+   constant C_COLL_CHAR : integer := 33;
+   constant C_BENCH     : integer := 34;
+   constant C_CONTACT   : integer := 40;
 
    signal a_vcount    : std_logic_vector(10 downto 0);
    signal a_hcount    : std_logic_vector(10 downto 0);
-   signal a_collision : std_logic_vector( 3 downto 0);
-   signal a_config    : std_logic_vector(2**(G_CONF_SIZE+3)-1 downto 0) := (
+   signal a_collision : std_logic_vector(13 downto 0);
+   signal a_contact   : std_logic_vector(6*17-1 downto 0);
+   signal a_config    : std_logic_vector(32*8-1 downto 0) := (
       C_FGCOL*8+7 downto C_FGCOL*8 => '1',
       C_BGCOL*8+7 downto C_BGCOL*8 => '0',
       others => '0');
    signal a_rd_data   : std_logic_vector(7 downto 0);
 
+   signal a_cycles       : std_logic_vector(31 downto 0) := (others => '0');
+   signal a_cycles_latch : std_logic_vector(23 downto 0) := (others => '0');
+
    signal a_irq_s      : std_logic_vector(1 downto 0);
    signal a_irq_latch  : std_logic_vector(1 downto 0) := (others => '0');
    signal a_coll_latch : std_logic_vector(3 downto 0) := (others => '0');
+   signal a_pair_latch : std_logic_vector(5 downto 0) := (others => '0');
+   signal a_char_latch : std_logic_vector(3 downto 0) := (others => '0');
+
+   signal a_bench_opcode : std_logic_vector(7 downto 0);
+   signal a_bench_nmos   : std_logic_vector(7 downto 0);
 
-   signal b_config    : std_logic_vector(2**(G_CONF_SIZE+3)-1 downto 0);
+   signal b_config    : std_logic_vector(32*8-1 downto 0);
+
+   function to_hex(arg : std_logic_vector(7 downto 0)) return string is
+      constant C_HEX : string(1 to 16) := "0123456789ABCDEF";
+   begin
+      return C_HEX(conv_integer(arg(7 downto 4))+1) & C_HEX(conv_integer(arg(3 downto 0))+1);
+   end function to_hex;
+
+   function to_diff(cycles : integer; nmos : integer) return string is
+   begin
+      if cycles > nmos then
+         return " (slower)";
+      elsif cycles < nmos then
+         return " (faster)";
+      end if;
+      return "";
+   end function to_diff;
 
 begin
 
@@ -104,7 +151,7 @@ begin
    inst_cdc_collision : entity work.cdcvector
    generic map (
       G_NEXYS4DDR => G_NEXYS4DDR,
-      G_SIZE      => 4
+      G_SIZE      => 14
    )
    port map (
       rx_clk_i => b_clk_i,
@@ -113,11 +160,23 @@ begin
       tx_out_o => a_collision
    );
 
+   inst_cdc_contact : entity work.cdcvector
+   generic map (
+      G_NEXYS4DDR => G_NEXYS4DDR,
+      G_SIZE      => 6*17
+   )
+   port map (
+      rx_clk_i => b_clk_i,
+      rx_in_i  => b_contact_i,
+      tx_clk_i => a_clk_i,
+      tx_out_o => a_contact
+   );
+
    -- From @a_clk_i to @b_clk_i
    inst_cdcvector_config : entity work.cdcvector
    generic map (
       G_NEXYS4DDR => G_NEXYS4DDR,
-      G_SIZE      => 2**(G_CONF_SIZE+3)
+      G_SIZE      => 32*8
    )
    port map (
       rx_clk_i => a_clk_i,
@@ -134,22 +193,28 @@ begin
    -- Generate interrupt
    a_irq_s(0) <= '1' when a_vcount(8 downto 0) = (a_config(C_YLINE*8+7 downto C_YLINE*8) & '1')
                       and a_hcount = std_logic_vector(to_unsigned(656, 11)) else '0';
-   a_irq_s(1) <= '1' when a_collision /= "0000" else '0';
+   a_irq_s(1) <= '1' when a_collision(3 downto 0) /= "0000" else '0';
 
 
    proc_write : process (a_clk_i)
       variable addr_v : integer range 0 to 2**G_CONF_SIZE-1;
       variable a_irq_latch_v  : std_logic_vector(1 downto 0);
       variable a_coll_latch_v : std_logic_vector(3 downto 0);
+      variable a_pair_latch_v : std_logic_vector(5 downto 0);
+      variable a_char_latch_v : std_logic_vector(3 downto 0);
    begin
       if rising_edge(a_clk_i) then
          addr_v := conv_integer(a_addr_i(G_CONF_SIZE-1 downto 0));
 
          a_irq_latch_v  := a_irq_latch;
          a_coll_latch_v := a_coll_latch;
+         a_pair_latch_v := a_pair_latch;
+         a_char_latch_v := a_char_latch;
 
          if a_wr_en_i = '1' then
-            a_config(addr_v*8+7 downto addr_v*8) <= a_wr_data_i;
+            if addr_v < 32 then
+               a_config(addr_v*8+7 downto addr_v*8) <= a_wr_data_i;
+            end if;
 
             if addr_v = C_IRQ_STAT then
                a_irq_latch_v := a_irq_latch_v and not a_wr_data_i(1 downto 0);
@@ -157,13 +222,23 @@ begin
             if addr_v = C_COLLISION then
                a_coll_latch_v := a_coll_latch_v and not a_wr_data_i(3 downto 0);
             end if;
+            if addr_v = C_COLL_PAIR then
+               a_pair_latch_v := a_pair_latch_v and not a_wr_data_i(5 downto 0);
+            end if;
+            if addr_v = C_COLL_CHAR then
+               a_char_latch_v := a_char_latch_v and not a_wr_data_i(3 downto 0);
+            end if;
          end if;
 
          a_irq_latch_v  := a_irq_latch_v or (a_irq_s and a_config(C_IRQ_MASK*8+1 downto C_IRQ_MASK*8));
-         a_coll_latch_v := a_coll_latch_v or a_collision;
+         a_coll_latch_v := a_coll_latch_v or a_collision(3 downto 0);
+         a_pair_latch_v := a_pair_latch_v or a_collision(9 downto 4);
+         a_char_latch_v := a_char_latch_v or a_collision(13 downto 10);
 
          a_irq_latch  <= a_irq_latch_v;
          a_coll_latch <= a_coll_latch_v;
+         a_pair_latch <= a_pair_latch_v;
+         a_char_latch <= a_char_latch_v;
 
          a_config(C_IRQ_STAT*8+1  downto C_IRQ_STAT*8)  <= a_irq_latch_v;
          a_config(C_COLLISION*8+3 downto C_COLLISION*8) <= a_coll_latch_v;
@@ -171,12 +246,56 @@ begin
          if a_rst_i = '1' then
             a_irq_latch  <= (others => '0');
             a_coll_latch <= (others => '0');
+            a_pair_latch <= (others => '0');
+            a_char_latch <= (others => '0');
          end if;
       end if;
    end process proc_write;
 
+   -- Count clock cycles, so the CPU can measure execution time.
+   proc_cycles : process (a_clk_i)
+   begin
+      if rising_edge(a_clk_i) then
+         a_cycles <= a_cycles + 1;
+
+         if a_rst_i = '1' then
+            a_cycles <= (others => '0');
+         end if;
+      end if;
+   end process proc_cycles;
+
+   -- Print the results of prog/cpubench.c in simulation.
+   proc_report : process (a_clk_i)
+      variable addr_v   : integer range 0 to 2**G_CONF_SIZE-1;
+      variable cycles_v : integer range 0 to 255;
+      variable nmos_v   : integer range 0 to 255;
+   begin
+      if rising_edge(a_clk_i) then
+         addr_v := conv_integer(a_addr_i(G_CONF_SIZE-1 downto 0));
+
+         if a_wr_en_i = '1' then
+            case addr_v is
+               when C_BENCH   =>
+                  a_bench_opcode <= a_wr_data_i;
+               when C_BENCH+1 =>
+                  a_bench_nmos <= a_wr_data_i;
+               when C_BENCH+2 =>
+                  cycles_v := conv_integer(a_wr_data_i);
+                  nmos_v   := conv_integer(a_bench_nmos);
+                  report "Opcode " & to_hex(a_bench_opcode)
+                     & ": " & integer'image(cycles_v) & " cycles"
+                     & ", NMOS 6502: " & integer'image(nmos_v)
+                     & to_diff(cycles_v, nmos_v);
+               when others =>
+                  null;
+            end case;
+         end if;
+      end if;
+   end process proc_report;
+
    proc_read : process (a_clk_i)
       variable addr_v : integer range 0 to 2**G_CONF_SIZE-1;
+      variable pair_v : integer range 0 to 5;
    begin
       if rising_edge(a_clk_i) then
          addr_v := conv_integer(a_addr_i(G_CONF_SIZE-1 downto 0));
@@ -193,8 +312,31 @@ begin
                   a_rd_data(1 downto 0) <= a_irq_latch;
                when C_COLLISION =>
                   a_rd_data(3 downto 0) <= a_coll_latch;
+               when C_COLL_PAIR =>
+                  a_rd_data(5 downto 0) <= a_pair_latch;
+               when C_COLL_CHAR =>
+                  a_rd_data(3 downto 0) <= a_char_latch;
+               when C_CONTACT to C_CONTACT+6*4-1 =>
+                  pair_v := (addr_v - C_CONTACT) / 4;
+                  case (addr_v - C_CONTACT) mod 4 is
+                     when 0 => a_rd_data    <= a_contact(pair_v*17 +  7 downto pair_v*17);
+                     when 1 => a_rd_data(0) <= a_contact(pair_v*17 +  8);
+                     when 2 => a_rd_data    <= a_contact(pair_v*17 + 16 downto pair_v*17 + 9);
+                     when others => null;
+                  end case;
+               when C_CYCLES    =>
+                  a_rd_data      <= a_cycles(7 downto 0);
+                  a_cycles_latch <= a_cycles(31 downto 8);
+               when C_CYCLES+1  =>
+                  a_rd_data <= a_cycles_latch(7 downto 0);
+               when C_CYCLES+2  =>
+                  a_rd_data <= a_cycles_latch(15 downto 8);
+               when C_CYCLES+3  =>
+                  a_rd_data <= a_cycles_latch(23 downto 16);
                when others =>
-                  a_rd_data <= a_config(addr_v*8+7 downto addr_v*8);
+                  if addr_v < 32 then
+                     a_rd_data <= a_config(addr_v*8+7 downto addr_v*8);
+                  end if;
             end case;
          end if;
       end if;
@@ -69,12 +69,13 @@ entity mem_module is
       b_col_data_o  : out std_logic_vector(7 downto 0);
       b_mob_addr_i  : in  std_logic_vector(G_MOB_SIZE-2 downto 0);
       b_mob_data_o  : out std_logic_vector(15 downto 0);
-      b_config_o    : out std_logic_vector((2**G_CONF_SIZE)*8-1 downto 0);
+      b_config_o    : out std_logic_vector(32*8-1 downto 0);
       b_font_addr_i : in  std_logic_vector(G_FONT_SIZE-1 downto 0);
       b_font_data_o : out std_logic_vector(7 downto 0);
       b_vcount_i    : in  std_logic_vector(10 downto 0);
       b_hcount_i    : in  std_logic_vector(10 downto 0);
-      b_collision_i : in  std_logic_vector(3 downto 0)
+      b_collision_i : in  std_logic_vector(13 downto 0);
+      b_contact_i   : in  std_logic_vector(6*17-1 downto 0)
   );
 end mem_module;
 
@@ -215,7 +216,8 @@ begin
       b_config_o    => b_config_o,
       b_vcount_i    => b_vcount_i,
       b_hcount_i    => b_hcount_i,
-      b_collision_i => b_collision_i
+      b_collision_i => b_collision_i,
+      b_contact_i   => b_contact_i
    );
 
 
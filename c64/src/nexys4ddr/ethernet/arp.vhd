@@ -0,0 +1,134 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.std_logic_unsigned.all;
+
+-- This module answers ARP requests for our IP address. This way the host can
+-- find our MAC address without a static ARP entry.
+--
+-- The input is the received MAC frame without CRC, i.e. the output of
+-- strip_crc. The reply is padded to the minimum frame size of 60 bytes (without
+-- CRC), and is presented on the same pulling interface as encap.
+-- If a request arrives while the previous reply is still being sent, the
+-- request is ignored.
+--
+-- Like encap, this module operates on the falling clock edge.
+
+entity arp is
+   port (
+      clk_i       : in  std_logic;
+      rst_i       : in  std_logic;
+
+      -- Ctrl interface. Assumed to be constant for now.
+      ctrl_mac_i  : in  std_logic_vector(47 downto 0);
+      ctrl_ip_i   : in  std_logic_vector(31 downto 0);
+
+      -- Received MAC frame
+      rx_ena_i    : in  std_logic;
+      rx_sof_i    : in  std_logic;
+      rx_eof_i    : in  std_logic;
+      rx_data_i   : in  std_logic_vector(7 downto 0);
+
+      -- Reply MAC frame
+      tx_data_o   : out std_logic_vector(7 downto 0);
+      tx_sof_o    : out std_logic;
+      tx_eof_o    : out std_logic;
+      tx_empty_o  : out std_logic;
+      tx_rden_i   : in  std_logic
+   );
+end arp;
+
+architecture Structural of arp is
+
+   -- The first 42 bytes of the received frame. Byte 0 is in the MSB.
+   signal req     : std_logic_vector(42*8-1 downto 0);
+   signal req_cnt : integer range 0 to 42;
+
+   -- The reply frame. Byte 0 is in the MSB.
+   signal rsp     : std_logic_vector(60*8-1 downto 0);
+   signal rsp_cnt : integer range 0 to 60;
+
+   signal tx_empty : std_logic := '1';
+   signal tx_sof   : std_logic := '0';
+   signal tx_eof   : std_logic := '0';
+
+begin
+
+   proc_arp : process (clk_i)
+      variable req_v : std_logic_vector(42*8-1 downto 0);
+
+      -- Return 'len' bytes starting at byte 'pos' of the request.
+      function field(arg : std_logic_vector(42*8-1 downto 0);
+                     pos : integer;
+                     len : integer) return std_logic_vector is
+      begin
+         return arg((42-pos)*8-1 downto (42-pos-len)*8);
+      end function field;
+
+   begin
+      if falling_edge(clk_i) then
+
+         -- Store the first 42 bytes of the frame.
+         if rx_ena_i = '1' then
+            req_v := req;
+            if rx_sof_i = '1' then
+               req_v   := req_v(41*8-1 downto 0) & rx_data_i;
+               req_cnt <= 1;
+            elsif req_cnt < 42 then
+               req_v   := req_v(41*8-1 downto 0) & rx_data_i;
+               req_cnt <= req_cnt + 1;
+            end if;
+            req <= req_v;
+
+            -- Build the reply, if this is an ARP request for our IP address.
+            if rx_eof_i = '1' and rx_sof_i = '0' and req_cnt >= 41 and tx_empty = '1' and
+               field(req_v, 12, 2)  = X"0806" and
+               field(req_v, 14, 8)  = X"0001080006040001" and
+               field(req_v, 38, 4)  = ctrl_ip_i then
+
+               rsp <= field(req_v, 22, 6) &          -- Destination MAC
+                      ctrl_mac_i &                   -- Source MAC
+                      X"0806" &                      -- EtherType
+                      X"0001080006040002" &          -- ARP reply
+                      ctrl_mac_i &                   -- Sender hardware address
+                      ctrl_ip_i &                    -- Sender protocol address
+                      field(req_v, 22, 6) &          -- Target hardware address
+                      field(req_v, 28, 4) &          -- Target protocol address
+                      X"000000000000000000" &        -- Padding
+                      X"000000000000000000";
+               rsp_cnt  <= 60;
+               tx_empty <= '0';
+               tx_sof   <= '1';
+               tx_eof   <= '0';
+            end if;
+         end if;
+
+         -- Send the reply.
+         if tx_empty = '0' and tx_rden_i = '1' then
+            rsp     <= rsp(59*8-1 downto 0) & X"00";
+            rsp_cnt <= rsp_cnt - 1;
+            tx_sof  <= '0';
+            if rsp_cnt <= 2 then
+               tx_eof <= '1';
+            end if;
+            if rsp_cnt = 1 then
+               tx_empty <= '1';
+               tx_eof   <= '0';
+            end if;
+         end if;
+
+         if rst_i = '1' then
+            req_cnt  <= 0;
+            tx_empty <= '1';
+            tx_sof   <= '0';
+            tx_eof   <= '0';
+         end if;
+      end if;
+   end process proc_arp;
+
+   -- Drive output signals
+   tx_data_o  <= rsp(60*8-1 downto 59*8);
+   tx_sof_o   <= tx_sof;
+   tx_eof_o   <= tx_eof;
+   tx_empty_o <= tx_empty;
+
+end Structural;
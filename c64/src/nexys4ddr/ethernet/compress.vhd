@@ -1,20 +1,25 @@
 library ieee;
 use ieee.std_logic_1164.all;
 use ieee.std_logic_unsigned.all;
-use ieee.numeric_std.all;
 
--- This is a simple run-length-encoding compression algorithm
--- It receives data one byte at a time, and writes the output
--- to a two-byte wide fifo. This simplifies the desgin.
-
--- One existing bug is that if the last byte of the frame is
--- different from the preceding, then two writes to the fifo
--- is necessary. Therefore, the second write may happen during
--- the first byte of the next frame.
--- This will be a problem, if the next frame is only one byte long,
--- because then the two writes will collide.
--- To reproduce this bug therefore send a two-byte frame (two different bytes),
--- followed immediately in the next clock cycle by a one-byte frame.
+-- This is a simple run-length-encoding compression algorithm.
+-- It receives data one byte at a time, and outputs a sequence of tokens.
+-- Each token consists of two bytes: The data byte, and the number of
+-- repetitions minus one. SOF is set on the first byte of the first token,
+-- and EOF is set on the last byte of the last token.
+--
+-- Input frames may arrive back-to-back at one byte every clock cycle. This
+-- includes frames of only one byte.
+--
+-- Each input byte completes at most two tokens: When the last byte of a
+-- frame differs from the preceding byte, both the preceding run and the last
+-- byte are completed. Therefore, each entry in the output fifo contains room
+-- for two tokens, and a valid bit for the second token. This way there is
+-- never more than a single write to the fifo in each clock cycle.
+--
+-- The output rate is one byte every clock cycle, i.e. up to two clock cycles
+-- for each input byte. The output fifo absorbs the difference, so the input
+-- must on average be compressible.
 
 entity compress is
    port (
@@ -33,142 +38,100 @@ end compress;
 
 architecture Structural of compress is
 
-   signal in_sof_d  : std_logic;
-   signal in_eof_d  : std_logic;
-   signal in_data_d : std_logic_vector(7 downto 0);
+   -- Each token in the fifo is 32 bits:
+   -- Bits  7- 0 : Data byte
+   -- Bits 15- 8 : Count
+   -- Bit  16    : SOF
+   -- Bit  17    : EOF
+   -- Bit  18    : Valid (only used for the second token)
+   subtype t_token is std_logic_vector(31 downto 0);
+
+   function token(data : std_logic_vector(7 downto 0);
+                  cnt  : std_logic_vector(7 downto 0);
+                  sof  : std_logic;
+                  eof  : std_logic) return t_token is
+      variable res : t_token;
+   begin
+      res := (others => '0');
+      res( 7 downto 0) := data;
+      res(15 downto 8) := cnt;
+      res(16) := sof;
+      res(17) := eof;
+      res(18) := '1';
+      return res;
+   end function token;
+
+   -- Current run
+   signal run_data : std_logic_vector(7 downto 0);
+   signal run_cnt  : std_logic_vector(7 downto 0);
+   signal run_sof  : std_logic;
 
    signal fifo_wr_en    : std_logic;
-   signal fifo_wr_data  : std_logic_vector(31 downto 0);
+   signal fifo_wr_data  : std_logic_vector(63 downto 0);
    signal fifo_rd_en    : std_logic;
-   signal fifo_rd_data  : std_logic_vector(15 downto 0);
+   signal fifo_rd_data  : std_logic_vector(63 downto 0);
    signal fifo_rd_empty : std_logic;
 
+   -- Current byte of the fifo entry: 0 and 1 are the first token,
+   -- 2 and 3 are the second token.
+   signal out_pos   : integer range 0 to 3 := 0;
+   signal out_tok   : t_token;
+
    signal out_ena   : std_logic;
    signal out_sof   : std_logic;
    signal out_eof   : std_logic;
-   signal out_eof_d : std_logic;
    signal out_data  : std_logic_vector(7 downto 0);
 
-   signal fsm_sof : std_logic;
-   signal fsm_eof : std_logic;
-   signal fsm_cnt : std_logic_vector(7 downto 0);
-
 begin
 
-   -- Remember the last byte received.
-   proc_delay : process (clk_i)
-   begin
-      if rising_edge(clk_i) then
-         if in_ena_i = '1' then
-            in_sof_d  <= in_sof_i;
-            in_eof_d  <= in_eof_i;
-            in_data_d <= in_data_i;
-         end if;
-
-         if rst_i = '1' then
-            in_sof_d  <= '0';
-            in_eof_d  <= '0';
-            in_data_d <= (others => '0');
-         end if;
-      end if;
-   end process proc_delay;
-
    -- The main state machine to control the compression.
    proc_input : process (clk_i)
-      variable same_v : std_logic;
-      variable lst_v  : std_logic_vector(2 downto 0);
    begin
       if rising_edge(clk_i) then
          fifo_wr_en   <= '0';
-         fifo_wr_data(31 downto 26) <= (others => '0');
-         fifo_wr_data(15 downto 10) <= (others => '0');
-         fifo_wr_data(9)            <= '0'; -- Never EOF on first byte
-         fifo_wr_data(24)           <= '0'; -- Never SOF on second byte
-
-         -- This compares the received byte with the previous byte.
-         -- Take care to avoid wrap-around of counter.
-         -- This value is not used at SOF.
-         same_v := '0';
-         if in_data_d = in_data_i and fsm_cnt /= X"FF" then
-            same_v := '1';
-         end if;
-
-         lst_v := in_sof_i & in_eof_i & same_v;
+         fifo_wr_data <= (others => '0');
 
          if in_ena_i = '1' then
-            case lst_v is
-               when "000" =>
-                  -- Middle of frame, different byte received.
-                  fifo_wr_data(7 downto 0)   <= in_data_d;
-                  fifo_wr_data(8)            <= fsm_sof;
-                  fifo_wr_data(23 downto 16) <= fsm_cnt;
-                  fifo_wr_data(25)           <= fsm_eof;
-                  fifo_wr_en <= '1';
-                  fsm_sof    <= '0';
-                  fsm_eof    <= '0';
-                  fsm_cnt    <= (others => '0');
-
-               when "001" =>
-                  -- Middle of frame, same byte received.
-                  fsm_cnt <= fsm_cnt + 1;
-
-               when "010" =>
-                  -- End of frame, but last byte is different.
-                  fifo_wr_data(7 downto 0)   <= in_data_d;
-                  fifo_wr_data(8)            <= fsm_sof;
-                  fifo_wr_data(23 downto 16) <= fsm_cnt;
-                  fifo_wr_data(25)           <= '0';
-                  fifo_wr_en <= '1';
-                  fsm_sof    <= '0';
-                  fsm_eof    <= '1';   -- Force write on next clock cycle.
-                  fsm_cnt    <= (others => '0');
-
-               when "011" =>
-                  -- End of frame, and last byte is the same as previous.
-                  fifo_wr_data(7 downto 0)   <= in_data_d;
-                  fifo_wr_data(8)            <= fsm_sof;
-                  fifo_wr_data(23 downto 16) <= fsm_cnt + 1;
-                  fifo_wr_data(25)           <= '1';
-                  fifo_wr_en <= '1';
-                  fsm_sof    <= '0';
-                  fsm_eof    <= '0';
-                  fsm_cnt    <= (others => '0');
-
-               when "100" | "101" =>
-                  -- First byte of multi-byte frame doesn't lead to any writes.
-                  fsm_cnt <= (others => '0');
-                  fsm_sof <= '1';
-                  fsm_eof <= '0';
+            if in_sof_i = '1' then
+               -- First byte of frame starts a new run.
+               run_data <= in_data_i;
+               run_cnt  <= (others => '0');
+               run_sof  <= '1';
 
-               when "110" | "111" =>
+               if in_eof_i = '1' then
                   -- Frame consists of a single byte only.
-                  fifo_wr_data(7 downto 0)   <= in_data_i;
-                  fifo_wr_data(8)            <= '1';
-                  fifo_wr_data(23 downto 16) <= (others => '0');
-                  fifo_wr_data(25)           <= '1';
+                  fifo_wr_data(31 downto 0) <= token(in_data_i, X"00", '1', '1');
                   fifo_wr_en <= '1';
+               end if;
 
-               when others => null;
-            end case;
-         end if;
+            elsif in_data_i = run_data and run_cnt /= X"FF" then
+               -- Same byte received. Take care to avoid wrap-around of counter.
+               run_cnt <= run_cnt + 1;
 
-         -- This inserts an extra write after EOF, if the
-         -- last byte of the frame was different from the previous.
-         -- This will overwrite a write from the next frame, if it occurs.
-         if fsm_eof = '1' then
-            fifo_wr_data(7 downto 0)   <= in_data_d;
-            fifo_wr_data(8)            <= '0';
-            fifo_wr_data(23 downto 16) <= (others => '0');
-            fifo_wr_data(25)           <= '1';
-            fifo_wr_en <= '1';
-            fsm_eof <= '0';
+               if in_eof_i = '1' then
+                  fifo_wr_data(31 downto 0) <= token(run_data, run_cnt + 1, run_sof, '1');
+                  fifo_wr_en <= '1';
+               end if;
+
+            else
+               -- Different byte received. This completes the current run.
+               fifo_wr_data(31 downto 0) <= token(run_data, run_cnt, run_sof, '0');
+               fifo_wr_en <= '1';
+               run_data <= in_data_i;
+               run_cnt  <= (others => '0');
+               run_sof  <= '0';
+
+               if in_eof_i = '1' then
+                  -- The last byte is a run of its own.
+                  fifo_wr_data(63 downto 32) <= token(in_data_i, X"00", '0', '1');
+               end if;
+            end if;
          end if;
 
          if rst_i = '1' then
             fifo_wr_en <= '0';
-            fsm_cnt    <= (others => '0');
-            fsm_sof    <= '0';
-            fsm_eof    <= '0';
+            run_cnt    <= (others => '0');
+            run_sof    <= '0';
          end if;
       end if;
    end process proc_input;
@@ -178,46 +141,63 @@ begin
    -- Instantiate output FIFO
    --------------------------
 
-   -- This converts the data stream from 16-bits to 8-bits.
-   inst_fifo : entity work.fifo_width_change
+   inst_fifo : entity work.fifo
    generic map (
-      G_WRPORT_SIZE => 32,
-      G_RDPORT_SIZE => 16
+      G_WIDTH => 64
       )
    port map (
       wr_clk_i   => clk_i,
       wr_rst_i   => rst_i,
-      rd_clk_i   => clk_i,
-      rd_rst_i   => rst_i,
-
       wr_en_i    => fifo_wr_en,
       wr_data_i  => fifo_wr_data,
+      wr_error_o => open,
+      --
+      rd_clk_i   => clk_i,
+      rd_rst_i   => rst_i,
       rd_en_i    => fifo_rd_en,
       rd_data_o  => fifo_rd_data,
-      rd_empty_o => fifo_rd_empty
+      rd_empty_o => fifo_rd_empty,
+      rd_error_o => open
       );
 
-   -- Read from fifo
-   -- Add extra empty cycle between frame. Not necessary, but
-   -- simplifies debugging.
-   fifo_rd_en <= '1' when fifo_rd_empty = '0' and (out_eof = '0' or out_eof_d = '1')
+   -- Select current token
+   out_tok <= fifo_rd_data(31 downto 0) when out_pos < 2 else
+              fifo_rd_data(63 downto 32);
+
+   -- Read from fifo after the last byte of the entry.
+   fifo_rd_en <= '1' when fifo_rd_empty = '0' and
+                          (out_pos = 3 or (out_pos = 1 and fifo_rd_data(50) = '0'))
                  else '0';
 
    -- Drive output signals
    proc_out : process (clk_i)
    begin
       if rising_edge(clk_i) then
-         out_ena  <= fifo_rd_en;
-         out_sof  <= fifo_rd_data(8) and fifo_rd_en;
-         out_eof  <= fifo_rd_data(9) and fifo_rd_en;
-         out_data <= fifo_rd_data(7 downto 0);
-         out_eof_d <= out_eof;
+         out_ena <= '0';
+         out_sof <= '0';
+         out_eof <= '0';
+
+         if fifo_rd_empty = '0' then
+            out_ena <= '1';
+            if out_pos = 0 or out_pos = 2 then
+               out_data <= out_tok(7 downto 0);
+               out_sof  <= out_tok(16);
+               out_pos  <= out_pos + 1;
+            else
+               out_data <= out_tok(15 downto 8);
+               out_eof  <= out_tok(17);
+               out_pos  <= (out_pos + 1) mod 4;
+               if out_pos = 1 and fifo_rd_data(50) = '0' then
+                  out_pos <= 0;   -- No second token
+               end if;
+            end if;
+         end if;
 
          if rst_i = '1' then
-            out_ena   <= '0';
-            out_sof   <= '0';
-            out_eof   <= '0';
-            out_eof_d <= '0';
+            out_ena <= '0';
+            out_sof <= '0';
+            out_eof <= '0';
+            out_pos <= 0;
          end if;
       end if;
    end process proc_out;
@@ -228,4 +208,3 @@ begin
    out_data_o <= out_data;
 
 end Structural;
-
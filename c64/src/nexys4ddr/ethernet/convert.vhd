@@ -3,6 +3,9 @@ use ieee.std_logic_1164.all;
 use ieee.std_logic_unsigned.all;
 
 -- This converts the VGA output to Ethernet frames.
+-- Each frame contains a block of 8 lines. Blocks that are unchanged since the
+-- previous VGA frame are skipped, see delta.vhd. The remaining blocks are
+-- run-length encoded, see compress.vhd.
 
 -- TODO: Read the VGA output and convert to .ppm (P6) format, see
 -- https://en.wikipedia.org/wiki/Netpbm_format Use a simple run-length encoding
@@ -64,6 +67,13 @@ architecture Structural of convert is
    signal vga_pkg_eof  : std_logic;
    signal vga_pkg_data : std_logic_vector(7 downto 0);
  
+   -- Changed packets only
+   signal vga_delta_ena  : std_logic := '0';
+   signal vga_delta_sof  : std_logic;
+   signal vga_delta_eof  : std_logic;
+   signal vga_delta_data : std_logic_vector(7 downto 0);
+   signal vga_key        : std_logic;
+
    -- Compressed data
    signal vga_comp_ena  : std_logic := '0';
    signal vga_comp_sof  : std_logic;
@@ -166,17 +176,40 @@ begin
 
 
    ------------------------------
-   -- Compress packet
+   -- Skip unchanged packets
    ------------------------------
 
-   inst_compress : entity work.compress
+   -- Start with a key frame, whenever transmission is resumed.
+   vga_key <= not vga_transmit;
+
+   inst_delta : entity work.delta
    port map (
       clk_i       => vga_clk_i,
       rst_i       => vga_rst_i,
+      key_i       => vga_key,
       in_ena_i    => vga_pkg_ena,
       in_sof_i    => vga_pkg_sof,
       in_eof_i    => vga_pkg_eof,
       in_data_i   => vga_pkg_data,
+      out_ena_o   => vga_delta_ena,
+      out_sof_o   => vga_delta_sof,
+      out_eof_o   => vga_delta_eof,
+      out_data_o  => vga_delta_data
+   );
+
+
+   ------------------------------
+   -- Compress packet
+   ------------------------------
+
+   inst_compress : entity work.compress
+   port map (
+      clk_i       => vga_clk_i,
+      rst_i       => vga_rst_i,
+      in_ena_i    => vga_delta_ena,
+      in_sof_i    => vga_delta_sof,
+      in_eof_i    => vga_delta_eof,
+      in_data_i   => vga_delta_data,
       out_ena_o   => vga_comp_ena,
       out_sof_o   => vga_comp_sof,
       out_eof_o   => vga_comp_eof,
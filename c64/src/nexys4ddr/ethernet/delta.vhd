@@ -0,0 +1,211 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.std_logic_unsigned.all;
+
+-- This module removes packets that are identical to the same packet in the
+-- previous frame. Each packet consists of a line number (0-59) followed by
+-- the pixel data for that block of lines.
+--
+-- Each packet is stored in a buffer while a signature (Fletcher-32) is
+-- calculated. At EOF the signature is compared with the signature of the
+-- same line block in the previous frame. Only if they differ is the packet
+-- forwarded. The buffer has two banks, so the next packet can be received
+-- while the previous is being forwarded.
+--
+-- Every G_KEY_INTERVAL frames a key frame is sent, where all packets are
+-- forwarded. This allows the receiver to resynchronize, e.g. after a lost
+-- packet. A key frame is also sent first, and after key_i has been
+-- asserted.
+--
+-- The first byte of each forwarded packet is modified as follows:
+-- Bit 7   : This packet belongs to a key frame.
+-- Bit 6   : Frame parity. Toggles for every frame.
+-- Bit 5-0 : Line number.
+--
+-- The output rate is one byte every clock cycle. A packet must therefore not
+-- arrive faster than that, and it must be no longer than 8K bytes.
+
+entity delta is
+   generic (
+      G_KEY_INTERVAL : integer := 60    -- One key frame every second.
+   );
+   port (
+      clk_i       : in  std_logic;
+      rst_i       : in  std_logic;
+      key_i       : in  std_logic;    -- Force next frame to be a key frame.
+      in_ena_i    : in  std_logic;
+      in_sof_i    : in  std_logic;
+      in_eof_i    : in  std_logic;
+      in_data_i   : in  std_logic_vector(7 downto 0);
+      out_ena_o   : out std_logic;
+      out_sof_o   : out std_logic;
+      out_eof_o   : out std_logic;
+      out_data_o  : out std_logic_vector(7 downto 0)
+   );
+end delta;
+
+architecture Structural of delta is
+
+   -- Two banks of 8K bytes each.
+   type t_buf is array (0 to 2*8192-1) of std_logic_vector(7 downto 0);
+   signal buf : t_buf;
+
+   -- One signature for each line block.
+   type t_sig is array (0 to 63) of std_logic_vector(31 downto 0);
+   signal sig_ram : t_sig := (others => (others => '0'));
+
+   -- Input side
+   signal wr_bank  : std_logic := '0';
+   signal wr_addr  : std_logic_vector(12 downto 0) := (others => '0');
+   signal sum1     : std_logic_vector(15 downto 0);
+   signal sum2     : std_logic_vector(15 downto 0);
+   signal line     : std_logic_vector(5 downto 0);
+   signal prev_sig : std_logic_vector(31 downto 0);
+
+   -- Frame counter
+   signal key_cnt  : integer range 0 to G_KEY_INTERVAL-1 := 0;
+   signal key      : std_logic := '0';
+   signal odd      : std_logic := '0';
+
+   -- Packet to forward
+   signal fwd      : std_logic := '0';
+   signal fwd_bank : std_logic;
+   signal fwd_last : std_logic_vector(12 downto 0);
+   signal fwd_hdr  : std_logic_vector(7 downto 0);
+
+   -- Output side
+   signal rd_active : std_logic := '0';
+   signal rd_bank   : std_logic;
+   signal rd_addr   : std_logic_vector(12 downto 0);
+   signal rd_last   : std_logic_vector(12 downto 0);
+   signal rd_hdr    : std_logic_vector(7 downto 0);
+
+   signal out_ena  : std_logic := '0';
+   signal out_sof  : std_logic := '0';
+   signal out_eof  : std_logic := '0';
+   signal out_data : std_logic_vector(7 downto 0);
+
+begin
+
+   -- Store the incoming packet.
+   proc_write : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if in_ena_i = '1' then
+            buf(conv_integer(wr_bank & wr_addr)) <= in_data_i;
+         end if;
+      end if;
+   end process proc_write;
+
+
+   -- Calculate signature, and decide whether to forward the packet.
+   proc_input : process (clk_i)
+      variable sum1_v : std_logic_vector(15 downto 0);
+      variable sum2_v : std_logic_vector(15 downto 0);
+      variable sig_v  : std_logic_vector(31 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         fwd <= '0';
+
+         if in_ena_i = '1' then
+            if in_sof_i = '1' then
+               sum1_v := X"00" & in_data_i;
+               sum2_v := X"00" & in_data_i;
+               line     <= in_data_i(5 downto 0);
+               prev_sig <= sig_ram(conv_integer(in_data_i(5 downto 0)));
+
+               -- Start of a new frame.
+               if in_data_i(5 downto 0) = 0 then
+                  odd <= not odd;
+                  key <= '0';
+                  if key_cnt = 0 then
+                     key     <= '1';
+                     key_cnt <= G_KEY_INTERVAL-1;
+                  else
+                     key_cnt <= key_cnt - 1;
+                  end if;
+               end if;
+            else
+               sum1_v := sum1 + in_data_i;
+               sum2_v := sum2 + sum1_v;
+            end if;
+            sum1    <= sum1_v;
+            sum2    <= sum2_v;
+            wr_addr <= wr_addr + 1;
+
+            if in_eof_i = '1' then
+               sig_v := sum2_v & sum1_v;
+               sig_ram(conv_integer(line)) <= sig_v;
+
+               -- Only forward changed packets, or all packets in a key frame.
+               if sig_v /= prev_sig or key = '1' then
+                  fwd      <= '1';
+                  fwd_bank <= wr_bank;
+                  fwd_last <= wr_addr;
+                  fwd_hdr  <= key & odd & line;
+               end if;
+
+               -- Prepare for next packet.
+               wr_bank <= not wr_bank;
+               wr_addr <= (others => '0');
+            end if;
+         end if;
+
+         if key_i = '1' then
+            key_cnt <= 0;
+         end if;
+
+         if rst_i = '1' then
+            wr_bank <= '0';
+            wr_addr <= (others => '0');
+            key_cnt <= 0;
+         end if;
+      end if;
+   end process proc_input;
+
+
+   -- Forward the packet from the buffer.
+   proc_output : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         out_ena <= '0';
+         out_sof <= '0';
+         out_eof <= '0';
+
+         if rd_active = '1' then
+            out_ena  <= '1';
+            out_data <= buf(conv_integer(rd_bank & rd_addr));
+            if rd_addr = 0 then
+               out_sof  <= '1';
+               out_data <= rd_hdr;
+            end if;
+            if rd_addr = rd_last then
+               out_eof   <= '1';
+               rd_active <= '0';
+            end if;
+            rd_addr <= rd_addr + 1;
+         end if;
+
+         if fwd = '1' then
+            rd_active <= '1';
+            rd_bank   <= fwd_bank;
+            rd_addr   <= (others => '0');
+            rd_last   <= fwd_last;
+            rd_hdr    <= fwd_hdr;
+         end if;
+
+         if rst_i = '1' then
+            rd_active <= '0';
+            out_ena   <= '0';
+            out_sof   <= '0';
+            out_eof   <= '0';
+         end if;
+      end if;
+   end process proc_output;
+
+   out_ena_o  <= out_ena;
+   out_sof_o  <= out_sof;
+   out_eof_o  <= out_eof;
+   out_data_o <= out_data;
+
+end Structural;
@@ -5,7 +5,8 @@ use ieee.numeric_std.all;
 
 -- This module provides a high-level interface to the Ethernet port.
 -- On the transmit side, it compresses and encapsulates the VGA frame data.
--- on the receive side, it writes data to the memory.
+-- On the receive side, it loads data into the memory, see loader.vhd.
+-- Replies from the receive side are sent in between the VGA frames.
 
 entity ethernet is
    generic (
@@ -14,7 +15,8 @@ entity ethernet is
       G_DUT_PORT  : std_logic_vector(15 downto 0);
       G_HOST_MAC  : std_logic_vector(47 downto 0);
       G_HOST_IP   : std_logic_vector(31 downto 0);
-      G_HOST_PORT : std_logic_vector(15 downto 0)
+      G_HOST_PORT : std_logic_vector(15 downto 0);
+      G_LOAD_PORT : std_logic_vector(15 downto 0)
    );
    port (
       eth_clk_i           : in  std_logic;
@@ -45,9 +47,11 @@ entity ethernet is
       -- Output to CPU
       cpu_clk_i           : in    std_logic;
       cpu_rst_i           : in    std_logic;
-      cpu_wr_addr_o       : out   std_logic_vector(15 downto 0);
+      cpu_wr_addr_o       : out   std_logic_vector(15 downto 0);   -- Also used for reads
       cpu_wr_en_o         : out   std_logic;
       cpu_wr_data_o       : out   std_logic_vector(7 downto 0);
+      cpu_rd_en_o         : out   std_logic;
+      cpu_rd_data_i       : in    std_logic_vector(7 downto 0);
       cpu_reset_o         : out   std_logic;
 
       -- Debug output
@@ -71,6 +75,18 @@ architecture Structural of ethernet is
    signal eth_tx_empty      : std_logic;
    signal eth_tx_rden       : std_logic;
    --
+   signal eth_vga_data      : std_logic_vector(7 downto 0);
+   signal eth_vga_sof       : std_logic;
+   signal eth_vga_eof       : std_logic;
+   signal eth_vga_empty     : std_logic;
+   signal eth_vga_rden      : std_logic;
+   --
+   signal eth_reply_data    : std_logic_vector(7 downto 0);
+   signal eth_reply_sof     : std_logic;
+   signal eth_reply_eof     : std_logic;
+   signal eth_reply_empty   : std_logic;
+   signal eth_reply_rden    : std_logic;
+   --
    signal eth_rx_data       : std_logic_vector(7 downto 0);
    signal eth_rx_sof        : std_logic;
    signal eth_rx_eof        : std_logic;
@@ -195,23 +211,53 @@ begin
 
          eth_clk_i      => eth_clk_i,
          eth_rst_i      => eth_rst_i,
-         eth_data_o     => eth_tx_data,
-         eth_sof_o      => eth_tx_sof,
-         eth_eof_o      => eth_tx_eof,
-         eth_empty_o    => eth_tx_empty,
-         eth_rden_i     => eth_tx_rden
+         eth_data_o     => eth_vga_data,
+         eth_sof_o      => eth_vga_sof,
+         eth_eof_o      => eth_vga_eof,
+         eth_empty_o    => eth_vga_empty,
+         eth_rden_i     => eth_vga_rden
       );
 
 
+   -----------------------------------
+   -- Share the transmitter
+   -----------------------------------
+
+   -- Replies take priority over the VGA frames.
+   inst_tx_mux : entity work.tx_mux
+   port map (
+      clk_i       => eth_clk_i,
+      rst_i       => eth_rst_i,
+      in0_data_i  => eth_reply_data,
+      in0_sof_i   => eth_reply_sof,
+      in0_eof_i   => eth_reply_eof,
+      in0_empty_i => eth_reply_empty,
+      in0_rden_o  => eth_reply_rden,
+      in1_data_i  => eth_vga_data,
+      in1_sof_i   => eth_vga_sof,
+      in1_eof_i   => eth_vga_eof,
+      in1_empty_i => eth_vga_empty,
+      in1_rden_o  => eth_vga_rden,
+      out_data_o  => eth_tx_data,
+      out_sof_o   => eth_tx_sof,
+      out_eof_o   => eth_tx_eof,
+      out_empty_o => eth_tx_empty,
+      out_rden_i  => eth_tx_rden
+   );
+
+
    -----------------------------------
    -- Ethernet receive
    -----------------------------------
    
    inst_receive : entity work.receive
    generic map (
-      G_DUT_MAC  => G_DUT_MAC,
-      G_DUT_IP   => G_DUT_IP,
-      G_DUT_PORT => G_DUT_PORT
+      G_DUT_MAC   => G_DUT_MAC,
+      G_DUT_IP    => G_DUT_IP,
+      G_DUT_PORT  => G_DUT_PORT,
+      G_HOST_MAC  => G_HOST_MAC,
+      G_HOST_IP   => G_HOST_IP,
+      G_LOAD_PORT => G_LOAD_PORT
    )
    port map (
       eth_clk_i       => eth_clk_i,
@@ -222,11 +268,18 @@ begin
       eth_err_i       => eth_rx_err,
       eth_data_i      => eth_rx_data,
       eth_crc_valid_i => eth_rx_crc_valid,
+      eth_tx_data_o   => eth_reply_data,
+      eth_tx_sof_o    => eth_reply_sof,
+      eth_tx_eof_o    => eth_reply_eof,
+      eth_tx_empty_o  => eth_reply_empty,
+      eth_tx_rden_i   => eth_reply_rden,
       pl_clk_i        => cpu_clk_i,  
       pl_rst_i        => cpu_rst_i, 
       pl_wr_addr_o    => cpu_wr_addr_o,
       pl_wr_en_o      => cpu_wr_en_o,
       pl_wr_data_o    => cpu_wr_data_o,
+      pl_rd_en_o      => cpu_rd_en_o,
+      pl_rd_data_i    => cpu_rd_data_i,
       pl_reset_o      => cpu_reset_o,
       pl_drop_mac_o   => cpu_drop_mac,
       pl_drop_ip_o    => cpu_drop_ip,
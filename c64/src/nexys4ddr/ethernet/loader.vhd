@@ -0,0 +1,334 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.std_logic_unsigned.all;
+
+-- This module receives program images from the host, see load.cpp.
+-- It takes the UDP payload from decap, and writes to the CPU memory.
+--
+-- Each packet starts with a command byte, and ends with a CRC-16 (CCITT,
+-- initial value 0xFFFF) over all the preceding bytes. The CRC is appended
+-- most significant byte first, so the CRC of the entire packet is zero.
+-- All other fields are little-endian.
+--
+-- 0x01 START  : flags(1). Clears the window. Bit 0 of flags holds the CPU in reset.
+-- 0x02 DATA   : seq(2), addr(2), data(1-1024). Writes the data to memory.
+-- 0x03 VERIFY : addr(2), len(2). Calculates the CRC-16 of the memory.
+--               A length of zero means 64K. The CPU should be held in reset.
+-- 0x04 RUN    : flags(1). Bit 0 of flags holds the CPU in reset.
+--
+-- The host may send up to 32 DATA packets ahead of the oldest
+-- unacknowledged packet. DATA packets are written to memory as soon as they
+-- are received, even out of order, because each packet contains its own
+-- address. Duplicates, packets outside the window, and packets with a wrong
+-- CRC are not written.
+--
+-- Every packet is answered with a reply (18 bytes, so the Ethernet frame
+-- has the minimum size):
+-- Byte  0    : 0x80 + command (0x80 when the CRC was wrong).
+-- Bytes 1-2  : base. The sequence number of the oldest missing DATA packet.
+-- Bytes 3-6  : bitmap. Bit i is set, when DATA packet base+i is received.
+-- Byte  7    : Number of packets with wrong CRC since START (saturating).
+-- Bytes 8-9  : CRC-16 calculated by the last VERIFY.
+-- Bytes 10-17: Zero.
+-- This allows the host to retransmit only the missing packets.
+--
+-- While a packet is processed, rx_afull_o is asserted to stop decap.
+
+entity loader is
+   port (
+      clk_i         : in  std_logic;
+      rst_i         : in  std_logic;
+
+      -- Payload from decap
+      rx_ena_i      : in  std_logic;
+      rx_sof_i      : in  std_logic;
+      rx_eof_i      : in  std_logic;
+      rx_data_i     : in  std_logic_vector(7 downto 0);
+      rx_afull_o    : out std_logic;
+
+      -- Reply to encap
+      tx_ena_o      : out std_logic;
+      tx_sof_o      : out std_logic;
+      tx_eof_o      : out std_logic;
+      tx_data_o     : out std_logic_vector(7 downto 0);
+
+      -- Memory interface
+      mem_addr_o    : out std_logic_vector(15 downto 0);
+      mem_wr_en_o   : out std_logic;
+      mem_wr_data_o : out std_logic_vector(7 downto 0);
+      mem_rd_en_o   : out std_logic;
+      mem_rd_data_i : in  std_logic_vector(7 downto 0);   -- Valid two clock cycles after address
+      mem_reset_o   : out std_logic
+   );
+end loader;
+
+architecture Structural of loader is
+
+   constant C_CMD_START  : std_logic_vector(7 downto 0) := X"01";
+   constant C_CMD_DATA   : std_logic_vector(7 downto 0) := X"02";
+   constant C_CMD_VERIFY : std_logic_vector(7 downto 0) := X"03";
+   constant C_CMD_RUN    : std_logic_vector(7 downto 0) := X"04";
+
+   constant C_WINDOW     : integer := 32;
+   constant C_MAX_LEN    : integer := 5+1024+2;  -- Largest DATA packet
+
+   -- Calculate CRC-16 (CCITT), one byte at a time.
+   function crc16(crc  : std_logic_vector(15 downto 0);
+                  data : std_logic_vector(7 downto 0)) return std_logic_vector is
+      variable res : std_logic_vector(15 downto 0);
+   begin
+      res := crc;
+      for i in 7 downto 0 loop
+         if (res(15) xor data(i)) = '1' then
+            res := (res(14 downto 0) & '0') xor X"1021";
+         else
+            res := res(14 downto 0) & '0';
+         end if;
+      end loop;
+      return res;
+   end function crc16;
+
+   -- Packet buffer. The DATA is only written to memory after the CRC is checked.
+   type t_buf is array (0 to 2047) of std_logic_vector(7 downto 0);
+   signal buf         : t_buf;
+   signal buf_wr_addr : std_logic_vector(10 downto 0);
+   signal buf_rd_addr : std_logic_vector(10 downto 0);
+   signal buf_rd_data : std_logic_vector(7 downto 0);
+
+   type t_fsm_state is (IDLE_ST, CHECK_ST, COPY_ST, ADVANCE_ST, VERIFY_ST, REPLY_ST, SEND_ST);
+   signal fsm_state : t_fsm_state := IDLE_ST;
+
+   -- Received packet
+   signal rx_len    : std_logic_vector(11 downto 0);
+   signal rx_crc    : std_logic_vector(15 downto 0);
+   signal rx_cmd    : std_logic_vector(7 downto 0);
+   signal rx_arg1   : std_logic_vector(15 downto 0);
+   signal rx_arg2   : std_logic_vector(15 downto 0);
+
+   -- Window
+   signal base      : std_logic_vector(15 downto 0) := (others => '0');
+   signal bitmap    : std_logic_vector(C_WINDOW-1 downto 0) := (others => '0');
+   signal crc_err   : std_logic_vector(7 downto 0) := (others => '0');
+
+   -- Copy to memory
+   signal copy_last : std_logic_vector(10 downto 0);
+   signal copy_d    : std_logic := '0';
+   signal copy_addr : std_logic_vector(15 downto 0);
+
+   -- Verify
+   signal ver_cnt   : std_logic_vector(16 downto 0);
+   signal ver_wait  : std_logic;
+   signal ver_crc   : std_logic_vector(15 downto 0) := (others => '0');
+
+   -- Reply
+   signal reply     : std_logic_vector(18*8-1 downto 0);
+   signal reply_cmd : std_logic_vector(7 downto 0);
+   signal reply_cnt : integer range 0 to 18;
+
+   signal mem_addr    : std_logic_vector(15 downto 0);
+   signal mem_wr_en   : std_logic := '0';
+   signal mem_wr_data : std_logic_vector(7 downto 0);
+   signal mem_rd_en   : std_logic := '0';
+   signal mem_reset   : std_logic := '0';
+
+   signal tx_ena    : std_logic := '0';
+   signal tx_sof    : std_logic := '0';
+   signal tx_eof    : std_logic := '0';
+   signal tx_data   : std_logic_vector(7 downto 0);
+
+begin
+
+   -- Store the incoming packet.
+   buf_wr_addr <= (others => '0') when rx_sof_i = '1' else rx_len(10 downto 0);
+
+   proc_buf : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if rx_ena_i = '1' and fsm_state = IDLE_ST then
+            buf(conv_integer(buf_wr_addr)) <= rx_data_i;
+         end if;
+         buf_rd_data <= buf(conv_integer(buf_rd_addr));
+      end if;
+   end process proc_buf;
+
+
+   -- Main state machine
+   proc_fsm : process (clk_i)
+      variable crc_v    : std_logic_vector(15 downto 0);
+      variable offset_v : std_logic_vector(15 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         tx_ena    <= '0';
+         tx_sof    <= '0';
+         tx_eof    <= '0';
+         mem_wr_en <= '0';
+         copy_d    <= '0';
+
+         -- Write pipeline. The data is read from the buffer one clock cycle earlier.
+         if copy_d = '1' then
+            mem_addr    <= copy_addr;
+            mem_wr_en   <= '1';
+            mem_wr_data <= buf_rd_data;
+            copy_addr   <= copy_addr + 1;
+         end if;
+
+         case fsm_state is
+            when IDLE_ST =>
+               if rx_ena_i = '1' then
+                  if rx_sof_i = '1' then
+                     crc_v  := crc16(X"FFFF", rx_data_i);
+                     rx_len <= X"001";
+                     rx_cmd <= rx_data_i;
+                  else
+                     crc_v  := crc16(rx_crc, rx_data_i);
+                     if rx_len /= X"FFF" then
+                        rx_len <= rx_len + 1;
+                     end if;
+                     case conv_integer(rx_len) is
+                        when 1      => rx_arg1( 7 downto 0) <= rx_data_i;
+                        when 2      => rx_arg1(15 downto 8) <= rx_data_i;
+                        when 3      => rx_arg2( 7 downto 0) <= rx_data_i;
+                        when 4      => rx_arg2(15 downto 8) <= rx_data_i;
+                        when others => null;
+                     end case;
+                  end if;
+                  rx_crc <= crc_v;
+
+                  if rx_eof_i = '1' then
+                     fsm_state <= CHECK_ST;
+                  end if;
+               end if;
+
+            when CHECK_ST =>
+               reply_cmd <= rx_cmd;
+               fsm_state <= REPLY_ST;
+
+               if rx_crc /= 0 or rx_len < 3 then
+                  reply_cmd <= X"00";
+                  if crc_err /= X"FF" then
+                     crc_err <= crc_err + 1;
+                  end if;
+               else
+                  case rx_cmd is
+                     when C_CMD_START =>
+                        base      <= (others => '0');
+                        bitmap    <= (others => '0');
+                        crc_err   <= (others => '0');
+                        mem_reset <= rx_arg1(0);
+
+                     when C_CMD_DATA =>
+                        offset_v := rx_arg1 - base;
+                        if rx_len >= 8 and rx_len <= C_MAX_LEN and
+                           offset_v < C_WINDOW and
+                           bitmap(conv_integer(offset_v(4 downto 0))) = '0' then
+
+                           bitmap(conv_integer(offset_v(4 downto 0))) <= '1';
+                           copy_addr   <= rx_arg2;
+                           buf_rd_addr <= conv_std_logic_vector(5, 11);
+                           copy_last   <= rx_len(10 downto 0) - 3;
+                           fsm_state   <= COPY_ST;
+                        end if;
+
+                     when C_CMD_VERIFY =>
+                        mem_addr  <= rx_arg1;
+                        mem_rd_en <= '1';
+                        ver_cnt   <= '0' & rx_arg2;
+                        if rx_arg2 = 0 then
+                           ver_cnt <= '1' & X"0000";
+                        end if;
+                        ver_crc   <= X"FFFF";
+                        ver_wait  <= '1';
+                        fsm_state <= VERIFY_ST;
+
+                     when C_CMD_RUN =>
+                        mem_reset <= rx_arg1(0);
+
+                     when others =>
+                        fsm_state <= IDLE_ST;   -- Unknown command is ignored.
+                  end case;
+               end if;
+
+            when COPY_ST =>
+               copy_d      <= '1';
+               buf_rd_addr <= buf_rd_addr + 1;
+               if buf_rd_addr = copy_last then
+                  fsm_state <= ADVANCE_ST;
+               end if;
+
+            when ADVANCE_ST =>
+               -- Move the window past all received packets.
+               if bitmap(0) = '1' then
+                  bitmap <= '0' & bitmap(C_WINDOW-1 downto 1);
+                  base   <= base + 1;
+               elsif copy_d = '0' and mem_wr_en = '0' then
+                  fsm_state <= REPLY_ST;
+               end if;
+
+            when VERIFY_ST =>
+               -- Each byte takes two clock cycles, to allow for memory wait states.
+               ver_wait <= not ver_wait;
+               if ver_wait = '0' then
+                  ver_crc  <= crc16(ver_crc, mem_rd_data_i);
+                  mem_addr <= mem_addr + 1;
+                  ver_cnt  <= ver_cnt - 1;
+                  if ver_cnt = 1 then
+                     mem_rd_en <= '0';
+                     fsm_state <= REPLY_ST;
+                  end if;
+               end if;
+
+            when REPLY_ST =>
+               reply <= (X"80" or reply_cmd) &
+                        base(7 downto 0) & base(15 downto 8) &
+                        bitmap(7 downto 0) & bitmap(15 downto 8) &
+                        bitmap(23 downto 16) & bitmap(31 downto 24) &
+                        crc_err &
+                        ver_crc(7 downto 0) & ver_crc(15 downto 8) &
+                        X"0000000000000000";
+               reply_cnt <= 18;
+               fsm_state <= SEND_ST;
+
+            when SEND_ST =>
+               tx_ena    <= '1';
+               tx_data   <= reply(18*8-1 downto 17*8);
+               reply     <= reply(17*8-1 downto 0) & X"00";
+               reply_cnt <= reply_cnt - 1;
+               if reply_cnt = 18 then
+                  tx_sof <= '1';
+               end if;
+               if reply_cnt = 1 then
+                  tx_eof    <= '1';
+                  fsm_state <= IDLE_ST;
+               end if;
+
+         end case;
+
+         if rst_i = '1' then
+            fsm_state <= IDLE_ST;
+            base      <= (others => '0');
+            bitmap    <= (others => '0');
+            crc_err   <= (others => '0');
+            mem_wr_en <= '0';
+            mem_rd_en <= '0';
+            mem_reset <= '0';
+            copy_d    <= '0';
+            tx_ena    <= '0';
+         end if;
+      end if;
+   end process proc_fsm;
+
+   -- Stop decap while the packet is processed.
+   rx_afull_o <= '0' when fsm_state = IDLE_ST else '1';
+
+   -- Drive output signals
+   tx_ena_o      <= tx_ena;
+   tx_sof_o      <= tx_sof;
+   tx_eof_o      <= tx_eof;
+   tx_data_o     <= tx_data;
+   mem_addr_o    <= mem_addr;
+   mem_wr_en_o   <= mem_wr_en;
+   mem_wr_data_o <= mem_wr_data;
+   mem_rd_en_o   <= mem_rd_en;
+   mem_reset_o   <= mem_reset;
+
+end Structural;
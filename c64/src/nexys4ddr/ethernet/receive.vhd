@@ -3,23 +3,24 @@ use ieee.std_logic_1164.all;
 use ieee.std_logic_unsigned.all;
 use ieee.numeric_std.all;
 
--- This module strips the incoming frame of the MAC CRC (the last four bytes)
--- and forwards the CRC valid bit from EOF to SOF.
--- This module therefore operates in a store-and-forward mode,
--- where the entire frame is stored in the FIFO, until the last byte is received.
--- Only valid frames are forwarded. In other words, errored frames are discarded.
--- Frames are stored in a special-purpose FIFO, where the write pointer of
--- the SOF is recorded. If the frame is to be discarded, the write pointer is reset
--- to the start of the errored frame.
--- For simplicity, everything is in the same clock domain.
-
--- There is no flow control.
+-- This module handles all received frames:
+-- * ARP requests for our IP address are answered, see arp.vhd.
+-- * UDP packets to our port are passed to the program loader, see loader.vhd.
+--   The loader writes to (and reads from) the CPU memory, and its replies are
+--   sent to the host.
+-- The CRC of the incoming frame is checked and stripped first, see strip_crc.vhd.
+-- Errored frames are discarded.
+--
+-- The replies are presented on the same pulling interface as encap.
 
 entity receive is
    generic (
-      G_DUT_MAC  : std_logic_vector(47 downto 0);
-      G_DUT_IP   : std_logic_vector(31 downto 0);
-      G_DUT_PORT : std_logic_vector(15 downto 0)
+      G_DUT_MAC   : std_logic_vector(47 downto 0);
+      G_DUT_IP    : std_logic_vector(31 downto 0);
+      G_DUT_PORT  : std_logic_vector(15 downto 0);
+      G_HOST_MAC  : std_logic_vector(47 downto 0);
+      G_HOST_IP   : std_logic_vector(31 downto 0);
+      G_LOAD_PORT : std_logic_vector(15 downto 0)
    );
    port (
       -- Input interface
@@ -32,12 +33,21 @@ entity receive is
       eth_data_i      : in  std_logic_vector(7 downto 0);
       eth_crc_valid_i : in  std_logic;    -- Only valid @ EOF
 
+      -- Reply interface @ eth_clk_i
+      eth_tx_data_o   : out std_logic_vector(7 downto 0);
+      eth_tx_sof_o    : out std_logic;
+      eth_tx_eof_o    : out std_logic;
+      eth_tx_empty_o  : out std_logic;
+      eth_tx_rden_i   : in  std_logic;
+
       -- Output interface
       pl_clk_i       : in  std_logic;
       pl_rst_i       : in  std_logic;
-      pl_wr_addr_o   : out std_logic_vector(15 downto 0);
+      pl_wr_addr_o   : out std_logic_vector(15 downto 0);   -- Also used for reads
       pl_wr_en_o     : out std_logic;
       pl_wr_data_o   : out std_logic_vector(7 downto 0);
+      pl_rd_en_o     : out std_logic;
+      pl_rd_data_i   : in  std_logic_vector(7 downto 0);
       pl_reset_o     : out std_logic;
       pl_drop_mac_o  : out std_logic;
       pl_drop_ip_o   : out std_logic;
@@ -57,12 +67,25 @@ architecture Structural of receive is
    signal pl_eof  : std_logic;
    signal pl_data : std_logic_vector(7 downto 0);
 
-   signal pl_cnt       : std_logic_vector(1 downto 0);
-   signal pl_reset     : std_logic_vector(7 downto 0);
-   signal pl_wr_addr   : std_logic_vector(15 downto 0);
-   signal pl_wr_addr_d : std_logic_vector(15 downto 0);
-   signal pl_wr_en     : std_logic;
-   signal pl_wr_data   : std_logic_vector(7 downto 0);
+   signal pl_afull : std_logic;
+
+   -- Replies from the loader
+   signal pl_tx_ena  : std_logic;
+   signal pl_tx_sof  : std_logic;
+   signal pl_tx_eof  : std_logic;
+   signal pl_tx_data : std_logic_vector(7 downto 0);
+
+   signal eth_load_data  : std_logic_vector(7 downto 0);
+   signal eth_load_sof   : std_logic;
+   signal eth_load_eof   : std_logic;
+   signal eth_load_empty : std_logic;
+   signal eth_load_rden  : std_logic;
+
+   signal eth_arp_data   : std_logic_vector(7 downto 0);
+   signal eth_arp_sof    : std_logic;
+   signal eth_arp_eof    : std_logic;
+   signal eth_arp_empty  : std_logic;
+   signal eth_arp_rden   : std_logic;
 
    signal pl_drop_mac : std_logic;
    signal pl_drop_ip  : std_logic;
@@ -105,7 +128,7 @@ begin
       -- Payload interface @ pl_clk_i
       pl_clk_i        => pl_clk_i,  
       pl_rst_i        => pl_rst_i, 
-      pl_afull_i      => '0',
+      pl_afull_i      => pl_afull,
       pl_ena_o        => pl_ena,
       pl_sof_o        => pl_sof,
       pl_eof_o        => pl_eof,
@@ -116,61 +139,97 @@ begin
    );
 
 
-   -- Convert packet to memory accesses.
-   -- First two bytes are address (in little-endian format)
-   process (pl_clk_i)
-   begin
-      if rising_edge(pl_clk_i) then
-         pl_wr_en <= '0';
-
-         if pl_ena = '1' then
-            case pl_cnt is
-               when "00" => 
-                  if pl_sof = '1' then
-                     pl_wr_addr( 7 downto 0) <= pl_data;
-                     pl_cnt <= "01";
-                  end if;
-
-               when "01" => 
-                  pl_wr_addr(15 downto 8) <= pl_data;
-                  pl_cnt <= "10";
-
-               when "10" => 
-                  pl_reset <= pl_data;
-                  pl_cnt <= "11";
-
-               when "11" => 
-                  pl_wr_en     <= '1';
-                  pl_wr_data   <= pl_data;
-                  pl_wr_addr   <= pl_wr_addr + 1;
-                  pl_wr_addr_d <= pl_wr_addr;
-
-                  if pl_eof = '1' then
-                     pl_reset(0) <= pl_reset(1);
-                     pl_cnt <= "00";
-                  end if;
-
-               when others =>
-                  null;
-            end case;
-         end if;
-
-         if pl_rst_i = '1' then
-            pl_reset <= (others => '0');
-            pl_cnt <= "00";
-         end if;
-      end if;
-   end process;
+   inst_loader : entity work.loader
+   port map (
+      clk_i         => pl_clk_i,
+      rst_i         => pl_rst_i,
+      rx_ena_i      => pl_ena,
+      rx_sof_i      => pl_sof,
+      rx_eof_i      => pl_eof,
+      rx_data_i     => pl_data,
+      rx_afull_o    => pl_afull,
+      tx_ena_o      => pl_tx_ena,
+      tx_sof_o      => pl_tx_sof,
+      tx_eof_o      => pl_tx_eof,
+      tx_data_o     => pl_tx_data,
+      mem_addr_o    => pl_wr_addr_o,
+      mem_wr_en_o   => pl_wr_en_o,
+      mem_wr_data_o => pl_wr_data_o,
+      mem_rd_en_o   => pl_rd_en_o,
+      mem_rd_data_i => pl_rd_data_i,
+      mem_reset_o   => pl_reset_o
+   );
+
+
+   inst_encap : entity work.encap
+   port map (
+      pl_clk_i       => pl_clk_i,
+      pl_rst_i       => pl_rst_i,
+      pl_ena_i       => pl_tx_ena,
+      pl_sof_i       => pl_tx_sof,
+      pl_eof_i       => pl_tx_eof,
+      pl_data_i      => pl_tx_data,
+      pl_error_o     => open,
+      ctrl_mac_dst_i => G_HOST_MAC,
+      ctrl_mac_src_i => G_DUT_MAC,
+      ctrl_ip_dst_i  => G_HOST_IP,
+      ctrl_ip_src_i  => G_DUT_IP,
+      ctrl_udp_dst_i => G_LOAD_PORT,
+      ctrl_udp_src_i => G_DUT_PORT,
+      mac_clk_i      => eth_clk_i,
+      mac_rst_i      => eth_rst_i,
+      mac_data_o     => eth_load_data,
+      mac_sof_o      => eth_load_sof,
+      mac_eof_o      => eth_load_eof,
+      mac_empty_o    => eth_load_empty,
+      mac_rden_i     => eth_load_rden
+   );
+
+
+   inst_arp : entity work.arp
+   port map (
+      clk_i      => eth_clk_i,
+      rst_i      => eth_rst_i,
+      ctrl_mac_i => G_DUT_MAC,
+      ctrl_ip_i  => G_DUT_IP,
+      rx_ena_i   => eth_rx_ena,
+      rx_sof_i   => eth_rx_sof,
+      rx_eof_i   => eth_rx_eof,
+      rx_data_i  => eth_rx_data,
+      tx_data_o  => eth_arp_data,
+      tx_sof_o   => eth_arp_sof,
+      tx_eof_o   => eth_arp_eof,
+      tx_empty_o => eth_arp_empty,
+      tx_rden_i  => eth_arp_rden
+   );
+
+
+   -- ARP replies take priority over loader replies.
+   inst_tx_mux : entity work.tx_mux
+   port map (
+      clk_i       => eth_clk_i,
+      rst_i       => eth_rst_i,
+      in0_data_i  => eth_arp_data,
+      in0_sof_i   => eth_arp_sof,
+      in0_eof_i   => eth_arp_eof,
+      in0_empty_i => eth_arp_empty,
+      in0_rden_o  => eth_arp_rden,
+      in1_data_i  => eth_load_data,
+      in1_sof_i   => eth_load_sof,
+      in1_eof_i   => eth_load_eof,
+      in1_empty_i => eth_load_empty,
+      in1_rden_o  => eth_load_rden,
+      out_data_o  => eth_tx_data_o,
+      out_sof_o   => eth_tx_sof_o,
+      out_eof_o   => eth_tx_eof_o,
+      out_empty_o => eth_tx_empty_o,
+      out_rden_i  => eth_tx_rden_i
+   );
 
 
    -- Drive output signals
-   pl_wr_addr_o  <= pl_wr_addr_d;
-   pl_wr_en_o    <= pl_wr_en;
-   pl_wr_data_o  <= pl_wr_data;
-   pl_reset_o    <= pl_reset(0);
    pl_drop_mac_o <= pl_drop_mac;
    pl_drop_ip_o  <= pl_drop_ip;
    pl_drop_udp_o <= pl_drop_udp;
 
 end Structural;
-
@@ -0,0 +1,85 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.std_logic_unsigned.all;
+
+-- This module lets two sources share the transmitter. Both the inputs and
+-- the output use the pulling interface of encap and eth_tx.
+--
+-- A source is only selected between frames, and the selected source keeps
+-- the transmitter until it has delivered the last byte of the frame.
+-- Input 0 has priority over input 1.
+--
+-- Like encap, this module operates on the falling clock edge.
+
+entity tx_mux is
+   port (
+      clk_i        : in  std_logic;
+      rst_i        : in  std_logic;
+
+      in0_data_i   : in  std_logic_vector(7 downto 0);
+      in0_sof_i    : in  std_logic;
+      in0_eof_i    : in  std_logic;
+      in0_empty_i  : in  std_logic;
+      in0_rden_o   : out std_logic;
+
+      in1_data_i   : in  std_logic_vector(7 downto 0);
+      in1_sof_i    : in  std_logic;
+      in1_eof_i    : in  std_logic;
+      in1_empty_i  : in  std_logic;
+      in1_rden_o   : out std_logic;
+
+      out_data_o   : out std_logic_vector(7 downto 0);
+      out_sof_o    : out std_logic;
+      out_eof_o    : out std_logic;
+      out_empty_o  : out std_logic;
+      out_rden_i   : in  std_logic
+   );
+end tx_mux;
+
+architecture Structural of tx_mux is
+
+   type t_sel is (IDLE_ST, IN0_ST, IN1_ST);
+   signal sel : t_sel := IDLE_ST;
+
+begin
+
+   proc_sel : process (clk_i)
+   begin
+      if falling_edge(clk_i) then
+         case sel is
+            when IDLE_ST =>
+               if in0_empty_i = '0' then
+                  sel <= IN0_ST;
+               elsif in1_empty_i = '0' then
+                  sel <= IN1_ST;
+               end if;
+
+            when IN0_ST =>
+               if out_rden_i = '1' and in0_eof_i = '1' then
+                  sel <= IDLE_ST;
+               end if;
+
+            when IN1_ST =>
+               if out_rden_i = '1' and in1_eof_i = '1' then
+                  sel <= IDLE_ST;
+               end if;
+         end case;
+
+         if rst_i = '1' then
+            sel <= IDLE_ST;
+         end if;
+      end if;
+   end process proc_sel;
+
+   -- Drive output signals
+   out_data_o  <= in0_data_i  when sel = IN0_ST else in1_data_i;
+   out_sof_o   <= in0_sof_i   when sel = IN0_ST else in1_sof_i;
+   out_eof_o   <= in0_eof_i   when sel = IN0_ST else in1_eof_i;
+   out_empty_o <= in0_empty_i when sel = IN0_ST else
+                  in1_empty_i when sel = IN1_ST else
+                  '1';
+
+   in0_rden_o <= out_rden_i when sel = IN0_ST else '0';
+   in1_rden_o <= out_rden_i when sel = IN1_ST else '0';
+
+end Structural;
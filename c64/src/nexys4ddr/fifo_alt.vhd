@@ -7,7 +7,7 @@ use UNISIM.Vcomponents.all;
 
 -- This module is a wrapper for the Xilinx-specific FIFO.
 -- The error signals are latches, i.e. are only cleared on reset.
--- G_WIDTH must be a power of 2.
+-- G_WIDTH must be a power of 2, and at most 64.
 
 entity fifo is
    generic (
@@ -42,6 +42,16 @@ architecture behavioral of fifo is
    signal rderr_l  : std_logic;
    signal wrerr_l  : std_logic;
 
+   -- The 72-bit data width is only available in the FIFO36_72 mode.
+   function fifo_mode(width : natural) return string is
+   begin
+      if width > 32 then
+         return "FIFO36_72";
+      else
+         return "FIFO36";
+      end if;
+   end function fifo_mode;
+
 begin  -- architecture behavioral
 
    -- Global asynchronous reset. Common for read and write port.
@@ -56,6 +66,7 @@ begin  -- architecture behavioral
       GENERIC MAP (
          FIRST_WORD_FALL_THROUGH => true,
          DATA_WIDTH              => (G_WIDTH*9)/8,
+         FIFO_MODE               => fifo_mode(G_WIDTH),
          EN_SYN                  => false)
       PORT MAP (
          DI            => fifo_in,
@@ -18,7 +18,8 @@ entity nexys4ddr is
       G_DUT_PORT   : std_logic_vector(15 downto 0) := X"2345";          -- Port 9029
       G_HOST_MAC   : std_logic_vector(47 downto 0) := X"F46D04D7F3CA";
       G_HOST_IP    : std_logic_vector(31 downto 0) := X"C0A8012B";      -- 192.168.1.43
-      G_HOST_PORT  : std_logic_vector(15 downto 0) := X"1234"           -- Port 4660
+      G_HOST_PORT  : std_logic_vector(15 downto 0) := X"1234";          -- Port 4660
+      G_LOAD_PORT  : std_logic_vector(15 downto 0) := X"1235"           -- Port 4661
    );
    port (
       -- Clock. Connected to an external 100 MHz crystal.
@@ -103,6 +104,8 @@ architecture Structural of nexys4ddr is
    signal cpu_wr_addr  : std_logic_vector(15 downto 0);
    signal cpu_wr_en    : std_logic;
    signal cpu_wr_data  : std_logic_vector(7 downto 0);
+   signal cpu_rd_en    : std_logic;
+   signal cpu_rd_data  : std_logic_vector(7 downto 0);
    signal cpu_reset    : std_logic;
    signal cpu_hack_rst : std_logic;
 
@@ -143,7 +146,8 @@ begin
       G_DUT_PORT  => G_DUT_PORT,
       G_HOST_MAC  => G_HOST_MAC,
       G_HOST_IP   => G_HOST_IP,
-      G_HOST_PORT => G_HOST_PORT
+      G_HOST_PORT => G_HOST_PORT,
+      G_LOAD_PORT => G_LOAD_PORT
    )
    port map (
       eth_clk_i           => eth_clk,
@@ -171,6 +175,8 @@ begin
       cpu_wr_addr_o       => cpu_wr_addr,
       cpu_wr_en_o         => cpu_wr_en,
       cpu_wr_data_o       => cpu_wr_data,
+      cpu_rd_en_o         => cpu_rd_en,
+      cpu_rd_data_i       => cpu_rd_data,
       cpu_reset_o         => cpu_reset,
       eth_smi_registers_o => eth_smi_registers,
       eth_stat_debug_o    => eth_stat_debug
@@ -192,12 +198,12 @@ begin
       G_COL_SIZE  => 10,                 -- Number of bits in COL address
       G_FONT_SIZE => 12,                 -- Number of bits in FONT address
       G_MOB_SIZE  => 7,                  -- Number of bits in MOB address
-      G_CONF_SIZE => 5,                  -- Number of bits in CONF address
+      G_CONF_SIZE => 6,                  -- Number of bits in CONF address
       G_RAM_MASK  => X"0000",            -- Last address 0x07FF
       G_DISP_MASK => X"8000",            -- Last address 0x83FF
       G_COL_MASK  => X"8800",            -- Last address 0x8BFF
       G_MOB_MASK  => X"8400",            -- Last address 0x847F
-      G_CONF_MASK => X"8600",            -- Last address 0x861F
+      G_CONF_MASK => X"8600",            -- Last address 0x863F
       G_FONT_MASK => X"9000",            -- Last address 0x9FFF
       G_ROM_MASK  => X"F800",            -- Last address 0xFFFF
       G_ROM_FILE  => "rom.txt",          -- Contains the machine code
@@ -210,6 +216,8 @@ begin
       cpu_wr_addr_i => cpu_wr_addr,
       cpu_wr_en_i   => cpu_wr_en,
       cpu_wr_data_i => cpu_wr_data,
+      cpu_rd_en_i   => cpu_rd_en,
+      cpu_rd_data_o => cpu_rd_data,
       cpu_led_o     => led_o(7 downto 0),
       --
       vga_clk_i     => vga_clk,
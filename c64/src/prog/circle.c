@@ -54,7 +54,7 @@ d(x*y) = x*dy + y*dx = (x^2-y^2)*dt = (x^2/4 - y^2/4)*(4*dt)
 
 #include "memorymap.h"
 #include "zeropage.h"
-#include "umult.h"
+#include "mult.h"
 
 // Entry point after CPU reset
 void __fastcall__ circle_init(void)
@@ -247,9 +247,9 @@ noNegX:
 noIncX:
 
    // Calculate (2X)^2/4
-   __asm__("LDA $0700,X"); // MSB into X
+   __asm__("LDA %w,X", MEM_SQR_HI); // MSB into X
    __asm__("TAX");
-   __asm__("LDA $0600,X"); // LSB into Y
+   __asm__("LDA %w,X", MEM_SQR_LO); // LSB into Y
    //__asm__("TAY");
 
    // Multiply by 4
@@ -295,9 +295,9 @@ noNegY:
 noIncY:
 
    // Calculate (2Y)^2/4
-   __asm__("LDA $0700,X"); // MSB into X
+   __asm__("LDA %w,X", MEM_SQR_HI); // MSB into X
    __asm__("TAX");
-   __asm__("LDA $0600,X"); // LSB into Y
+   __asm__("LDA %w,X", MEM_SQR_LO); // LSB into Y
    //__asm__("TAY");
 
    // Multiply by 4
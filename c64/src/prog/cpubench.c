@@ -0,0 +1,448 @@
+//
+// This measures the number of clock cycles used by each instruction
+// implemented in the CPU, and compares with the NMOS 6502. The instructions
+// are the same as those tested in cputest.c, except BRK, which is the reset.
+// The purpose is to make changes to the micro-code in cpu/ctl.vhd visible.
+//
+// Each instruction is copied eight times into a buffer in RAM, followed by a
+// JMP back to ROM. The buffer is executed between two readings of the clock
+// cycle counter, and the time of an empty buffer is subtracted.
+//
+// All instructions access the same byte in the zero-page, and X and Y are
+// zero, so no page boundary is crossed. The flags are Z=1 and N=C=V=0, so
+// BPL, BVC, BCC, and BEQ are taken, while BMI, BVS, BCS, and BNE are not.
+// Branches, JMP, and JSR go to the next copy. RTS and RTI return to the next
+// copy, using frames prepared on the stack.
+//
+// The results are shown four to a line: The opcode, the cycles used, and the
+// cycles used by the NMOS 6502, followed by '+' if the instruction is slower
+// and '-' if it is faster.
+//
+// In simulation each result is also written to VGA_BENCH_OPCODE,
+// VGA_BENCH_NMOS, and VGA_BENCH_CYCLES, and conf_mem.vhd prints it.
+//
+
+#include "memorymap.h"
+#include "zeropage.h"   // Variables to be stored in the zero-page.
+#include "mem.h"
+
+#define COL_WHITE       0xFFU   // 111_111_11
+#define COL_LIGHT       0x6FU   // 011_011_11
+#define COL_DARK        0x44U   // 010_001_00
+
+#define COPIES          8       // Must match the division in reset()
+#define ENTRY_SIZE      5
+#define RESULT_POS      (MEM_DISP + 2*40)
+#define RESULT_SIZE     10
+#define LEGEND_POS      (MEM_DISP + 17*40)
+
+// Each entry contains the instruction (3 bytes), its size, and the number of
+// cycles on the NMOS 6502. The list ends with a zero opcode.
+static const char tests[] = {
+   0x05, ZP_CPU_DATA,   0x00, 2, 3,    // ORA d
+   0x0A, 0x00,          0x00, 1, 2,    // ASL A
+   0x10, 0x00,          0x00, 2, 3,    // BPL r (taken)
+   0x18, 0x00,          0x00, 1, 2,    // CLC
+   0x20, 0x00,          0x00, 3, 6,    // JSR a
+   0x25, ZP_CPU_DATA,   0x00, 2, 3,    // AND d
+   0x29, 0x00,          0x00, 2, 2,    // AND #
+   0x2A, 0x00,          0x00, 1, 2,    // ROL A
+   0x30, 0x00,          0x00, 2, 2,    // BMI r (not taken)
+   0x38, 0x00,          0x00, 1, 2,    // SEC
+   0x40, 0x00,          0x00, 1, 6,    // RTI
+   0x45, ZP_CPU_DATA,   0x00, 2, 3,    // EOR d
+   0x49, 0x00,          0x00, 2, 2,    // EOR #
+   0x4C, 0x00,          0x00, 3, 3,    // JMP a
+   0x50, 0x00,          0x00, 2, 3,    // BVC r (taken)
+   0x58, 0x00,          0x00, 1, 2,    // CLI
+   0x60, 0x00,          0x00, 1, 6,    // RTS
+   0x65, ZP_CPU_DATA,   0x00, 2, 3,    // ADC d
+   0x69, 0x00,          0x00, 2, 2,    // ADC #
+   0x6A, 0x00,          0x00, 1, 2,    // ROR A
+   0x6D, ZP_CPU_DATA,   0x00, 3, 4,    // ADC a
+   0x70, 0x00,          0x00, 2, 2,    // BVS r (not taken)
+   0x78, 0x00,          0x00, 1, 2,    // SEI
+   0x81, ZP_CPU_PTR_LO, 0x00, 2, 6,    // STA (d,X)
+   0x85, ZP_CPU_DATA,   0x00, 2, 3,    // STA d
+   0x88, 0x00,          0x00, 1, 2,    // DEY
+   0x8A, 0x00,          0x00, 1, 2,    // TXA
+   0x8D, ZP_CPU_DATA,   0x00, 3, 4,    // STA a
+   0x8E, ZP_CPU_DATA,   0x00, 3, 4,    // STX a
+   0x90, 0x00,          0x00, 2, 3,    // BCC r (taken)
+   0x91, ZP_CPU_PTR_LO, 0x00, 2, 6,    // STA (d),Y
+   0x98, 0x00,          0x00, 1, 2,    // TYA
+   0x9A, 0x00,          0x00, 1, 2,    // TXS
+   0x9D, ZP_CPU_DATA,   0x00, 3, 5,    // STA a,X
+   0xA1, ZP_CPU_PTR_LO, 0x00, 2, 6,    // LDA (d,X)
+   0xA2, 0x00,          0x00, 2, 2,    // LDX #
+   0xA5, ZP_CPU_DATA,   0x00, 2, 3,    // LDA d
+   0xA8, 0x00,          0x00, 1, 2,    // TAY
+   0xA9, 0x00,          0x00, 2, 2,    // LDA #
+   0xAA, 0x00,          0x00, 1, 2,    // TAX
+   0xAD, ZP_CPU_DATA,   0x00, 3, 4,    // LDA a
+   0xB0, 0x00,          0x00, 2, 2,    // BCS r (not taken)
+   0xB1, ZP_CPU_PTR_LO, 0x00, 2, 5,    // LDA (d),Y
+   0xBA, 0x00,          0x00, 1, 2,    // TSX
+   0xBD, ZP_CPU_DATA,   0x00, 3, 4,    // LDA a,X
+   0xC5, ZP_CPU_DATA,   0x00, 2, 3,    // CMP d
+   0xC8, 0x00,          0x00, 1, 2,    // INY
+   0xC9, 0x00,          0x00, 2, 2,    // CMP #
+   0xCA, 0x00,          0x00, 1, 2,    // DEX
+   0xCD, ZP_CPU_DATA,   0x00, 3, 4,    // CMP a
+   0xD0, 0x00,          0x00, 2, 2,    // BNE r (not taken)
+   0xD8, 0x00,          0x00, 1, 2,    // CLD
+   0xDD, ZP_CPU_DATA,   0x00, 3, 4,    // CMP a,X
+   0xE5, ZP_CPU_DATA,   0x00, 2, 3,    // SBC d
+   0xE8, 0x00,          0x00, 1, 2,    // INX
+   0xE9, 0x00,          0x00, 2, 2,    // SBC #
+   0xED, ZP_CPU_DATA,   0x00, 3, 4,    // SBC a
+   0xF0, 0x00,          0x00, 2, 3,    // BEQ r (taken)
+   0x00};
+
+static const char strTitle[]  = "Cycles: Opcode, this CPU, NMOS 6502";
+static const char strLegend[] = "+ slower, - faster than the NMOS 6502";
+static const char hex[] = "0123456789ABCDEF";
+
+// Variables
+static char code[COPIES*3+3];    // The instructions being measured
+
+static void __fastcall__ benchStop(void); // Forward declaration
+
+// Copies the title and the legend to the screen.
+static void __fastcall__ printText(void)
+{
+   __asm__("LDA #<%v", strTitle);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strTitle);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #%b", sizeof(strTitle)-1);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA #<%v", strLegend);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strLegend);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", LEGEND_POS);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", LEGEND_POS);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #%b", sizeof(strLegend)-1);
+   __asm__("TAY");
+   memcpy8();
+} // end of printText
+
+// Fills the buffer with A copies of the instruction in the entry pointed to
+// by ZP_SRC, followed by a JMP to benchStop.
+static void __fastcall__ build(void)
+{
+   __asm__("STA %b", ZP_CPU_COUNT);
+   __asm__("LDA #<%v", code);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%v", code);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA %b", ZP_CPU_COUNT);
+   __asm__("BEQ %g", end);
+
+copy:
+   __asm__("LDA #$03");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // Size of the instruction
+   __asm__("TAY");
+   memcpy8();
+
+   // JMP and JSR go to the next copy.
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // Opcode
+   __asm__("CMP #$4C");
+   __asm__("BEQ %g", jump);
+   __asm__("CMP #$20");
+   __asm__("BNE %g", next);
+jump:
+   __asm__("INY");
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$03");
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA (%b),Y", ZP_DST_LO);
+
+next:
+   __asm__("LDA #$03");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // Size of the instruction
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_DST_LO);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("LDA %b", ZP_CPU_COUNT);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_CPU_COUNT);
+   __asm__("BNE %g", copy);
+
+end:
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA #$4C");                // JMP benchStop
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA #<%v", benchStop);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA #>%v", benchStop);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+} // end of build
+
+// Executes the buffer. The buffer ends in benchStop(), which returns the
+// number of clock cycles in A to the caller of this function.
+static void __fastcall__ measure(void)
+{
+   __asm__("TSX");
+   __asm__("TXA");
+   __asm__("STA %b", ZP_CPU_SP);
+
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // Opcode
+   __asm__("CMP #$60");
+   __asm__("BEQ %g", frames);
+   __asm__("CMP #$40");
+   __asm__("BNE %g", start);
+
+   // Place a frame on the stack for each copy of RTS or RTI, starting with
+   // the last copy. RTS returns to the address in the frame plus one, while
+   // RTI returns to the address itself.
+frames:
+   __asm__("LDA #%b", COPIES-1);
+   __asm__("STA %b", ZP_CPU_COUNT);
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("CMP #$60");
+   __asm__("BEQ %g", first);
+   __asm__("LDA #%b", COPIES);
+   __asm__("STA %b", ZP_CPU_COUNT);
+first:
+   __asm__("LDA %b", ZP_CPU_COUNT);
+   __asm__("CLC");
+   __asm__("ADC #<%v", code);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%v", code);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("LDA #%b", COPIES);
+   __asm__("STA %b", ZP_CPU_COUNT);
+push:
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("STA %w,X", 0x0100);
+   __asm__("DEX");
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("STA %w,X", 0x0100);
+   __asm__("DEX");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("CMP #$60");
+   __asm__("BEQ %g", pushed);
+   __asm__("LDA #$04");                // Status register, interrupts disabled
+   __asm__("STA %w,X", 0x0100);
+   __asm__("DEX");
+pushed:
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("SBC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA %b", ZP_CPU_COUNT);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_CPU_COUNT);
+   __asm__("BNE %g", push);
+   __asm__("TXS");
+
+start:
+   __asm__("LDA %w", VGA_ADDR_CYCLES);
+   __asm__("STA %b", ZP_CPU_START);
+   __asm__("LDA #$00");
+   __asm__("TAX");
+   __asm__("TAY");
+   __asm__("CLC");
+   __asm__("ADC #$00");                // Z=1, N=C=V=0
+   __asm__("JMP %v", code);
+} // end of measure
+
+// This is reached by a JMP from the end of the buffer.
+static void __fastcall__ benchStop(void)
+{
+   __asm__("LDA %w", VGA_ADDR_CYCLES);
+   __asm__("SEI");                     // In case CLI was measured
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_CPU_START);
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_CPU_SP);       // Remove what JSR left on the stack
+   __asm__("TAX");
+   __asm__("TXS");
+   __asm__("TYA");
+} // end of benchStop
+
+// Shows A as two hex digits at ZP_SCREEN_POS+Y, and moves Y past them.
+static void __fastcall__ printHex(void)
+{
+   __asm__("STA %b", ZP_CPU_COUNT);
+   __asm__("AND #$F0");
+   __asm__("CLC");
+   __asm__("ROR A");
+   __asm__("ROR A");
+   __asm__("ROR A");
+   __asm__("ROR A");
+   __asm__("TAX");
+   __asm__("LDA %v,X", hex);
+   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO);
+   __asm__("INY");
+   __asm__("LDA %b", ZP_CPU_COUNT);
+   __asm__("AND #$0F");
+   __asm__("TAX");
+   __asm__("LDA %v,X", hex);
+   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO);
+   __asm__("INY");
+} // end of printHex
+
+// Shows the result of the entry pointed to by ZP_SRC at ZP_SCREEN_POS, and
+// moves ZP_SCREEN_POS to the next result.
+static void __fastcall__ printResult(void)
+{
+   __asm__("LDA #$04");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // NMOS 6502 cycles
+   __asm__("STA %b", ZP_TEMP);
+   __asm__("STA %w", VGA_BENCH_NMOS);
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);   // Opcode
+   __asm__("STA %w", VGA_BENCH_OPCODE);
+   printHex();
+   __asm__("LDA %b", ZP_CPU_CYCLES);
+   __asm__("STA %w", VGA_BENCH_CYCLES);
+
+   // The cycles may exceed 15, so they need two digits too.
+   __asm__("INY");
+   printHex();
+   __asm__("INY");
+   __asm__("LDA %b", ZP_TEMP);
+   __asm__("TAX");
+   __asm__("LDA %v,X", hex);
+   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO);
+   __asm__("INY");
+
+   __asm__("LDA %b", ZP_CPU_CYCLES);
+   __asm__("CMP %b", ZP_TEMP);
+   __asm__("BEQ %g", next);
+   __asm__("LDA #%b", '+');
+   __asm__("BCS %g", mark);
+   __asm__("LDA #%b", '-');
+mark:
+   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO);
+
+next:
+   __asm__("LDA %b", ZP_SCREEN_POS_LO);
+   __asm__("CLC");
+   __asm__("ADC #%b", RESULT_SIZE);
+   __asm__("STA %b", ZP_SCREEN_POS_LO);
+   __asm__("LDA %b", ZP_SCREEN_POS_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SCREEN_POS_HI);
+} // end of printResult
+
+// Entry point after CPU reset
+void __fastcall__ reset(void)
+{
+   __asm__("SEI");                           // Disable all interrupts
+   __asm__("CLD");
+   __asm__("LDX #$FF");
+   __asm__("TXS");                           // Reset stack pointer
+
+   // Configure text color
+   __asm__("LDA #%b", COL_LIGHT);
+   __asm__("STA %w",  VGA_ADDR_FGCOL);
+   __asm__("LDA #%b", COL_DARK);
+   __asm__("STA %w",  VGA_ADDR_BGCOL);
+
+   __asm__("LDA #%b", ' ');
+   disp_clear();
+   __asm__("LDA #%b", COL_WHITE);
+   disp_colour();
+   printText();
+
+   __asm__("LDA #%b", ZP_CPU_DATA);
+   __asm__("STA %b", ZP_CPU_PTR_LO);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_CPU_PTR_HI);
+
+   __asm__("LDA #<%w", RESULT_POS);
+   __asm__("STA %b", ZP_SCREEN_POS_LO);
+   __asm__("LDA #>%w", RESULT_POS);
+   __asm__("STA %b", ZP_SCREEN_POS_HI);
+   __asm__("LDA #<%v", tests);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", tests);
+   __asm__("STA %b", ZP_SRC_HI);
+
+   // The first entry is not RTS or RTI, so no frames are used here.
+   __asm__("LDA #$00");
+   build();
+   measure();
+   __asm__("STA %b", ZP_CPU_EMPTY);
+
+loop:
+   __asm__("LDA #%b", COPIES);
+   build();
+   measure();
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_CPU_EMPTY);
+   __asm__("CLC");
+   __asm__("ROR A");
+   __asm__("CLC");
+   __asm__("ROR A");
+   __asm__("CLC");
+   __asm__("ROR A");                         // Divide by COPIES
+   __asm__("STA %b", ZP_CPU_CYCLES);
+   printResult();
+
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC #%b", ENTRY_SIZE);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("BNE %g", loop);
+
+here:
+   __asm__("JMP %g", here);
+} // end of reset
+
+// Maskable interrupt
+void __fastcall__ irq(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of irq
+
+// Non-maskable interrupt
+void __fastcall__ nmi(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of nmi
+
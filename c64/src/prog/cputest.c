@@ -1,5 +1,6 @@
 // This test is mainly for simulation.
 // It tests the correct functionality of the individual instructions.
+// The number of clock cycles used by each instruction is measured by cpubench.c.
 // Instructions tested:
 // 4C JMP a
 // A9 LDA #
@@ -53,6 +54,8 @@
 // ED SBC a
 // CD CMP a
 // 8E STX a
+// 05 ORA d
+// 25 AND d
 
 // To come soon:
 // A0 LDY #
@@ -908,6 +911,43 @@ noError26:
 error27:
    __asm__("BNE %g", error27);
 
+   // Now we test ORA d
+   __asm__("LDA #$5A");
+   __asm__("STA $92");
+   __asm__("LDA #$00");
+   __asm__("SEC");
+   __asm__("ORA $92");              // Should clear zero and sign flag
+   __asm__("BCC %g", error28);      // Should not jump
+   __asm__("BEQ %g", error28);      // Should not jump
+   __asm__("BMI %g", error28);      // Should not jump
+   __asm__("CMP #$5A");
+   __asm__("BNE %g", error28);      // Should not jump
+   __asm__("LDA #$A4");
+   __asm__("ORA $92");              // Should set sign flag
+   __asm__("BPL %g", error28);      // Should not jump
+   __asm__("CMP #$FE");
+   __asm__("BEQ %g", noError28);    // Should jump
+error28:
+   __asm__("JMP %g", error28);
+noError28:
+
+   // Now we test AND d
+   __asm__("LDA #$A5");
+   __asm__("CLC");
+   __asm__("AND $92");              // Should clear sign flag
+   __asm__("BCS %g", error29);      // Should not jump
+   __asm__("BMI %g", error29);      // Should not jump
+   __asm__("CMP #$00");
+   __asm__("BNE %g", error29);      // Should not jump
+   __asm__("LDA #$F0");
+   __asm__("AND $92");              // Should clear zero flag
+   __asm__("BEQ %g", error29);      // Should not jump
+   __asm__("CMP #$50");
+   __asm__("BEQ %g", noError29);    // Should jump
+error29:
+   __asm__("JMP %g", error29);
+noError29:
+
    // Loop forever doing nothing
 here:
    __asm__("LDA #$CC");          // Make it easy to recognize a successfull test.
@@ -0,0 +1,67 @@
+/*
+ * Prints a 16-bit number in decimal.
+ *
+ * Each digit is found by subtracting the power of ten as many times as
+ * possible. This is at most nine subtractions per digit, which is much
+ * faster than a division.
+ *
+ * The 32-bit version is in dec32.c. It is in a separate file, so the
+ * programs that only print 16-bit numbers don't use the ROM space.
+ */
+
+#include "zeropage.h"
+
+static const unsigned int powersOfTen[] = {10000, 1000, 100, 10, 1};
+
+// Prints the 16-bit number in ZP_NUM_0 and ZP_NUM_1 as 5 decimal digits at
+// ZP_DST, starting at offset Y. Y is returned just after the last digit.
+// ZP_NUM and ZP_DIV_0, ZP_DIV_1 and ZP_REM_0 are destroyed.
+void __fastcall__ printDec16(void)
+{
+   __asm__("LDX #$00");             // Index into powersOfTen
+
+nextDigit:
+   __asm__("LDA %v,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_0);
+   __asm__("LDA %v+1,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_1);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_REM_0);     // The digit
+
+   // Subtract the power of ten as many times as possible.
+subtract:
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("SBC %b", ZP_DIV_0);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("SBC %b", ZP_DIV_1);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("BCC %g", restore);
+   __asm__("LDA %b", ZP_REM_0);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_REM_0);
+   __asm__("JMP %g", subtract);
+
+restore:
+   __asm__("CLC");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("ADC %b", ZP_DIV_0);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("ADC %b", ZP_DIV_1);
+   __asm__("STA %b", ZP_NUM_1);
+
+   __asm__("LDA %b", ZP_REM_0);
+   __asm__("CLC");
+   __asm__("ADC #%b", '0');
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("INX");
+   __asm__("INX");
+   __asm__("TXA");
+   __asm__("CMP #%b", sizeof(powersOfTen));
+   __asm__("BNE %g", nextDigit);
+} // end of printDec16
+
@@ -0,0 +1,99 @@
+/*
+ * Prints a 32-bit number in decimal.
+ *
+ * This works like printDec16() in dec16.c, but with ten digits, and the
+ * leading zeros are replaced by spaces. The numbers are right aligned, so a
+ * number can be printed over the previous one.
+ */
+
+#include "zeropage.h"
+
+static const unsigned long powersOfTen[] = {
+   1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+   10000UL, 1000UL, 100UL, 10UL, 1UL};
+
+// Prints the 32-bit number in ZP_NUM as 10 decimal digits at ZP_DST,
+// starting at offset Y. Y is returned just after the last digit.
+// ZP_NUM and ZP_DIV, ZP_REM_0 and ZP_REM_1 are destroyed.
+void __fastcall__ printDec32(void)
+{
+   __asm__("LDX #$00");             // Index into powersOfTen
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_REM_1);     // Set when the first digit is printed
+
+nextDigit:
+   __asm__("LDA %v,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_0);
+   __asm__("INX");
+   __asm__("LDA %v,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_1);
+   __asm__("INX");
+   __asm__("LDA %v,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_2);
+   __asm__("INX");
+   __asm__("LDA %v,X", powersOfTen);
+   __asm__("STA %b", ZP_DIV_3);
+   __asm__("INX");
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_REM_0);     // The digit
+
+   // Subtract the power of ten as many times as possible.
+subtract:
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("SBC %b", ZP_DIV_0);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("SBC %b", ZP_DIV_1);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("LDA %b", ZP_NUM_2);
+   __asm__("SBC %b", ZP_DIV_2);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("LDA %b", ZP_NUM_3);
+   __asm__("SBC %b", ZP_DIV_3);
+   __asm__("STA %b", ZP_NUM_3);
+   __asm__("BCC %g", restore);
+   __asm__("LDA %b", ZP_REM_0);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_REM_0);
+   __asm__("JMP %g", subtract);
+
+restore:
+   __asm__("CLC");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("ADC %b", ZP_DIV_0);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("ADC %b", ZP_DIV_1);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("LDA %b", ZP_NUM_2);
+   __asm__("ADC %b", ZP_DIV_2);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("LDA %b", ZP_NUM_3);
+   __asm__("ADC %b", ZP_DIV_3);
+   __asm__("STA %b", ZP_NUM_3);
+
+   __asm__("LDA %b", ZP_REM_0);
+   __asm__("BNE %g", first);
+   __asm__("LDA %b", ZP_REM_1);
+   __asm__("BNE %g", digit);
+   __asm__("TXA");
+   __asm__("CMP #%b", sizeof(powersOfTen));  // The last digit is always printed
+   __asm__("BEQ %g", digit);
+   __asm__("LDA #%b", ' ');
+   __asm__("JMP %g", store);
+first:
+   __asm__("STA %b", ZP_REM_1);
+digit:
+   __asm__("LDA %b", ZP_REM_0);
+   __asm__("CLC");
+   __asm__("ADC #%b", '0');
+store:
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("TXA");
+   __asm__("CMP #%b", sizeof(powersOfTen));
+   __asm__("BNE %g", nextDigit);
+} // end of printDec32
+
@@ -8,7 +8,7 @@
 #include "memorymap.h"
 #include "zeropage.h"   // Variables to be stored in the zero-page.
 #include "circle.h"     // Routines to move the sprite around in a circle.
-#include "smult.h"      // Signed 8-bit multiplication.
+#include "mult.h"       // Fast 8-bit and 16-bit multiplication.
 
 #define COL_LIGHT       0x6F   // 011_011_11
 #define COL_DARK        0x44   // 010_001_00
@@ -415,7 +415,7 @@ void __fastcall__ reset(void)
    __asm__("LDX #$FF");
    __asm__("TXS");                           // Reset stack pointer
 
-//   smult_init();
+//   mult_init();
    circle_init();
 //   clearScreen();
 //   resetColorLine();
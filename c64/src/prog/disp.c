@@ -0,0 +1,88 @@
+/*
+ * Block memory routines for the character display.
+ *
+ * The addresses of the display are constants, so these routines use
+ * absolute indexed addressing instead of pointers in the zero-page. This
+ * avoids the setup of the pointers, and the page crossings are handled by
+ * using a separate base address for each page.
+ *
+ * Note that reading from the display takes one extra clock cycle.
+ */
+
+#include "memorymap.h"
+
+#define LINE            40                // Characters per line
+#define LAST_LINE       (17*LINE)         // Offset of the bottom line
+
+// Fills the whole display with the character in A.
+void __fastcall__ disp_clear(void)
+{
+   __asm__("LDX #$00");
+loop:
+   __asm__("STA %w,X", MEM_DISP);
+   __asm__("STA %w,X", MEM_DISP+256);
+   __asm__("STA %w,X", MEM_DISP+512);
+   __asm__("STA %w,X", MEM_DISP+768);
+   __asm__("INX");
+   __asm__("BNE %g", loop);
+} // end of disp_clear
+
+// Fills the colour of the whole display with the value in A.
+void __fastcall__ disp_colour(void)
+{
+   __asm__("LDX #$00");
+loop:
+   __asm__("STA %w,X", MEM_COL);
+   __asm__("STA %w,X", MEM_COL+256);
+   __asm__("STA %w,X", MEM_COL+512);
+   __asm__("STA %w,X", MEM_COL+768);
+   __asm__("INX");
+   __asm__("BNE %g", loop);
+} // end of disp_colour
+
+// Scrolls the display one line up, and fills the bottom line with the
+// character in A. The colours are not changed.
+void __fastcall__ disp_scroll(void)
+{
+   __asm__("TAY");
+
+   // The first two pages.
+   __asm__("LDX #$00");
+page0:
+   __asm__("LDA %w,X", MEM_DISP+LINE);
+   __asm__("STA %w,X", MEM_DISP);
+   __asm__("LDA %w,X", MEM_DISP+LINE+1);
+   __asm__("STA %w,X", MEM_DISP+1);
+   __asm__("INX");
+   __asm__("INX");
+   __asm__("BNE %g", page0);
+page1:
+   __asm__("LDA %w,X", MEM_DISP+256+LINE);
+   __asm__("STA %w,X", MEM_DISP+256);
+   __asm__("LDA %w,X", MEM_DISP+256+LINE+1);
+   __asm__("STA %w,X", MEM_DISP+256+1);
+   __asm__("INX");
+   __asm__("INX");
+   __asm__("BNE %g", page1);
+
+   // The rest, up to the bottom line. X counts up to zero, so the base
+   // address is moved back accordingly.
+   __asm__("LDX #%b", 768-LAST_LINE);
+rest:
+   __asm__("LDA %w,X", MEM_DISP+LAST_LINE-256+LINE);
+   __asm__("STA %w,X", MEM_DISP+LAST_LINE-256);
+   __asm__("LDA %w,X", MEM_DISP+LAST_LINE-256+LINE+1);
+   __asm__("STA %w,X", MEM_DISP+LAST_LINE-256+1);
+   __asm__("INX");
+   __asm__("INX");
+   __asm__("BNE %g", rest);
+
+   // Fill the bottom line.
+   __asm__("TYA");
+   __asm__("LDX #%b", LINE-1);
+fill:
+   __asm__("STA %w,X", MEM_DISP+LAST_LINE);
+   __asm__("DEX");
+   __asm__("BPL %g", fill);
+} // end of disp_scroll
+
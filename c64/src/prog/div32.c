@@ -0,0 +1,76 @@
+/*
+ * Divides a 32-bit number by a 32-bit divisor.
+ *
+ * This is the usual shift and subtract division, one bit of the quotient at
+ * a time. The numbers are kept in memory instead of the zero-page, so the
+ * bytes can be handled in loops with absolute indexed addressing. This makes
+ * the routine small enough for the programs with little ROM space left.
+ *
+ * The numbers are stored with the least significant byte first. The loops
+ * count X up to zero from $F8 or $FC, so the base addresses are moved back
+ * accordingly, and no compare is needed.
+ */
+
+char div32_num[8];         // The number, followed by the remainder
+char div32_div[4];         // The divisor
+
+static char diff[4];
+static char temp;
+static char count;
+
+// Divides div32_num by div32_div. The quotient replaces the number, and the
+// remainder is stored after it. The divisor is preserved.
+// Y is preserved.
+void __fastcall__ divide32(void)
+{
+   __asm__("LDA #$00");
+   __asm__("LDX #$03");
+clear:
+   __asm__("STA %v+4,X", div32_num);
+   __asm__("DEX");
+   __asm__("BPL %g", clear);
+   __asm__("LDA #$20");
+   __asm__("STA %v", count);
+
+loop:
+   // Shift the next bit of the number into the remainder
+   __asm__("LDX #$F8");
+   __asm__("CLC");
+shift:
+   __asm__("LDA %v-$F8,X", div32_num);
+   __asm__("ROL A");
+   __asm__("STA %v-$F8,X", div32_num);
+   __asm__("INX");
+   __asm__("BNE %g", shift);
+
+   __asm__("LDX #$FC");
+   __asm__("SEC");
+subtract:
+   __asm__("LDA %v-$FC,X", div32_div);
+   __asm__("STA %v", temp);
+   __asm__("LDA %v+4-$FC,X", div32_num);
+   __asm__("SBC %v", temp);
+   __asm__("STA %v-$FC,X", diff);
+   __asm__("INX");
+   __asm__("BNE %g", subtract);
+   __asm__("BCC %g", next);
+
+   __asm__("LDX #$03");
+copy:
+   __asm__("LDA %v,X", diff);
+   __asm__("STA %v+4,X", div32_num);
+   __asm__("DEX");
+   __asm__("BPL %g", copy);
+   __asm__("LDA %v", div32_num);    // Set quotient bit
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %v", div32_num);
+
+next:
+   __asm__("LDA %v", count);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %v", count);
+   __asm__("BNE %g", loop);
+} // end of divide32
+
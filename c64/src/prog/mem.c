@@ -0,0 +1,37 @@
+/*
+ * Block memory routines for up to 256 bytes.
+ *
+ * The source and destination pointers are in ZP_SRC and ZP_DST, and the
+ * number of bytes is in Y, where Y = 0 means 256 bytes. The bytes are
+ * handled from the end, so a block may be moved up in memory, even if the
+ * source and destination overlap.
+ *
+ * The routines for 16-bit lengths are in mem16.c, and the routines
+ * specialised for the character display are in disp.c. They are in separate
+ * files, so the programs that don't need them don't use the ROM space.
+ */
+
+#include "zeropage.h"
+
+// Copies Y bytes from ZP_SRC to ZP_DST.
+// X is preserved.
+void __fastcall__ memcpy8(void)
+{
+loop:
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("TYA");
+   __asm__("BNE %g", loop);
+} // end of memcpy8
+
+// Fills Y bytes at ZP_DST with the value in A.
+// X is preserved.
+void __fastcall__ memset8(void)
+{
+loop:
+   __asm__("DEY");
+   __asm__("STA (%b),Y", ZP_DST_LO);  // STA does not change the flags
+   __asm__("BNE %g", loop);
+} // end of memset8
+
@@ -0,0 +1,8 @@
+void __fastcall__ memcpy8(void);
+void __fastcall__ memset8(void);
+void __fastcall__ memcpy16(void);
+void __fastcall__ memset16(void);
+void __fastcall__ memcmp16(void);
+void __fastcall__ disp_clear(void);
+void __fastcall__ disp_colour(void);
+void __fastcall__ disp_scroll(void);
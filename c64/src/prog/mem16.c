@@ -0,0 +1,235 @@
+/*
+ * Block memory routines for 16-bit lengths.
+ *
+ * The source and destination pointers are in ZP_SRC and ZP_DST, and the
+ * number of bytes is in ZP_LEN. The pointers and X and Y are destroyed.
+ *
+ * Whole pages are handled first, with the loop unrolled four times, so the
+ * branch and the loop counter only cost a little per byte. The remaining
+ * bytes are handled afterwards. The unrolled loops don't need a compare,
+ * since Y wraps around to zero after exactly one page.
+ *
+ * To handle the last bytes in increasing order, the pointers are moved back
+ * by 256-n bytes, and Y counts from -n up to zero. This way, the loop again
+ * ends when Y wraps around.
+ */
+
+#include "zeropage.h"
+#include "mem.h"
+
+// Adds ZP_LEN_LO-256 to ZP_SRC and ZP_DST, and returns -ZP_LEN_LO in Y.
+// ZP_LEN_LO must not be zero.
+static void __fastcall__ memRest(void)
+{
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_LEN_LO);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$FF");
+   __asm__("STA %b", ZP_SRC_HI);
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_LEN_LO);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$FF");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("LDA #$00");
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_LEN_LO);
+   __asm__("TAY");
+} // end of memRest
+
+// Copies ZP_LEN bytes from ZP_SRC to ZP_DST.
+// The source and destination may overlap: If the destination is above the
+// source, the bytes are copied from the end.
+void __fastcall__ memcpy16(void)
+{
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CMP %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("SBC %b", ZP_SRC_HI);
+   __asm__("BCS %g", backward);
+
+   // Copy from the start
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_LEN_HI);
+   __asm__("TAX");
+   __asm__("BEQ %g", forwardRest);
+forwardPage:
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("BNE %g", forwardPage);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("DEX");
+   __asm__("BNE %g", forwardPage);
+
+forwardRest:
+   __asm__("LDA %b", ZP_LEN_LO);
+   __asm__("BEQ %g", end);
+   memRest();
+forwardByte:
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("BNE %g", forwardByte);
+   __asm__("RTS");
+
+   // Copy from the end. First the bytes after the whole pages.
+backward:
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_LEN_HI);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_LEN_HI);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA %b", ZP_LEN_LO);
+   __asm__("BEQ %g", backwardPages);
+   __asm__("TAY");
+   memcpy8();
+
+backwardPages:
+   __asm__("LDA %b", ZP_LEN_HI);
+   __asm__("BEQ %g", end);
+   __asm__("TAX");
+backwardNext:
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$00");
+   __asm__("TAY");
+backwardPage:
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("TYA");
+   __asm__("BNE %g", backwardPage);
+   __asm__("DEX");
+   __asm__("BNE %g", backwardNext);
+end:
+   __asm__("RTS");
+} // end of memcpy16
+
+// Fills ZP_LEN bytes at ZP_DST with the value in A.
+void __fastcall__ memset16(void)
+{
+   __asm__("STA %b", ZP_MEM_VAL);
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_LEN_HI);
+   __asm__("TAX");
+   __asm__("BEQ %g", rest);
+page:
+   __asm__("LDA %b", ZP_MEM_VAL);
+fill:
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("INY");
+   __asm__("BNE %g", fill);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("DEX");
+   __asm__("BNE %g", page);
+
+rest:
+   __asm__("LDA %b", ZP_LEN_LO);
+   __asm__("BEQ %g", end);
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_MEM_VAL);
+   memset8();
+end:
+   __asm__("RTS");
+} // end of memset16
+
+// Compares ZP_LEN bytes at ZP_SRC and ZP_DST.
+// Returns A = 0 if they are equal, and A = 1 otherwise.
+void __fastcall__ memcmp16(void)
+{
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_LEN_HI);
+   __asm__("TAX");
+   __asm__("BEQ %g", rest);
+page:
+   __asm__("LDA (%b),Y", ZP_DST_LO);
+   __asm__("STA %b", ZP_MEM_VAL);
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("CMP %b", ZP_MEM_VAL);
+   __asm__("BNE %g", different);
+   __asm__("INY");
+   __asm__("BNE %g", page);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("DEX");
+   __asm__("BNE %g", page);
+
+rest:
+   __asm__("LDA %b", ZP_LEN_LO);
+   __asm__("BEQ %g", end);
+   memRest();
+byte:
+   __asm__("LDA (%b),Y", ZP_DST_LO);
+   __asm__("STA %b", ZP_MEM_VAL);
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("CMP %b", ZP_MEM_VAL);
+   __asm__("BNE %g", different);
+   __asm__("INY");
+   __asm__("BNE %g", byte);
+   __asm__("LDA #$00");
+end:
+   __asm__("RTS");
+
+different:
+   __asm__("LDA #$01");
+} // end of memcmp16
+
@@ -0,0 +1,470 @@
+//
+// This measures the speed of the block memory routines, when clearing and
+// scrolling the character display.
+//
+// Each method is used once, and the time is measured with the clock cycle
+// counter, including the setup and the calls. The screen is filled with a
+// pattern before each test, and the result is checked afterwards. The
+// results are shown when all the tests are done.
+//
+// The scroll moves the 17 lines below the top line, i.e. 680 bytes, and
+// clears the bottom line.
+//
+
+#include "memorymap.h"
+#include "zeropage.h"   // Variables to be stored in the zero-page.
+#include "mem.h"
+#include "timer.h"
+#include "num.h"
+
+#define COL_WHITE       0xFFU   // 111_111_11
+#define COL_LIGHT       0x6FU   // 011_011_11
+#define COL_DARK        0x44U   // 010_001_00
+
+#define LABEL_POS_Y     2
+#define LABEL_SIZE      20
+#define LABEL_LINES     8
+#define TESTS           (LABEL_LINES-1)
+
+#define SCROLL_SIZE     (17*40)
+
+// Constants
+static const char strTitle[]  = "Clear and scroll, clock cycles";
+static const char strLabels[] =
+   "Clear, memset8      "
+   "Clear, memset16     "
+   "Clear, disp_clear   "
+   "Scroll, memcpy8     "
+   "Scroll, memcpy16    "
+   "Scroll, disp_scroll "
+   "Down, memcpy16      "
+   "Errors:             ";
+
+// Variables
+static char results[2*TESTS];
+static char next;                   // Index into results
+static char errors;
+static char saved[SCROLL_SIZE+40];  // Copy of the pattern on the screen
+
+// Copies the title and the labels to the screen.
+static void __fastcall__ printText(void)
+{
+   __asm__("LDA #<%v", strTitle);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strTitle);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #%b", sizeof(strTitle)-1);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA #<%v", strLabels);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strLabels);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDX #%b", LABEL_LINES);
+line:
+   __asm__("LDA #%b", LABEL_SIZE);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC #%b", LABEL_SIZE);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SRC_HI);
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("DEX");
+   __asm__("BNE %g", line);
+} // end of printText
+
+// Prints the 16-bit number in ZP_NUM_0 and ZP_NUM_1 at the end of the label
+// on the line ZP_DST. Afterwards ZP_DST is moved to the next line.
+static void __fastcall__ printValue(void)
+{
+   __asm__("LDA #%b", LABEL_SIZE);
+   __asm__("TAY");
+   printDec16();
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+} // end of printValue
+
+// Fills the screen with a pattern, which is different on each line.
+static void __fastcall__ fillPattern(void)
+{
+   __asm__("LDX #$00");
+loop:
+   __asm__("TXA");
+   __asm__("STA %w,X", MEM_DISP);
+   __asm__("STA %w,X", MEM_DISP+256);
+   __asm__("STA %w,X", MEM_DISP+512);
+   __asm__("STA %w,X", MEM_DISP+768);
+   __asm__("INX");
+   __asm__("BNE %g", loop);
+} // end of fillPattern
+
+// Stores the cycles since timer_start() in the next entry of results.
+// All tests take less than 65536 cycles, so the upper bytes are ignored.
+static void __fastcall__ stopTimer(void)
+{
+   timer_stop();
+   __asm__("LDA %v", next);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("STA %v,X", results);
+   __asm__("INX");
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("STA %v,X", results);
+   __asm__("INX");
+   __asm__("TXA");
+   __asm__("STA %v", next);
+} // end of stopTimer
+
+// Counts an error, if the screen is not blank.
+static void __fastcall__ checkClear(void)
+{
+   __asm__("LDX #$00");
+   __asm__("LDA #%b", ' ');
+loop:
+   __asm__("CMP %w,X", MEM_DISP);
+   __asm__("BNE %g", error);
+   __asm__("CMP %w,X", MEM_DISP+256);
+   __asm__("BNE %g", error);
+   __asm__("CMP %w,X", MEM_DISP+512);
+   __asm__("BNE %g", error);
+   __asm__("CMP %w,X", MEM_DISP+768);
+   __asm__("BNE %g", error);
+   __asm__("INX");
+   __asm__("BNE %g", loop);
+   __asm__("RTS");
+
+error:
+   __asm__("LDA %v", errors);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %v", errors);
+} // end of checkClear
+
+// Counts an error, if the screen is not the pattern moved one line up.
+static void __fastcall__ checkUp(void)
+{
+   __asm__("LDA #<(%v+40)", saved);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>(%v+40)", saved);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #>%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_HI);
+   memcmp16();
+   __asm__("CLC");
+   __asm__("ADC %v", errors);
+   __asm__("STA %v", errors);
+} // end of checkUp
+
+// Counts an error, if the screen is not the pattern moved one line down.
+static void __fastcall__ checkDown(void)
+{
+   __asm__("LDA #<%v", saved);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", saved);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #>%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_HI);
+   memcmp16();
+   __asm__("CLC");
+   __asm__("ADC %v", errors);
+   __asm__("STA %v", errors);
+} // end of checkDown
+
+// Clears one page at a time.
+static void __fastcall__ benchClear8(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDX #$04");
+page:
+   __asm__("LDA #$00");
+   __asm__("TAY");
+   __asm__("LDA #%b", ' ');
+   memset8();
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("DEX");
+   __asm__("BNE %g", page);
+   stopTimer();
+   checkClear();
+} // end of benchClear8
+
+static void __fastcall__ benchClear16(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #$04");
+   __asm__("STA %b", ZP_LEN_HI);
+   __asm__("LDA #%b", ' ');
+   memset16();
+   stopTimer();
+   checkClear();
+} // end of benchClear16
+
+static void __fastcall__ benchClearDisp(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #%b", ' ');
+   disp_clear();
+   stopTimer();
+   checkClear();
+} // end of benchClearDisp
+
+// Moves one line at a time.
+static void __fastcall__ benchScroll8(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #<%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDX #$11");
+line:
+   __asm__("LDA #$28");
+   __asm__("TAY");
+   memcpy8();
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("DEX");
+   __asm__("BNE %g", line);
+   __asm__("LDA #$28");
+   __asm__("TAY");
+   __asm__("LDA #%b", ' ');
+   memset8();
+   stopTimer();
+   checkUp();
+} // end of benchScroll8
+
+static void __fastcall__ benchScroll16(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #<%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #>%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_HI);
+   memcpy16();
+   __asm__("LDA #<%w", MEM_DISP+SCROLL_SIZE);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP+SCROLL_SIZE);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$28");
+   __asm__("TAY");
+   __asm__("LDA #%b", ' ');
+   memset8();
+   stopTimer();
+   checkUp();
+} // end of benchScroll16
+
+static void __fastcall__ benchScrollDisp(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #%b", ' ');
+   disp_scroll();
+   stopTimer();
+   checkUp();
+} // end of benchScrollDisp
+
+// The destination is above the source, so memcpy16() copies from the end.
+static void __fastcall__ benchDown16(void)
+{
+   fillPattern();
+   timer_start();
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP+40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #>%w", SCROLL_SIZE);
+   __asm__("STA %b", ZP_LEN_HI);
+   memcpy16();
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$28");
+   __asm__("TAY");
+   __asm__("LDA #%b", ' ');
+   memset8();
+   stopTimer();
+   checkDown();
+} // end of benchDown16
+
+// Entry point after CPU reset
+void __fastcall__ reset(void)
+{
+   __asm__("SEI");                           // Disable all interrupts
+   __asm__("LDX #$FF");
+   __asm__("TXS");                           // Reset stack pointer
+
+   // Configure text color
+   __asm__("LDA #%b", COL_LIGHT);
+   __asm__("STA %w",  VGA_ADDR_FGCOL);
+   __asm__("LDA #%b", COL_DARK);
+   __asm__("STA %w",  VGA_ADDR_BGCOL);
+   __asm__("LDA #%b", COL_WHITE);
+   disp_colour();
+
+   __asm__("LDA #$00");
+   __asm__("STA %v", next);
+   __asm__("STA %v", errors);
+
+   // Keep a copy of the pattern, to check the scrolling against.
+   fillPattern();
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%v", saved);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%v", saved);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%w", sizeof(saved));
+   __asm__("STA %b", ZP_LEN_LO);
+   __asm__("LDA #>%w", sizeof(saved));
+   __asm__("STA %b", ZP_LEN_HI);
+   memcpy16();
+
+   benchClear8();
+   benchClear16();
+   benchClearDisp();
+   benchScroll8();
+   benchScroll16();
+   benchScrollDisp();
+   benchDown16();
+
+   // Show the results
+   __asm__("LDA #%b", ' ');
+   disp_clear();
+   printText();
+
+   __asm__("LDA #<%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$00");
+   __asm__("STA %v", next);
+print:
+   __asm__("LDA %v", next);
+   __asm__("TAX");
+   __asm__("LDA %v,X", results);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %v+1,X", results);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("INX");
+   __asm__("INX");
+   __asm__("TXA");
+   __asm__("STA %v", next);
+   printValue();
+   __asm__("LDA %v", next);
+   __asm__("CMP #%b", sizeof(results));
+   __asm__("BNE %g", print);
+
+   __asm__("LDA %v", errors);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_NUM_1);
+   printValue();
+
+loop:
+   __asm__("JMP %g", loop);
+} // end of reset
+
+// Maskable interrupt
+void __fastcall__ irq(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of irq
+
+// Non-maskable interrupt
+void __fastcall__ nmi(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of nmi
+
@@ -4,10 +4,14 @@
 #define MEM_DISP 0x8000 // - 0x83FF
 #define MEM_COL  0x8800 // - 0x8BFF
 #define MEM_MOB  0x8400 // - 0x847F
-#define MEM_CONF 0x8600 // - 0x861F
+#define MEM_CONF 0x8600 // - 0x863F
 #define MEM_FONT 0x9000 // - 0x9FFF
 #define MEM_ROM  0xF800 // - 0xFFFF
 
+// Table of x^2/4 used by the multiplication routines, see mult.c.
+#define MEM_SQR_LO 0x0600 // - 0x06FF
+#define MEM_SQR_HI 0x0700 // - 0x07FF
+
 // The VGA screen contains 40 x 18 characters and is located at 0x8000.
 #define VGA_ADDR_SCREEN          0x8000
 #define VGA_SCREEN_SIZE_X        40
@@ -42,6 +46,9 @@
 #define VGA_ADDR_SPRITE_2_ENA    0x8612    // 0:Enabled, 2-1:Magnify
 #define VGA_ADDR_SPRITE_3_ENA    0x8613    // 0:Enabled, 2-1:Magnify
 
+#define VGA_ADDR_CYCLES          0x8614    // Clock cycle counter (4 bytes, read only).
+                                           // Reading the LSB latches the upper bytes.
+
 #define VGA_ADDR_FGCOL           0x8618    // Character foreground colour
 #define VGA_ADDR_BGCOL           0x8619    // Character background colour
 #define VGA_ADDR_XSCROLL         0x861A    // Bits 3-0 : X-scroll
@@ -49,5 +56,20 @@
 #define VGA_ADDR_IRQ             0x861C    // Bit 0 : Y-line interrupt
 #define VGA_ADDR_MASK            0x861D    // Bit 0 : Y-line interrupt
 #define VGA_KEY                  0x861E
-#define VGA_COLL                 0x861F
+#define VGA_COLL                 0x861F    // Bits 3-0 : Sprite collided with another sprite
+#define VGA_COLL_PAIR            0x8620    // Bits 5-0 : Sprites 0-1, 0-2, 0-3, 1-2, 1-3, 2-3 collided
+#define VGA_COLL_CHAR            0x8621    // Bits 3-0 : Sprite collided with a character
+                                           // The collision bits are cleared by writing a one.
+#define VGA_BENCH_OPCODE         0x8622    // Report of cpubench.c (write only).
+#define VGA_BENCH_NMOS           0x8623    // Writing to VGA_BENCH_CYCLES prints a
+#define VGA_BENCH_CYCLES         0x8624    // line in simulation.
+
+// Coordinates of the first contact of each pair of sprites in the most recent
+// frame with a collision. Four bytes pr pair: X, X MSB, Y, and one unused.
+#define VGA_ADDR_CONTACT_01      0x8628
+#define VGA_ADDR_CONTACT_02      0x862C
+#define VGA_ADDR_CONTACT_03      0x8630
+#define VGA_ADDR_CONTACT_12      0x8634
+#define VGA_ADDR_CONTACT_13      0x8638
+#define VGA_ADDR_CONTACT_23      0x863C
 
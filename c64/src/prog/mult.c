@@ -0,0 +1,231 @@
+/*
+ * Fast 8-bit multiplication, signed and unsigned.
+ *
+ * The method used is a*b = (a+b)^2/4 - (a-b)^2/4.
+ * In other words a*b = f(a+b) - f(a-b), where f(x) = x^2/4.
+ *
+ * The fractional part of f(x) will either be 0 or 0.25. And the fractional part
+ * will always be the same for the two evaluations of f(x). Therefore,
+ * it suffices to take the integer part (floor) of f(x).
+ *
+ * The evaluation of f(x) is done via table-lookup. The table contains
+ * f(x) for 0 <= x <= 255, with the LSB in the page MEM_SQR_LO and the MSB in
+ * the page MEM_SQR_HI. The table must be initialized by calling mult_init().
+ *
+ * For unsigned numbers, a+b may be up to 510. Then the identity
+ * f(256+x) = f(x) + 128*x + 16384 is used, so the same table suffices.
+ * Since f(x) is even, signed numbers just use the absolute value of
+ * a+b and a-b.
+ */
+
+#include "memorymap.h"
+#include "zeropage.h"
+
+// This initializes the table of x^2/4.
+void __fastcall__ mult_init(void)
+{
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_HI);
+   __asm__("TAY");
+   __asm__("TAX");
+   __asm__("STA %w,X", MEM_SQR_LO);
+   __asm__("STA %w,X", MEM_SQR_HI);
+   __asm__("INX");
+
+   __asm__("STA %w,X", MEM_SQR_LO);
+   __asm__("STA %w,X", MEM_SQR_HI);
+   __asm__("INX");
+   __asm__("INY");
+
+   // f(x) increases by 1, 1, 2, 2, 3, 3, ...
+loop:
+   __asm__("TYA");
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("STA %w,X", MEM_SQR_LO);
+   __asm__("LDA %b", ZP_MULT_T_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_MULT_T_HI);
+   __asm__("STA %w,X", MEM_SQR_HI);
+   __asm__("INX");
+   __asm__("BEQ %g", end);
+
+   __asm__("TYA");
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("STA %w,X", MEM_SQR_LO);
+   __asm__("LDA %b", ZP_MULT_T_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_MULT_T_HI);
+   __asm__("STA %w,X", MEM_SQR_HI);
+   __asm__("INY");
+   __asm__("INX");
+   __asm__("BNE %g", loop);
+
+end:
+   __asm__("RTS");
+} // end of mult_init
+
+// Multiply two unsigned 8-bit numbers to get an unsigned 16-bit result.
+// The two numbers are in A and X.
+// The result has MSB in X and LSB in A.
+// The two numbers are left in ZP_MULT_A and ZP_MULT_B.
+void __fastcall__ umult8(void)
+{
+   __asm__("STA %b", ZP_MULT_A);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_MULT_B);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_A);   // A+X. The 9'th bit is in the carry.
+   __asm__("TAX");
+   __asm__("BCS %g", large);
+
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("STA %b", ZP_MULT_T_HI);
+   __asm__("JMP %g", difference);
+
+large:
+   // f(256+x) = f(x) + 128*x + 16384
+   __asm__("TXA");
+   __asm__("CLC");
+   __asm__("ROR A");                // x/2, and bit 0 of x in carry
+   __asm__("STA %b", ZP_MULT_T_HI);
+   __asm__("LDA #$00");
+   __asm__("ROR A");                // 128*(x&1). This clears the carry.
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("ADC %b", ZP_MULT_T_HI);
+   __asm__("ADC #$40");             // Carry is always clear here.
+   __asm__("STA %b", ZP_MULT_T_HI);
+
+difference:
+   __asm__("LDA %b", ZP_MULT_A);
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_MULT_B);   // A-X
+   __asm__("BCS %g", noNegate);
+
+   __asm__("EOR #$FF"); // Negate
+   __asm__("ADC #$01"); // Increment. Carry is always clear here.
+
+noNegate:
+   __asm__("TAX");      // Move |A-X| to X
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("EOR #$FF");    // Negate
+   __asm__("SEC");
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("EOR #$FF");
+   __asm__("ADC %b", ZP_MULT_T_HI);
+   __asm__("TAX");      // Move MSB to X
+   __asm__("LDA %b", ZP_MULT_T_LO);
+} // end of umult8
+
+// Multiply two signed 8-bit numbers to get a signed 16-bit result.
+// The two numbers are in A and X.
+// The result has MSB in X and LSB in A.
+//
+// When evaluating a+b (and a-b), the result is 9 bit, where the 9'th bit is in
+// the carry. The carry acts as the sign of the result, and if set, the result
+// is to be negated. Depending on the signs of a and b, only one of a+b and a-b
+// can overflow.
+void __fastcall__ smult8(void)
+{
+   __asm__("STA %b", ZP_MULT_A);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_MULT_B);
+   __asm__("EOR %b", ZP_MULT_A);
+   __asm__("BMI %g", negative);
+
+   __asm__("TXA");
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_A);   // A+X
+   __asm__("BCC %g", noNegate);
+
+   __asm__("EOR #$FF"); // Negate
+   __asm__("ADC #$00"); // Increment. Carry is always set here.
+   __asm__("BEQ %g", minus256);   // Only when A = X = -128.
+
+noNegate:
+   __asm__("TAX");      // Move |A+X| to X
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("STA %b", ZP_MULT_T_HI);
+
+   __asm__("LDA %b", ZP_MULT_A);
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_MULT_B);   // A-X
+   __asm__("BCS %g", noNegate2);
+
+   __asm__("EOR #$FF"); // Negate
+   __asm__("ADC #$01"); // Increment. Carry is always clear here.
+
+noNegate2:
+   __asm__("TAX");      // Move |A-X| to X
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("EOR #$FF");    // Negate
+   __asm__("SEC");
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("EOR #$FF");
+   __asm__("ADC %b", ZP_MULT_T_HI);
+   __asm__("TAX");      // Move MSB to X
+   __asm__("LDA %b", ZP_MULT_T_LO);
+   __asm__("RTS");
+
+minus256:
+   // (-128)*(-128) = f(256) - f(0) = 16384
+   __asm__("LDX #$40");
+   __asm__("RTS");
+
+negative:
+   __asm__("TXA");
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_A);   // A+X
+   __asm__("BCS %g", noNegate3);
+
+   __asm__("EOR #$FF"); // Negate
+   __asm__("ADC #$01"); // Increment. Carry is always clear here.
+
+noNegate3:
+   __asm__("TAX");      // Move |A+X| to X
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("STA %b", ZP_MULT_T_HI);
+
+   __asm__("LDA %b", ZP_MULT_A);
+   __asm__("SEC");
+   __asm__("SBC %b", ZP_MULT_B);   // A-X
+   __asm__("BCC %g", noNegate4);
+
+   __asm__("EOR #$FF"); // Negate
+   __asm__("ADC #$00"); // Increment. Carry is always set here.
+
+noNegate4:
+   __asm__("TAX");      // Move |A-X| to X
+   __asm__("LDA %w,X", MEM_SQR_LO);
+   __asm__("EOR #$FF");    // Negate
+   __asm__("SEC");
+   __asm__("ADC %b", ZP_MULT_T_LO);
+   __asm__("STA %b", ZP_MULT_T_LO);
+
+   __asm__("LDA %w,X", MEM_SQR_HI);
+   __asm__("EOR #$FF");
+   __asm__("ADC %b", ZP_MULT_T_HI);
+   __asm__("TAX");      // Move MSB to X
+   __asm__("LDA %b", ZP_MULT_T_LO);
+} // end of smult8
+
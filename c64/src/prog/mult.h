@@ -0,0 +1,5 @@
+void __fastcall__ mult_init(void);
+void __fastcall__ umult8(void);
+void __fastcall__ smult8(void);
+void __fastcall__ umult16(void);
+void __fastcall__ smult16(void);
@@ -0,0 +1,108 @@
+/*
+ * Fast 16-bit multiplication, signed and unsigned.
+ *
+ * The product is built from four 8-bit products:
+ * (256*xh + xl) * (256*yh + yl) = 65536*xh*yh + 256*(xh*yl + xl*yh) + xl*yl.
+ *
+ * For signed numbers, the unsigned product is corrected afterwards:
+ * If x is negative, its unsigned value is x + 65536, so y*65536 is
+ * subtracted from the result. And similarly if y is negative.
+ *
+ * The table of x^2/4 must be initialized by calling mult_init().
+ */
+
+#include "zeropage.h"
+#include "mult.h"
+
+// Multiply two unsigned 16-bit numbers to get an unsigned 32-bit result.
+// The first number has LSB in A and MSB in X.
+// The second number is in ZP_MULT_Y_LO and ZP_MULT_Y_HI.
+// The result is in ZP_MULT_R0 - ZP_MULT_R3.
+void __fastcall__ umult16(void)
+{
+   __asm__("STA %b", ZP_MULT_X_LO);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_MULT_X_HI);
+
+   // xl*yl
+   __asm__("LDA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_MULT_X_LO);
+   umult8();
+   __asm__("STA %b", ZP_MULT_R0);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_MULT_R1);
+
+   // xh*yh
+   __asm__("LDA %b", ZP_MULT_Y_HI);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_MULT_X_HI);
+   umult8();
+   __asm__("STA %b", ZP_MULT_R2);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_MULT_R3);
+
+   // xl*yh
+   __asm__("LDA %b", ZP_MULT_Y_HI);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_MULT_X_LO);
+   umult8();
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_R1);
+   __asm__("STA %b", ZP_MULT_R1);
+   __asm__("TXA");
+   __asm__("ADC %b", ZP_MULT_R2);
+   __asm__("STA %b", ZP_MULT_R2);
+   __asm__("LDA %b", ZP_MULT_R3);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_MULT_R3);
+
+   // xh*yl
+   __asm__("LDA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_MULT_X_HI);
+   umult8();
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_MULT_R1);
+   __asm__("STA %b", ZP_MULT_R1);
+   __asm__("TXA");
+   __asm__("ADC %b", ZP_MULT_R2);
+   __asm__("STA %b", ZP_MULT_R2);
+   __asm__("LDA %b", ZP_MULT_R3);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_MULT_R3);
+} // end of umult16
+
+// Multiply two signed 16-bit numbers to get a signed 32-bit result.
+// The first number has LSB in A and MSB in X.
+// The second number is in ZP_MULT_Y_LO and ZP_MULT_Y_HI.
+// The result is in ZP_MULT_R0 - ZP_MULT_R3.
+void __fastcall__ smult16(void)
+{
+   umult16();
+
+   __asm__("LDA %b", ZP_MULT_X_HI);
+   __asm__("BPL %g", xPositive);
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_MULT_R2);
+   __asm__("SBC %b", ZP_MULT_Y_LO);
+   __asm__("STA %b", ZP_MULT_R2);
+   __asm__("LDA %b", ZP_MULT_R3);
+   __asm__("SBC %b", ZP_MULT_Y_HI);
+   __asm__("STA %b", ZP_MULT_R3);
+
+xPositive:
+   __asm__("LDA %b", ZP_MULT_Y_HI);
+   __asm__("BPL %g", yPositive);
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_MULT_R2);
+   __asm__("SBC %b", ZP_MULT_X_LO);
+   __asm__("STA %b", ZP_MULT_R2);
+   __asm__("LDA %b", ZP_MULT_R3);
+   __asm__("SBC %b", ZP_MULT_X_HI);
+   __asm__("STA %b", ZP_MULT_R3);
+
+yPositive:
+   __asm__("RTS");
+} // end of smult16
+
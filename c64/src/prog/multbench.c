@@ -0,0 +1,414 @@
+//
+// This measures the speed of the multiplication routines, and checks the new
+// 8-bit routines against the old ones for all possible operands.
+//
+// Each routine is called 256 times with different operands, and the time is
+// measured with the clock cycle counter. The time of an empty loop is
+// subtracted, so the result is the average number of clock cycles per
+// multiplication, including the JSR and RTS.
+//
+// The old routine smult() gets (-128)*(-128) wrong, so this single case is
+// skipped when comparing the signed routines.
+//
+
+#include "memorymap.h"
+#include "zeropage.h"   // Variables to be stored in the zero-page.
+#include "mem.h"
+#include "timer.h"
+#include "num.h"
+#include "mult.h"
+#include "umult.h"
+#include "smult.h"
+
+#define COL_WHITE       0xFFU   // 111_111_11
+#define COL_LIGHT       0x6FU   // 011_011_11
+#define COL_DARK        0x44U   // 010_001_00
+
+#define LABEL_POS_Y     2
+#define LABEL_SIZE      20
+#define LABEL_LINES     7
+
+// Constants
+static const char strTitle[]  = "Multiplication, cycles per call";
+static const char strLabels[] =
+   "umult   (shift-add) "
+   "umult8  (table)     "
+   "smult   (old table) "
+   "smult8  (table)     "
+   "umult16 (table)     "
+   "smult16 (table)     "
+   "Errors:             ";
+
+// Copies the title and the labels to the screen.
+static void __fastcall__ printText(void)
+{
+   __asm__("LDA #<%v", strTitle);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strTitle);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #%b", sizeof(strTitle)-1);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA #<%v", strLabels);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strLabels);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDX #%b", LABEL_LINES);
+line:
+   __asm__("LDA #%b", LABEL_SIZE);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC #%b", LABEL_SIZE);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SRC_HI);
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("DEX");
+   __asm__("BNE %g", line);
+} // end of printText
+
+// Prints the 16-bit number in ZP_NUM_0 and ZP_NUM_1 at the end of the label
+// on the line ZP_DST. Afterwards ZP_DST is moved to the next line.
+static void __fastcall__ printValue(void)
+{
+   __asm__("LDA #%b", LABEL_SIZE);
+   __asm__("TAY");
+   printDec16();
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+} // end of printValue
+
+// Starts the clock cycle counter, and clears the loop counter.
+static void __fastcall__ startTimer(void)
+{
+   timer_start();
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_BENCH_I);
+} // end of startTimer
+
+// Subtracts the time of the empty loop, divides by 256, and prints the result.
+static void __fastcall__ printCycles(void)
+{
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("SBC %b", ZP_BENCH_BASE_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("SBC %b", ZP_BENCH_BASE_1);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_NUM_2);
+   __asm__("SBC %b", ZP_BENCH_BASE_2);
+   __asm__("STA %b", ZP_NUM_1);
+   printValue();
+} // end of printCycles
+
+// The benchmark loops below all set up the operands in the same way. The first
+// operand is the loop counter I, and the second operand is I xor $5A. For the
+// 16-bit routines, the second operand is the first operand with the bytes
+// swapped. This is the same loop, but without the call.
+static void __fastcall__ benchEmpty(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+
+   __asm__("LDA %b", ZP_NUM_0);
+   __asm__("STA %b", ZP_BENCH_BASE_0);
+   __asm__("LDA %b", ZP_NUM_1);
+   __asm__("STA %b", ZP_BENCH_BASE_1);
+   __asm__("LDA %b", ZP_NUM_2);
+   __asm__("STA %b", ZP_BENCH_BASE_2);
+   __asm__("LDA %b", ZP_NUM_3);
+   __asm__("STA %b", ZP_BENCH_BASE_3);
+} // end of benchEmpty
+
+static void __fastcall__ benchUmult(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   umult();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchUmult
+
+static void __fastcall__ benchUmult8(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   umult8();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchUmult8
+
+static void __fastcall__ benchSmult(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   smult();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchSmult
+
+static void __fastcall__ benchSmult8(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   smult8();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchSmult8
+
+static void __fastcall__ benchUmult16(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   umult16();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchUmult16
+
+static void __fastcall__ benchSmult16(void)
+{
+   startTimer();
+loop:
+   __asm__("STA %b", ZP_MULT_Y_HI);
+   __asm__("EOR #$5A");
+   __asm__("STA %b", ZP_MULT_Y_LO);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   smult16();
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+   timer_stop();
+   printCycles();
+} // end of benchSmult16
+
+// Compares the result in A and X with ZP_BENCH_LO and ZP_BENCH_HI, and counts
+// the errors.
+static void __fastcall__ compare(void)
+{
+   __asm__("CMP %b", ZP_BENCH_LO);
+   __asm__("BNE %g", error);
+   __asm__("TXA");
+   __asm__("CMP %b", ZP_BENCH_HI);
+   __asm__("BNE %g", error);
+   __asm__("RTS");
+
+error:
+   __asm__("LDA %b", ZP_BENCH_ERR_LO);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_ERR_LO);
+   __asm__("LDA %b", ZP_BENCH_ERR_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_BENCH_ERR_HI);
+} // end of compare
+
+// Compares umult8() with umult(), and smult8() with smult(), for all 65536
+// pairs of operands. The number of errors is printed.
+static void __fastcall__ verify(void)
+{
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("STA %b", ZP_BENCH_J);
+   __asm__("STA %b", ZP_BENCH_ERR_LO);
+   __asm__("STA %b", ZP_BENCH_ERR_HI);
+
+loop:
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   umult();
+   __asm__("STA %b", ZP_BENCH_LO);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_BENCH_HI);
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   umult8();
+   compare();
+
+   // Skip (-128)*(-128)
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CMP #$80");
+   __asm__("BNE %g", doSigned);
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("CMP #$80");
+   __asm__("BEQ %g", next);
+
+doSigned:
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   smult();
+   __asm__("STA %b", ZP_BENCH_LO);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_BENCH_HI);
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_BENCH_I);
+   smult8();
+   compare();
+
+next:
+   __asm__("LDA %b", ZP_BENCH_J);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_J);
+   __asm__("BNE %g", loop);
+   __asm__("LDA %b", ZP_BENCH_I);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_BENCH_I);
+   __asm__("BNE %g", loop);
+
+   __asm__("LDA %b", ZP_BENCH_ERR_LO);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %b", ZP_BENCH_ERR_HI);
+   __asm__("STA %b", ZP_NUM_1);
+   printValue();
+} // end of verify
+
+// Entry point after CPU reset
+void __fastcall__ reset(void)
+{
+   __asm__("SEI");                           // Disable all interrupts
+   __asm__("LDX #$FF");
+   __asm__("TXS");                           // Reset stack pointer
+
+   // Configure text color
+   __asm__("LDA #%b", COL_LIGHT);
+   __asm__("STA %w",  VGA_ADDR_FGCOL);
+   __asm__("LDA #%b", COL_DARK);
+   __asm__("STA %w",  VGA_ADDR_BGCOL);
+
+   __asm__("LDA #%b", ' ');
+   disp_clear();
+   __asm__("LDA #%b", COL_WHITE);
+   disp_colour();
+   printText();
+
+   // Both smult() and the new routines use the same table.
+   mult_init();
+
+   __asm__("LDA #<%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + LABEL_POS_Y*40);
+   __asm__("STA %b", ZP_DST_HI);
+
+   benchEmpty();
+   benchUmult();
+   benchUmult8();
+   benchSmult();
+   benchSmult8();
+   benchUmult16();
+   benchSmult16();
+   verify();
+
+loop:
+   __asm__("JMP %g", loop);
+} // end of reset
+
+// Maskable interrupt
+void __fastcall__ irq(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of irq
+
+// Non-maskable interrupt
+void __fastcall__ nmi(void)
+{
+   // Not used.
+   __asm__("RTI");
+} // end of nmi
+
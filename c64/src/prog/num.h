@@ -0,0 +1,6 @@
+extern char div32_num[8];
+extern char div32_div[4];
+
+void __fastcall__ printDec16(void);
+void __fastcall__ printDec32(void);
+void __fastcall__ divide32(void);
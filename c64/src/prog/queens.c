@@ -1,10 +1,26 @@
 //
-// This solves the 8-queens problem.
+// This solves the N-queens problem, for N from 4 to 16.
+//
+// The search is the usual backtracking, one row at a time. The attacked
+// columns and diagonals are kept as bit masks (16 bits, stored as a low and
+// high byte), so the free squares in the next row are found with a few
+// logical operations, instead of comparing against every queen on the board.
+// For each row the remaining candidates are stored too, so the search can be
+// stopped and resumed after any step.
+//
+// The lowest candidate is removed with x & (x-1), and the difference is
+// the bit of the new queen. A table converts this bit to a column number.
+//
+// The search runs in the main loop. The IRQ just tells the main loop that a
+// new frame has started, so the display is only updated once every frame.
+// The time spent in the search is measured with the clock cycle counter.
 //
 
 #include "memorymap.h"
 #include "zeropage.h"   // Variables to be stored in the zero-page.
-#include "keyboard.h"
+#include "mem.h"
+#include "timer.h"
+#include "num.h"
 
 #define COL_WHITE       0xFFU   // 111_111_11
 #define COL_LIGHT       0x6FU   // 011_011_11
@@ -12,597 +28,595 @@
 #define COL_BLACK       0x00U   // 000_000_00
 #define COL_RED         0xE0U   // 111_000_00
 
-#define HELP_POS_X      3
-#define HELP_POS_Y      11
+#define PANEL_X         18
+#define VALUE_X         (PANEL_X+10)
+#define LABEL_POS_Y     2
+#define HELP_POS_Y      9
 
 #define KEY_STEP        0x1B   // 's'
 #define KEY_MODE        0x3A   // 'm'
+#define KEY_SIZE        0x31   // 'n'
+
+#define SIZE_MIN        4
+#define SIZE_MAX        16
+
+// Return values from step()
+#define STEP_PLACED     0
+#define STEP_SOLUTION   1
+#define STEP_DONE       2
 
 // Constants
-static const char strHelp1[] = "Press S to step.";
-static const char strHelp2[] = "Press M to change step mode.";
-static const char strMode[]  = "Current step mode is: ";
+static const char strTitle[]  = "N-Queens";
+static const char strLabels[] = "Size:     Mode:     Solutions:Steps:    Cycles:   Cyc/sol:  ";
+static const char strHelp[]   = "S: Step    M: Mode    N: Size    ";
+static const char strOverflow[] = "  Overflow  Overflow";   // Cycles and Cyc/sol
 static const char * const strModes[] = {
-   "Single.  ",
-   "Solution.",
-   "All.     ",
-   "Loop.    "};
+   "Single   ",
+   "Solution ",
+   "All      ",
+   "Loop     "};
 
 // Variables
 
-static char positions[8];
-static char curIndex;
-static char curLine;
+// State of the search, for each row.
+static char colsLo[SIZE_MAX];       // Attacked columns
+static char colsHi[SIZE_MAX];
+static char diagLLo[SIZE_MAX];      // Attacked diagonals, moving left
+static char diagLHi[SIZE_MAX];
+static char diagRLo[SIZE_MAX];      // Attacked diagonals, moving right
+static char diagRHi[SIZE_MAX];
+static char availLo[SIZE_MAX];      // Remaining candidates
+static char availHi[SIZE_MAX];
+static char positions[SIZE_MAX];    // Column of the queen
+
+static char bitIndex[129];          // Converts a single bit to its position
+
+// 32-bit counters, least significant byte first. The cycle counter has a
+// fifth byte, so it is 40 bits.
+static char counters[13];
+#define CNT_SOLUTIONS   0
+#define CNT_STEPS       4
+#define CNT_CYCLES      8
 
-static char countLo;
-static char countHi;
-static char solutions;
 static char stepMode;
 #define STEP_MODE_SINGLE   0
 #define STEP_MODE_SOLUTION 1
 #define STEP_MODE_ALL      2
 #define STEP_MODE_LOOP     3
 
+static char running;
+static char finished;
 static char irqA;
-static char irqX;
-static char lastKey; 
-
-static char tempLo;
-static char tempHi;
-static char temp;
+static char lastKey;
+static char released;
 
-static void __fastcall__ my_memcpy(void)
+// Copies a block of text to the screen. The block has X lines, each of
+// ZP_QUEENS_TEMP characters.
+static void __fastcall__ printBlock(void)
 {
 loop:
-   __asm__("DEY");
-   __asm__("LDA (%b),Y", ZP_SRC_LO);
-   __asm__("STA (%b),Y", ZP_DST_LO);
-   __asm__("TYA");
+   __asm__("LDA %b", ZP_QUEENS_TEMP);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA %b", ZP_SRC_LO);
+   __asm__("CLC");
+   __asm__("ADC %b", ZP_QUEENS_TEMP);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA %b", ZP_SRC_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_SRC_HI);
+
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
+   __asm__("DEX");
    __asm__("BNE %g", loop);
-} // end of my_memcpy
+} // end of printBlock
 
-static void __fastcall__ printHelp(void)
+static void __fastcall__ printText(void)
 {
-   __asm__("LDA #<%v", strHelp1);
-   __asm__("STA %w", ZP_SRC_LO);
-   __asm__("LDA #>%v", strHelp1);
-   __asm__("STA %w", ZP_SRC_HI);
-   __asm__("LDA #<%w", MEM_DISP + HELP_POS_Y*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_LO);
-   __asm__("LDA #>%w", MEM_DISP + HELP_POS_Y*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_HI);
-   __asm__("LDA #%b", sizeof(strHelp1)-1);
-   __asm__("TAY");
-   my_memcpy();
-
-   __asm__("LDA #<%v", strHelp2);
-   __asm__("STA %w", ZP_SRC_LO);
-   __asm__("LDA #>%v", strHelp2);
-   __asm__("STA %w", ZP_SRC_HI);
-   __asm__("LDA #<%w", MEM_DISP + (HELP_POS_Y+1)*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_LO);
-   __asm__("LDA #>%w", MEM_DISP + (HELP_POS_Y+1)*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_HI);
-   __asm__("LDA #%b", sizeof(strHelp2)-1);
-   __asm__("TAY");
-   my_memcpy();
-
-} // end of printHelp
+   __asm__("LDA #<%v", strTitle);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strTitle);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + PANEL_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + PANEL_X);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #%b", sizeof(strTitle)-1);
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("LDX #$01");
+   printBlock();
+
+   __asm__("LDA #<%v", strLabels);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strLabels);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + LABEL_POS_Y*40 + PANEL_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + LABEL_POS_Y*40 + PANEL_X);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$0A");
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("LDX #$06");
+   printBlock();
+
+   __asm__("LDA #<%v", strHelp);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strHelp);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + HELP_POS_Y*40 + PANEL_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + HELP_POS_Y*40 + PANEL_X);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$0B");
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("LDX #$03");
+   printBlock();
+} // end of printText
+
+static void __fastcall__ printSize(void)
+{
+   __asm__("LDA %b", ZP_QUEENS_SIZE);
+   __asm__("CMP #$0A");
+   __asm__("BCC %g", small);
+   __asm__("SBC #$0A");
+   __asm__("TAX");
+   __asm__("LDA #%b", '1');
+   __asm__("JMP %g", tens);
+small:
+   __asm__("TAX");
+   __asm__("LDA #%b", ' ');
+tens:
+   __asm__("STA %w", MEM_DISP + LABEL_POS_Y*40 + VALUE_X);
+   __asm__("TXA");
+   __asm__("CLC");
+   __asm__("ADC #%b", '0');
+   __asm__("STA %w", MEM_DISP + LABEL_POS_Y*40 + VALUE_X + 1);
+} // end of printSize
 
 static void __fastcall__ printStepMode(void)
 {
-   __asm__("LDA #<%v", strMode);
-   __asm__("STA %w", ZP_SRC_LO);
-   __asm__("LDA #>%v", strMode);
-   __asm__("STA %w", ZP_SRC_HI);
-   __asm__("LDA #<%w", MEM_DISP + (HELP_POS_Y+2)*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_LO);
-   __asm__("LDA #>%w", MEM_DISP + (HELP_POS_Y+2)*40 + HELP_POS_X);
-   __asm__("STA %w", ZP_DST_HI);
-   __asm__("LDA #%b", sizeof(strMode)-1);
-   __asm__("TAY");
-   my_memcpy();
-
    __asm__("LDA %v", stepMode);
    __asm__("CLC");
    __asm__("ROL A");
    __asm__("TAX");
    __asm__("LDA %v,X", strModes);
-   __asm__("STA %w", ZP_SRC_LO);
+   __asm__("STA %b", ZP_SRC_LO);
    __asm__("INX");
    __asm__("LDA %v,X", strModes);
-   __asm__("STA %w", ZP_SRC_HI);
-   __asm__("LDA #<%w", MEM_DISP + (HELP_POS_Y+2)*40 + HELP_POS_X + sizeof(strMode)-1);
-   __asm__("STA %w", ZP_DST_LO);
-   __asm__("LDA #>%w", MEM_DISP + (HELP_POS_Y+2)*40 + HELP_POS_X + sizeof(strMode)-1);
-   __asm__("STA %w", ZP_DST_HI);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + (LABEL_POS_Y+1)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + (LABEL_POS_Y+1)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_HI);
    __asm__("LDA #%b", 9);
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 } // end of printStepMode
 
-static void __fastcall__ clearScreen(void)
+static void __fastcall__ printBoard(void)
 {
-   // Clear the screen
-   __asm__("LDA #<%w", MEM_DISP); 
-   __asm__("STA %b", ZP_DST_LO); 
-   __asm__("LDA #>%w", MEM_DISP); 
-   __asm__("STA %b", ZP_DST_HI); 
-   __asm__("LDA #$00"); 
-   __asm__("TAY"); 
-clear2:
-   __asm__("LDA #$20"); 
-clear1:
-   __asm__("STA (%b),Y", ZP_DST_LO); 
-   __asm__("INY"); 
-   __asm__("BNE %g", clear1); 
-   __asm__("LDA %b", ZP_DST_HI); 
-   __asm__("CLC"); 
-   __asm__("ADC #$01"); 
-   __asm__("STA %b", ZP_DST_HI); 
-   __asm__("CMP #>%w", MEM_DISP+4*256); 
-   __asm__("BNE %g", clear2); 
-} // end of clearScreen
-
-static void __fastcall__ clearColours(void)
-{
-   // Clear the screen
-   __asm__("LDA #<%w", MEM_COL); 
-   __asm__("STA %b", ZP_DST_LO); 
-   __asm__("LDA #>%w", MEM_COL); 
-   __asm__("STA %b", ZP_DST_HI); 
-   __asm__("LDA #$00"); 
-   __asm__("TAY"); 
-clear2:
-   __asm__("LDA #%b", COL_WHITE); 
-clear1:
-   __asm__("STA (%b),Y", ZP_DST_LO); 
-   __asm__("INY"); 
-   __asm__("BNE %g", clear1); 
-   __asm__("LDA %b", ZP_DST_HI); 
-   __asm__("CLC"); 
-   __asm__("ADC #$01"); 
-   __asm__("STA %b", ZP_DST_HI); 
-   __asm__("CMP #>%w", MEM_COL+4*256); 
-   __asm__("BNE %g", clear2); 
-} // end of clearColours
-
-static void printBoard()
-{
-   __asm__("LDA #$00"); 
-   __asm__("STA %v", curLine); 
-   __asm__("LDA #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA #$80"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
+   __asm__("LDA #<%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDX #$00");
 
 loop:
-   __asm__("LDA #$07"); 
-   __asm__("TAY"); 
-   __asm__("LDA #%b", '.'); 
+   __asm__("LDA %b", ZP_QUEENS_SIZE);
+   __asm__("TAY");
+   __asm__("DEY");
+   __asm__("LDA #%b", '.');
 loop2:
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-   __asm__("DEY"); 
-   __asm__("BPL %g", loop2); 
-
-   __asm__("LDA %v", curLine); 
-   __asm__("CMP %v", curIndex); 
-   __asm__("BEQ %g", thisRow); 
-   __asm__("TAX"); 
-   __asm__("LDA %v,X", positions); 
-   __asm__("TAY"); 
-   __asm__("LDA #%b", 'o'); 
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-   __asm__("JMP %g", nextRow); 
-
-thisRow:
-   __asm__("TAX"); 
-   __asm__("LDA %v,X", positions); 
-   __asm__("TAY"); 
-   __asm__("LDA #%b", 'O'); 
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-
-nextRow:
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-
-   __asm__("LDA %v", curLine); 
-   __asm__("CLC"); 
-   __asm__("ADC #$01"); 
-   __asm__("STA %v", curLine); 
-   __asm__("CMP #$08"); 
-   __asm__("BNE %g", loop); 
-
-} // end of printBoard
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEY");
+   __asm__("BPL %g", loop2);
 
-static void printIllegal()
-{
-   __asm__("LDA %v", curIndex);
-   __asm__("CMP #$08");
-   __asm__("BNE %g", cont);
-   __asm__("RTS");
+   // Only rows above ZP_QUEENS_PLACED have a queen.
+   __asm__("TXA");
+   __asm__("CMP %b", ZP_QUEENS_PLACED);
+   __asm__("BCS %g", nextRow);
 
-cont:
-   __asm__("TAX");
    __asm__("LDA %v,X", positions);
    __asm__("TAY");
-checkLegal:
-   __asm__("DEX");
-   __asm__("BMI %g", checkDiagonal);
-   __asm__("CMP %v,X", positions);
-   __asm__("BNE %g", checkLegal);
-   // Illegal vertical. Register 'X' contains the top row, register 'Y' contains the column.
-   __asm__("LDA #<%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA #>%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("STX %v", temp);
    __asm__("TXA");
-   __asm__("BEQ %g", draw);
-nextRow:
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("DEX");
-   __asm__("BNE %g", nextRow);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("CMP %b", ZP_QUEENS_PLACED);
+   __asm__("BEQ %g", lastRow);
+   __asm__("LDA #%b", 'o');
+   __asm__("JMP %g", draw);
+lastRow:
+   __asm__("LDA #%b", 'O');
 draw:
-   __asm__("LDA %v", temp);
-   __asm__("TAX");
-colRow:
-   __asm__("LDA #%b", COL_RED);
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
+   __asm__("STA (%b),Y", ZP_DST_LO);
+
+nextRow:
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+
    __asm__("INX");
    __asm__("TXA");
-   __asm__("CMP %v", curIndex);
-   __asm__("BCC %g", colRow);
-   __asm__("BEQ %g", colRow);
+   __asm__("CMP %b", ZP_QUEENS_SIZE);
+   __asm__("BNE %g", loop);
+} // end of printBoard
 
-checkDiagonal:
-   __asm__("LDA %v", curIndex);
+// Copies the counter at offset X to ZP_NUM.
+static void __fastcall__ loadNumber(void)
+{
+   __asm__("LDA %v,X", counters);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %v+1,X", counters);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("LDA %v+2,X", counters);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("LDA %v+3,X", counters);
+   __asm__("STA %b", ZP_NUM_3);
+} // end of loadNumber
+
+static void __fastcall__ printNumbers(void)
+{
+   // Solutions, steps, and cycles are printed on consecutive lines.
+   __asm__("LDA #<%w", MEM_DISP + (LABEL_POS_Y+2)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + (LABEL_POS_Y+2)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$00");
+loop:
+   __asm__("STA %b", ZP_QUEENS_TEMP);
    __asm__("TAX");
-   __asm__("LDA %v,X", positions);
-checkLegal2:
-   __asm__("DEX");
-   __asm__("BMI %g", checkDiagonal2);
-   __asm__("SEC");
-   __asm__("SBC #$01");
-   __asm__("CMP %v,X", positions);
-   __asm__("BNE %g", checkLegal2);
+   loadNumber();
+   __asm__("LDA #$00");
    __asm__("TAY");
-   // Illegal Diagonal. Register 'X' contains the top row, register 'Y' contains the top column.
-   __asm__("LDA #<%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA #>%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("STX %v", temp);
-   __asm__("TXA");
-   __asm__("BEQ %g", draw2);
-nextRow2:
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("DEX");
-   __asm__("BNE %g", nextRow2);
-draw2:
-   __asm__("LDA %v", temp);
-   __asm__("TAX");
-colRow2:
-   __asm__("LDA #%b", COL_RED);
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("INX");
-   __asm__("INY");
-   __asm__("TXA");
-   __asm__("CMP %v", curIndex);
-   __asm__("BCC %g", colRow2);
-   __asm__("BEQ %g", colRow2);
+   printDec32();
+   __asm__("LDA %b", ZP_DST_LO);
+   __asm__("CLC");
+   __asm__("ADC #$28");
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA %b", ZP_DST_HI);
+   __asm__("ADC #$00");
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA %b", ZP_QUEENS_TEMP);
+   __asm__("CLC");
+   __asm__("ADC #$04");
+   __asm__("CMP #$0C");
+   __asm__("BNE %g", loop);
 
-checkDiagonal2:
-   __asm__("LDA %v", curIndex);
-   __asm__("TAX");
-   __asm__("LDA %v,X", positions);
-checkLegal3:
+   // Cycles per solution. This is zero, until the first solution is found.
+   __asm__("LDX #$03");
+copy:
+   __asm__("LDA %v+8,X", counters);
+   __asm__("STA %v,X", div32_num);
+   __asm__("LDA %v,X", counters);
+   __asm__("STA %v,X", div32_div);
    __asm__("DEX");
-   __asm__("BMI %g", end);
-   __asm__("CLC");
-   __asm__("ADC #$01");
-   __asm__("CMP %v,X", positions);
-   __asm__("BNE %g", checkLegal3);
+   __asm__("BPL %g", copy);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("STA %b", ZP_NUM_3);
+   __asm__("LDA %v", counters);
+   __asm__("BNE %g", divide);
+   __asm__("LDA %v+1", counters);
+   __asm__("BNE %g", divide);
+   __asm__("LDA %v+2", counters);
+   __asm__("BNE %g", divide);
+   __asm__("LDA %v+3", counters);
+   __asm__("BEQ %g", print);
+divide:
+   divide32();
+   __asm__("LDA %v", div32_num);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %v+1", div32_num);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("LDA %v+2", div32_num);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("LDA %v+3", div32_num);
+   __asm__("STA %b", ZP_NUM_3);
+print:
+   __asm__("LDA #$00");
    __asm__("TAY");
-   // Illegal Diagonal. Register 'X' contains the top row, register 'Y' contains the top column.
-   __asm__("LDA #<%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA #>%w", MEM_COL); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("STX %v", temp);
-   __asm__("TXA");
-   __asm__("BEQ %g", draw3);
-nextRow3:
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("DEX");
-   __asm__("BNE %g", nextRow3);
-draw3:
-   __asm__("LDA %v", temp);
-   __asm__("TAX");
-colRow3:
-   __asm__("LDA #%b", COL_RED);
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_LO); 
-   __asm__("CLC"); 
-   __asm__("ADC #$28"); 
-   __asm__("STA %b", ZP_SCREEN_POS_LO); 
-   __asm__("LDA %b", ZP_SCREEN_POS_HI); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %b", ZP_SCREEN_POS_HI); 
-   __asm__("INX");
-   __asm__("DEY");
-   __asm__("TXA");
-   __asm__("CMP %v", curIndex);
-   __asm__("BCC %g", colRow3);
-   __asm__("BEQ %g", colRow3);
+   printDec32();
 
-end:
+   // Ten digits are only enough for 32 bits.
+   __asm__("LDA %v+12", counters);
+   __asm__("BNE %g", overflow);
    __asm__("RTS");
-} // end of printIllegal
-
-// Prints a value in register 'A' as a three-digit decimal number
-static void printOneByteDec()
+overflow:
+   __asm__("LDA #<%v", strOverflow);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", strOverflow);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #<%w", MEM_DISP + (LABEL_POS_Y+4)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", MEM_DISP + (LABEL_POS_Y+4)*40 + VALUE_X);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #$0A");
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("LDX #$02");
+   printBlock();
+} // end of printNumbers
+
+static void __fastcall__ redraw(void)
 {
-   __asm__("LDX #$30"); 
-doHundreds:
-   __asm__("CMP #100"); 
-   __asm__("BCC %g", storeHundreds); 
-   __asm__("SBC #100"); 
-   __asm__("INX"); 
-   __asm__("JMP %g", doHundreds); 
-storeHundreds:
-   __asm__("STX %w", MEM_DISP+12); 
-
-   __asm__("LDX #$30"); 
-doTens:
-   __asm__("CMP #10"); 
-   __asm__("BCC %g", storeTens); 
-   __asm__("SBC #10"); 
-   __asm__("INX"); 
-   __asm__("JMP %g", doTens); 
-storeTens:
-   __asm__("STX %w", MEM_DISP+13); 
-
-   __asm__("CLC"); 
-   __asm__("ADC #$30"); 
-   __asm__("STA %w", MEM_DISP+14); 
-
-} // end of printOneByteDec
-
-// Prints a two-byte value (MSB in register 'X' and LSB in register 'A') as a five-digit decimal number
-static void printTwoByteDec()
-{
-   __asm__("STA %v", tempLo); 
-   __asm__("STX %v", tempHi); 
-
-   __asm__("LDX #$30"); 
-doTenThousands:
-   __asm__("LDA %v", tempLo); 
-   __asm__("SEC"); 
-   __asm__("SBC #<%w", 10000); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("SBC #>%w", 10000); 
-   __asm__("STA %v", tempHi); 
-   __asm__("INX"); 
-   __asm__("BCS %g", doTenThousands); 
-   __asm__("DEX"); 
-   __asm__("STX %w", MEM_DISP+50); 
-   __asm__("LDA %v", tempLo); 
-   __asm__("CLC"); 
-   __asm__("ADC #<%w", 10000); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("ADC #>%w", 10000); 
-   __asm__("STA %v", tempHi); 
-
-   __asm__("LDX #$30"); 
-doThousands:
-   __asm__("LDA %v", tempLo); 
-   __asm__("SEC"); 
-   __asm__("SBC #<%w", 1000); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("SBC #>%w", 1000); 
-   __asm__("STA %v", tempHi); 
-   __asm__("INX"); 
-   __asm__("BCS %g", doThousands); 
-   __asm__("DEX"); 
-   __asm__("STX %w", MEM_DISP+51); 
-   __asm__("LDA %v", tempLo); 
-   __asm__("CLC"); 
-   __asm__("ADC #<%w", 1000); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("ADC #>%w", 1000); 
-   __asm__("STA %v", tempHi); 
-
-   __asm__("LDX #$30"); 
-doHundreds:
-   __asm__("LDA %v", tempLo); 
-   __asm__("SEC"); 
-   __asm__("SBC #<%w", 100); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("SBC #>%w", 100); 
-   __asm__("STA %v", tempHi); 
-   __asm__("INX"); 
-   __asm__("BCS %g", doHundreds); 
-   __asm__("DEX"); 
-   __asm__("STX %w", MEM_DISP+52); 
-   __asm__("LDA %v", tempLo); 
-   __asm__("CLC"); 
-   __asm__("ADC #<%w", 100); 
-   __asm__("STA %v", tempLo); 
-   __asm__("LDA %v", tempHi); 
-   __asm__("ADC #>%w", 100); 
-   __asm__("STA %v", tempHi); 
-
-   // At this point, tempHi is zero.
-   __asm__("LDA %v", tempLo); 
-   __asm__("LDX #$30"); 
-doTens:
-   __asm__("CMP #10"); 
-   __asm__("BCC %g", storeTens); 
-   __asm__("SBC #10"); 
-   __asm__("INX"); 
-   __asm__("JMP %g", doTens); 
-storeTens:
-   __asm__("STX %w", MEM_DISP+53); 
-
-   __asm__("CLC"); 
-   __asm__("ADC #$30"); 
-   __asm__("STA %w", MEM_DISP+54); 
-
-} // end of printTwoByteDec
-
-static void updateBoard()
-{
-   // Is it legal
-   __asm__("LDA %v", curIndex);
-   __asm__("CMP #$08");
-   __asm__("BNE %g", checkVertical);
-   __asm__("LDA #$07");
-   __asm__("STA %v", curIndex);
-   __asm__("JMP %g", next);
+   __asm__("LDA #%b", ' ');
+   disp_clear();
+   printText();
+   printSize();
+   printStepMode();
+   printBoard();
+   printNumbers();
+} // end of redraw
 
-checkVertical:
+// Clears the board, and prepares the first row.
+static void __fastcall__ newBoard(void)
+{
+   // Make a mask with one bit for each column.
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_QUEENS_FULL_LO);
+   __asm__("STA %b", ZP_QUEENS_FULL_HI);
+   __asm__("LDA %b", ZP_QUEENS_SIZE);
    __asm__("TAX");
-   __asm__("LDA %v,X", positions);
-checkLegal:
+loop:
+   __asm__("SEC");
+   __asm__("LDA %b", ZP_QUEENS_FULL_LO);
+   __asm__("ROL A");
+   __asm__("STA %b", ZP_QUEENS_FULL_LO);
+   __asm__("LDA %b", ZP_QUEENS_FULL_HI);
+   __asm__("ROL A");
+   __asm__("STA %b", ZP_QUEENS_FULL_HI);
    __asm__("DEX");
-   __asm__("BMI %g", checkDiagonal);
-   __asm__("CMP %v,X", positions);
-   __asm__("BEQ %g", next);
-   __asm__("JMP %g", checkLegal);
+   __asm__("BNE %g", loop);
 
-checkDiagonal:
-   __asm__("LDA %v", curIndex);
-   __asm__("TAX");
-   __asm__("LDA %v,X", positions);
-checkLegal2:
-   __asm__("DEX");
-   __asm__("BMI %g", checkDiagonal2);
-   __asm__("SEC");
-   __asm__("SBC #$01");
-   __asm__("CMP %v,X", positions);
-   __asm__("BEQ %g", next);
-   __asm__("JMP %g", checkLegal2);
+   __asm__("LDA #$00");
+   __asm__("STA %v", colsLo);
+   __asm__("STA %v", colsHi);
+   __asm__("STA %v", diagLLo);
+   __asm__("STA %v", diagLHi);
+   __asm__("STA %v", diagRLo);
+   __asm__("STA %v", diagRHi);
+   __asm__("STA %b", ZP_QUEENS_ROW);
+   __asm__("STA %b", ZP_QUEENS_PLACED);
+   __asm__("LDA %b", ZP_QUEENS_FULL_LO);
+   __asm__("STA %v", availLo);
+   __asm__("LDA %b", ZP_QUEENS_FULL_HI);
+   __asm__("STA %v", availHi);
+} // end of newBoard
+
+static void __fastcall__ newSearch(void)
+{
+   newBoard();
 
-checkDiagonal2:
-   __asm__("LDA %v", curIndex);
-   __asm__("TAX");
-   __asm__("LDA %v,X", positions);
-checkLegal3:
+   __asm__("LDA #$00");
+   __asm__("STA %v", finished);
+   __asm__("LDX #%b", sizeof(counters)-1);
+loop:
+   __asm__("STA %v,X", counters);
    __asm__("DEX");
-   __asm__("BMI %g", legal);
+   __asm__("BPL %g", loop);
+} // end of newSearch
+
+// Adds the cycles since timer_start() to the total. The total is 40 bits, so
+// it does not wrap around until after about 6 hours of searching.
+static void __fastcall__ stopTimer(void)
+{
+   timer_stop();
    __asm__("CLC");
+   __asm__("LDA %v+8", counters);
+   __asm__("ADC %b", ZP_NUM_0);
+   __asm__("STA %v+8", counters);
+   __asm__("LDA %v+9", counters);
+   __asm__("ADC %b", ZP_NUM_1);
+   __asm__("STA %v+9", counters);
+   __asm__("LDA %v+10", counters);
+   __asm__("ADC %b", ZP_NUM_2);
+   __asm__("STA %v+10", counters);
+   __asm__("LDA %v+11", counters);
+   __asm__("ADC %b", ZP_NUM_3);
+   __asm__("STA %v+11", counters);
+   __asm__("LDA %v+12", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+12", counters);
+} // end of stopTimer
+
+// Takes one step in the search: Either a queen is placed in the current row,
+// or the search goes back one row. Returns STEP_PLACED, STEP_SOLUTION, or
+// STEP_DONE in A.
+static void __fastcall__ step(void)
+{
+   __asm__("CLC");
+   __asm__("LDA %v+4", counters);
    __asm__("ADC #$01");
-   __asm__("CMP %v,X", positions);
-   __asm__("BEQ %g", next);
-   __asm__("JMP %g", checkLegal3);
+   __asm__("STA %v+4", counters);
+   __asm__("BCC %g", counted);
+   __asm__("LDA %v+5", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+5", counters);
+   __asm__("BCC %g", counted);
+   __asm__("LDA %v+6", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+6", counters);
+   __asm__("BCC %g", counted);
+   __asm__("LDA %v+7", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+7", counters);
+
+counted:
+   __asm__("LDA %b", ZP_QUEENS_ROW);
+   __asm__("TAX");
+   __asm__("LDA %v,X", availLo);
+   __asm__("BEQ %g", tryHi);
 
-goBack:
-   __asm__("LDA #$00");
+   // Take the lowest candidate in columns 0-7.
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("TAY");
+   __asm__("DEY");
+   __asm__("TYA");
+   __asm__("AND %b", ZP_QUEENS_TEMP);
+   __asm__("STA %v,X", availLo);
+   __asm__("EOR %b", ZP_QUEENS_TEMP);
+   __asm__("STA %b", ZP_QUEENS_BIT_LO);
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_QUEENS_INDEX_LO);
    __asm__("STA %v,X", positions);
-   __asm__("LDA %v", curIndex);
-   __asm__("SEC");
-   __asm__("SBC #$01");
-   __asm__("STA %v", curIndex);
-   __asm__("BPL %g", next);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_QUEENS_BIT_HI);
+   __asm__("JMP %g", place);
 
-   __asm__("LDA %v", stepMode);
-   __asm__("CMP #%b", STEP_MODE_ALL);
-   __asm__("BEQ %g", stop);
+tryHi:
+   __asm__("LDA %v,X", availHi);
+   __asm__("BEQ %g", backtrack);
 
+   // Take the lowest candidate in columns 8-15.
+   __asm__("STA %b", ZP_QUEENS_TEMP);
+   __asm__("TAY");
+   __asm__("DEY");
+   __asm__("TYA");
+   __asm__("AND %b", ZP_QUEENS_TEMP);
+   __asm__("STA %v,X", availHi);
+   __asm__("EOR %b", ZP_QUEENS_TEMP);
+   __asm__("STA %b", ZP_QUEENS_BIT_HI);
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_QUEENS_INDEX_LO);
+   __asm__("CLC");
+   __asm__("ADC #$08");
+   __asm__("STA %v,X", positions);
    __asm__("LDA #$00");
-   __asm__("STA %v", curIndex);
-   __asm__("RTS");
+   __asm__("STA %b", ZP_QUEENS_BIT_LO);
 
-legal:
-   __asm__("LDA %v", curIndex);
+place:
+   __asm__("TXA");
    __asm__("CLC");
    __asm__("ADC #$01");
-   __asm__("STA %v", curIndex);
-   __asm__("CMP #$08");
-   __asm__("BEQ %g", found);
-   __asm__("JMP %g", finished);
+   __asm__("CMP %b", ZP_QUEENS_SIZE);
+   __asm__("BEQ %g", solution);
+   __asm__("STA %b", ZP_QUEENS_ROW);
+   __asm__("STA %b", ZP_QUEENS_PLACED);
+
+   // Calculate the attacked squares in the next row. The diagonals move one
+   // column for each row.
+   __asm__("LDA %v,X", colsLo);
+   __asm__("ORA %b", ZP_QUEENS_BIT_LO);
+   __asm__("STA %v+1,X", colsLo);
+   __asm__("STA %b", ZP_QUEENS_OCC_LO);
+   __asm__("LDA %v,X", colsHi);
+   __asm__("ORA %b", ZP_QUEENS_BIT_HI);
+   __asm__("STA %v+1,X", colsHi);
+   __asm__("STA %b", ZP_QUEENS_OCC_HI);
+
+   __asm__("LDA %v,X", diagLLo);
+   __asm__("ORA %b", ZP_QUEENS_BIT_LO);
+   __asm__("ASL A");
+   __asm__("STA %v+1,X", diagLLo);
+   __asm__("ORA %b", ZP_QUEENS_OCC_LO);
+   __asm__("STA %b", ZP_QUEENS_OCC_LO);
+   __asm__("LDA %v,X", diagLHi);
+   __asm__("ORA %b", ZP_QUEENS_BIT_HI);
+   __asm__("ROL A");
+   __asm__("STA %v+1,X", diagLHi);
+   __asm__("ORA %b", ZP_QUEENS_OCC_HI);
+   __asm__("STA %b", ZP_QUEENS_OCC_HI);
 
-next:
-   // Increment current row
-   __asm__("LDA %v", curIndex);
-   __asm__("TAX");
-   __asm__("LDA %v,X", positions);
+   __asm__("LDA %v,X", diagRHi);
+   __asm__("ORA %b", ZP_QUEENS_BIT_HI);
    __asm__("CLC");
-   __asm__("ADC #$01");
-   __asm__("STA %v,X", positions);
-
-   // Is it overflowed
-   __asm__("CMP #$08");
-   __asm__("BEQ %g", goBack);
+   __asm__("ROR A");
+   __asm__("STA %v+1,X", diagRHi);
+   __asm__("ORA %b", ZP_QUEENS_OCC_HI);
+   __asm__("EOR #$FF");
+   __asm__("AND %b", ZP_QUEENS_FULL_HI);
+   __asm__("STA %v+1,X", availHi);
+   __asm__("LDA %v,X", diagRLo);
+   __asm__("ORA %b", ZP_QUEENS_BIT_LO);
+   __asm__("ROR A");
+   __asm__("STA %v+1,X", diagRLo);
+   __asm__("ORA %b", ZP_QUEENS_OCC_LO);
+   __asm__("EOR #$FF");
+   __asm__("AND %b", ZP_QUEENS_FULL_LO);
+   __asm__("STA %v+1,X", availLo);
+
+   __asm__("LDA #%b", STEP_PLACED);
+   __asm__("RTS");
 
-finished:
-   __asm__("LDA %v", stepMode);
-   __asm__("CMP #%b", STEP_MODE_SINGLE);
-   __asm__("BEQ %g", stop);
+solution:
+   __asm__("STA %b", ZP_QUEENS_PLACED);
+   __asm__("CLC");
+   __asm__("LDA %v", counters);
+   __asm__("ADC #$01");
+   __asm__("STA %v", counters);
+   __asm__("LDA %v+1", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+1", counters);
+   __asm__("LDA %v+2", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+2", counters);
+   __asm__("LDA %v+3", counters);
+   __asm__("ADC #$00");
+   __asm__("STA %v+3", counters);
+   __asm__("LDA #%b", STEP_SOLUTION);
    __asm__("RTS");
 
-stop:
-   // Stop the search, by preventing any further IRQ
-   __asm__("LDA #$00"); 
-   __asm__("STA %w", VGA_ADDR_MASK);
+backtrack:
+   __asm__("DEX");
+   __asm__("BMI %g", done);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_QUEENS_ROW);
+   __asm__("STA %b", ZP_QUEENS_PLACED);
+   __asm__("LDA #%b", STEP_PLACED);
    __asm__("RTS");
 
-found:
-   __asm__("LDA %v", solutions); 
-   __asm__("CLC"); 
-   __asm__("ADC #$01"); 
-   __asm__("STA %v", solutions); 
-   printOneByteDec();
+done:
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_QUEENS_PLACED);
+   __asm__("LDA #%b", STEP_DONE);
+} // end of step
 
-   __asm__("LDA %v", stepMode);
-   __asm__("CMP #%b", STEP_MODE_SOLUTION);
-   __asm__("BEQ %g", stop);
+// Returns in A the scan code of a key just pressed, or zero. Keys held down
+// are only reported once.
+static void __fastcall__ readKey(void)
+{
+   __asm__("LDA %w", VGA_KEY);              // Pop data from keyboard fifo
+   __asm__("BEQ %g", none);
+   __asm__("CMP #$F0");
+   __asm__("BEQ %g", release);
+   __asm__("CMP #$E0");                     // Ignore extended keys
+   __asm__("BEQ %g", none);
+   __asm__("CMP #$AA");                     // Ignore initialization code
+   __asm__("BEQ %g", none);
+   __asm__("TAX");
+   __asm__("LDA %v", released);
+   __asm__("BNE %g", up);
+   __asm__("TXA");
+   __asm__("CMP %v", lastKey);
+   __asm__("BEQ %g", none);
+   __asm__("STA %v", lastKey);
+   __asm__("RTS");
 
+up:
+   __asm__("LDA #$00");
+   __asm__("STA %v", released);
+   __asm__("STA %v", lastKey);
    __asm__("RTS");
-} // end of updateBoard
+
+release:
+   __asm__("LDA #$01");
+   __asm__("STA %v", released);
+none:
+   __asm__("LDA #$00");
+} // end of readKey
 
 // Entry point after CPU reset
 void __fastcall__ reset(void)
@@ -617,108 +631,157 @@ void __fastcall__ reset(void)
    __asm__("LDA #%b", COL_DARK);
    __asm__("STA %w",  VGA_ADDR_BGCOL);
 
-   // Clear the board
-   __asm__("LDA #$00");
-   __asm__("LDX #$07");
-loop1:
-   __asm__("STA %v,X", positions);
-   __asm__("DEX");
-   __asm__("BPL %g", loop1);
-   __asm__("LDA #$00");
-   __asm__("STA %v", curIndex);
-   __asm__("STA %v", countLo);
-   __asm__("STA %v", countHi);
-   __asm__("STA %v", solutions);
+   // Fill in the table of bit positions.
+   __asm__("LDA #<%v", bitIndex);
+   __asm__("STA %b", ZP_QUEENS_INDEX_LO);
+   __asm__("LDA #>%v", bitIndex);
+   __asm__("STA %b", ZP_QUEENS_INDEX_HI);
+   __asm__("LDX #$00");
+   __asm__("LDA #$01");
+   __asm__("TAY");
+index:
+   __asm__("TXA");
+   __asm__("STA (%b),Y", ZP_QUEENS_INDEX_LO);
+   __asm__("INX");
+   __asm__("TYA");
+   __asm__("ASL A");
+   __asm__("TAY");
+   __asm__("BNE %g", index);
+
+   __asm__("LDA #$08");
+   __asm__("STA %b", ZP_QUEENS_SIZE);
    __asm__("LDA #%b", STEP_MODE_SINGLE);
    __asm__("STA %v", stepMode);
+   __asm__("LDA #$00");
+   __asm__("STA %v", running);
+   __asm__("STA %v", lastKey);
+   __asm__("STA %v", released);
+   __asm__("STA %b", ZP_QUEENS_FRAME);
+   newSearch();
 
-   clearScreen();
-   clearColours();
-   printHelp();
-   printStepMode();
-   printBoard();
-
-   __asm__("LDA %v", solutions); 
-   printOneByteDec();
-
-   __asm__("LDA %v", countHi); 
-   __asm__("TAX"); 
-   __asm__("LDA %v", countLo); 
-   printTwoByteDec();
+   __asm__("LDA #%b", COL_WHITE);
+   disp_colour();
+   redraw();
 
    // Configure VGA interrupt
-   __asm__("LDA #$E0"); 
+   __asm__("LDA #$E0");
    __asm__("STA %w", VGA_ADDR_YLINE);             // Set the interrupt at the end of the screen
    __asm__("LDA %w", VGA_ADDR_IRQ);
    __asm__("STA %w", VGA_ADDR_IRQ);               // Clear any pending IRQ
-   __asm__("CLI"); 
+   __asm__("LDA #$01");
+   __asm__("STA %w", VGA_ADDR_MASK);
+   __asm__("CLI");
 
-   // Any key-press will re-enable interrupt.
 loop:
-   readCurrentKey();
-   __asm__("BEQ %g", halt2); 
+   readKey();
+   __asm__("CMP #%b", KEY_STEP);
+   __asm__("BEQ %g", keyStep);
+   __asm__("CMP #%b", KEY_MODE);
+   __asm__("BEQ %g", keyMode);
+   __asm__("CMP #%b", KEY_SIZE);
+   __asm__("BEQ %g", keySize);
+
+run:
+   __asm__("LDA %v", running);
+   __asm__("BEQ %g", loop);
+
+   // Search until the next 256 steps are taken, or the search stops.
+   timer_start();
+batch:
+   step();
+   __asm__("BEQ %g", next);
+   __asm__("CMP #%b", STEP_SOLUTION);
+   __asm__("BEQ %g", found);
 
-   __asm__("CMP %v", lastKey); 
-   __asm__("BEQ %g", loop); 
-   __asm__("STA %v", lastKey); 
+   // The search is finished.
+   __asm__("LDA %v", stepMode);
+   __asm__("CMP #%b", STEP_MODE_LOOP);
+   __asm__("BNE %g", finish);
+   newBoard();
+   __asm__("JMP %g", next);
 
-   __asm__("CMP #%b", KEY_STEP); 
-   __asm__("BEQ %g", step); 
-   __asm__("CMP #%b", KEY_MODE); 
-   __asm__("BNE %g", loop); 
+found:
+   __asm__("LDA %v", stepMode);
+   __asm__("CMP #%b", STEP_MODE_SOLUTION);
+   __asm__("BEQ %g", stop);
 
-   // Change the stepping mode
+next:
+   __asm__("LDA %v", stepMode);
+   __asm__("CMP #%b", STEP_MODE_SINGLE);
+   __asm__("BEQ %g", stop);
+   __asm__("LDA %v+4", counters);
+   __asm__("BNE %g", batch);
+   stopTimer();
+
+   // Update the display once every frame.
+   __asm__("LDA %b", ZP_QUEENS_FRAME);
+   __asm__("BEQ %g", loop);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_QUEENS_FRAME);
+   printBoard();
+   printNumbers();
+   __asm__("JMP %g", loop);
+
+finish:
+   __asm__("LDA #$01");
+   __asm__("STA %v", finished);
+stop:
+   stopTimer();
+pause:
+   __asm__("LDA #$00");
+   __asm__("STA %v", running);
+   printBoard();
+   printNumbers();
+   __asm__("JMP %g", loop);
+
+keyStep:
+   __asm__("LDA %v", running);
+   __asm__("BNE %g", pause);
+   __asm__("LDA %v", finished);
+   __asm__("BEQ %g", start);
+   newSearch();
+start:
+   __asm__("LDA #$01");
+   __asm__("STA %v", running);
+   __asm__("JMP %g", loop);
+
+keyMode:
    __asm__("LDA %v", stepMode);
    __asm__("CLC");
-   __asm__("ADC #$01"); 
-   __asm__("AND #$03"); 
+   __asm__("ADC #$01");
+   __asm__("AND #$03");
    __asm__("STA %v", stepMode);
    printStepMode();
-   __asm__("JMP %g", loop); 
+   __asm__("JMP %g", run);
 
-step:
-   __asm__("LDA #$01"); 
-   __asm__("STA %w", VGA_ADDR_MASK);
-   __asm__("JMP %g", loop); 
-halt2:
-   __asm__("STA %v", lastKey); 
-   __asm__("JMP %g", loop); 
+keySize:
+   __asm__("LDA %v", running);
+   __asm__("BNE %g", run);
+   __asm__("LDA %b", ZP_QUEENS_SIZE);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("CMP #%b", SIZE_MAX+1);
+   __asm__("BNE %g", setSize);
+   __asm__("LDA #%b", SIZE_MIN);
+setSize:
+   __asm__("STA %b", ZP_QUEENS_SIZE);
+   newSearch();
+   redraw();
+   __asm__("JMP %g", loop);
 
 } // end of reset
 
-#define KEY_STEP        0x1B   // 's'
-#define KEY_MODE        0x3A   // 'm'
-
 // Maskable interrupt
 void __fastcall__ irq(void)
 {
    __asm__("STA %v", irqA);                        // Store register A
-   __asm__("TXA");
-   __asm__("STA %v", irqX);                        // Store register X
 
    __asm__("LDA %w", VGA_ADDR_IRQ);
    __asm__("STA %w", VGA_ADDR_IRQ);                // Clear any pending IRQ
 
-   updateBoard();
-   printBoard();
-   clearColours();
-   printIllegal();
-
-   __asm__("LDA %v", countLo); 
-   __asm__("CLC"); 
-   __asm__("ADC #$01"); 
-   __asm__("STA %v", countLo); 
-   __asm__("LDA %v", countHi); 
-   __asm__("ADC #$00"); 
-   __asm__("STA %v", countHi); 
-
-   __asm__("LDA %v", countHi); 
-   __asm__("TAX"); 
-   __asm__("LDA %v", countLo); 
-   printTwoByteDec();
-
-   __asm__("LDA %v", irqX);                        // Restore register X
-   __asm__("TAX");
+   __asm__("LDA #$01");
+   __asm__("STA %b", ZP_QUEENS_FRAME);
+
    __asm__("LDA %v", irqA);                        // Restore register A
    __asm__("RTI");
 } // end of irq
@@ -8,7 +8,8 @@
 #include "tennis_ball.h"
 #include "tennis_player.h"
 #include "tennis_ai.h"
-#include "smult.h"
+#include "mult.h"
+#include "mem.h"
 
 extern char ball_vx_lo;
 extern char ball_vx_hi;
@@ -69,27 +70,6 @@ static const char bitmap_wall[32] = {
    0x03, 0xC0,
    0x03, 0xC0};
 
-void __fastcall__ my_memcpy(void)
-{
-loop:
-   __asm__("DEY");
-   __asm__("LDA (%b),Y", ZP_SRC_LO);
-   __asm__("STA (%b),Y", ZP_DST_LO);
-   __asm__("TYA");
-   __asm__("BNE %g", loop);
-} // end of my_memcpy
-
-void __fastcall__ my_memset(void)
-{
-   __asm__("TAX");
-loop:
-   __asm__("DEY");
-   __asm__("TXA");
-   __asm__("STA (%b),Y", ZP_DST_LO);
-   __asm__("TYA");
-   __asm__("BNE %g", loop);
-} // end of my_memset
-
 static void __fastcall__ clearScreen(void)
 {
    // Clear the screen
@@ -132,7 +112,7 @@ void __fastcall__ vga_init(void)
    __asm__("STA %b", ZP_SRC_HI);
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 
    // Configure sprite 1 as the left player
    __asm__("LDA #<%w", VGA_ADDR_SPRITE_1_BITMAP);
@@ -145,7 +125,7 @@ void __fastcall__ vga_init(void)
    __asm__("STA %b", ZP_SRC_HI);
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 
    // Configure sprite 2 as the right player
    __asm__("LDA #<%w", VGA_ADDR_SPRITE_2_BITMAP);
@@ -158,7 +138,7 @@ void __fastcall__ vga_init(void)
    __asm__("STA %b", ZP_SRC_HI);
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 
    // Configure sprite 3 as the wall
    __asm__("LDA #<%w", VGA_ADDR_SPRITE_3_BITMAP);
@@ -171,7 +151,7 @@ void __fastcall__ vga_init(void)
    __asm__("STA %b", ZP_SRC_HI);
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 
    // Configure ball
    __asm__("LDA #<%w", WALL_XPOS/2);
@@ -229,7 +209,7 @@ void __fastcall__ reset(void)
    __asm__("LDX #$FF");
    __asm__("TXS");                           // Reset stack pointer
 
-   smult_init();
+   mult_init();
    clearScreen();
 
    // Initialize ball position and velocity
@@ -322,21 +302,27 @@ checkRightBounce:
    __asm__("STA %v", ball_vx_hi);
 
 checkCollisionPlayer:
-   __asm__("LDA %w", VGA_COLL);  // Read collision status
-   __asm__("AND #$03");
-   __asm__("CMP #$03");
-   __asm__("BNE %g", checkCollisionAi);
-
-   // Get players coordinates, and divide by 2.
-   __asm__("LDA %w", VGA_ADDR_SPRITE_1_X_MSB);
+   __asm__("LDA %w", VGA_COLL_PAIR);  // Read collision status
+   __asm__("AND #$01");               // Ball (0) and left player (1)
+   __asm__("BEQ %g", checkCollisionAi);
+
+   // The ball is reflected as if it hit a player centred on the contact
+   // point, i.e. in the direction from the contact point to the centre of
+   // the ball. Get the contact coordinates, subtract half a sprite, and
+   // divide by 2.
+   __asm__("LDA %w", VGA_ADDR_CONTACT_01+1);
    __asm__("ROR A");  // Move MSB to carry
-   __asm__("LDA %w", VGA_ADDR_SPRITE_1_X);
+   __asm__("LDA %w", VGA_ADDR_CONTACT_01);
    __asm__("ROR A");
+   __asm__("SEC");
+   __asm__("SBC #$04");
    __asm__("TAX");
 
-   __asm__("LDA %w", VGA_ADDR_SPRITE_1_Y);
+   __asm__("LDA %w", VGA_ADDR_CONTACT_01+2);
    __asm__("CLC");
    __asm__("ROR A");
+   __asm__("SEC");
+   __asm__("SBC #$04");
 
    ball_bounce();
 
@@ -358,21 +344,24 @@ loop:
 #endif
 
 checkCollisionAi:
-   __asm__("LDA %w", VGA_COLL);  // Read collision status
-   __asm__("AND #$05");
-   __asm__("CMP #$05");
-   __asm__("BNE %g", update);
+   __asm__("LDA %w", VGA_COLL_PAIR);  // Read collision status
+   __asm__("AND #$02");               // Ball (0) and right player (2)
+   __asm__("BEQ %g", update);
 
-   // Get AIs coordinates, and divide by 2.
-   __asm__("LDA %w", VGA_ADDR_SPRITE_2_X_MSB);
+   // Get the contact coordinates, as for the player.
+   __asm__("LDA %w", VGA_ADDR_CONTACT_02+1);
    __asm__("ROR A");  // Move MSB to carry
-   __asm__("LDA %w", VGA_ADDR_SPRITE_2_X);
+   __asm__("LDA %w", VGA_ADDR_CONTACT_02);
    __asm__("ROR A");
+   __asm__("SEC");
+   __asm__("SBC #$04");
    __asm__("TAX");
 
-   __asm__("LDA %w", VGA_ADDR_SPRITE_2_Y);
+   __asm__("LDA %w", VGA_ADDR_CONTACT_02+2);
    __asm__("CLC");
    __asm__("ROR A");
+   __asm__("SEC");
+   __asm__("SBC #$04");
 
    ball_bounce();
 
@@ -382,8 +371,8 @@ update:
    player_move();
 
    // Clear collision status
-   __asm__("LDA %w", VGA_COLL);
-   __asm__("STA %w", VGA_COLL); 
+   __asm__("LDA %w", VGA_COLL_PAIR);
+   __asm__("STA %w", VGA_COLL_PAIR);
 
    __asm__("RTI");
 } // end of irq
@@ -1,6 +1,6 @@
 #include "memorymap.h"
 #include "tennis.h"
-#include "smult.h"
+#include "mult.h"
 #include "zeropage.h"
 
 /* Coordinates and velocities are stored in 16 bit numbers in fixed-point
@@ -134,7 +134,7 @@ void __fastcall__ ball_rotate(void)
    __asm__("LDA %b", ZP_BALL_T3);   // A12
    __asm__("TAX");
    __asm__("LDA %b", ZP_BALL_T1);   // Vy
-   smult();
+   smult8();
    __asm__("STA %b", ZP_BALL_T4);   // Wx LSB
    __asm__("TXA");
    __asm__("STA %b", ZP_BALL_T5);   // Wx MSB
@@ -143,7 +143,7 @@ void __fastcall__ ball_rotate(void)
    __asm__("LDA %b", ZP_BALL_T2);   // A11
    __asm__("TAX");
    __asm__("LDA %b", ZP_BALL_T0);   // Vx
-   smult();
+   smult8();
    __asm__("ADC %b", ZP_BALL_T4);   // Wx LSB
    __asm__("STA %b", ZP_BALL_T4);
    __asm__("TXA");
@@ -154,7 +154,7 @@ void __fastcall__ ball_rotate(void)
    __asm__("LDA %b", ZP_BALL_T2);   // A11
    __asm__("TAX");
    __asm__("LDA %b", ZP_BALL_T1);   // Vy
-   smult();
+   smult8();
    __asm__("STA %b", ZP_BALL_T6);   // Wy LSB
    __asm__("TXA");
    __asm__("STA %b", ZP_BALL_T7);   // Wy MSB
@@ -163,7 +163,7 @@ void __fastcall__ ball_rotate(void)
    __asm__("LDA %b", ZP_BALL_T3);   // A12
    __asm__("TAX");
    __asm__("LDA %b", ZP_BALL_T0);   // Vx
-   smult();
+   smult8();
    __asm__("SBC %b", ZP_BALL_T6);   // Wy LSB
    __asm__("STA %b", ZP_BALL_T6);
    __asm__("TXA");
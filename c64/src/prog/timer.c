@@ -0,0 +1,47 @@
+/*
+ * Measures time with the clock cycle counter.
+ *
+ * Reading the least significant byte of the counter latches the upper
+ * bytes, so the four bytes are always read in increasing order.
+ *
+ * The decimal print routines are in dec16.c and dec32.c, and the division
+ * is in div32.c.
+ */
+
+#include "memorymap.h"
+#include "zeropage.h"
+
+static char startCycles[4];
+
+// Starts the clock cycle counter.
+void __fastcall__ timer_start(void)
+{
+   __asm__("LDA %w", VGA_ADDR_CYCLES);     // This latches the upper bytes
+   __asm__("STA %v", startCycles);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+1);
+   __asm__("STA %v+1", startCycles);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+2);
+   __asm__("STA %v+2", startCycles);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+3);
+   __asm__("STA %v+3", startCycles);
+} // end of timer_start
+
+// Stores the cycles since timer_start() in ZP_NUM.
+// X and Y are preserved.
+void __fastcall__ timer_stop(void)
+{
+   __asm__("SEC");
+   __asm__("LDA %w", VGA_ADDR_CYCLES);     // This latches the upper bytes
+   __asm__("SBC %v", startCycles);
+   __asm__("STA %b", ZP_NUM_0);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+1);
+   __asm__("SBC %v+1", startCycles);
+   __asm__("STA %b", ZP_NUM_1);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+2);
+   __asm__("SBC %v+2", startCycles);
+   __asm__("STA %b", ZP_NUM_2);
+   __asm__("LDA %w", VGA_ADDR_CYCLES+3);
+   __asm__("SBC %v+3", startCycles);
+   __asm__("STA %b", ZP_NUM_3);
+} // end of timer_stop
+
@@ -0,0 +1,2 @@
+void __fastcall__ timer_start(void);
+void __fastcall__ timer_stop(void);
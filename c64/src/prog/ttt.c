@@ -1,63 +1,84 @@
 //
 // This implements the Tic-Tac-Toe game.
 //
+// The game is played on a 3x3 board with the keys 1-9, or on a 4x4 board
+// with the keys 1234, QWER, ASDF, and ZXCV. N starts a new game, and B
+// changes the size of the board.
+//
+// After each move of the computer, the number of positions searched and the
+// number of positions searched per second are shown.
+//
 
 #include "memorymap.h"
 #include "zeropage.h"   // Variables to be stored in the zero-page.
-#include "keyboard.h"
 #include "ttt_vga.h"
+#include "mem.h"
 #include "ttt_ai.h"
+#include "num.h"
 
 #define COL_WHITE       0xFF   // 111_111_11
 #define COL_LIGHT       0x6E   // 011_011_10
 #define COL_DARK        0x24   // 001_001_00
 #define COL_BLACK       0x00   // 000_000_00
 
+#define CPU_FREQ        52500000UL  // Clock cycles per second
+
+// Keyboard scan codes
+#define KEY_N           0x31
+#define KEY_B           0x32
+
+#define STATS_LINE      16
+
 // Constants
 const char win_str[] = "Player . won!";
-const char draw_str[] = "Well done!";
+const char draw_str[] = "Well done!   ";   // Same length as win_str
+const char stats_str[] = "Nodes:          Nodes/s:";
+
+// Scan codes of the keys for each square.
+static const char keys3[9] = {
+   0x16, 0x1E, 0x26,          // 1 2 3
+   0x25, 0x2E, 0x36,          // 4 5 6
+   0x3D, 0x3E, 0x46};         // 7 8 9
+
+static const char keys4[16] = {
+   0x16, 0x1E, 0x26, 0x25,    // 1 2 3 4
+   0x15, 0x1D, 0x24, 0x2D,    // Q W E R
+   0x1C, 0x1B, 0x23, 0x2B,    // A S D F
+   0x1A, 0x22, 0x21, 0x2A};   // Z X C V
 
 // Global variables
-char pieces[9];
+char pieces[16];
 
 // Local variables
-static int gameOver;
+static char gameOver;
+static char squares;    // Number of squares on the board, 9 or 16
+static char released;
+static char temp;
+
+// The registers are saved here during interrupts
+static char irqA;
+static char irqX;
+static char irqY;
 
 static void __fastcall__ clearScreen(void)
 {
-   // Clear the screen
    __asm__("LDA #<%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_SCREEN_POS_LO);
+   __asm__("STA %b", ZP_DST_LO);
    __asm__("LDA #>%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_SCREEN_POS_HI);
+   __asm__("STA %b", ZP_DST_HI);
+page:
    __asm__("LDA #$00");
    __asm__("TAY");
-clear:
-   __asm__("LDA #$20");
-   __asm__("STA (%b),Y", ZP_SCREEN_POS_LO);
-   __asm__("INY");
-   __asm__("BNE %g", clear);
-   __asm__("LDA %b", ZP_SCREEN_POS_HI);
+   __asm__("LDA #%b", ' ');
+   memset8();
+   __asm__("LDA %b", ZP_DST_HI);
    __asm__("CLC");
    __asm__("ADC #$01");
-   __asm__("STA %b", ZP_SCREEN_POS_HI);
+   __asm__("STA %b", ZP_DST_HI);
    __asm__("CMP #$84");
-   __asm__("BNE %g", clear);
-   __asm__("RTS");
+   __asm__("BNE %g", page);
 } // end of clearScreen
 
-static void __fastcall__ clearLine(void)
-{
-   __asm__("LDA #<%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_DST_LO);
-   __asm__("LDA #>%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_DST_HI);
-   __asm__("LDA #%b", sizeof(win_str));
-   __asm__("TAY");
-   __asm__("LDA #$20");
-   my_memset();
-} // end of clearLine
-
 // Resets game to start
 static void __fastcall__ newGame(void)
 {
@@ -65,117 +86,184 @@ static void __fastcall__ newGame(void)
    __asm__("STA %b", ZP_DST_LO);
    __asm__("LDA #>%v", pieces);
    __asm__("STA %b", ZP_DST_HI);
-   __asm__("LDA #$09");
+   __asm__("LDA #%b", sizeof(pieces));
    __asm__("TAY");
    __asm__("LDA #$00");
-   my_memset();
+   memset8();
 
    __asm__("LDA #$00");
    __asm__("STA %v", gameOver);
+
+   __asm__("LDA %v", squares);
+   __asm__("CMP #$09");
+   __asm__("BNE %g", board4);
+   __asm__("LDA #<%v", keys3);
+   __asm__("STA %b", ZP_TTT_KEYS_LO);
+   __asm__("LDA #>%v", keys3);
+   __asm__("STA %b", ZP_TTT_KEYS_HI);
+   __asm__("RTS");
+
+board4:
+   __asm__("LDA #<%v", keys4);
+   __asm__("STA %b", ZP_TTT_KEYS_LO);
+   __asm__("LDA #>%v", keys4);
+   __asm__("STA %b", ZP_TTT_KEYS_HI);
 } // end of newGame
 
-// Checks if player in 'A' has won the game.
-void __fastcall__ checkEnd(void)
+// Returns in A the scan code of a key pressed, or zero.
+static void __fastcall__ readKey(void)
 {
-   __asm__("LDX #$00");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow1);
-   __asm__("LDX #$01");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow1);
-   __asm__("LDX #$02");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow1);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow1:
+   __asm__("LDA %w", VGA_KEY);              // Pop data from keyboard fifo
+   __asm__("BEQ %g", none);
+   __asm__("CMP #$F0");
+   __asm__("BEQ %g", release);
+   __asm__("CMP #$E0");                     // Ignore extended keys
+   __asm__("BEQ %g", none);
+   __asm__("CMP #$AA");                     // Ignore initialization code
+   __asm__("BEQ %g", none);
+   __asm__("TAX");
+   __asm__("LDA %v", released);
+   __asm__("BNE %g", up);
+   __asm__("TXA");
+   __asm__("RTS");
+
+up:
+   __asm__("LDA #$00");                     // The key was released
+   __asm__("BEQ %g", store);
+
+release:
+   __asm__("LDA #$01");
+store:
+   __asm__("STA %v", released);
+none:
+   __asm__("LDA #$00");
+} // end of readKey
 
+// Converts the scan code in A to a square. The square is returned in A, or
+// 0xFF if the key does not belong to a square.
+static void __fastcall__ findSquare(void)
+{
+   __asm__("STA %v", temp);
+   __asm__("LDA %v", squares);
+   __asm__("TAY");
+loop:
+   __asm__("DEY");
+   __asm__("BMI %g", end);
+   __asm__("LDA (%b),Y", ZP_TTT_KEYS_LO);
+   __asm__("CMP %v", temp);
+   __asm__("BNE %g", loop);
+end:
+   __asm__("TYA");
+} // end of findSquare
+
+// Copies the 32-bit number at ZP_SRC to div32_num.
+static void __fastcall__ loadNumber(void)
+{
+   __asm__("LDA #$03");
+   __asm__("TAY");
    __asm__("LDX #$03");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow2);
-   __asm__("LDX #$04");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow2);
-   __asm__("LDX #$05");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow2);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow2:
-
-   __asm__("LDX #$06");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow3);
-   __asm__("LDX #$07");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow3);
-   __asm__("LDX #$08");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow3);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow3:
-
-   __asm__("LDX #$00");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow4);
+loop:
+   __asm__("LDA (%b),Y", ZP_SRC_LO);
+   __asm__("STA %v,X", div32_num);
+   __asm__("DEX");
+   __asm__("DEY");
+   __asm__("BPL %g", loop);
+} // end of loadNumber
+
+// Copies div32_num to div32_div.
+static void __fastcall__ numberToDivisor(void)
+{
    __asm__("LDX #$03");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow4);
-   __asm__("LDX #$06");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow4);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow4:
-
-   __asm__("LDX #$01");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow5);
-   __asm__("LDX #$04");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow5);
-   __asm__("LDX #$07");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow5);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow5:
-
-   __asm__("LDX #$02");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow6);
-   __asm__("LDX #$05");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow6);
-   __asm__("LDX #$08");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow6);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow6:
-
-   __asm__("LDX #$02");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow7);
-   __asm__("LDX #$04");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow7);
-   __asm__("LDX #$06");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow7);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow7:
-
-   __asm__("LDX #$00");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow8);
-   __asm__("LDX #$04");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow8);
-   __asm__("LDX #$08");
-   __asm__("CMP %v,X", pieces);
-   __asm__("BNE %g", nextRow8);
-   __asm__("RTS");   // Player 'A' has won.
-nextRow8:
-
-   __asm__("LDA #$00"); // Return zero => game not finished.
-
-} // end of checkEnd
+loop:
+   __asm__("LDA %v,X", div32_num);
+   __asm__("STA %v,X", div32_div);
+   __asm__("DEX");
+   __asm__("BPL %g", loop);
+} // end of numberToDivisor
+
+// Prints div32_num in decimal at ZP_DST, right aligned in eight characters.
+// The number is destroyed.
+static void __fastcall__ printNumber(void)
+{
+   __asm__("LDA #$08");
+   __asm__("TAY");
+   __asm__("LDA #%b", ' ');
+   memset8();
+
+   __asm__("LDA #$0A");
+   __asm__("STA %v", div32_div);
+   __asm__("LDA #$00");
+   __asm__("STA %v+1", div32_div);
+   __asm__("STA %v+2", div32_div);
+   __asm__("STA %v+3", div32_div);
+   __asm__("LDA #$07");
+   __asm__("TAY");
+
+loop:
+   divide32();
+   __asm__("LDA %v+4", div32_num);  // The remainder is the next digit
+   __asm__("CLC");
+   __asm__("ADC #%b", '0');
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEY");
+   __asm__("LDA %v", div32_num);
+   __asm__("BNE %g", loop);
+   __asm__("LDA %v+1", div32_num);
+   __asm__("BNE %g", loop);
+   __asm__("LDA %v+2", div32_num);
+   __asm__("BNE %g", loop);
+   __asm__("LDA %v+3", div32_num);
+   __asm__("BNE %g", loop);
+} // end of printNumber
+
+// Shows the number of positions searched by the computer, and the number of
+// positions searched per second.
+static void __fastcall__ printStats(void)
+{
+   __asm__("LDA #<%w", VGA_ADDR_SCREEN + STATS_LINE*40);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", VGA_ADDR_SCREEN + STATS_LINE*40);
+   __asm__("STA %b", ZP_DST_HI);
+   __asm__("LDA #<%v", stats_str);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", stats_str);
+   __asm__("STA %b", ZP_SRC_HI);
+   __asm__("LDA #%b", sizeof(stats_str)-1);
+   __asm__("TAY");
+   memcpy8();
+
+   __asm__("LDA #<%v", ai_nodes);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", ai_nodes);
+   __asm__("STA %b", ZP_SRC_HI);
+   loadNumber();
+   __asm__("LDA #<%w", VGA_ADDR_SCREEN + STATS_LINE*40 + 7);
+   __asm__("STA %b", ZP_DST_LO);
+   printNumber();
+
+   // First the number of cycles per node, and then the nodes per second.
+   loadNumber();
+   numberToDivisor();
+   __asm__("LDA #<%v", ai_cycles);
+   __asm__("STA %b", ZP_SRC_LO);
+   __asm__("LDA #>%v", ai_cycles);
+   __asm__("STA %b", ZP_SRC_HI);
+   loadNumber();
+   divide32();
+   numberToDivisor();
+   __asm__("LDA #%b", CPU_FREQ & 0xFF);
+   __asm__("STA %v", div32_num);
+   __asm__("LDA #%b", (CPU_FREQ >> 8) & 0xFF);
+   __asm__("STA %v+1", div32_num);
+   __asm__("LDA #%b", (CPU_FREQ >> 16) & 0xFF);
+   __asm__("STA %v+2", div32_num);
+   __asm__("LDA #%b", (CPU_FREQ >> 24) & 0xFF);
+   __asm__("STA %v+3", div32_num);
+   divide32();
+   __asm__("LDA #<%w", VGA_ADDR_SCREEN + STATS_LINE*40 + 25);
+   __asm__("STA %b", ZP_DST_LO);
+   printNumber();
+} // end of printStats
 
 // Entry point after CPU reset
 void __fastcall__ reset(void)
@@ -184,39 +272,46 @@ void __fastcall__ reset(void)
    __asm__("LDX #$FF");
    __asm__("TXS");                           // Reset stack pointer
    ai_init();
+   __asm__("LDA #$00");
+   __asm__("STA %v", released);
+   __asm__("LDA #$09");
+   __asm__("STA %v", squares);
 
 new:
+   __asm__("SEI");
    clearScreen();
-   clearLine();
-   vga_init();
-   ai_newgame();
    newGame();
+   __asm__("LDA %v", squares);
+   ai_newgame();
+   __asm__("LDA %v", squares);
+   vga_init();                               // This enables interrupts again
+   vga_draw();
 
 loop:
-   // This is a blocking call; it won't return until a valid keypress is detected.
-   readFromKeyboard();
+   readKey();
+   __asm__("BEQ %g", loop);
 
    // Check if a new game is requested
-   __asm__("CMP #%b", 'N');
-   __asm__("BEQ %g", new);
-   __asm__("CMP #%b", 'n');
+   __asm__("CMP #%b", KEY_N);
    __asm__("BEQ %g", new);
+   __asm__("CMP #%b", KEY_B);
+   __asm__("BNE %g", play);
+
+   // Change the size of the board
+   __asm__("LDA %v", squares);
+   __asm__("EOR #%b", 9^16);
+   __asm__("STA %v", squares);
+   __asm__("JMP %g", new);
 
+play:
    // If game over, no more pieces may be placed.
    __asm__("TAX");
    __asm__("LDA %v", gameOver);
    __asm__("BNE %g", loop);
    __asm__("TXA");
 
-   // Check if a digit was pressed
-   __asm__("CMP #$30");
-   __asm__("BCC %g", loop);
-   __asm__("CMP #$3A");
-   __asm__("BCS %g", loop);
-
-   // Convert into range 0-8
-   __asm__("SEC");
-   __asm__("SBC #$31");
+   findSquare();
+   __asm__("BMI %g", loop);
 
    // Check whether square is already occupied
    __asm__("TAX");
@@ -227,34 +322,34 @@ loop:
    __asm__("LDA #%b", 'X');
    __asm__("STA %v,X", pieces);
    __asm__("TXA");
+   ai_playX();
+   vga_draw();
 
    __asm__("LDA #%b", 'X');
-   checkEnd();
-   __asm__("TAX");
-   __asm__("STA %v", gameOver);
-   __asm__("BNE %g", update);
+   ai_checkEnd();
+   __asm__("BNE %g", end);
 
    ai_findO();
-   __asm__("CMP #$09");
-   __asm__("BEQ %g", draw);
-
    __asm__("TAX");
    __asm__("LDA #%b", 'O');
    __asm__("STA %v,X", pieces);
-   __asm__("TXA");
+   vga_draw();
+
+   // The interrupt uses ZP_SRC and ZP_DST too.
+   __asm__("SEI");
+   printStats();
+   __asm__("CLI");
 
    __asm__("LDA #%b", 'O');
-   checkEnd();
-   __asm__("TAX");
-   __asm__("STA %v", gameOver);
-   __asm__("BNE %g", writeEnd);
+   ai_checkEnd();
+   __asm__("BNE %g", end);
 
    goto loop;  // Just do an endless loop.
 
-update:
-   ai_update();
-
-writeEnd:
+   // The game is over. 'A' contains the winner, or 1 for a draw.
+end:
+   __asm__("STA %v", gameOver);
+   __asm__("SEI");
    __asm__("LDA #<%w", VGA_ADDR_SCREEN);
    __asm__("STA %b", ZP_DST_LO);
    __asm__("LDA #>%w", VGA_ADDR_SCREEN);
@@ -263,37 +358,43 @@ writeEnd:
    __asm__("STA %b", ZP_SRC_LO);
    __asm__("LDA #>%v", win_str);
    __asm__("STA %b", ZP_SRC_HI);
-   __asm__("LDA #%b", sizeof(win_str)-1);
-   __asm__("TAY");
-   my_memcpy();
    __asm__("LDA %v", gameOver);
-   __asm__("STA %w", VGA_ADDR_SCREEN + 7);
-   __asm__("JMP %g", loop);
-
-draw:
-   __asm__("STA %v", gameOver);
-
-   __asm__("LDA #<%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_DST_LO);
-   __asm__("LDA #>%w", VGA_ADDR_SCREEN);
-   __asm__("STA %b", ZP_DST_HI);
+   __asm__("CMP #$01");
+   __asm__("BNE %g", message);
    __asm__("LDA #<%v", draw_str);
    __asm__("STA %b", ZP_SRC_LO);
    __asm__("LDA #>%v", draw_str);
    __asm__("STA %b", ZP_SRC_HI);
-   __asm__("LDA #%b", sizeof(draw_str)-1);
+
+message:
+   __asm__("LDA #%b", sizeof(win_str)-1);
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
+   __asm__("LDA %v", gameOver);
+   __asm__("CMP #$01");
+   __asm__("BEQ %g", done);
+   __asm__("STA %w", VGA_ADDR_SCREEN + 7);  // The winner
+done:
+   __asm__("CLI");
+   goto loop;
 
-   goto loop;  // Just do an endless loop.
- 
 } // end of reset
 
 // Maskable interrupt
 void __fastcall__ irq(void)
 {
+   // The interrupt may arrive during the search of the computer.
+   __asm__("STA %v", irqA);
+   __asm__("TXA");
+   __asm__("STA %v", irqX);
+   __asm__("TYA");
+   __asm__("STA %v", irqY);
    vga_irq();
-   // Not used.
+   __asm__("LDA %v", irqY);
+   __asm__("TAY");
+   __asm__("LDA %v", irqX);
+   __asm__("TAX");
+   __asm__("LDA %v", irqA);
    __asm__("RTI");
 } // end of irq
 
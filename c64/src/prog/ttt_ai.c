@@ -1,142 +1,661 @@
-#include "zeropage.h"
-#include "ttt_vga.h"
+//
+// This implements the computer player of the Tic-Tac-Toe game.
+//
+// The board is stored as two bit boards, one bit for each square, so a line
+// is checked with a single AND and compare.
+//
+// The computer searches the game tree with negamax and alpha-beta pruning.
+// The CPU stack is too small for a recursive search, so the search is a loop,
+// and the state of each level is kept in small arrays indexed by the ply.
+// During the search, ZP_AI_ME is always the player to move. The two bit boards
+// are swapped, when going up or down one level.
+//
+// Scores are offset by 0x80, so they can be compared with CMP. A win scores
+// SCORE_WIN plus the number of empty squares, so a quick win is preferred.
+// On the 3x3 board the whole tree is searched, so the computer plays perfectly.
+// On the 4x4 board the search stops after AI_DEPTH_4X4 moves, and the position
+// is scored by the number of lines still open for each player.
+//
+// Positions already searched are kept in a small transposition table in the
+// zero page. The best move found is stored too, and it is searched first the
+// next time. The other moves are searched in a fixed order: The center
+// squares, then the corners, and finally the edges.
+//
+
 #include "memorymap.h"
+#include "zeropage.h"
+#include "ttt_ai.h"
 
-static char best[256];
-static char positions[5];
+#define AI_TT_SIZE      96       // 16 entries of 6 bytes
+#define AI_TT_EXACT     0x80     // Flags stored with the best move
+#define AI_TT_LOWER     0x40
+#define AI_TT_UPPER     0x20
 
-// External declaration
-extern char pieces[9];
+#define AI_MAX_PLY      17
+#define AI_DEPTH_4X4    6
 
-void __fastcall__ ai_init(void)
-{
-   __asm__("LDX #$00");
-   __asm__("LDA #$11");
-   __asm__("TAY");
+#define SCORE_NONE      0x00
+#define SCORE_MIN       0x01
+#define SCORE_DRAW      0x80
+#define SCORE_WIN       0xC0
+#define SCORE_MAX       0xFF
 
-loop:
-   __asm__("TYA");
-   __asm__("ROL A");
-   __asm__("ADC #$AB");
-   __asm__("TAY");
-   __asm__("AND #$0F");
-   __asm__("CMP #$09");
-   __asm__("BCS %g", loop);
+#define MOVE_NONE       0xFF
 
-   __asm__("STA %v,X", best);
-   __asm__("INX");
-   __asm__("BNE %g", loop);
+// Constants
+static const char bitLo[16] = {
+   0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static const char bitHi[16] = {
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+
+// Rows, columns, and diagonals. LSB first.
+static const char lines3[16] = {
+   0x07, 0x00,  0x38, 0x00,  0xC0, 0x01,
+   0x49, 0x00,  0x92, 0x00,  0x24, 0x01,
+   0x11, 0x01,  0x54, 0x00};
+
+static const char lines4[20] = {
+   0x0F, 0x00,  0xF0, 0x00,  0x00, 0x0F,  0x00, 0xF0,
+   0x11, 0x11,  0x22, 0x22,  0x44, 0x44,  0x88, 0x88,
+   0x21, 0x84,  0x48, 0x12};
+
+static const char order3[9]  = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+static const char order4[16] = {5, 6, 9, 10, 0, 3, 12, 15, 1, 2, 4, 7, 8, 11, 13, 14};
+
+// The tables and parameters of each board.
+static const char * const lines[2]  = {lines3, lines4};
+static const char * const orders[2] = {order3, order4};
+static const char params[4] = {
+   sizeof(lines3), AI_MAX_PLY-1,
+   sizeof(lines4), AI_DEPTH_4X4-1};
+
+// Global variables
+char ai_nodes[4];       // Number of moves searched
+char ai_cycles[4];      // Clock cycles used by the search
+
+// The state of each level of the search
+static char plyAlpha[AI_MAX_PLY];
+static char plyBeta[AI_MAX_PLY];
+static char plyAlphaOrig[AI_MAX_PLY];
+static char plyBest[AI_MAX_PLY];
+static char plyBestMove[AI_MAX_PLY];
+static char plyMove[AI_MAX_PLY];
+static char plyIndex[AI_MAX_PLY];   // Index into the move order, or MOVE_NONE
+static char plyFirst[AI_MAX_PLY];   // Move from the transposition table
+static char plyHash[AI_MAX_PLY];    // Offset into the transposition table
+
+void __fastcall__ ai_init(void)
+{
+   __asm__("LDA #%b", ZP_AI_ME_LO);
+   __asm__("STA %b", ZP_AI_POS_LO);
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_AI_POS_HI);
+   __asm__("STA %b", ZP_AI_TT_HI);
 } // end of ai_init
 
+// Starts a new game on a board with the number of squares in A.
 void __fastcall__ ai_newgame(void)
 {
-   __asm__("LDA #<%v", positions);
-   __asm__("STA %b", ZP_DST_LO);
-   __asm__("LDA #>%v", positions);
-   __asm__("STA %b", ZP_DST_HI);
-   __asm__("LDA #%b", sizeof(positions));
-   __asm__("TAY");
-   __asm__("LDA #$00");
-   my_memset();
+   __asm__("STA %b", ZP_AI_SQUARES);
+   __asm__("STA %b", ZP_AI_EMPTY);
+   __asm__("LDX #$00");
+   __asm__("CMP #$09");
+   __asm__("BEQ %g", board3);
+   __asm__("LDX #$02");
+board3:
+   __asm__("LDA %v,X", lines);
+   __asm__("STA %b", ZP_AI_LINE_LO);
+   __asm__("LDA %v+1,X", lines);
+   __asm__("STA %b", ZP_AI_LINE_HI);
+   __asm__("LDA %v,X", orders);
+   __asm__("STA %b", ZP_AI_ORDER_LO);
+   __asm__("LDA %v+1,X", orders);
+   __asm__("STA %b", ZP_AI_ORDER_HI);
+   __asm__("LDA %v,X", params);
+   __asm__("STA %b", ZP_AI_LINES);
+   __asm__("LDA %v+1,X", params);
+   __asm__("STA %b", ZP_AI_DEPTH);
 
+clear:
+   // Outside the search, ME is the computer and YOU is the player.
    __asm__("LDA #$00");
-   __asm__("STA %b", ZP_AI_NUMPOS);
+   __asm__("STA %b", ZP_AI_ME_LO);
+   __asm__("STA %b", ZP_AI_ME_HI);
+   __asm__("STA %b", ZP_AI_YOU_LO);
+   __asm__("STA %b", ZP_AI_YOU_HI);
+   __asm__("STA %b", ZP_AI_OCC_LO);
+   __asm__("STA %b", ZP_AI_OCC_HI);
 } // end of ai_newgame
 
-// Figure out where to place the next piece
-void __fastcall__ ai_findO(void)
+// Swaps the two bit boards.
+static void __fastcall__ swap(void)
 {
-   // First compute the index
+   __asm__("LDA %b", ZP_AI_ME_LO);
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("LDA %b", ZP_AI_YOU_LO);
+   __asm__("STA %b", ZP_AI_ME_LO);
+   __asm__("LDA %b", ZP_AI_TEMP);
+   __asm__("STA %b", ZP_AI_YOU_LO);
 
-   __asm__("LDA #$00");
+   __asm__("LDA %b", ZP_AI_ME_HI);
    __asm__("STA %b", ZP_AI_TEMP);
-   __asm__("LDX #$00");
+   __asm__("LDA %b", ZP_AI_YOU_HI);
+   __asm__("STA %b", ZP_AI_ME_HI);
+   __asm__("LDA %b", ZP_AI_TEMP);
+   __asm__("STA %b", ZP_AI_YOU_HI);
+} // end of swap
+
+// Places or removes a piece of ME on the square in A.
+static void __fastcall__ toggle(void)
+{
+   __asm__("TAX");
+   __asm__("LDA %v,X", bitLo);
+   __asm__("STA %b", ZP_AI_BIT_LO);
+   __asm__("LDA %v,X", bitHi);
+   __asm__("STA %b", ZP_AI_BIT_HI);
+
+   __asm__("LDA %b", ZP_AI_ME_LO);
+   __asm__("EOR %b", ZP_AI_BIT_LO);
+   __asm__("STA %b", ZP_AI_ME_LO);
+   __asm__("LDA %b", ZP_AI_ME_HI);
+   __asm__("EOR %b", ZP_AI_BIT_HI);
+   __asm__("STA %b", ZP_AI_ME_HI);
+   __asm__("LDA %b", ZP_AI_OCC_LO);
+   __asm__("EOR %b", ZP_AI_BIT_LO);
+   __asm__("STA %b", ZP_AI_OCC_LO);
+   __asm__("LDA %b", ZP_AI_OCC_HI);
+   __asm__("EOR %b", ZP_AI_BIT_HI);
+   __asm__("STA %b", ZP_AI_OCC_HI);
+} // end of toggle
+
+// Places a piece of ME on the square in A.
+static void __fastcall__ makeMove(void)
+{
+   toggle();
+   __asm__("LDA %b", ZP_AI_EMPTY);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_AI_EMPTY);
+} // end of makeMove
+
+// Removes the piece placed at the current ply.
+static void __fastcall__ unmakeMove(void)
+{
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA %v,X", plyMove);
+   toggle();
+   __asm__("LDA %b", ZP_AI_EMPTY);
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_AI_EMPTY);
+} // end of unmakeMove
+
+// Returns non-zero in A, if ME has a complete line.
+static void __fastcall__ checkWin(void)
+{
+   __asm__("LDA %b", ZP_AI_LINES);
+   __asm__("TAY");
 loop:
-   __asm__("LDA %v,X", pieces);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_AI_LINE_LO);
+   __asm__("STA %b", ZP_AI_MASK_HI);
+   __asm__("AND %b", ZP_AI_ME_HI);
+   __asm__("CMP %b", ZP_AI_MASK_HI);
+   __asm__("BNE %g", skip);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_AI_LINE_LO);
+   __asm__("STA %b", ZP_AI_MASK_LO);
+   __asm__("AND %b", ZP_AI_ME_LO);
+   __asm__("CMP %b", ZP_AI_MASK_LO);
+   __asm__("BNE %g", next);
+   __asm__("LDA #$01");
+   __asm__("RTS");
+
+skip:
+   __asm__("DEY");
+next:
+   __asm__("TYA");
+   __asm__("BNE %g", loop);
+} // end of checkWin
+
+// Scores the position for ME, when the search is stopped: The number of lines
+// without pieces of YOU, minus the number of lines without pieces of ME.
+static void __fastcall__ evaluate(void)
+{
+   __asm__("LDA #%b", SCORE_DRAW);
+   __asm__("STA %b", ZP_AI_EVAL);
+   __asm__("LDA %b", ZP_AI_LINES);
+   __asm__("TAY");
+loop:
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_AI_LINE_LO);
+   __asm__("STA %b", ZP_AI_MASK_HI);
+   __asm__("DEY");
+   __asm__("LDA (%b),Y", ZP_AI_LINE_LO);
+   __asm__("STA %b", ZP_AI_MASK_LO);
+
+   __asm__("AND %b", ZP_AI_YOU_LO);
+   __asm__("BNE %g", closedMe);
+   __asm__("LDA %b", ZP_AI_MASK_HI);
+   __asm__("AND %b", ZP_AI_YOU_HI);
+   __asm__("BNE %g", closedMe);
+   __asm__("LDA %b", ZP_AI_EVAL);
    __asm__("CLC");
-   __asm__("ADC %b", ZP_AI_TEMP);
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_AI_EVAL);
+
+closedMe:
+   __asm__("LDA %b", ZP_AI_MASK_LO);
+   __asm__("AND %b", ZP_AI_ME_LO);
+   __asm__("BNE %g", closedYou);
+   __asm__("LDA %b", ZP_AI_MASK_HI);
+   __asm__("AND %b", ZP_AI_ME_HI);
+   __asm__("BNE %g", closedYou);
+   __asm__("LDA %b", ZP_AI_EVAL);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_AI_EVAL);
+
+closedYou:
+   __asm__("TYA");
+   __asm__("BNE %g", loop);
+   __asm__("LDA %b", ZP_AI_EVAL);
+} // end of evaluate
+
+// Looks up the current position in the transposition table. Returns non-zero
+// in A, if the stored score can be used directly. The score is then in
+// ZP_AI_SCORE.
+static void __fastcall__ probe(void)
+{
+   // Calculate the hash value, a number from 0 to 15, and multiply by 6.
+   __asm__("LDA %b", ZP_AI_ME_LO);
+   __asm__("EOR %b", ZP_AI_YOU_HI);
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("LDA %b", ZP_AI_YOU_LO);
+   __asm__("ASL A");
+   __asm__("EOR %b", ZP_AI_TEMP);
+   __asm__("EOR %b", ZP_AI_ME_HI);
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("CLC");
+   __asm__("ROL A");
+   __asm__("ROL A");
    __asm__("ROL A");
+   __asm__("ROL A");
+   __asm__("EOR %b", ZP_AI_TEMP);
+   __asm__("AND #$0F");
    __asm__("STA %b", ZP_AI_TEMP);
-   __asm__("INX");
-   __asm__("TXA");
-   __asm__("CMP #$09");
-   __asm__("BNE %g", loop);
+   __asm__("ASL A");
+   __asm__("ADC %b", ZP_AI_TEMP);   // Carry is always clear here.
+   __asm__("ASL A");
+   __asm__("ADC #%b", ZP_AI_TT);    // Carry is always clear here.
+   __asm__("STA %b", ZP_AI_TT_LO);
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_AI_TT_LO);
+   __asm__("STA %v,X", plyHash);
+   __asm__("LDA #%b", MOVE_NONE);
+   __asm__("STA %v,X", plyFirst);
+
+   // The first four bytes of the entry are the two bit boards.
+   __asm__("LDA #$03");
+   __asm__("TAY");
+compare:
+   __asm__("LDA (%b),Y", ZP_AI_POS_LO);
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("LDA (%b),Y", ZP_AI_TT_LO);
+   __asm__("CMP %b", ZP_AI_TEMP);
+   __asm__("BNE %g", miss);
+   __asm__("DEY");
+   __asm__("BPL %g", compare);
+
+   __asm__("LDA #$04");
+   __asm__("TAY");
+   __asm__("LDA (%b),Y", ZP_AI_TT_LO);
+   __asm__("STA %b", ZP_AI_SCORE);
+   __asm__("INY");
+   __asm__("LDA (%b),Y", ZP_AI_TT_LO);
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("AND #$0F");
+   __asm__("STA %v,X", plyFirst);
 
-   // Next look up the move
    __asm__("LDA %b", ZP_AI_TEMP);
+   __asm__("ASL A");
+   __asm__("BCS %g", hit);          // AI_TT_EXACT
+   __asm__("ASL A");
+   __asm__("BCC %g", upper);        // Not AI_TT_LOWER
+   __asm__("LDA %b", ZP_AI_SCORE);
+   __asm__("CMP %v,X", plyBeta);
+   __asm__("BCS %g", hit);          // Score >= beta
+   __asm__("BCC %g", miss);
+
+upper:
+   __asm__("LDA %v,X", plyAlpha);
+   __asm__("CMP %b", ZP_AI_SCORE);
+   __asm__("BCS %g", hit);          // Alpha >= score
+
+miss:
+   __asm__("LDA #$00");
+   __asm__("RTS");
+
+hit:
+   __asm__("LDA #$01");
+} // end of probe
+
+// Stores the result of the search at the current ply in the transposition
+// table.
+static void __fastcall__ store(void)
+{
+   __asm__("LDA %b", ZP_AI_PLY);
    __asm__("TAX");
-   __asm__("LDA %v,X", best);
-   __asm__("TAX");
+   __asm__("LDA %v,X", plyBest);
+   __asm__("CMP %v,X", plyAlphaOrig);
+   __asm__("BEQ %g", upper);
+   __asm__("BCC %g", upper);        // Best <= alpha
+   __asm__("CMP %v,X", plyBeta);
+   __asm__("BCS %g", lower);        // Best >= beta
+   __asm__("LDA #%b", AI_TT_EXACT);
+   __asm__("BNE %g", flag);
+upper:
+   __asm__("LDA #%b", AI_TT_UPPER);
+   __asm__("BNE %g", flag);
+lower:
+   __asm__("LDA #%b", AI_TT_LOWER);
+flag:
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("LDA %v,X", plyBestMove);
+   __asm__("ORA %b", ZP_AI_TEMP);
+   __asm__("STA %b", ZP_AI_TEMP);
 
-   // Check if move in 'X' is valid
-   __asm__("LDA #$09");
+   __asm__("LDA %v,X", plyHash);
+   __asm__("STA %b", ZP_AI_TT_LO);
+   __asm__("LDA #$03");
    __asm__("TAY");
-next:
+copy:
+   __asm__("LDA (%b),Y", ZP_AI_POS_LO);
+   __asm__("STA (%b),Y", ZP_AI_TT_LO);
    __asm__("DEY");
-   __asm__("BMI %g", end);
-   __asm__("LDA %v,X", pieces);
-   __asm__("BEQ %g", valid);
-   __asm__("INX");
-   __asm__("TXA");
-   __asm__("CMP #$09");
-   __asm__("BCC %g", next);
-   __asm__("LDX #$00");
-   __asm__("JMP %g", next);
+   __asm__("BPL %g", copy);
 
-valid:
-   // Move 'X' to 'Y'
-   __asm__("TXA");
+   __asm__("LDA #$04");
    __asm__("TAY");
+   __asm__("LDA %v,X", plyBest);
+   __asm__("STA (%b),Y", ZP_AI_TT_LO);
+   __asm__("INY");
+   __asm__("LDA %b", ZP_AI_TEMP);
+   __asm__("STA (%b),Y", ZP_AI_TT_LO);
+} // end of store
 
-   // Store current position
-   __asm__("LDA %b", ZP_AI_NUMPOS);
+// Returns in A the next move to search at the current ply, or MOVE_NONE.
+static void __fastcall__ nextMove(void)
+{
+   __asm__("LDA %b", ZP_AI_PLY);
    __asm__("TAX");
-   __asm__("LDA %b", ZP_AI_TEMP);
-   __asm__("STA %v,X", positions);
-   __asm__("INX");
+   __asm__("LDA %v,X", plyIndex);
+   __asm__("CMP #%b", MOVE_NONE);
+   __asm__("BNE %g", loop);
+
+   // The move from the transposition table is searched first.
+   __asm__("LDA #$00");
+   __asm__("STA %v,X", plyIndex);
+   __asm__("LDA %v,X", plyFirst);
+   __asm__("CMP #%b", MOVE_NONE);
+   __asm__("BEQ %g", loop);
+   __asm__("RTS");
+
+loop:
+   __asm__("LDA %v,X", plyIndex);
+   __asm__("CMP %b", ZP_AI_SQUARES);
+   __asm__("BCS %g", none);
+   __asm__("TAY");
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %v,X", plyIndex);
+   __asm__("LDA (%b),Y", ZP_AI_ORDER_LO);
+   __asm__("CMP %v,X", plyFirst);
+   __asm__("BEQ %g", loop);          // Already searched
+
+   __asm__("TAX");
+   __asm__("LDA %v,X", bitLo);
+   __asm__("AND %b", ZP_AI_OCC_LO);
+   __asm__("BNE %g", occupied);
+   __asm__("LDA %v,X", bitHi);
+   __asm__("AND %b", ZP_AI_OCC_HI);
+   __asm__("BNE %g", occupied);
    __asm__("TXA");
-   __asm__("STA %b", ZP_AI_NUMPOS);
+   __asm__("RTS");
 
-   // Return chosen move in 'A'
-   __asm__("TYA");
+occupied:
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("JMP %g", loop);
+
+none:
+   __asm__("LDA #%b", MOVE_NONE);
+} // end of nextMove
+
+// The player places a piece on the square in A.
+void __fastcall__ ai_playX(void)
+{
+   __asm__("STA %b", ZP_AI_SCORE);
+   swap();
+   __asm__("LDA %b", ZP_AI_SCORE);
+   makeMove();
+   swap();
+} // end of ai_playX
+
+// Checks if player in 'A' has won the game. Returns the player in 'A', or 1
+// if the board is full, or zero.
+void __fastcall__ ai_checkEnd(void)
+{
+   __asm__("STA %b", ZP_AI_SCORE);
+   __asm__("CMP #%b", 'O');
+   __asm__("BEQ %g", computer);
+
+   swap();
+   checkWin();
+   __asm__("STA %b", ZP_AI_EVAL);
+   swap();
+   __asm__("LDA %b", ZP_AI_EVAL);
+   __asm__("JMP %g", result);
+
+computer:
+   checkWin();
+
+result:
+   __asm__("BEQ %g", notWon);
+   __asm__("LDA %b", ZP_AI_SCORE);
    __asm__("RTS");
 
-end:
-   __asm__("LDA #$09");
+notWon:
+   __asm__("LDA %b", ZP_AI_EMPTY);
+   __asm__("BEQ %g", full);
+   __asm__("LDA #$00");
    __asm__("RTS");
-} // end of ai_findO
 
-// Increment best moves for each position visited in this game
-void __fastcall__ ai_update(void)
+full:
+   __asm__("LDA #$01");
+} // end of ai_checkEnd
+
+// Figure out where to place the next piece. The move is returned in 'A'.
+// The board must not be full.
+void __fastcall__ ai_findO(void)
 {
+   // Reading the LSB of the cycle counter latches the upper bytes. X counts
+   // from -4 to 0, so the loop starts with the LSB.
+   __asm__("LDX #$FC");
+startTimer:
+   __asm__("LDA %w-$FC,X", VGA_ADDR_CYCLES);
+   __asm__("STA %v-$FC,X", ai_cycles);
    __asm__("LDA #$00");
-   __asm__("STA %b", ZP_AI_TEMP); // Index into positions[]
-   __asm__("CMP %b", ZP_AI_NUMPOS);
-   __asm__("BEQ %g", end);
+   __asm__("STA %v-$FC,X", ai_nodes);
+   __asm__("INX");
+   __asm__("BNE %g", startTimer);
 
-loop:
+   // Clear the transposition table. No position matches all ones.
+   __asm__("LDA #%b", ZP_AI_TT);
+   __asm__("STA %b", ZP_AI_TT_LO);
+   __asm__("LDA #%b", AI_TT_SIZE-1);
+   __asm__("TAY");
+   __asm__("LDA #$FF");
+clear:
+   __asm__("STA (%b),Y", ZP_AI_TT_LO);
+   __asm__("DEY");
+   __asm__("BPL %g", clear);
+
+   __asm__("LDA #$00");
+   __asm__("STA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA #%b", SCORE_MIN);
+   __asm__("STA %v,X", plyAlpha);
+   __asm__("LDA #%b", SCORE_MAX);
+   __asm__("STA %v,X", plyBeta);
+
+   // A new position is searched at the current ply.
+node:
+   __asm__("LDA %b", ZP_AI_PLY);
    __asm__("TAX");
-   __asm__("LDA %v,X", positions);
+   __asm__("LDA %v,X", plyAlpha);
+   __asm__("STA %v,X", plyAlphaOrig);
+   __asm__("LDA #%b", SCORE_NONE);
+   __asm__("STA %v,X", plyBest);
+   __asm__("LDA #%b", MOVE_NONE);
+   __asm__("STA %v,X", plyIndex);
+   probe();
+   __asm__("BEQ %g", next);
+   __asm__("JMP %g", leave);
+
+   // Try the next move at the current ply.
+next:
+   nextMove();
+   __asm__("CMP #%b", MOVE_NONE);
+   __asm__("BNE %g", move);
+   __asm__("JMP %g", finish);
+
+move:
+   __asm__("TAY");
+   __asm__("LDA %b", ZP_AI_PLY);
    __asm__("TAX");
-   __asm__("LDA %v,X", best);
+   __asm__("TYA");
+   __asm__("STA %v,X", plyMove);
+   makeMove();
+
+   // Increment the node counter.
+   __asm__("LDX #$FC");
+count:
+   __asm__("LDA %v-$FC,X", ai_nodes);
    __asm__("CLC");
    __asm__("ADC #$01");
-   __asm__("STA %v,X", best);
+   __asm__("STA %v-$FC,X", ai_nodes);
+   __asm__("BCC %g", counted);
+   __asm__("INX");
+   __asm__("BNE %g", count);
+counted:
 
-   __asm__("CMP #$09");
-   __asm__("BCC %g", next);
-   __asm__("LDA #$00");
-   __asm__("STA %v,X", best);
+   checkWin();
+   __asm__("BEQ %g", noWin);
+   __asm__("LDA %b", ZP_AI_EMPTY);
+   __asm__("CLC");
+   __asm__("ADC #%b", SCORE_WIN);
+   __asm__("JMP %g", score);
 
-next:
+noWin:
+   __asm__("LDA %b", ZP_AI_EMPTY);
+   __asm__("BNE %g", notFull);
+   __asm__("LDA #%b", SCORE_DRAW);
+   __asm__("JMP %g", score);
+
+notFull:
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("CMP %b", ZP_AI_DEPTH);
+   __asm__("BCC %g", down);
+   evaluate();
+   __asm__("JMP %g", score);
+
+   // Search the new position one level down. The window is negated.
+down:
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA %v,X", plyBeta);
+   __asm__("EOR #$FF");
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("STA %b", ZP_AI_TEMP);
+   __asm__("LDA %v,X", plyAlpha);
+   __asm__("EOR #$FF");
+   __asm__("CLC");
+   __asm__("ADC #$01");
+   __asm__("INX");
+   __asm__("STA %v,X", plyBeta);
    __asm__("LDA %b", ZP_AI_TEMP);
+   __asm__("STA %v,X", plyAlpha);
+   __asm__("TXA");
+   __asm__("STA %b", ZP_AI_PLY);
+   swap();
+   __asm__("JMP %g", node);
+
+   // The score of the move at the current ply is in A.
+score:
+   __asm__("STA %b", ZP_AI_SCORE);
+   unmakeMove();
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA %b", ZP_AI_SCORE);
+   __asm__("CMP %v,X", plyBest);
+   __asm__("BEQ %g", notBest);
+   __asm__("BCC %g", notBest);
+   __asm__("STA %v,X", plyBest);
+   __asm__("LDA %v,X", plyMove);
+   __asm__("STA %v,X", plyBestMove);
+   __asm__("LDA %b", ZP_AI_SCORE);
+   __asm__("CMP %v,X", plyAlpha);
+   __asm__("BCC %g", notBest);
+   __asm__("STA %v,X", plyAlpha);
+   __asm__("CMP %v,X", plyBeta);
+   __asm__("BCS %g", finish);      // Alpha >= beta, so skip the other moves
+notBest:
+   __asm__("JMP %g", next);
+
+   // All moves at the current ply are searched.
+finish:
+   store();
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("TAX");
+   __asm__("LDA %v,X", plyBest);
+   __asm__("STA %b", ZP_AI_SCORE);
+
+   // Go one level up with the score in ZP_AI_SCORE.
+leave:
+   __asm__("LDA %b", ZP_AI_PLY);
+   __asm__("BEQ %g", done);
+   __asm__("SEC");
+   __asm__("SBC #$01");
+   __asm__("STA %b", ZP_AI_PLY);
+   swap();
+   __asm__("LDA %b", ZP_AI_SCORE);
+   __asm__("EOR #$FF");
    __asm__("CLC");
    __asm__("ADC #$01");
+   __asm__("JMP %g", score);
+
+done:
+   __asm__("LDX #$FC");
+   __asm__("SEC");
+stopTimer:
+   __asm__("LDA %v-$FC,X", ai_cycles);
    __asm__("STA %b", ZP_AI_TEMP);
-   __asm__("CMP %b", ZP_AI_NUMPOS);
-   __asm__("BNE %g", loop);
+   __asm__("LDA %w-$FC,X", VGA_ADDR_CYCLES);
+   __asm__("SBC %b", ZP_AI_TEMP);
+   __asm__("STA %v-$FC,X", ai_cycles);
+   __asm__("INX");
+   __asm__("BNE %g", stopTimer);       // INX leaves the carry alone
 
-end:
-   __asm__("RTS");
-} // end of ai_update
+   __asm__("LDA %v", plyBestMove);
+   __asm__("STA %b", ZP_AI_SCORE);
+   makeMove();
+   __asm__("LDA %b", ZP_AI_SCORE);
+} // end of ai_findO
 
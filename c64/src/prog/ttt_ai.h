@@ -1,5 +1,8 @@
-
 void __fastcall__ ai_init(void);
 void __fastcall__ ai_newgame(void);
+void __fastcall__ ai_playX(void);
+void __fastcall__ ai_checkEnd(void);
 void __fastcall__ ai_findO(void);
-void __fastcall__ ai_update(void);
+
+extern char ai_nodes[4];
+extern char ai_cycles[4];
@@ -4,7 +4,7 @@
 
 #include "memorymap.h"
 #include "zeropage.h"   // Variables to be stored in the zero-page.
-#include "keyboard.h"
+#include "mem.h"
 
 #define COL_WHITE       0xFFU  // 111_111_11
 #define COL_LIGHT       0x6E   // 011_011_10
@@ -15,7 +15,7 @@
 #define BOARD_XPOS      0x20
 
 // External declaration
-extern char pieces[9];
+extern char pieces[16];
 
 static const char bitmap_X[32] = {
    0xE0, 0x07,
@@ -71,35 +71,45 @@ static const char bitmap_board[32] = {
    0x84, 0x21,
    0xff, 0xff};
 
-void __fastcall__ my_memcpy(void)
-{
-loop:
-   __asm__("DEY");
-   __asm__("LDA (%b),Y", ZP_SRC_LO);
-   __asm__("STA (%b),Y", ZP_DST_LO);
-   __asm__("TYA");
-   __asm__("BNE %g", loop);
-} // end of my_memcpy
+// Position on the screen of each square of the 4x4 board.
+static const char offset4[16] = {
+   3*40+4, 3*40+6, 3*40+8, 3*40+10,
+   4*40+4, 4*40+6, 4*40+8, 4*40+10,
+   5*40+4, 5*40+6, 5*40+8, 5*40+10,
+   6*40+4, 6*40+6, 6*40+8, 6*40+10};
 
-void __fastcall__ my_memset(void)
-{
-   __asm__("TAX");
-loop:
-   __asm__("DEY");
-   __asm__("TXA");
-   __asm__("STA (%b),Y", ZP_DST_LO);
-   __asm__("TYA");
-   __asm__("BNE %g", loop);
-} // end of my_memset
+// Local variables
+static char squares;
+static char row;        // First square of the row shown by sprites 1 to 3
 
+// Sets up the screen for a board with the number of squares in A.
+// The 3x3 board is drawn with sprites, and the 4x4 board in text mode.
 void __fastcall__ vga_init(void)
 {
+   __asm__("SEI");
+   __asm__("STA %v", squares);
+
    // Configure text color
    __asm__("LDA #%b", COL_LIGHT);
    __asm__("STA %w",  VGA_ADDR_FGCOL);
    __asm__("LDA #%b", COL_DARK);
    __asm__("STA %w",  VGA_ADDR_BGCOL);
 
+   __asm__("LDA %v", squares);
+   __asm__("CMP #$09");
+   __asm__("BEQ %g", sprites);
+
+   // The 4x4 board needs neither sprites nor interrupts.
+   __asm__("LDA #$00");
+   __asm__("STA %w", VGA_ADDR_MASK);
+   __asm__("LDX #$03");
+disable:
+   __asm__("STA %w,X", VGA_ADDR_SPRITE_0_ENA);
+   __asm__("DEX");
+   __asm__("BPL %g", disable);
+   __asm__("RTS");
+
+sprites:
    // Configure sprite 0 as the playing board
    __asm__("LDA #<%w", VGA_ADDR_SPRITE_0_BITMAP);
    __asm__("STA %b", ZP_DST_LO);
@@ -111,7 +121,7 @@ void __fastcall__ vga_init(void)
    __asm__("STA %b", ZP_SRC_HI);
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
+   memcpy8();
 
    __asm__("LDA #<%w", BOARD_XPOS);
    __asm__("STA %w", VGA_ADDR_SPRITE_0_X);
@@ -124,32 +134,37 @@ void __fastcall__ vga_init(void)
    __asm__("LDA #$05"); // Magnification = x4
    __asm__("STA %w", VGA_ADDR_SPRITE_0_ENA);
 
-   __asm__("LDA #<%w", BOARD_XPOS+4);
-   __asm__("STA %w", VGA_ADDR_SPRITE_1_X);
-   __asm__("LDA #>%w", BOARD_XPOS+4);
+   // Sprites 1 to 3 show the pieces, one row at a time.
+   __asm__("LDX #$04");
+   __asm__("LDA #<%w", BOARD_XPOS+44);
+xpos:
+   __asm__("STA %w,X", VGA_ADDR_SPRITE_1_X);
+   __asm__("SEC");
+   __asm__("SBC #$14");
+   __asm__("DEX");
+   __asm__("DEX");
+   __asm__("BPL %g", xpos);
+   __asm__("LDA #$00");
    __asm__("STA %w", VGA_ADDR_SPRITE_1_X_MSB);
-
-   __asm__("LDA #<%w", BOARD_XPOS+24);
-   __asm__("STA %w", VGA_ADDR_SPRITE_2_X);
-   __asm__("LDA #>%w", BOARD_XPOS+24);
    __asm__("STA %w", VGA_ADDR_SPRITE_2_X_MSB);
-
-   __asm__("LDA #<%w", BOARD_XPOS+44);
-   __asm__("STA %w", VGA_ADDR_SPRITE_3_X);
-   __asm__("LDA #>%w", BOARD_XPOS+44);
    __asm__("STA %w", VGA_ADDR_SPRITE_3_X_MSB);
 
-   __asm__("LDA #%b", COL_WHITE);
-   __asm__("STA %w", VGA_ADDR_SPRITE_1_COL);
-   __asm__("STA %w", VGA_ADDR_SPRITE_2_COL);
-   __asm__("STA %w", VGA_ADDR_SPRITE_3_COL);
-
    __asm__("LDA #%b", BOARD_YPOS);
    __asm__("STA %w", VGA_ADDR_YLINE); // The line number for interrupt
+   __asm__("LDA #$00");
+   __asm__("STA %v", row);
+
+   __asm__("LDX #$02");
+enable:
+   __asm__("LDA #%b", COL_WHITE);
+   __asm__("STA %w,X", VGA_ADDR_SPRITE_1_COL);
    __asm__("LDA #$01");
+   __asm__("STA %w,X", VGA_ADDR_SPRITE_1_ENA);
+   __asm__("DEX");
+   __asm__("BPL %g", enable);
    __asm__("STA %w", VGA_ADDR_MASK); // Enable IRQ
    __asm__("CLI");
-} // end of initScreen
+} // end of vga_init
 
 // Maskable interrupt
 void __fastcall__ vga_irq(void)
@@ -162,138 +177,89 @@ void __fastcall__ vga_irq(void)
    __asm__("STA %w", VGA_ADDR_SPRITE_1_Y);
    __asm__("STA %w", VGA_ADDR_SPRITE_2_Y);
    __asm__("STA %w", VGA_ADDR_SPRITE_3_Y);
-   __asm__("LDA %w", VGA_ADDR_YLINE); // The line number for interrupt
-   __asm__("CMP #%b", BOARD_YPOS);
-   __asm__("BEQ %g", row1);
-   __asm__("CMP #%b", BOARD_YPOS+20);
-   __asm__("BEQ %g", row2);
-   __asm__("CMP #%b", BOARD_YPOS+40);
-   __asm__("BEQ %g", row3);
-   __asm__("RTS");
-
-row1:
-   __asm__("LDA #%b", BOARD_YPOS+20);
-   __asm__("STA %w", VGA_ADDR_YLINE);
-   __asm__("LDX #$00");
-   __asm__("JMP %g", row);
 
-row2:
-   __asm__("LDA #%b", BOARD_YPOS+40);
-   __asm__("STA %w", VGA_ADDR_YLINE);
-   __asm__("LDX #$03");
-   __asm__("JMP %g", row);
-
-row3:
+   // Move to the next row of the board.
+   __asm__("ADC #$10");
+   __asm__("CMP #%b", BOARD_YPOS+60);
+   __asm__("BNE %g", nextLine);
    __asm__("LDA #%b", BOARD_YPOS);
+nextLine:
    __asm__("STA %w", VGA_ADDR_YLINE);
-   __asm__("LDX #$06");
-
-row:
-   __asm__("LDA %v,X", pieces);
-   __asm__("BEQ %g", col1empty);
-   __asm__("CMP #%b", 'X');
-   __asm__("BEQ %g", col1x);
-   __asm__("CMP #%b", 'O');
-   __asm__("BEQ %g", col1o);
-   __asm__("JMP %g", col2);
-col1empty:
+   __asm__("LDA %v", row);
+   __asm__("TAX");
+   __asm__("CLC");
+   __asm__("ADC #$03");
+   __asm__("CMP #$09");
+   __asm__("BNE %g", nextRow);
    __asm__("LDA #$00");
-   __asm__("STA %w", VGA_ADDR_SPRITE_1_ENA);
-   __asm__("JMP %g", col2);
-col1x:
-   __asm__("LDA #<%v", bitmap_X);
-   __asm__("STA %b", ZP_SRC_LO);
-   __asm__("LDA #>%v", bitmap_X);
-   __asm__("STA %b", ZP_SRC_HI);
-   __asm__("JMP %g", col1enable);
-col1o:
-   __asm__("LDA #<%v", bitmap_O);
-   __asm__("STA %b", ZP_SRC_LO);
-   __asm__("LDA #>%v", bitmap_O);
-   __asm__("STA %b", ZP_SRC_HI);
-col1enable:
+nextRow:
+   __asm__("STA %v", row);
+
    __asm__("LDA #<%w", VGA_ADDR_SPRITE_1_BITMAP);
    __asm__("STA %b", ZP_DST_LO);
    __asm__("LDA #>%w", VGA_ADDR_SPRITE_1_BITMAP);
    __asm__("STA %b", ZP_DST_HI);
+
+   // Sprites 1 to 3 show the three squares of the current row.
+col:
    __asm__("LDA #$20");
    __asm__("TAY");
-   my_memcpy();
-   __asm__("LDA #$01");
-   __asm__("STA %w", VGA_ADDR_SPRITE_1_ENA);
-
-col2:
-   __asm__("INX");
    __asm__("LDA %v,X", pieces);
-   __asm__("BEQ %g", col2empty);
+   __asm__("BEQ %g", colEmpty);
    __asm__("CMP #%b", 'X');
-   __asm__("BEQ %g", col2x);
-   __asm__("CMP #%b", 'O');
-   __asm__("BEQ %g", col2o);
-   __asm__("JMP %g", col3);
-col2empty:
-   __asm__("LDA #$00");
-   __asm__("STA %w", VGA_ADDR_SPRITE_2_ENA);
-   __asm__("JMP %g", col3);
-col2x:
-   __asm__("LDA #<%v", bitmap_X);
-   __asm__("STA %b", ZP_SRC_LO);
-   __asm__("LDA #>%v", bitmap_X);
-   __asm__("STA %b", ZP_SRC_HI);
-   __asm__("JMP %g", col2enable);
-col2o:
+   __asm__("BEQ %g", colX);
    __asm__("LDA #<%v", bitmap_O);
    __asm__("STA %b", ZP_SRC_LO);
    __asm__("LDA #>%v", bitmap_O);
    __asm__("STA %b", ZP_SRC_HI);
-col2enable:
-   __asm__("LDA #<%w", VGA_ADDR_SPRITE_2_BITMAP);
-   __asm__("STA %b", ZP_DST_LO);
-   __asm__("LDA #>%w", VGA_ADDR_SPRITE_2_BITMAP);
-   __asm__("STA %b", ZP_DST_HI);
-   __asm__("LDA #$20");
-   __asm__("TAY");
-   my_memcpy();
-   __asm__("LDA #$01");
-   __asm__("STA %w", VGA_ADDR_SPRITE_2_ENA);
-
-col3:
-   __asm__("INX");
-   __asm__("LDA %v,X", pieces);
-   __asm__("BEQ %g", col3empty);
-   __asm__("CMP #%b", 'X');
-   __asm__("BEQ %g", col3x);
-   __asm__("CMP #%b", 'O');
-   __asm__("BEQ %g", col3o);
-   __asm__("JMP %g", end);
-col3empty:
-   __asm__("LDA #$00");
-   __asm__("STA %w", VGA_ADDR_SPRITE_3_ENA);
-   __asm__("JMP %g", end);
-col3x:
+   __asm__("JMP %g", colCopy);
+colX:
    __asm__("LDA #<%v", bitmap_X);
    __asm__("STA %b", ZP_SRC_LO);
    __asm__("LDA #>%v", bitmap_X);
    __asm__("STA %b", ZP_SRC_HI);
-   __asm__("JMP %g", col3enable);
-col3o:
-   __asm__("LDA #<%v", bitmap_O);
-   __asm__("STA %b", ZP_SRC_LO);
-   __asm__("LDA #>%v", bitmap_O);
-   __asm__("STA %b", ZP_SRC_HI);
-col3enable:
-   __asm__("LDA #<%w", VGA_ADDR_SPRITE_3_BITMAP);
+colCopy:
+   memcpy8();
+   __asm__("JMP %g", colNext);
+colEmpty:
+   __asm__("DEY");                  // A is zero here
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("BNE %g", colEmpty);
+
+colNext:
+   __asm__("INX");
+   __asm__("LDA %b", ZP_DST_LO);   // Next sprite bitmap
+   __asm__("CLC");
+   __asm__("ADC #$20");
    __asm__("STA %b", ZP_DST_LO);
-   __asm__("LDA #>%w", VGA_ADDR_SPRITE_3_BITMAP);
+   __asm__("CMP #<%w", VGA_ADDR_SPRITE_1_BITMAP + 0x60);
+   __asm__("BNE %g", col);
+} // end of vga_irq
+
+// Draws the 4x4 board in text mode.
+void __fastcall__ vga_draw(void)
+{
+   __asm__("LDA %v", squares);
+   __asm__("CMP #$10");
+   __asm__("BNE %g", end);
+
+   __asm__("LDA #<%w", VGA_ADDR_SCREEN);
+   __asm__("STA %b", ZP_DST_LO);
+   __asm__("LDA #>%w", VGA_ADDR_SCREEN);
    __asm__("STA %b", ZP_DST_HI);
-   __asm__("LDA #$20");
+   __asm__("LDX #$0F");
+loop:
+   __asm__("LDA %v,X", offset4);
    __asm__("TAY");
-   my_memcpy();
-   __asm__("LDA #$01");
-   __asm__("STA %w", VGA_ADDR_SPRITE_3_ENA);
-
+   __asm__("LDA %v,X", pieces);
+   __asm__("BNE %g", piece);
+   __asm__("LDA #%b", '.');
+piece:
+   __asm__("STA (%b),Y", ZP_DST_LO);
+   __asm__("DEX");
+   __asm__("BPL %g", loop);
 end:
    __asm__("RTS");
+} // end of vga_draw
 
-} // end of irq
 
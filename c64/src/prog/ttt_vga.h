@@ -1,4 +1,3 @@
 void __fastcall__ vga_init(void);
 void __fastcall__ vga_irq(void);
-void __fastcall__ my_memcpy(void);
-void __fastcall__ my_memset(void);
+void __fastcall__ vga_draw(void);
@@ -8,7 +8,8 @@
 #define ZP_XSCROLL         0x05
 #define ZP_CNT             0x06
 #define ZP_AI_TEMP         0x07
-#define ZP_AI_NUMPOS       0x08
+#define ZP_TTT_KEYS_LO     0x08  // Pointer to table of scan codes
+#define ZP_TTT_KEYS_HI     0x09
 
 #define ZP_XLO             0x10
 #define ZP_XHI             0x11
@@ -34,8 +35,97 @@
 #define ZP_UMULT_X         0x31
 #define ZP_UMULT_C         0x32
 
+#define ZP_CPU_DATA        0x38  // Operand of the instructions being measured
+#define ZP_CPU_PTR_LO      0x39  // Pointer to ZP_CPU_DATA
+#define ZP_CPU_PTR_HI      0x3A
+#define ZP_CPU_COUNT       0x3B
+#define ZP_CPU_START       0x3C  // Clock cycle counter before the instructions
+#define ZP_CPU_EMPTY       0x3D  // Cycles used without any instructions
+#define ZP_CPU_SP          0x3E  // Stack pointer to restore afterwards
+#define ZP_CPU_CYCLES      0x3F  // Cycles per instruction
+
 #define ZP_SRC_LO          0x40
 #define ZP_SRC_HI          0x41
 #define ZP_DST_LO          0x42
 #define ZP_DST_HI          0x43
+#define ZP_LEN_LO          0x44  // Number of bytes for the 16-bit block routines
+#define ZP_LEN_HI          0x45
+#define ZP_MEM_VAL         0x46
+
+#define ZP_QUEENS_ROW      0x50  // Current row
+#define ZP_QUEENS_PLACED   0x51  // Number of queens on the board
+#define ZP_QUEENS_SIZE     0x52  // Number of rows and columns
+#define ZP_QUEENS_FULL_LO  0x53  // One bit for each column
+#define ZP_QUEENS_FULL_HI  0x54
+#define ZP_QUEENS_BIT_LO   0x55  // Column of the queen just placed
+#define ZP_QUEENS_BIT_HI   0x56
+#define ZP_QUEENS_OCC_LO   0x57  // Columns attacked in the next row
+#define ZP_QUEENS_OCC_HI   0x58
+#define ZP_QUEENS_TEMP     0x59
+#define ZP_QUEENS_INDEX_LO 0x5A  // Pointer to table of bit index
+#define ZP_QUEENS_INDEX_HI 0x5B
+#define ZP_QUEENS_FRAME    0x5C  // Set once every frame by the IRQ
+
+#define ZP_NUM_0           0x64  // 32-bit number, least significant byte first
+#define ZP_NUM_1           0x65
+#define ZP_NUM_2           0x66
+#define ZP_NUM_3           0x67
+#define ZP_DIV_0           0x68  // 32-bit divisor
+#define ZP_DIV_1           0x69
+#define ZP_DIV_2           0x6A
+#define ZP_DIV_3           0x6B
+#define ZP_REM_0           0x6C  // 32-bit remainder
+#define ZP_REM_1           0x6D
+#define ZP_REM_2           0x6E
+#define ZP_REM_3           0x6F
+
+#define ZP_MULT_A          0x70  // 8-bit operands
+#define ZP_MULT_B          0x71
+#define ZP_MULT_T_LO       0x72
+#define ZP_MULT_T_HI       0x73
+#define ZP_MULT_X_LO       0x74  // 16-bit operands
+#define ZP_MULT_X_HI       0x75
+#define ZP_MULT_Y_LO       0x76
+#define ZP_MULT_Y_HI       0x77
+#define ZP_MULT_R0         0x78  // 32-bit result, least significant byte first
+#define ZP_MULT_R1         0x79
+#define ZP_MULT_R2         0x7A
+#define ZP_MULT_R3         0x7B
+
+#define ZP_BENCH_I         0x7C  // Loop counters
+#define ZP_BENCH_J         0x7D
+#define ZP_BENCH_LO        0x7E  // Expected product
+#define ZP_BENCH_HI        0x7F
+#define ZP_BENCH_ERR_LO    0x80  // Number of wrong products
+#define ZP_BENCH_ERR_HI    0x81
+#define ZP_BENCH_BASE_0    0x82  // Cycles used by an empty loop
+#define ZP_BENCH_BASE_1    0x83
+#define ZP_BENCH_BASE_2    0x84
+#define ZP_BENCH_BASE_3    0x85
 
+#define ZP_AI_ME_LO        0x86  // Bit board of the player to move
+#define ZP_AI_ME_HI        0x87
+#define ZP_AI_YOU_LO       0x88  // Bit board of the other player
+#define ZP_AI_YOU_HI       0x89
+#define ZP_AI_OCC_LO       0x8A  // Occupied squares
+#define ZP_AI_OCC_HI       0x8B
+#define ZP_AI_BIT_LO       0x8C  // Bit of the current square
+#define ZP_AI_BIT_HI       0x8D
+#define ZP_AI_MASK_LO      0x8E  // Current line
+#define ZP_AI_MASK_HI      0x8F
+#define ZP_AI_PLY          0x90  // Current depth in the search
+#define ZP_AI_DEPTH        0x91  // Last ply of the search
+#define ZP_AI_EMPTY        0x92  // Number of empty squares
+#define ZP_AI_SQUARES      0x93  // Number of squares on the board, 9 or 16
+#define ZP_AI_LINES        0x94  // Number of bytes in the table of lines
+#define ZP_AI_SCORE        0x95
+#define ZP_AI_EVAL         0x96
+#define ZP_AI_LINE_LO      0x97  // Pointer to table of lines
+#define ZP_AI_LINE_HI      0x98
+#define ZP_AI_ORDER_LO     0x99  // Pointer to table of move order
+#define ZP_AI_ORDER_HI     0x9A
+#define ZP_AI_TT_LO        0x9B  // Pointer to an entry in the transposition table
+#define ZP_AI_TT_HI        0x9C
+#define ZP_AI_POS_LO       0x9D  // Pointer to the two bit boards
+#define ZP_AI_POS_HI       0x9E
+#define ZP_AI_TT           0xA0  // Transposition table, 16 entries of 6 bytes
@@ -62,7 +62,8 @@ entity chars is
       hsync_o     : out std_logic;
       vsync_o     : out std_logic;
       blank_o     : out std_logic;
-      col_o       : out std_logic_vector( 7 downto 0)
+      col_o       : out std_logic_vector( 7 downto 0);
+      pix_o       : out std_logic                        -- Character foreground
    );
 end chars;
 
@@ -426,6 +427,7 @@ begin
 
          if stage7.blank = '1' then
             stage8.col <= (others => '0');
+            stage8.pix <= '0';
          end if;
 
          -- Undo effects of horizontal scrolling.
@@ -442,6 +444,7 @@ begin
    vsync_o  <= stage8.vsync;
    col_o    <= stage8.col;
    blank_o  <= stage8.blank;
+   pix_o    <= stage8.pix;
 
 end Behavioral;
 
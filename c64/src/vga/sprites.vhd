@@ -14,6 +14,17 @@
 -- * 0x1B Y-line interrupt
 -- * 0x1C IRQ status
 -- * 0x1D IRQ mask
+--
+-- The collision status in collision_o is valid for each pixel and contains
+-- * bits  3-0 : Sprites overlapping another sprite
+-- * bits  9-4 : Pairs of sprites overlapping, in the order 0-1, 0-2, 0-3,
+--               1-2, 1-3, and 2-3
+-- * bits 13-10: Sprites overlapping a character in the foreground
+--
+-- For each pair of sprites, contact_o holds the coordinates of the first pixel
+-- where the pair overlapped in the current frame. They are in the same units
+-- as the sprite positions, i.e. bits 8-0 are X and bits 16-9 are Y. The
+-- coordinates keep their value in frames without a collision.
 -----------------------------------------------------------------------------
 
 library ieee;
@@ -31,6 +42,7 @@ entity sprites is
       vs_i          : in  std_logic;
       blank_i       : in  std_logic;
       col_i         : in  std_logic_vector( 7 downto 0);
+      char_pix_i    : in  std_logic;
 
       config_i      : in  std_logic_vector(32*8-1 downto 0);
 
@@ -43,7 +55,8 @@ entity sprites is
       vs_o          : out std_logic;
       blank_o       : out std_logic;
       col_o         : out std_logic_vector( 7 downto 0);
-      collision_o   : out std_logic_vector( 3 downto 0)
+      collision_o   : out std_logic_vector(13 downto 0);
+      contact_o     : out std_logic_vector(6*17-1 downto 0)
    );
 end sprites;
 
@@ -57,6 +70,11 @@ architecture Behavioral of sprites is
    -- This is the same value as defined in vga/sync.vhd
    constant H_MAX   : natural := 800;            -- H total period (pixels)
 
+   -- The two sprites in each pair
+   type t_pair is array(0 to 5) of integer range 0 to 3;
+   constant C_PAIR_A : t_pair := (0, 0, 0, 1, 1, 2);
+   constant C_PAIR_B : t_pair := (1, 2, 3, 2, 3, 3);
+
    signal fsm_addr  : std_logic_vector(4*4-1 downto 0) := (others => '0');
    signal fsm_rden  : std_logic_vector(3 downto 0) := (others => '0');
 
@@ -79,12 +97,15 @@ architecture Behavioral of sprites is
       vs              : std_logic;                         -- Valid in stage 0
       blank           : std_logic;                         -- Valid in stage 0
       col             : std_logic_vector( 7 downto 0);     -- Valid in stage 0
+      char_pix        : std_logic;                         -- Valid in stage 0
       row_index       : std_logic_vector(4*4-1 downto 0);  -- Valid in stage 1 (0 - 15) for each sprite
       row_index_valid : std_logic_vector(3 downto 0);      -- Valid in stage 1
       col_index       : std_logic_vector(4*4-1 downto 0);  -- Valid in stage 1 (0 - 15) for each sprite
       col_index_valid : std_logic_vector(3 downto 0);      -- Valid in stage 1
       pix             : std_logic_vector(3 downto 0);      -- Valid in stage 2
-      collision       : std_logic_vector(3 downto 0);      -- Valid in stage 2
+      collision       : std_logic_vector(3 downto 0);      -- Valid in stage 3
+      coll_pair       : std_logic_vector(5 downto 0);      -- Valid in stage 3
+      coll_char       : std_logic_vector(3 downto 0);      -- Valid in stage 3
    end record t_stage;
 
    constant STAGE_DEFAULT : t_stage := (
@@ -94,12 +115,15 @@ architecture Behavioral of sprites is
       vs              => '0',
       blank           => '0',
       col             => (others => '0'),
+      char_pix        => '0',
       row_index       => (others => '0'),
       row_index_valid => (others => '0'),
       col_index       => (others => '0'),
       col_index_valid => (others => '0'),
       pix             => (others => '0'),
-      collision       => (others => '0')
+      collision       => (others => '0'),
+      coll_pair       => (others => '0'),
+      coll_char       => (others => '0')
    );
 
    signal stage0 : t_stage := STAGE_DEFAULT;
@@ -107,6 +131,10 @@ architecture Behavioral of sprites is
    signal stage2 : t_stage := STAGE_DEFAULT;
    signal stage3 : t_stage := STAGE_DEFAULT;
 
+   -- First contact of each pair of sprites in the current frame
+   signal contact      : std_logic_vector(6*17-1 downto 0) := (others => '0');
+   signal contact_seen : std_logic_vector(5 downto 0) := (others => '0');
+
    type t_posx    is array(natural range <>) of std_logic_vector(8 downto 0);
    type t_posy    is array(natural range <>) of std_logic_vector(7 downto 0);
    type t_color   is array(natural range <>) of std_logic_vector(7 downto 0);
@@ -241,6 +269,7 @@ begin
    stage0.vs     <= vs_i;
    stage0.blank  <= blank_i;
    stage0.col    <= col_i;
+   stage0.char_pix <= char_pix_i;
 
 
    ----------------------------------------
@@ -304,6 +333,7 @@ begin
    ----------------------------------------
 
    p_stage3 : process (clk_i)
+      variable seen_v : std_logic_vector(5 downto 0);
    begin
       if rising_edge(clk_i) then
          stage3 <= stage2;
@@ -321,6 +351,32 @@ begin
             stage3.collision <= stage2.pix;
          end if;
 
+         -- Collision between each pair of sprites. The coordinates of the
+         -- first contact are recorded once every frame.
+         seen_v := contact_seen;
+         if stage2.hcount = 0 and stage2.vcount = 0 then
+            seen_v := (others => '0');
+         end if;
+
+         stage3.coll_pair <= (others => '0');
+         for p in 0 to 5 loop
+            if stage2.pix(C_PAIR_A(p)) = '1' and stage2.pix(C_PAIR_B(p)) = '1' then
+               stage3.coll_pair(p) <= '1';
+               if seen_v(p) = '0' then
+                  contact(p*17 +  8 downto p*17)     <= stage2.hcount(9 downto 1);
+                  contact(p*17 + 16 downto p*17 + 9) <= stage2.vcount(8 downto 1);
+                  seen_v(p) := '1';
+               end if;
+            end if;
+         end loop;
+         contact_seen <= seen_v;
+
+         -- Collision between sprites and characters in the foreground.
+         stage3.coll_char <= (others => '0');
+         if stage2.char_pix = '1' then
+            stage3.coll_char <= stage2.pix;
+         end if;
+
       end if;
    end process p_stage3;
 
@@ -335,7 +391,8 @@ begin
    vs_o        <= stage3.vs;
    blank_o     <= stage3.blank;
    col_o       <= stage3.col;
-   collision_o <= stage3.collision;
+   collision_o <= stage3.coll_char & stage3.coll_pair & stage3.collision;
+   contact_o   <= contact;
 
 end Behavioral;
 
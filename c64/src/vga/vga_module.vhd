@@ -25,6 +25,9 @@
 --
 -- Interrupt is level-asserted, whenever the current line number matches the
 -- value of 0x1B.
+--
+-- The collision status and the coordinates of the first contact between each
+-- pair of sprites are described in vga/sprites.vhd.
 ----------------------------------------------------------------------------------
 
 library ieee;
@@ -45,7 +48,8 @@ entity vga_module is
       col_o       : out std_logic_vector(  7 downto 0);
       hcount_o    : out std_logic_vector( 10 downto 0);
       vcount_o    : out std_logic_vector( 10 downto 0);
-      collision_o : out std_logic_vector(  3 downto 0);
+      collision_o : out std_logic_vector( 13 downto 0);
+      contact_o   : out std_logic_vector(6*17-1 downto 0);
       --
       font_addr_o : out std_logic_vector( 11 downto 0);
       font_data_i : in  std_logic_vector(  7 downto 0);
@@ -82,6 +86,7 @@ architecture Structural of vga_module is
    signal char_hcount : std_logic_vector(10 downto 0);
    signal char_vcount : std_logic_vector(10 downto 0);
    signal char_col    : std_logic_vector( 7 downto 0);
+   signal char_pix    : std_logic;
 
    -- Signals driven by the Sprite Display block
    signal sprite_hs        : std_logic; 
@@ -90,7 +95,8 @@ architecture Structural of vga_module is
    signal sprite_hcount    : std_logic_vector(10 downto 0);
    signal sprite_vcount    : std_logic_vector(10 downto 0);
    signal sprite_col       : std_logic_vector( 7 downto 0);
-   signal sprite_collision : std_logic_vector( 3 downto 0);
+   signal sprite_collision : std_logic_vector(13 downto 0);
+   signal sprite_contact   : std_logic_vector(6*17-1 downto 0);
 
    constant C_YINT : integer := 27;
 
@@ -151,7 +157,8 @@ begin
       hsync_o     => char_hs,
       vsync_o     => char_vs,
       blank_o     => char_blank,
-      col_o       => char_col
+      col_o       => char_col,
+      pix_o       => char_pix
    );
 
 
@@ -169,6 +176,7 @@ begin
       vs_i          => char_vs,
       blank_i       => char_blank,
       col_i         => char_col,
+      char_pix_i    => char_pix,
 
       config_i      => config_i,
 
@@ -181,7 +189,8 @@ begin
       vs_o          => sprite_vs,
       blank_o       => sprite_blank,
       col_o         => sprite_col,
-      collision_o   => sprite_collision
+      collision_o   => sprite_collision,
+      contact_o     => sprite_contact
    );
 
    -----------------------
@@ -194,6 +203,7 @@ begin
    hcount_o    <= sprite_hcount;
    vcount_o    <= sprite_vcount;
    collision_o <= sprite_collision;
+   contact_o   <= sprite_contact;
 
 end Structural;
 
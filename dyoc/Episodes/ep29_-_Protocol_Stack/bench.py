@@ -0,0 +1,57 @@
+#! /usr/bin/env python
+
+# This builds each of the benchmark programs, runs it in the GHDL simulation
+# until it writes BENCH_DONE (see prog/inc/bench.h), and collects the number
+# of clock cycles reported by the testbench.
+#
+# The result is printed and written to bench.json, with one entry per program.
+# A program that fails to build, fails in simulation, or does not finish in
+# time gets the value null.
+#
+# Usage: ./bench.py [program ...]
+
+import sys
+import json
+import re
+import subprocess
+
+PROGRAMS = ["life", "sudoku", "maze2d", "ethernet", "timertest", "alloctest"]
+
+RESULT_FILE = "bench.json"
+
+def run(args):
+    p = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    out = p.communicate()[0].decode("ascii", "replace")
+    return p.returncode, out
+
+def bench(program):
+    # A clean build is needed, since the program objects and the ROM file
+    # do not depend on the value of PROGRAM or CFLAGS.
+    run(["make", "-C", "prog", "clean"])
+    rc, out = run(["make", "-C", "prog", "PROGRAM=" + program, "CFLAGS=-O -DBENCH"])
+    if rc != 0:
+        sys.stderr.write(out)
+        return None
+
+    # GHDL fails on an assertion error, e.g. a wrong frame in the Ethernet
+    # test, and the cycles are then not trusted either.
+    rc, out = run(["make", "-C", "fpga", "bench"])
+    m = re.search(r"BENCH cycles=([0-9A-Fa-f]+)", out)
+    if rc != 0 or m is None:
+        sys.stderr.write(out)
+        return None
+
+    return int(m.group(1), 16)
+
+programs = sys.argv[1:] or PROGRAMS
+
+results = {}
+for program in programs:
+    results[program] = bench(program)
+    print("%-10s %s" % (program, results[program]))
+
+fl = open(RESULT_FILE, "w")
+json.dump(results, fl, indent=3, sort_keys=True)
+fl.write("\n")
+fl.close()
+
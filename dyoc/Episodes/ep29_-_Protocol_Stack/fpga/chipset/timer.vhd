@@ -3,24 +3,44 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std_unsigned.all;
 
 -- This helper module emulates a timer that generates an interrupt at a fixed interval.
+--
+-- Additionally, it contains a free-running 48-bit microsecond counter.
+-- The value read by the CPU is frozen while latch_i is '1', so that all six
+-- bytes can be read consistently.
+-- The compare interrupt is a one-shot: When enabled, it fires once the
+-- counter reaches the compare value, and then clears the enable.
 
 entity timer is
    generic (
-      G_TIMER_CNT : integer
+      G_TIMER_CNT : integer;
+      G_USEC_CNT  : integer     -- Number of clock cycles per microsecond
    );
    port (
-      clk_i : in  std_logic;  -- Approx 25 MHz
-      irq_o : out std_logic
+      clk_i         : in  std_logic;  -- Approx 25 MHz
+      irq_o         : out std_logic;
+
+      latch_i       : in  std_logic;
+      usec_o        : out std_logic_vector(47 downto 0);
+      cmp_i         : in  std_logic_vector(47 downto 0);
+      cmp_enable_i  : in  std_logic;
+      cmp_clear_o   : out std_logic;  -- Clears cmp_enable_i
+      cmp_irq_o     : out std_logic
    );
 end timer;
 
 architecture structural of timer is
 
    constant C_TIMER_CNT : std_logic_vector(17 downto 0) := to_std_logic_vector(G_TIMER_CNT, 18);
+   constant C_USEC_CNT  : std_logic_vector( 7 downto 0) := to_std_logic_vector(G_USEC_CNT, 8);
 
    signal cnt_r : std_logic_vector(17 downto 0) := (others => '0');
    signal irq_r : std_logic := '0';
 
+   signal usec_cnt_r   : std_logic_vector( 7 downto 0) := (others => '0');
+   signal usec_r       : std_logic_vector(47 downto 0) := (others => '0');
+   signal usec_latch_r : std_logic_vector(47 downto 0) := (others => '0');
+   signal cmp_irq_r    : std_logic := '0';
+
 begin
 
    --------------------------------------------------
@@ -51,11 +71,58 @@ begin
    end process p_irq;
 
 
+   --------------------------------------------------
+   -- Microsecond counter
+   --------------------------------------------------
+
+   p_usec : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+
+         if usec_cnt_r = C_USEC_CNT-1 then
+            usec_cnt_r <= (others => '0');
+            usec_r     <= usec_r + 1;
+         else
+            usec_cnt_r <= usec_cnt_r + 1;
+         end if;
+      end if;
+   end process p_usec;
+
+   -- Latch the counter while the CPU is reading it.
+   p_usec_latch : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if latch_i = '0' then
+            usec_latch_r <= usec_r;
+         end if;
+      end if;
+   end process p_usec_latch;
+
+
+   --------------------------------------------------
+   -- Generate compare interrupt
+   --------------------------------------------------
+
+   p_cmp_irq : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         cmp_irq_r <= '0';
+
+         if cmp_enable_i = '1' and cmp_irq_r = '0' and usec_r >= cmp_i then
+            cmp_irq_r <= '1';
+         end if;
+      end if;
+   end process p_cmp_irq;
+
+
    --------------------------------------------------
    -- Drive output signals
    --------------------------------------------------
 
-   irq_o  <= irq_r;
+   irq_o       <= irq_r;
+   usec_o      <= usec_latch_r;
+   cmp_clear_o <= cmp_irq_r;
+   cmp_irq_o   <= cmp_irq_r;
 
 end architecture structural;
 
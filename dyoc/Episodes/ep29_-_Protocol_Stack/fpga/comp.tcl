@@ -1,12 +1,12 @@
 # This is a tcl command script for the Vivado tool chain
 read_vhdl -vhdl2008 { \
    chipset/ic.vhd chipset/waiter.vhd chipset/timer.vhd \
-   vga/overlay.vhd vga/chars.vhd vga/font.vhd vga/vga.vhd \
+   vga/overlay.vhd vga/chars.vhd vga/font.vhd vga/bitmap.vhd vga/blitter.vhd vga/sprites.vhd vga/vga.vhd \
    mem/dmem.vhd mem/ram.vhd mem/rom.vhd mem/mem.vhd mem/memio.vhd \
    keyboard/ps2.vhd keyboard/scancode.vhd keyboard/keyboard.vhd \
    cpu/zp.vhd cpu/sr.vhd cpu/regfile.vhd cpu/hilo.vhd cpu/pc.vhd cpu/datapath.vhd cpu/ctl.vhd cpu/cpu.vhd cpu/alu.vhd cpu/cycle.vhd \
    ethernet/ethernet.vhd ethernet/lan8720a/lan8720a.vhd ethernet/lan8720a/rmii_rx.vhd ethernet/lan8720a/rmii_tx.vhd \
-   ethernet/rx_dma.vhd ethernet/fifo.vhd ethernet/rx_header.vhd ethernet/tx_dma.vhd \
+   ethernet/rx_dma.vhd ethernet/fifo.vhd ethernet/rx_header.vhd ethernet/tx_dma.vhd ethernet/responder.vhd ethernet/rx_filter.vhd \
    comp.vhd}
 read_xdc comp.xdc
 synth_design -top comp -part xc7a100tcsg324-1 -flatten_hierarchy none
@@ -106,17 +106,54 @@ architecture structural of comp is
    signal cpu_memio_eth_txdma_ptr      : std_logic_vector(15 downto 0);
    signal cpu_memio_eth_txdma_enable   : std_logic;
    signal cpu_memio_eth_txdma_clear    : std_logic;
+   signal cpu_memio_eth_txdma_payload_ptr : std_logic_vector(15 downto 0);
+   signal cpu_memio_eth_txdma_payload_len : std_logic_vector(15 downto 0);
+   signal cpu_memio_eth_resp_mac       : std_logic_vector(47 downto 0);
+   signal cpu_memio_eth_resp_ip        : std_logic_vector(31 downto 0);
+   signal cpu_memio_eth_resp_enable    : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_resp_cnt_arp   : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_resp_cnt_icmp  : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_filt_enable    : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_filt_mcast     : std_logic_vector(47 downto 0);
+   signal cpu_memio_eth_filt_etype     : std_logic_vector(47 downto 0);
+   signal cpu_memio_eth_filt_udp       : std_logic_vector(63 downto 0);
+   signal cpu_memio_eth_filt_cnt_mac   : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_filt_cnt_etype : std_logic_vector( 7 downto 0);
+   signal cpu_memio_eth_filt_cnt_udp   : std_logic_vector( 7 downto 0);
 
    -- Memory Mapped I/O
-   signal memio_rd    : std_logic_vector(8*32-1 downto 0);
-   signal memio_rden  : std_logic_vector(  32-1 downto 0);
-   signal memio_wr    : std_logic_vector(8*32-1 downto 0);
-   signal memio_clear : std_logic_vector(  32-1 downto 0);
+   signal memio_rd    : std_logic_vector(8*128-1 downto 0);
+   signal memio_rden  : std_logic_vector(  128-1 downto 0);
+   signal memio_wr    : std_logic_vector(8*128-1 downto 0);
+   signal memio_wren  : std_logic_vector(  128-1 downto 0);
+   signal memio_clear : std_logic_vector(  128-1 downto 0);
 
    signal vga_memio_palette   : std_logic_vector(16*8-1 downto 0);
    signal vga_memio_pix_y_int : std_logic_vector( 2*8-1 downto 0);
    signal vga_memio_pix_x     : std_logic_vector( 2*8-1 downto 0);
    signal vga_memio_pix_y     : std_logic_vector( 2*8-1 downto 0);
+   signal vga_memio_front     : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_front_active : std_logic_vector( 1*8-1 downto 0);
+   signal vga_bank            : std_logic;
+   signal mem_memio_bank      : std_logic_vector( 1*8-1 downto 0);
+
+   signal vga_memio_bitmap       : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_x       : std_logic_vector( 2*8-1 downto 0);
+   signal vga_memio_blit_y       : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_w       : std_logic_vector( 2*8-1 downto 0);
+   signal vga_memio_blit_h       : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_col     : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_cmd     : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_clear   : std_logic;
+   signal vga_memio_blit_src_x   : std_logic_vector( 2*8-1 downto 0);
+   signal vga_memio_blit_src_y   : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_blit_pattern : std_logic_vector( 8*8-1 downto 0);
+
+   signal vga_memio_sprite         : std_logic_vector(24*8-1 downto 0);
+   signal vga_memio_sprite_addr    : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_sprite_data    : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_sprite_coll    : std_logic_vector( 1*8-1 downto 0);
+   signal vga_memio_sprite_fg      : std_logic_vector( 1*8-1 downto 0);
 
    signal kbd_memio_data : std_logic_vector( 1*8-1 downto 0);
 
@@ -127,12 +164,22 @@ architecture structural of comp is
    signal cpu_memio_latch : std_logic_vector( 1*8-1 downto 0);
    signal cpu_memio_cyc   : std_logic_vector( 4*8-1 downto 0);
 
+   signal timer_memio_usec       : std_logic_vector( 6*8-1 downto 0);
+   signal timer_memio_cmp        : std_logic_vector( 6*8-1 downto 0);
+   signal timer_memio_cmp_enable : std_logic;
+   signal timer_memio_cmp_clear  : std_logic;
+
+   -- Only used by the testbench, see tb.vhd.
+   signal bench_memio_cycles     : std_logic_vector( 4*8-1 downto 0);
+   signal bench_memio_done       : std_logic;
+
    -- Interrupt controller
    signal ic_irq    : std_logic_vector(7 downto 0);
    signal cpu_irq   : std_logic;
    signal vga_irq   : std_logic;
    signal kbd_irq   : std_logic;
    signal timer_irq : std_logic := '0';
+   signal timer_cmp_irq : std_logic := '0';
 
    signal kbd_debug : std_logic_vector(15 downto 0);
 
@@ -190,11 +237,18 @@ begin
 
    i_timer : entity work.timer
    generic map (
-      G_TIMER_CNT => 25000    -- Generate interrupt every millisecond
+      G_TIMER_CNT => 25000,   -- Generate interrupt every millisecond
+      G_USEC_CNT  => 25       -- Count microseconds
    )
    port map (
-      clk_i => vga_clk,
-      irq_o => timer_irq
+      clk_i        => vga_clk,
+      irq_o        => timer_irq,
+      latch_i      => cpu_memio_latch(0),
+      usec_o       => timer_memio_usec,
+      cmp_i        => timer_memio_cmp,
+      cmp_enable_i => timer_memio_cmp_enable,
+      cmp_clear_o  => timer_memio_cmp_clear,
+      cmp_irq_o    => timer_cmp_irq
    );
 
 
@@ -251,18 +305,24 @@ begin
    generic map (
       G_ROM_SIZE   => 14, -- 16 Kbytes
       G_RAM_SIZE   => 15, -- 32 Kbytes
-      G_CHAR_SIZE  => 13, -- 8 Kbytes
-      G_COL_SIZE   => 13, -- 8 Kbytes
-      G_MEMIO_SIZE =>  6, -- 64 bytes
+      G_CHAR_SIZE  => 13, -- 8 Kbytes (two banks)
+      G_COL_SIZE   => 13, -- 8 Kbytes (two banks)
+      G_MEMIO_SIZE =>  8, -- 256 bytes
       --
       G_ROM_MASK   => X"C000",
       G_RAM_MASK   => X"0000",
       G_CHAR_MASK  => X"8000",
       G_COL_MASK   => X"A000",
-      G_MEMIO_MASK => X"7FC0",
+      G_MEMIO_MASK => X"7F00",
       --
       G_ROM_FILE   => "../rom.txt",
       G_MEMIO_INIT => X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
+                      X"00000000000000000000000000000000" &
                       X"FFFCE3E0433C1E178C82803022110A00"
    )
    port map (
@@ -274,7 +334,9 @@ begin
       a_wren_i => cpu_wren,
       a_data_i => cpu_data,
       a_wait_o => mem_wait,
+      a_bank_i => mem_memio_bank(0),
       --
+      b_bank_i      => vga_bank,
       b_char_addr_i => char_addr,
       b_char_data_o => char_data,
       b_col_addr_i  => col_addr,
@@ -290,6 +352,7 @@ begin
       b_memio_rd_i    => memio_rd,    -- To MEMIO
       b_memio_rden_o  => memio_rden,  -- To MEMIO
       b_memio_wr_o    => memio_wr,    -- From MEMIO
+      b_memio_wren_o  => memio_wren,  -- From MEMIO
       b_memio_clear_i => memio_clear
    );
 
@@ -319,7 +382,33 @@ begin
       memio_pix_y_int_i => vga_memio_pix_y_int,
       memio_pix_x_o     => vga_memio_pix_x,
       memio_pix_y_o     => vga_memio_pix_y,
-      irq_o             => vga_irq
+      irq_o             => vga_irq,
+
+      memio_front_i        => vga_memio_front,
+      memio_front_o        => vga_memio_front_active,
+      bank_o               => vga_bank,
+
+      memio_bitmap_i       => vga_memio_bitmap,
+      memio_blit_x_i       => vga_memio_blit_x,
+      memio_blit_y_i       => vga_memio_blit_y,
+      memio_blit_w_i       => vga_memio_blit_w,
+      memio_blit_h_i       => vga_memio_blit_h,
+      memio_blit_col_i     => vga_memio_blit_col,
+      memio_blit_cmd_i     => vga_memio_blit_cmd,
+      memio_blit_clear_o   => vga_memio_blit_clear,
+      memio_blit_src_x_i   => vga_memio_blit_src_x,
+      memio_blit_src_y_i   => vga_memio_blit_src_y,
+      memio_blit_pattern_i => vga_memio_blit_pattern,
+
+      memio_sprite_i          => vga_memio_sprite,
+      memio_sprite_addr_i     => vga_memio_sprite_addr,
+      memio_sprite_addr_wr_i  => memio_wren(88),
+      memio_sprite_data_i     => vga_memio_sprite_data,
+      memio_sprite_data_wr_i  => memio_wren(89),
+      memio_sprite_coll_o     => vga_memio_sprite_coll,
+      memio_sprite_coll_clr_i => memio_rden(64),
+      memio_sprite_fg_o       => vga_memio_sprite_fg,
+      memio_sprite_fg_clr_i   => memio_rden(65)
    );
 
 
@@ -357,6 +446,8 @@ begin
       user_txdma_ptr_i         => cpu_memio_eth_txdma_ptr,
       user_txdma_enable_i      => cpu_memio_eth_txdma_enable,
       user_txdma_clear_o       => cpu_memio_eth_txdma_clear,
+      user_txdma_payload_ptr_i => cpu_memio_eth_txdma_payload_ptr,
+      user_txdma_payload_len_i => cpu_memio_eth_txdma_payload_len,
       user_rxdma_enable_i      => cpu_memio_eth_rxdma_enable,
       user_rxdma_clear_o       => cpu_memio_eth_rxdma_clear,
       user_rxdma_pending_o     => cpu_memio_eth_rxdma_pending,
@@ -367,6 +458,18 @@ begin
       user_rxcnt_overflow_o    => cpu_memio_eth_rxcnt_overflow,
       user_txcnt_start_o       => cpu_memio_eth_txcnt_start,
       user_txcnt_end_o         => cpu_memio_eth_txcnt_end,
+      user_resp_mac_i          => cpu_memio_eth_resp_mac,
+      user_resp_ip_i           => cpu_memio_eth_resp_ip,
+      user_resp_enable_i       => cpu_memio_eth_resp_enable,
+      user_resp_cnt_arp_o      => cpu_memio_eth_resp_cnt_arp,
+      user_resp_cnt_icmp_o     => cpu_memio_eth_resp_cnt_icmp,
+      user_filt_enable_i       => cpu_memio_eth_filt_enable,
+      user_filt_mcast_i        => cpu_memio_eth_filt_mcast,
+      user_filt_etype_i        => cpu_memio_eth_filt_etype,
+      user_filt_udp_i          => cpu_memio_eth_filt_udp,
+      user_filt_cnt_mac_o      => cpu_memio_eth_filt_cnt_mac,
+      user_filt_cnt_etype_o    => cpu_memio_eth_filt_cnt_etype,
+      user_filt_cnt_udp_o      => cpu_memio_eth_filt_cnt_udp,
       --
       eth_clk_i    => eth_clk,
       eth_txd_o    => eth_txd_o,
@@ -389,12 +492,15 @@ begin
 
    -- 7FC0 - 7FCF : VGA_PALETTE
    -- 7FD0 - 7FD1 : VGA_PIX_Y_INT
-   -- 7FD2        : CPU_CYC_LATCH
+   -- 7FD2        : CPU_CYC_LATCH (also latches TIMER_USEC)
    -- 7FD3        : ETH_RXDMA_ENABLE (bit 0)
    -- 7FD4 - 7FD5 : ETH_RXDMA_PTR
    -- 7FD6 - 7FD7 : ETH_TXDMA_PTR
    -- 7FD8        : ETH_TXDMA_ENABLE
-   -- 7FD9 - 7FDE : Not used
+   -- 7FD9 - 7FDA : ETH_TXDMA_PAYLOAD_PTR
+   -- 7FDB - 7FDC : ETH_TXDMA_PAYLOAD_LEN
+   -- 7FDD        : VGA_FRONT (bit 0)
+   -- 7FDE        : CHAR_BANK (bit 0)
    -- 7FDF        : IRQ_MASK
    vga_memio_palette          <= memio_wr(15*8+7 downto  0*8);
    vga_memio_pix_y_int        <= memio_wr(17*8+7 downto 16*8);
@@ -403,10 +509,47 @@ begin
    cpu_memio_eth_rxdma_ptr    <= memio_wr(21*8+7 downto 20*8);
    cpu_memio_eth_txdma_ptr    <= memio_wr(23*8+7 downto 22*8);
    cpu_memio_eth_txdma_enable <= memio_wr(24*8);
-   --                            memio_wr(30*8+7 downto 25*8);      -- Not used
+   cpu_memio_eth_txdma_payload_ptr <= memio_wr(26*8+7 downto 25*8);
+   cpu_memio_eth_txdma_payload_len <= memio_wr(28*8+7 downto 27*8);
+   vga_memio_front            <= memio_wr(29*8+7 downto 29*8);
+   mem_memio_bank             <= memio_wr(30*8+7 downto 30*8);
    irq_memio_mask             <= memio_wr(31*8+7 downto 31*8);
    memio_clear                <= (19 => cpu_memio_eth_rxdma_clear,                  -- ETH_RXDMA_ENABLE
-                                  24 => cpu_memio_eth_txdma_clear, others => '0');  -- ETH_TXDMA_ENABLE
+                                  24 => cpu_memio_eth_txdma_clear,                  -- ETH_TXDMA_ENABLE
+                                  27 => cpu_memio_eth_txdma_clear,                  -- ETH_TXDMA_PAYLOAD_LEN
+                                  28 => cpu_memio_eth_txdma_clear,
+                                  38 => timer_memio_cmp_clear,                      -- TIMER_CMP_ENABLE
+                                  51 => vga_memio_blit_clear,                       -- BLIT_CMD
+                                  others => '0');
+
+   -- 7F80 - 7F85 : TIMER_CMP
+   -- 7F86        : TIMER_CMP_ENABLE (bit 0)
+   -- 7F87 - 7F8A : BENCH_CYCLES
+   -- 7F8B        : BENCH_DONE (bit 0)
+   -- 7F8C - 7F8D : BLIT_X
+   -- 7F8E        : BLIT_Y
+   -- 7F8F - 7F90 : BLIT_W
+   -- 7F91        : BLIT_H
+   -- 7F92        : BLIT_COL
+   -- 7F93        : BLIT_CMD
+   -- 7F94 - 7F95 : BLIT_SRC_X
+   -- 7F96        : BLIT_SRC_Y
+   -- 7F97 - 7F9E : BLIT_PATTERN
+   -- 7F9F        : BITMAP_ENABLE (bit 0)
+   timer_memio_cmp            <= memio_wr(37*8+7 downto 32*8);
+   timer_memio_cmp_enable     <= memio_wr(38*8);
+   bench_memio_cycles         <= memio_wr(42*8+7 downto 39*8);
+   bench_memio_done           <= memio_wr(43*8);
+   vga_memio_blit_x           <= memio_wr(45*8+7 downto 44*8);
+   vga_memio_blit_y           <= memio_wr(46*8+7 downto 46*8);
+   vga_memio_blit_w           <= memio_wr(48*8+7 downto 47*8);
+   vga_memio_blit_h           <= memio_wr(49*8+7 downto 49*8);
+   vga_memio_blit_col         <= memio_wr(50*8+7 downto 50*8);
+   vga_memio_blit_cmd         <= memio_wr(51*8+7 downto 51*8);
+   vga_memio_blit_src_x       <= memio_wr(53*8+7 downto 52*8);
+   vga_memio_blit_src_y       <= memio_wr(54*8+7 downto 54*8);
+   vga_memio_blit_pattern     <= memio_wr(62*8+7 downto 55*8);
+   vga_memio_bitmap           <= memio_wr(63*8+7 downto 63*8);
 
    -- 7FE0 - 7FE1 : VGA_PIX_X
    -- 7FE2 - 7FE3 : VGA_PIX_Y
@@ -417,7 +560,9 @@ begin
    -- 7FEB        : ETH_RXCNT_OVERFLOW
    -- 7FEC - 7FED : ETH_RXCNT_GOOD
    -- 7FEE        : ETH_RXDMA_PENDING
-   -- 7FEF - 7FFE : Not used
+   -- 7FEF - 7FF4 : TIMER_USEC
+   -- 7FF5        : VGA_FRONT_ACTIVE
+   -- 7FF6 - 7FFE : Not used
    -- 7FFF        : IRQ_STATUS
    memio_rd( 1*8+7 downto  0*8) <= vga_memio_pix_x;
    memio_rd( 3*8+7 downto  2*8) <= vga_memio_pix_y;
@@ -428,10 +573,62 @@ begin
    memio_rd(11*8+7 downto 11*8) <= cpu_memio_eth_rxcnt_overflow;
    memio_rd(13*8+7 downto 12*8) <= cpu_memio_eth_rxcnt_good;
    memio_rd(14*8+7 downto 14*8) <= cpu_memio_eth_rxdma_pending;
-   memio_rd(30*8+7 downto 15*8) <= (others => '0');   -- Not used
+   memio_rd(20*8+7 downto 15*8) <= timer_memio_usec;
+   memio_rd(21*8+7 downto 21*8) <= vga_memio_front_active;
+   memio_rd(30*8+7 downto 22*8) <= (others => '0');   -- Not used
    memio_rd(31*8+7 downto 31*8) <= irq_memio_status;
    irq_memio_clear <= memio_rden(31);
 
+   -- 7FA0 - 7FBF : Not used
+   memio_rd(63*8+7 downto 32*8) <= (others => '0');   -- Not used
+
+   -- 7F40 - 7F47 : SPRITE_X (2 bytes per sprite)
+   -- 7F48 - 7F4F : SPRITE_Y (2 bytes per sprite)
+   -- 7F50 - 7F53 : SPRITE_COL
+   -- 7F54 - 7F57 : SPRITE_CTRL
+   -- 7F58        : SPRITE_ADDR (writing sets the bitmap pointer)
+   -- 7F59        : SPRITE_DATA (writing stores a bitmap byte)
+   -- 7F5A - 7F5F : Not used
+   vga_memio_sprite           <= memio_wr(87*8+7 downto 64*8);
+   vga_memio_sprite_addr      <= memio_wr(88*8+7 downto 88*8);
+   vga_memio_sprite_data      <= memio_wr(89*8+7 downto 89*8);
+   --                            memio_wr(95*8+7 downto 90*8);      -- Not used
+
+   -- 7F60        : SPRITE_COLL (cleared when read)
+   -- 7F61        : SPRITE_COLL_FG (cleared when read)
+   -- 7F62 - 7F7F : Not used
+   memio_rd(64*8+7 downto 64*8) <= vga_memio_sprite_coll;
+   memio_rd(65*8+7 downto 65*8) <= vga_memio_sprite_fg;
+   memio_rd(95*8+7 downto 66*8) <= (others => '0');   -- Not used
+
+   -- 7F00 - 7F05 : ETH_RESP_MAC (also used by the Rx filter)
+   -- 7F06 - 7F09 : ETH_RESP_IP
+   -- 7F0A        : ETH_RESP_ENABLE (bit 0 : ARP, bit 1 : ICMP)
+   -- 7F0B        : ETH_FILT_ENABLE (bit 0 : MAC, bit 1 : EtherType, bit 2 : UDP port)
+   -- 7F0C - 7F11 : ETH_FILT_MCAST (2 entries of 3 bytes)
+   -- 7F12 - 7F17 : ETH_FILT_ETYPE (3 entries of 2 bytes)
+   -- 7F18 - 7F1F : ETH_FILT_UDP (4 entries of 2 bytes)
+   cpu_memio_eth_resp_mac     <= memio_wr(101*8+7 downto 96*8);
+   cpu_memio_eth_resp_ip      <= memio_wr(105*8+7 downto 102*8);
+   cpu_memio_eth_resp_enable  <= memio_wr(106*8+7 downto 106*8);
+   cpu_memio_eth_filt_enable  <= memio_wr(107*8+7 downto 107*8);
+   cpu_memio_eth_filt_mcast   <= memio_wr(113*8+7 downto 108*8);
+   cpu_memio_eth_filt_etype   <= memio_wr(119*8+7 downto 114*8);
+   cpu_memio_eth_filt_udp     <= memio_wr(127*8+7 downto 120*8);
+
+   -- 7F20        : ETH_RESP_CNT_ARP
+   -- 7F21        : ETH_RESP_CNT_ICMP
+   -- 7F22        : ETH_FILT_CNT_MAC
+   -- 7F23        : ETH_FILT_CNT_ETYPE
+   -- 7F24        : ETH_FILT_CNT_UDP
+   -- 7F25 - 7F3F : Not used
+   memio_rd( 96*8+7 downto  96*8) <= cpu_memio_eth_resp_cnt_arp;
+   memio_rd( 97*8+7 downto  97*8) <= cpu_memio_eth_resp_cnt_icmp;
+   memio_rd( 98*8+7 downto  98*8) <= cpu_memio_eth_filt_cnt_mac;
+   memio_rd( 99*8+7 downto  99*8) <= cpu_memio_eth_filt_cnt_etype;
+   memio_rd(100*8+7 downto 100*8) <= cpu_memio_eth_filt_cnt_udp;
+   memio_rd(127*8+7 downto 101*8) <= (others => '0');  -- Not used
+
 
    -------------------------
    -- Interrupt Sources
@@ -440,7 +637,8 @@ begin
    ic_irq(0) <= timer_irq;
    ic_irq(1) <= vga_irq;
    ic_irq(2) <= kbd_irq;
-   ic_irq(7 downto 3) <= (others => '0');             -- Not used
+   ic_irq(3) <= timer_cmp_irq;
+   ic_irq(7 downto 4) <= (others => '0');             -- Not used
 
 
    -------------------------
@@ -3,6 +3,8 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std_unsigned.all;
 
 -- This module provides a high-level interface to the Ethernet port.
+-- Optionally, ARP requests and pings are answered in hardware, see responder.vhd.
+-- Optionally, irrelevant frames are discarded in hardware, see rx_filter.vhd.
 
 entity ethernet is
    port (
@@ -21,6 +23,8 @@ entity ethernet is
       user_txdma_ptr_i      : in  std_logic_vector(15 downto 0);
       user_txdma_enable_i   : in  std_logic;
       user_txdma_clear_o    : out std_logic;
+      user_txdma_payload_ptr_i : in  std_logic_vector(15 downto 0);
+      user_txdma_payload_len_i : in  std_logic_vector(15 downto 0);
       user_rxdma_ptr_i      : in  std_logic_vector(15 downto 0);
       user_rxdma_enable_i   : in  std_logic;
       user_rxdma_clear_o    : out std_logic;
@@ -31,6 +35,18 @@ entity ethernet is
       user_rxcnt_overflow_o : out std_logic_vector( 7 downto 0);
       user_txcnt_start_o    : out std_logic_vector( 7 downto 0);
       user_txcnt_end_o      : out std_logic_vector( 7 downto 0);
+      user_resp_mac_i       : in  std_logic_vector(47 downto 0);
+      user_resp_ip_i        : in  std_logic_vector(31 downto 0);
+      user_resp_enable_i    : in  std_logic_vector( 7 downto 0);
+      user_resp_cnt_arp_o   : out std_logic_vector( 7 downto 0);
+      user_resp_cnt_icmp_o  : out std_logic_vector( 7 downto 0);
+      user_filt_enable_i    : in  std_logic_vector( 7 downto 0);
+      user_filt_mcast_i     : in  std_logic_vector(47 downto 0);
+      user_filt_etype_i     : in  std_logic_vector(47 downto 0);
+      user_filt_udp_i       : in  std_logic_vector(63 downto 0);
+      user_filt_cnt_mac_o   : out std_logic_vector( 7 downto 0);
+      user_filt_cnt_etype_o : out std_logic_vector( 7 downto 0);
+      user_filt_cnt_udp_o   : out std_logic_vector( 7 downto 0);
 
       -- Connected to PHY.
       eth_clk_i    : in    std_logic; -- Must be 50 MHz
@@ -67,22 +83,38 @@ architecture structural of ethernet is
    signal eth_tx_eof    : std_logic_vector(0 downto 0);
 
    -- Connection from rx_header to rxfifo
+   signal eth_rx_drop   : std_logic;
+
    signal eth_rxheader_valid : std_logic;
    signal eth_rxheader_data  : std_logic_vector(7 downto 0);
    signal eth_rxheader_eof   : std_logic_vector(0 downto 0);
    signal eth_rxfifo_afull   : std_logic;
 
-   -- Connection from rxfifo to rx_dma
+   -- Connection from rxfifo to responder
    signal user_rxfifo_empty : std_logic;
    signal user_rxfifo_data  : std_logic_vector(7 downto 0);
    signal user_rxfifo_eof   : std_logic_vector(0 downto 0);
+   signal user_rxfifo_rden  : std_logic;
+
+   -- Connection from responder to rx_dma
+   signal user_resp_empty   : std_logic;
+   signal user_resp_data    : std_logic_vector(7 downto 0);
+   signal user_resp_eof     : std_logic;
    signal user_rxdma_rden   : std_logic;
 
-   -- Connection from tx_dma to txfifo
+   -- Connection from tx_dma and responder to txfifo
    signal user_tx_afull : std_logic;
    signal user_tx_valid : std_logic;
    signal user_tx_data  : std_logic_vector(7 downto 0);
    signal user_tx_eof   : std_logic_vector(0 downto 0);
+   signal user_txdma_valid : std_logic;
+   signal user_txdma_data  : std_logic_vector(7 downto 0);
+   signal user_txdma_eof   : std_logic;
+   signal user_txdma_busy  : std_logic;
+   signal user_resp_valid  : std_logic;
+   signal user_resp_tx_data : std_logic_vector(7 downto 0);
+   signal user_resp_tx_eof  : std_logic;
+   signal user_resp_req    : std_logic;
    
 begin
 
@@ -139,6 +171,32 @@ begin
    );
 
 
+   -------------------------------
+   -- Receive filter
+   -- Our MAC address is shared with the responder.
+   -------------------------------
+   inst_rx_filter : entity work.rx_filter
+   port map (
+      clk_i          => eth_clk_i,
+      rst_i          => eth_rst,
+      enable_i       => user_filt_enable_i,
+      mac_i          => user_resp_mac_i,
+      mcast_i        => user_filt_mcast_i,
+      etype_i        => user_filt_etype_i,
+      udp_i          => user_filt_udp_i,
+      --
+      cnt_mac_o      => user_filt_cnt_mac_o,
+      cnt_etype_o    => user_filt_cnt_etype_o,
+      cnt_udp_o      => user_filt_cnt_udp_o,
+      --
+      rx_valid_i     => eth_rx_valid,
+      rx_eof_i       => eth_rx_eof,
+      rx_data_i      => eth_rx_data,
+      rx_error_i     => eth_rx_error,
+      drop_o         => eth_rx_drop
+   );
+
+
    -------------------------------
    -- Header insertion
    -------------------------------
@@ -150,6 +208,7 @@ begin
       rx_eof_i       => eth_rx_eof,
       rx_data_i      => eth_rx_data,
       rx_error_i     => eth_rx_error,
+      rx_drop_i      => eth_rx_drop,
       --
       cnt_good_o     => user_rxcnt_good_o,
       cnt_error_o    => user_rxcnt_error_o,
@@ -182,7 +241,7 @@ begin
       --
       rd_clk_i   => user_clk_i,
       rd_rst_i   => '0',
-      rd_en_i    => user_rxdma_rden,
+      rd_en_i    => user_rxfifo_rden,
       rd_data_o  => user_rxfifo_data,
       rd_sb_o    => user_rxfifo_eof,
       rd_empty_o => user_rxfifo_empty,
@@ -190,6 +249,39 @@ begin
    );
 
 
+   ------------------------------
+   -- Instantiate ARP and ICMP responder
+   ------------------------------
+
+   inst_responder : entity work.responder
+   port map (
+      clk_i       => user_clk_i,
+      rst_i       => user_rst_i,
+      mac_i       => user_resp_mac_i,
+      ip_i        => user_resp_ip_i,
+      enable_i    => user_resp_enable_i,
+      cnt_arp_o   => user_resp_cnt_arp_o,
+      cnt_icmp_o  => user_resp_cnt_icmp_o,
+      --
+      in_empty_i  => user_rxfifo_empty,
+      in_rden_o   => user_rxfifo_rden,
+      in_data_i   => user_rxfifo_data,
+      in_eof_i    => user_rxfifo_eof(0),
+      --
+      out_empty_o => user_resp_empty,
+      out_rden_i  => user_rxdma_rden,
+      out_data_o  => user_resp_data,
+      out_eof_o   => user_resp_eof,
+      --
+      tx_req_o    => user_resp_req,
+      tx_busy_i   => user_txdma_busy,
+      tx_afull_i  => user_tx_afull,
+      tx_valid_o  => user_resp_valid,
+      tx_data_o   => user_resp_tx_data,
+      tx_eof_o    => user_resp_tx_eof
+   );
+
+
    ------------------------------
    -- Instantiate Rx DMA
    ------------------------------
@@ -198,10 +290,10 @@ begin
    port map (
       clk_i        => user_clk_i,
       rst_i        => user_rst_i,
-      rd_empty_i   => user_rxfifo_empty,
+      rd_empty_i   => user_resp_empty,
       rd_en_o      => user_rxdma_rden,
-      rd_data_i    => user_rxfifo_data,
-      rd_eof_i     => user_rxfifo_eof(0),
+      rd_data_i    => user_resp_data,
+      rd_eof_i     => user_resp_eof,
       --
       wr_en_o      => user_rxdma_ram_wr_en_o,
       wr_addr_o    => user_rxdma_ram_wr_addr_o,
@@ -212,7 +304,7 @@ begin
       dma_clear_o  => user_rxdma_clear_o
    );
 
-   user_rxdma_pending_o <= (7 downto 1 => '0', 0 => not user_rxfifo_empty);
+   user_rxdma_pending_o <= (7 downto 1 => '0', 0 => not user_resp_empty);
 
    ------------------------------
    -- Instantiate Tx DMA
@@ -226,20 +318,32 @@ begin
       memio_enable_i => user_txdma_enable_i,
       memio_clear_o  => user_txdma_clear_o,
       --
+      memio_payload_ptr_i => user_txdma_payload_ptr_i,
+      memio_payload_len_i => user_txdma_payload_len_i,
+      --
+      hold_i         => user_resp_req,
+      busy_o         => user_txdma_busy,
+      --
       rd_en_o        => user_txdma_ram_rd_en_o,
       rd_addr_o      => user_txdma_ram_rd_addr_o,
       rd_data_i      => user_txdma_ram_rd_data_i,
       --
       wr_afull_i     => user_tx_afull,
-      wr_valid_o     => user_tx_valid,
-      wr_data_o      => user_tx_data,
-      wr_eof_o       => user_tx_eof(0),
+      wr_valid_o     => user_txdma_valid,
+      wr_data_o      => user_txdma_data,
+      wr_eof_o       => user_txdma_eof,
 
       cnt_start_o    => user_txcnt_start_o,
       cnt_end_o      => user_txcnt_end_o
    );
 
 
+   -- The Tx DMA and the responder never write at the same time.
+   user_tx_valid  <= user_txdma_valid or user_resp_valid;
+   user_tx_data   <= user_resp_tx_data when user_resp_valid = '1' else user_txdma_data;
+   user_tx_eof(0) <= user_resp_tx_eof  when user_resp_valid = '1' else user_txdma_eof;
+
+
    ------------------------------
    -- Instantiate txfifo to cross clock domain
    ------------------------------
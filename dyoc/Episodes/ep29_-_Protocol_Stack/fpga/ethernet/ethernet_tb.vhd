@@ -19,6 +19,8 @@ architecture structural of ethernet_tb is
    signal user_txdma_ptr         : std_logic_vector(15 downto 0);
    signal user_txdma_enable      : std_logic;
    signal user_txdma_clear       : std_logic;
+   signal user_txdma_payload_ptr : std_logic_vector(15 downto 0);
+   signal user_txdma_payload_len : std_logic_vector(15 downto 0);
    signal user_rxdma_ram_wr_en   : std_logic;
    signal user_rxdma_ram_wr_addr : std_logic_vector(15 downto 0);
    signal user_rxdma_ram_wr_data : std_logic_vector( 7 downto 0);
@@ -30,6 +32,15 @@ architecture structural of ethernet_tb is
    signal user_rxcnt_error       : std_logic_vector( 7 downto 0);
    signal user_rxcnt_crc_bad     : std_logic_vector( 7 downto 0);
    signal user_rxcnt_overflow    : std_logic_vector( 7 downto 0);
+   signal user_resp_mac          : std_logic_vector(47 downto 0);
+   signal user_resp_ip           : std_logic_vector(31 downto 0);
+   signal user_resp_enable       : std_logic_vector( 7 downto 0);
+   signal user_resp_cnt_arp      : std_logic_vector( 7 downto 0);
+   signal user_resp_cnt_icmp     : std_logic_vector( 7 downto 0);
+   signal user_filt_enable       : std_logic_vector( 7 downto 0);
+   signal user_filt_cnt_mac      : std_logic_vector( 7 downto 0);
+   signal user_filt_cnt_etype    : std_logic_vector( 7 downto 0);
+   signal user_filt_cnt_udp      : std_logic_vector( 7 downto 0);
    --
    signal eth_clk           : std_logic;  -- 50 MHz
    signal eth_refclk        : std_logic;
@@ -47,6 +58,45 @@ architecture structural of ethernet_tb is
    -- Control the execution of the test.
    signal sim_test_running : std_logic := '1';
 
+   -- Used for frames with specific contents.
+   type t_bytes is array (natural range <>) of integer range 0 to 255;
+
+   -- ARP request from 02:00:00:00:00:01 (192.168.1.1) for 192.168.1.77.
+   constant C_ARP_REQUEST : t_bytes(0 to 59) := (
+      255, 255, 255, 255, 255, 255,   2,   0,   0,   0,   0,   1,   8,   6,
+        0,   1,   8,   0,   6,   4,   0,   1,
+        2,   0,   0,   0,   0,   1, 192, 168,   1,   1,
+        0,   0,   0,   0,   0,   0, 192, 168,   1,  77,
+      others => 0);
+
+   -- The expected ARP reply from 70:4D:7B:11:22:33 (192.168.1.77).
+   constant C_ARP_REPLY : t_bytes(0 to 59) := (
+        2,   0,   0,   0,   0,   1, 112,  77, 123,  17,  34,  51,   8,   6,
+        0,   1,   8,   0,   6,   4,   0,   2,
+      112,  77, 123,  17,  34,  51, 192, 168,   1,  77,
+        2,   0,   0,   0,   0,   1, 192, 168,   1,   1,
+      others => 0);
+
+   -- ICMP echo request from 02:00:00:00:00:01 (192.168.1.1) to
+   -- 70:4D:7B:11:22:33 (192.168.1.77), with 18 bytes of data.
+   constant C_ICMP_REQUEST : t_bytes(0 to 59) := (
+      112,  77, 123,  17,  34,  51,   2,   0,   0,   0,   0,   1,   8,   0,
+       69,   0,   0,  46,  18,  52,   0,   0,  64,   1, 228, 252,
+      192, 168,   1,   1, 192, 168,   1,  77,
+        8,   0, 175, 172,   0,   1,   0,   1,
+        0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,
+       14,  15,  16,  17);
+
+   -- The expected ICMP echo reply. The IP header checksum is the same as in
+   -- the request, and the ICMP checksum is increased by 0x0800.
+   constant C_ICMP_REPLY : t_bytes(0 to 59) := (
+        2,   0,   0,   0,   0,   1, 112,  77, 123,  17,  34,  51,   8,   0,
+       69,   0,   0,  46,  18,  52,   0,   0,  64,   1, 228, 252,
+      192, 168,   1,  77, 192, 168,   1,   1,
+        0,   0, 183, 172,   0,   1,   0,   1,
+        0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,
+       14,  15,  16,  17);
+
 begin
 
    -----------------------------
@@ -124,6 +174,8 @@ begin
       user_txdma_ptr_i         => user_txdma_ptr,
       user_txdma_enable_i      => user_txdma_enable,
       user_txdma_clear_o       => user_txdma_clear,
+      user_txdma_payload_ptr_i => user_txdma_payload_ptr,
+      user_txdma_payload_len_i => user_txdma_payload_len,
       user_rxdma_ram_wr_en_o   => user_rxdma_ram_wr_en,
       user_rxdma_ram_wr_addr_o => user_rxdma_ram_wr_addr,
       user_rxdma_ram_wr_data_o => user_rxdma_ram_wr_data,
@@ -135,6 +187,18 @@ begin
       user_rxcnt_error_o       => user_rxcnt_error,
       user_rxcnt_crc_bad_o     => user_rxcnt_crc_bad,
       user_rxcnt_overflow_o    => user_rxcnt_overflow,
+      user_resp_mac_i          => user_resp_mac,
+      user_resp_ip_i           => user_resp_ip,
+      user_resp_enable_i       => user_resp_enable,
+      user_resp_cnt_arp_o      => user_resp_cnt_arp,
+      user_resp_cnt_icmp_o     => user_resp_cnt_icmp,
+      user_filt_enable_i       => user_filt_enable,
+      user_filt_mcast_i        => X"000000000000",
+      user_filt_etype_i        => X"000008060800",
+      user_filt_udp_i          => X"0000000000000000",
+      user_filt_cnt_mac_o      => user_filt_cnt_mac,
+      user_filt_cnt_etype_o    => user_filt_cnt_etype,
+      user_filt_cnt_udp_o      => user_filt_cnt_udp,
       --
       eth_clk_i           => eth_clk,
       eth_txd_o           => eth_txd,
@@ -182,6 +246,68 @@ begin
 
       end procedure send_frame;
 
+      -- Sends a frame, where the last payload_length bytes are read from
+      -- payload_offset by the payload DMA.
+      procedure send_frame_payload(first : integer; length : integer; offset : integer;
+                                   payload_length : integer; payload_offset : integer) is
+      begin
+         sim_ram_in <= (others => 'X');
+         sim_ram_in(8*offset + 15 downto 8*offset + 0) <= to_std_logic_vector(length, 16);
+         for i in 0 to length-1 loop
+            sim_ram_in(8*(i+2+offset)+7 downto 8*(i+2+offset)) <=
+               to_std_logic_vector((i+first) mod 256, 8);
+         end loop;
+         for i in 0 to payload_length-1 loop
+            sim_ram_in(8*(i+payload_offset)+7 downto 8*(i+payload_offset)) <=
+               to_std_logic_vector((i+length+first) mod 256, 8);
+         end loop;
+         sim_ram_init <= '1';
+
+         -- Wait until memory has been updated
+         wait until user_clk = '1';
+         sim_ram_init <= '0';
+         wait until user_clk = '1';
+
+         assert user_txdma_clear = '0';
+         user_txdma_ptr         <= to_std_logic_vector(offset, 16) + X"2000";
+         user_txdma_payload_ptr <= to_std_logic_vector(payload_offset, 16) + X"2000";
+         user_txdma_payload_len <= to_std_logic_vector(payload_length, 16);
+         user_txdma_enable      <= '1';
+         wait until user_txdma_clear = '1';
+         user_txdma_enable      <= '0';
+         user_txdma_payload_len <= (others => '0');
+         wait until user_clk = '1';
+         wait until user_clk = '1';
+         assert user_txdma_clear = '0';
+
+      end procedure send_frame_payload;
+
+      procedure send_bytes(bytes : t_bytes; offset : integer) is
+      begin
+         sim_ram_in <= (others => 'X');
+         sim_ram_in(8*offset + 15 downto 8*offset + 0) <= to_std_logic_vector(bytes'length, 16);
+         for i in 0 to bytes'length-1 loop
+            sim_ram_in(8*(i+2+offset)+7 downto 8*(i+2+offset)) <=
+               to_std_logic_vector(bytes(i), 8);
+         end loop;
+         sim_ram_init <= '1';
+
+         -- Wait until memory has been updated
+         wait until user_clk = '1';
+         sim_ram_init <= '0';
+         wait until user_clk = '1';
+
+         assert user_txdma_clear = '0';
+         user_txdma_ptr    <= to_std_logic_vector(offset, 16) + X"2000";
+         user_txdma_enable <= '1';
+         wait until user_txdma_clear = '1';
+         user_txdma_enable <= '0';
+         wait until user_clk = '1';
+         wait until user_clk = '1';
+         assert user_txdma_clear = '0';
+
+      end procedure send_bytes;
+
       procedure receive_frame(first : integer; length : integer; offset : integer) is
       begin
 
@@ -202,10 +328,36 @@ begin
          end loop;
       end procedure receive_frame;
 
+      procedure receive_bytes(bytes : t_bytes; offset : integer) is
+      begin
+
+         assert user_rxdma_clear = '0';
+         user_rxdma_ptr    <= to_std_logic_vector(offset, 16) + X"2000";
+         user_rxdma_enable <= '1';
+         wait until user_rxdma_clear = '1';
+         user_rxdma_enable <= '0';
+         wait until user_clk = '1';
+         wait until user_clk = '1';
+         assert user_rxdma_clear = '0';
+
+         assert sim_ram_out(8*offset + 15 downto 8*offset + 0) = to_std_logic_vector(bytes'length, 16);
+         for i in 0 to bytes'length-1 loop
+            assert sim_ram_out(8*(i+2+offset)+7 downto 8*(i+2+offset)) =
+               to_std_logic_vector(bytes(i), 8)
+               report "i=" & integer'image(i);
+         end loop;
+      end procedure receive_bytes;
+
    begin
       -- Wait for reset
       user_rxdma_enable <= '0';
       user_rxdma_ptr    <= (others => '0');
+      user_txdma_payload_ptr <= (others => '0');
+      user_txdma_payload_len <= (others => '0');
+      user_resp_mac     <= X"3322117B4D70";   -- 70:4D:7B:11:22:33
+      user_resp_ip      <= X"4D01A8C0";       -- 192.168.1.77
+      user_resp_enable  <= X"00";
+      user_filt_enable  <= X"00";
       wait until eth_rstn = '1';
       wait until user_clk = '1';
 
@@ -254,6 +406,96 @@ begin
       assert user_rxcnt_overflow = 0;
 
 
+      -----------------------------------------------
+      -- Test 3 : Send an ARP request for our IP address
+      -- Expected behaviour: The responder sends an ARP reply,
+      -- which is looped back and received by the CPU.
+      -----------------------------------------------
+
+      user_resp_enable <= X"01";
+      assert user_rxdma_pending = X"00";
+      send_bytes(C_ARP_REQUEST, offset => 1000);
+      receive_bytes(C_ARP_REPLY, offset => 600);
+      assert user_rxdma_pending = X"00";
+
+      -- Verify statistics counters
+      assert user_resp_cnt_arp   = 1;
+      assert user_resp_cnt_icmp  = 0;
+      assert user_rxcnt_good     = 5;
+      assert user_rxcnt_error    = 0;
+      assert user_rxcnt_crc_bad  = 0;
+      assert user_rxcnt_overflow = 0;
+
+
+      -----------------------------------------------
+      -- Test 4 : Enable the MAC filter, and send a frame to another
+      -- MAC address followed by an ARP request for our IP address.
+      -- Expected behaviour: The first frame is discarded. The ARP request
+      -- is a broadcast and is answered, but the looped back reply is
+      -- discarded.
+      -----------------------------------------------
+
+      user_filt_enable <= X"01";
+      assert user_rxdma_pending = X"00";
+      send_frame(first => 32, length => 100, offset => 1000);
+      send_bytes(C_ARP_REQUEST, offset => 600);
+      wait for 40 us;
+      assert user_rxdma_pending = X"00";
+
+      -- Verify statistics counters
+      assert user_resp_cnt_arp   = 2;
+      assert user_filt_cnt_mac   = 2;
+      assert user_filt_cnt_etype = 0;
+      assert user_filt_cnt_udp   = 0;
+      assert user_rxcnt_good     = 6;
+      assert user_rxcnt_error    = 0;
+      assert user_rxcnt_crc_bad  = 0;
+      assert user_rxcnt_overflow = 0;
+
+
+      -----------------------------------------------
+      -- Test 5 : Send a frame, where the last part is read by the payload
+      -- DMA from another place in memory.
+      -- Expected behaviour: The two parts are received as one frame, and the
+      -- frame check sequence is good.
+      -----------------------------------------------
+
+      user_filt_enable <= X"00";
+      assert user_rxdma_pending = X"00";
+      send_frame_payload(first => 60, length => 42, offset => 1000,
+                         payload_length => 58, payload_offset => 1400);
+      receive_frame(first => 60, length => 100, offset => 600);
+      assert user_rxdma_pending = X"00";
+
+      -- Verify statistics counters
+      assert user_rxcnt_good     = 7;
+      assert user_rxcnt_error    = 0;
+      assert user_rxcnt_crc_bad  = 0;
+      assert user_rxcnt_overflow = 0;
+
+
+      -----------------------------------------------
+      -- Test 6 : Send an ICMP echo request to our MAC and IP address
+      -- Expected behaviour: The responder sends an ICMP echo reply with the
+      -- addresses swapped and the checksum updated, which is looped back
+      -- and received by the CPU.
+      -----------------------------------------------
+
+      user_resp_enable <= X"03";
+      assert user_rxdma_pending = X"00";
+      send_bytes(C_ICMP_REQUEST, offset => 1000);
+      receive_bytes(C_ICMP_REPLY, offset => 600);
+      assert user_rxdma_pending = X"00";
+
+      -- Verify statistics counters
+      assert user_resp_cnt_arp   = 2;
+      assert user_resp_cnt_icmp  = 1;
+      assert user_rxcnt_good     = 9;
+      assert user_rxcnt_error    = 0;
+      assert user_rxcnt_crc_bad  = 0;
+      assert user_rxcnt_overflow = 0;
+
+
       -----------------------------------------------
       -- END OF TEST
       -----------------------------------------------
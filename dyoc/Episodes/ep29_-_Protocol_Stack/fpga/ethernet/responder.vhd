@@ -0,0 +1,310 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std_unsigned.all;
+
+-- This module answers ARP requests and ICMP echo requests (ping) in hardware,
+-- so these frames never reach the CPU.
+--
+-- It is placed between the Rx fifo and the Rx DMA, and operates in a
+-- store-and-forward mode: Each frame (including the two-byte length header
+-- from rx_header) is stored in a buffer, while the first 42 bytes are
+-- copied to registers. When the entire frame is received, it is examined:
+-- * An ARP request for our IP address is answered with an ARP reply.
+-- * An ICMP echo request to our MAC and IP address is answered with an
+--   ICMP echo reply containing the same data.
+-- * Any other frame is forwarded to the Rx DMA unchanged.
+--
+-- The reply is generated by reading the frame from the buffer, and replacing
+-- the relevant header fields. Only IPv4 packets without options and without
+-- fragmentation are answered. The IP header checksum is unchanged, since the
+-- two addresses are only swapped, and the ICMP checksum is updated
+-- incrementally (RFC 1624).
+--
+-- The reply shares the Tx fifo with the Tx DMA. The responder requests the
+-- Tx path with tx_req_o, which prevents the Tx DMA from starting a new frame,
+-- and then waits for the Tx DMA to finish any frame in progress.
+--
+-- The MAC and IP address must be written before the responder is enabled.
+-- Bit 0 of enable_i enables ARP replies and bit 1 enables ICMP echo replies.
+
+entity responder is
+   port (
+      clk_i        : in  std_logic;
+      rst_i        : in  std_logic;
+
+      -- Configuration
+      mac_i        : in  std_logic_vector(47 downto 0);  -- Byte 0 is first on the wire
+      ip_i         : in  std_logic_vector(31 downto 0);  -- Byte 0 is first on the wire
+      enable_i     : in  std_logic_vector( 7 downto 0);
+
+      -- Statistics
+      cnt_arp_o    : out std_logic_vector( 7 downto 0);
+      cnt_icmp_o   : out std_logic_vector( 7 downto 0);
+
+      -- Connected to Rx FIFO
+      in_empty_i   : in  std_logic;
+      in_rden_o    : out std_logic;
+      in_data_i    : in  std_logic_vector(7 downto 0);
+      in_eof_i     : in  std_logic;
+
+      -- Connected to Rx DMA. Same interface as the Rx FIFO.
+      out_empty_o  : out std_logic;
+      out_rden_i   : in  std_logic;
+      out_data_o   : out std_logic_vector(7 downto 0);
+      out_eof_o    : out std_logic;
+
+      -- Connected to Tx FIFO
+      tx_req_o     : out std_logic;   -- Prevents Tx DMA from starting
+      tx_busy_i    : in  std_logic;   -- Tx DMA is sending a frame
+      tx_afull_i   : in  std_logic;
+      tx_valid_o   : out std_logic;
+      tx_data_o    : out std_logic_vector(7 downto 0);
+      tx_eof_o     : out std_logic
+   );
+end responder;
+
+architecture structural of responder is
+
+   -- The buffer holds a single frame including the two-byte length header.
+   constant C_ADDR_SIZE : integer := 11;
+   type t_buf is array (0 to 2**C_ADDR_SIZE-1) of std_logic_vector(7 downto 0);
+   signal buf : t_buf := (others => (others => '0'));
+
+   -- Copy of the Ethernet, ARP, IP, and ICMP headers.
+   constant C_HDR_SIZE : integer := 42;
+   type t_hdr is array (0 to C_HDR_SIZE-1) of std_logic_vector(7 downto 0);
+   signal hdr : t_hdr;
+
+   type t_fsm_state is (IN_ST, DECIDE_ST, FWD_ST, TX_WAIT_ST, TX_ST);
+   signal fsm_state : t_fsm_state := IN_ST;
+
+   type t_kind is (ARP_KIND, ICMP_KIND);
+   signal kind : t_kind;
+
+   signal in_rden  : std_logic := '0';
+   signal wrptr    : std_logic_vector(C_ADDR_SIZE-1 downto 0) := (others => '0');
+   signal last     : std_logic_vector(C_ADDR_SIZE-1 downto 0);  -- Address of last byte
+
+   -- Read port of the buffer. rd_data always contains buf(rdptr).
+   signal rdptr    : std_logic_vector(C_ADDR_SIZE-1 downto 0);
+   signal rd_addr  : std_logic_vector(C_ADDR_SIZE-1 downto 0);
+   signal rd_data  : std_logic_vector(7 downto 0);
+   signal rd_adv   : std_logic;
+
+   -- Transmit
+   signal tx_toggle : std_logic := '0';
+   signal tx_pos    : std_logic_vector(C_ADDR_SIZE-1 downto 0);
+   signal tx_valid  : std_logic := '0';
+   signal tx_data   : std_logic_vector(7 downto 0);
+   signal tx_eof    : std_logic := '0';
+   signal icmp_csum : std_logic_vector(15 downto 0);
+
+   signal cnt_arp  : std_logic_vector(7 downto 0) := (others => '0');
+   signal cnt_icmp : std_logic_vector(7 downto 0) := (others => '0');
+
+   -- Return byte i of a configuration field.
+   function get_byte(arg : std_logic_vector; i : integer) return std_logic_vector is
+   begin
+      return arg(arg'low + 8*i + 7 downto arg'low + 8*i);
+   end function get_byte;
+
+begin
+
+   -- Advance the read pointer, when the current byte is consumed.
+   rd_adv <= out_rden_i when fsm_state = FWD_ST else
+             '1' when fsm_state = TX_ST and tx_toggle = '0' and tx_afull_i = '0' else
+             '0';
+
+   rd_addr <= rdptr + 1 when rd_adv = '1' else rdptr;
+
+
+   p_buf : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if in_rden = '1' then
+            buf(to_integer(wrptr)) <= in_data_i;
+         end if;
+         rd_data <= buf(to_integer(rd_addr));
+      end if;
+   end process p_buf;
+
+
+   p_fsm : process (clk_i)
+      variable v_match_mac : boolean;
+      variable v_match_ip  : boolean;
+      variable v_arp       : boolean;
+      variable v_icmp      : boolean;
+      variable v_csum      : std_logic_vector(16 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         in_rden  <= '0';
+         tx_valid <= '0';
+         tx_eof   <= '0';
+
+         if rd_adv = '1' then
+            rdptr <= rdptr + 1;
+         end if;
+
+         if in_rden = '1' then
+            -- Copy the headers, skipping the two-byte length.
+            if wrptr >= 2 and wrptr < C_HDR_SIZE+2 then
+               hdr(to_integer(wrptr-2)) <= in_data_i;
+            end if;
+            wrptr <= wrptr + 1;
+         end if;
+
+         case fsm_state is
+            when IN_ST =>
+               if in_empty_i = '0' and in_rden = '0' then   -- Only read every other clock cycle.
+                  in_rden <= '1';
+                  if in_eof_i = '1' then
+                     last      <= wrptr;
+                     rdptr     <= (others => '0');
+                     fsm_state <= DECIDE_ST;
+                  end if;
+               end if;
+
+            when DECIDE_ST =>
+               -- Wait for the last byte to be written.
+               if in_rden = '0' then
+                  wrptr <= (others => '0');
+
+                  v_match_mac := true;
+                  v_match_ip  := true;
+                  for i in 0 to 5 loop
+                     if hdr(i) /= get_byte(mac_i, i) then
+                        v_match_mac := false;
+                     end if;
+                  end loop;
+                  for i in 0 to 3 loop
+                     if hdr(38+i) /= get_byte(ip_i, i) then
+                        v_match_ip := false;
+                     end if;
+                  end loop;
+
+                  -- ARP request for our IP address.
+                  v_arp := enable_i(0) = '1' and last >= C_HDR_SIZE+1 and v_match_ip and
+                           hdr(12) = X"08" and hdr(13) = X"06" and               -- ARP
+                           hdr(14) = X"00" and hdr(15) = X"01" and               -- Ethernet
+                           hdr(16) = X"08" and hdr(17) = X"00" and               -- IPv4
+                           hdr(18) = X"06" and hdr(19) = X"04" and
+                           hdr(20) = X"00" and hdr(21) = X"01";                  -- Request
+
+                  v_match_ip := true;
+                  for i in 0 to 3 loop
+                     if hdr(30+i) /= get_byte(ip_i, i) then
+                        v_match_ip := false;
+                     end if;
+                  end loop;
+
+                  -- ICMP echo request to our MAC and IP address.
+                  v_icmp := enable_i(1) = '1' and last >= C_HDR_SIZE+1 and v_match_mac and v_match_ip and
+                            hdr(12) = X"08" and hdr(13) = X"00" and              -- IPv4
+                            hdr(14) = X"45" and                                  -- No options
+                            (hdr(20) and X"3F") = X"00" and hdr(21) = X"00" and  -- Not fragmented
+                            hdr(23) = X"01" and                                  -- ICMP
+                            hdr(34) = X"08" and hdr(35) = X"00";                 -- Echo request
+
+                  -- Changing the type from 8 to 0 adds 0x0800 to the checksum.
+                  v_csum    := ("0" & hdr(36) & hdr(37)) + X"0800";
+                  icmp_csum <= v_csum(15 downto 0) + v_csum(16);
+
+                  if v_arp then
+                     kind      <= ARP_KIND;
+                     rdptr     <= to_std_logic_vector(2, C_ADDR_SIZE);
+                     fsm_state <= TX_WAIT_ST;
+                  elsif v_icmp then
+                     kind      <= ICMP_KIND;
+                     rdptr     <= to_std_logic_vector(2, C_ADDR_SIZE);
+                     fsm_state <= TX_WAIT_ST;
+                  else
+                     fsm_state <= FWD_ST;
+                  end if;
+               end if;
+
+            when FWD_ST =>
+               if out_rden_i = '1' and rdptr = last then
+                  fsm_state <= IN_ST;
+               end if;
+
+            when TX_WAIT_ST =>
+               -- tx_req_o is now set, so the Tx DMA will not start a new frame.
+               if tx_busy_i = '0' then
+                  tx_toggle <= '0';
+                  tx_pos    <= (others => '0');
+                  fsm_state <= TX_ST;
+               end if;
+
+            when TX_ST =>
+               tx_toggle <= '0';
+               if rd_adv = '1' then   -- Only write every other clock cycle.
+                  tx_toggle <= '1';
+                  tx_valid  <= '1';
+                  tx_data   <= rd_data;
+                  tx_pos    <= tx_pos + 1;
+
+                  case to_integer(tx_pos) is
+                     -- Destination and source MAC address
+                     when  0 to  5 => tx_data <= hdr(to_integer(tx_pos)+6);
+                     when  6 to 11 => tx_data <= get_byte(mac_i, to_integer(tx_pos)-6);
+                     when others   => null;
+                  end case;
+
+                  if kind = ARP_KIND then
+                     case to_integer(tx_pos) is
+                        when 21       => tx_data <= X"02";    -- Reply
+                        when 22 to 27 => tx_data <= get_byte(mac_i, to_integer(tx_pos)-22);
+                        when 28 to 31 => tx_data <= get_byte(ip_i, to_integer(tx_pos)-28);
+                        when 32 to 41 => tx_data <= hdr(to_integer(tx_pos)-10);
+                        when others   => null;
+                     end case;
+                  else
+                     case to_integer(tx_pos) is
+                        when 26 to 29 => tx_data <= get_byte(ip_i, to_integer(tx_pos)-26);
+                        when 30 to 33 => tx_data <= hdr(to_integer(tx_pos)-4);
+                        when 34       => tx_data <= X"00";    -- Echo reply
+                        when 36       => tx_data <= icmp_csum(15 downto 8);
+                        when 37       => tx_data <= icmp_csum( 7 downto 0);
+                        when others   => null;
+                     end case;
+                  end if;
+
+                  if tx_pos + 2 = last then
+                     tx_eof <= '1';
+                     if kind = ARP_KIND then
+                        cnt_arp <= cnt_arp + 1;
+                     else
+                        cnt_icmp <= cnt_icmp + 1;
+                     end if;
+                     fsm_state <= IN_ST;
+                  end if;
+               end if;
+         end case;
+
+         if rst_i = '1' then
+            in_rden   <= '0';
+            wrptr     <= (others => '0');
+            tx_toggle <= '0';
+            fsm_state <= IN_ST;
+         end if;
+      end if;
+   end process p_fsm;
+
+
+   -- Connect output signals
+   in_rden_o   <= in_rden;
+
+   out_empty_o <= '0' when fsm_state = FWD_ST else '1';
+   out_data_o  <= rd_data;
+   out_eof_o   <= '1' when rdptr = last else '0';
+
+   tx_req_o    <= '1' when fsm_state = TX_WAIT_ST or fsm_state = TX_ST else '0';
+   tx_valid_o  <= tx_valid;
+   tx_data_o   <= tx_data;
+   tx_eof_o    <= tx_eof;
+
+   cnt_arp_o   <= cnt_arp;
+   cnt_icmp_o  <= cnt_icmp;
+
+end structural;
+
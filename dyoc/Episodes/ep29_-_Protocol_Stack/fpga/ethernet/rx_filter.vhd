@@ -0,0 +1,235 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std_unsigned.all;
+
+-- This module decides which received frames are relevant, so that the
+-- remaining frames can be discarded already in rx_header, before they are
+-- buffered and transferred to the CPU.
+--
+-- It monitors the same byte stream as rx_header, and sets drop_o as soon as
+-- the frame is known to be irrelevant. drop_o stays set until the end of the
+-- frame. Since all decisions are made within the first 78 bytes, drop_o is
+-- always valid when the last byte of a frame arrives.
+--
+-- There are three independent filters, each enabled by a bit in enable_i:
+-- * Bit 0 : Destination MAC address. Only frames to our MAC address, to the
+--           broadcast address, or to one of the IPv4 multicast addresses
+--           01:00:5E:xx:xx:xx in mcast_i are accepted.
+-- * Bit 1 : EtherType. Only frames with one of the EtherTypes in etype_i are
+--           accepted.
+-- * Bit 2 : UDP destination port. UDP packets are only accepted, if the
+--           destination port is one of the ports in udp_i. All other frames
+--           are accepted, including non-first IP fragments.
+-- Entries containing zero are not used.
+--
+-- The configuration comes from the user clock domain. It is assumed to be
+-- quasi-static, i.e. it is only changed while no frames are relevant.
+--
+-- For simplicity, everything is in the same clock domain.
+
+entity rx_filter is
+   port (
+      clk_i          : in  std_logic;
+      rst_i          : in  std_logic;
+
+      -- Configuration
+      enable_i       : in  std_logic_vector( 7 downto 0);
+      mac_i          : in  std_logic_vector(47 downto 0);  -- Byte 0 is first on the wire
+      mcast_i        : in  std_logic_vector(47 downto 0);  -- 2 entries of 3 bytes
+      etype_i        : in  std_logic_vector(47 downto 0);  -- 3 entries of 2 bytes (little-endian)
+      udp_i          : in  std_logic_vector(63 downto 0);  -- 4 entries of 2 bytes (little-endian)
+
+      -- Statistics. All these counters saturate at their maximum value.
+      cnt_mac_o      : out std_logic_vector( 7 downto 0);
+      cnt_etype_o    : out std_logic_vector( 7 downto 0);
+      cnt_udp_o      : out std_logic_vector( 7 downto 0);
+
+      -- Input interface
+      rx_valid_i     : in  std_logic;
+      rx_eof_i       : in  std_logic;
+      rx_data_i      : in  std_logic_vector(7 downto 0);
+      rx_error_i     : in  std_logic_vector(1 downto 0); -- Only valid @ EOF
+
+      -- Current frame must be discarded
+      drop_o         : out std_logic
+   );
+end rx_filter;
+
+architecture structural of rx_filter is
+
+   constant C_NUM_MCAST : integer := 2;
+   constant C_NUM_ETYPE : integer := 3;
+   constant C_NUM_UDP   : integer := 4;
+
+   -- Position of current byte within frame.
+   signal pos        : std_logic_vector(10 downto 0) := (others => '0');
+
+   -- Destination MAC address matches so far.
+   signal match_mac   : std_logic;
+   signal match_bcast : std_logic;
+   signal match_mcast : std_logic_vector(C_NUM_MCAST-1 downto 0);
+
+   -- Parsed from the headers.
+   signal etype_msb  : std_logic_vector(7 downto 0);
+   signal port_msb   : std_logic_vector(7 downto 0);
+   signal ipv4       : std_logic;
+   signal udp        : std_logic;
+   signal udp_pos    : std_logic_vector(10 downto 0);   -- Position of UDP destination port
+
+   type t_reason is (NONE, MAC_DROP, ETYPE_DROP, UDP_DROP);
+   signal reason     : t_reason := NONE;
+
+   -- Statistics
+   signal cnt_mac    : std_logic_vector(7 downto 0) := (others => '0');
+   signal cnt_etype  : std_logic_vector(7 downto 0) := (others => '0');
+   signal cnt_udp    : std_logic_vector(7 downto 0) := (others => '0');
+
+   -- Return byte i of a configuration field.
+   function get_byte(arg : std_logic_vector; i : integer) return std_logic_vector is
+   begin
+      return arg(arg'low + 8*i + 7 downto arg'low + 8*i);
+   end function get_byte;
+
+   -- Return entry i of a table of 16-bit values.
+   function get_word(arg : std_logic_vector; i : integer) return std_logic_vector is
+   begin
+      return arg(arg'low + 16*i + 15 downto arg'low + 16*i);
+   end function get_word;
+
+begin
+
+   p_filter : process (clk_i)
+      variable v_ok : boolean;
+   begin
+      if rising_edge(clk_i) then
+         if rx_valid_i = '1' then
+            pos <= pos + 1;
+
+            case to_integer(pos) is
+               when 0 to 5 =>
+                  -- Destination MAC address
+                  if pos = 0 then
+                     match_mac   <= '1';
+                     match_bcast <= '1';
+                     match_mcast <= (others => '1');
+                  end if;
+                  if rx_data_i /= get_byte(mac_i, to_integer(pos)) then
+                     match_mac <= '0';
+                  end if;
+                  if rx_data_i /= X"FF" then
+                     match_bcast <= '0';
+                  end if;
+                  for i in 0 to C_NUM_MCAST-1 loop
+                     case to_integer(pos) is
+                        when 0      => if rx_data_i /= X"01" then match_mcast(i) <= '0'; end if;
+                        when 1      => if rx_data_i /= X"00" then match_mcast(i) <= '0'; end if;
+                        when 2      => if rx_data_i /= X"5E" then match_mcast(i) <= '0'; end if;
+                        when others =>
+                           if rx_data_i /= get_byte(mcast_i, 3*i + to_integer(pos)-3) or
+                              get_byte(mcast_i, 3*i) & get_byte(mcast_i, 3*i+1) & get_byte(mcast_i, 3*i+2) = 0 then
+                              match_mcast(i) <= '0';
+                           end if;
+                     end case;
+                  end loop;
+
+               when 6 =>
+                  -- The destination MAC address is complete.
+                  if enable_i(0) = '1' and reason = NONE and
+                     match_mac = '0' and match_bcast = '0' and match_mcast = 0 then
+                     reason <= MAC_DROP;
+                  end if;
+
+               when 12 =>
+                  etype_msb <= rx_data_i;
+
+               when 13 =>
+                  v_ok := false;
+                  for i in 0 to C_NUM_ETYPE-1 loop
+                     if etype_msb & rx_data_i = get_word(etype_i, i) then
+                        v_ok := true;
+                     end if;
+                  end loop;
+                  if enable_i(1) = '1' and reason = NONE and not v_ok then
+                     reason <= ETYPE_DROP;
+                  end if;
+                  ipv4 <= '0';
+                  if etype_msb & rx_data_i = X"0800" then
+                     ipv4 <= '1';
+                  end if;
+
+               when 14 =>
+                  -- IP header length is in units of 4 bytes.
+                  udp_pos <= to_std_logic_vector(14+2, 11) + (rx_data_i(3 downto 0) & "00");
+                  udp     <= ipv4;
+
+               when 20 =>
+                  if rx_data_i(4 downto 0) /= 0 then
+                     udp <= '0';    -- Not the first fragment
+                  end if;
+
+               when 21 =>
+                  if rx_data_i /= 0 then
+                     udp <= '0';    -- Not the first fragment
+                  end if;
+
+               when 23 =>
+                  if rx_data_i /= 17 then
+                     udp <= '0';    -- Not UDP
+                  end if;
+
+               when others =>
+                  null;
+            end case;
+
+            -- UDP destination port
+            if pos >= 24 and pos = udp_pos then
+               port_msb <= rx_data_i;
+            end if;
+            if pos >= 24 and pos = udp_pos + 1 and udp = '1' then
+               v_ok := false;
+               for i in 0 to C_NUM_UDP-1 loop
+                  if port_msb & rx_data_i = get_word(udp_i, i) then
+                     v_ok := true;
+                  end if;
+               end loop;
+               if enable_i(2) = '1' and reason = NONE and not v_ok then
+                  reason <= UDP_DROP;
+               end if;
+            end if;
+
+            if rx_eof_i = '1' then
+               -- Only count frames that would otherwise have been received.
+               if rx_error_i = "00" then
+                  case reason is
+                     when MAC_DROP   => if cnt_mac   /= X"FF" then cnt_mac   <= cnt_mac   + 1; end if;
+                     when ETYPE_DROP => if cnt_etype /= X"FF" then cnt_etype <= cnt_etype + 1; end if;
+                     when UDP_DROP   => if cnt_udp   /= X"FF" then cnt_udp   <= cnt_udp   + 1; end if;
+                     when NONE       => null;
+                  end case;
+               end if;
+
+               -- Prepare for next frame.
+               pos    <= (others => '0');
+               reason <= NONE;
+            end if;
+         end if;
+
+         if rst_i = '1' then
+            pos       <= (others => '0');
+            reason    <= NONE;
+            cnt_mac   <= (others => '0');
+            cnt_etype <= (others => '0');
+            cnt_udp   <= (others => '0');
+         end if;
+      end if;
+   end process p_filter;
+
+
+   -- Connect output signals
+   drop_o      <= '0' when reason = NONE else '1';
+
+   cnt_mac_o   <= cnt_mac;
+   cnt_etype_o <= cnt_etype;
+   cnt_udp_o   <= cnt_udp;
+
+end structural;
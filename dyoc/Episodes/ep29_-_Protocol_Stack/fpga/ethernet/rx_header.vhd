@@ -13,6 +13,9 @@ use ieee.numeric_std_unsigned.all;
 -- start_ptr.  If the frame is to be discarded, the current write pointer is
 -- reset to this start_ptr.
 --
+-- Frames rejected by rx_filter (rx_drop_i) are discarded in the same way.
+-- They are not written to the input buffer, and are not counted here.
+--
 -- For simplicity, everything is in the same clock domain.
 
 entity rx_header is
@@ -24,6 +27,7 @@ entity rx_header is
       rx_eof_i       : in  std_logic;
       rx_data_i      : in  std_logic_vector(7 downto 0);
       rx_error_i     : in  std_logic_vector(1 downto 0); -- Only valid @ EOF
+      rx_drop_i      : in  std_logic;                    -- Discard this frame
 
       -- Statistics. All these counters saturate at their maximum value.
       cnt_good_o     : out std_logic_vector(15 downto 0);
@@ -103,6 +107,9 @@ begin
                if cnt_overflow /= X"FF" then   -- Saturate counter
                   cnt_overflow <= cnt_overflow + 1;
                end if;
+            elsif rx_drop_i = '1' then
+               -- Counted in rx_filter instead.
+               null;
             else
                -- No errors
                if cnt_good /= X"FFFF" then    -- Saturate counter
@@ -131,7 +138,10 @@ begin
 
          if rx_valid_i = '1' then
             -- Check for buffer overflow or for oversize frame
-            if wrptr + 1 = rdptr or (wrptr - start_ptr >= 1513 and rx_eof_i = '0') then
+            if rx_drop_i = '1' then
+               -- Don't waste space on a discarded frame.
+               null;
+            elsif wrptr + 1 = rdptr or (wrptr - start_ptr >= 1513 and rx_eof_i = '0') then
                -- Discard overflowed frame.
                rx_error <= '1';
             else
@@ -141,7 +151,7 @@ begin
             end if;
 
             if rx_eof_i = '1' then
-               if rx_error_i = "00" and rx_error = '0' and wrptr+1 /= rdptr then
+               if rx_error_i = "00" and rx_error = '0' and rx_drop_i = '0' and wrptr+1 /= rdptr then
                   -- Prepare for next frame.
                   start_ptr   <= wrptr+1;
                   wrptr       <= wrptr+1;
@@ -9,6 +9,17 @@ use ieee.numeric_std_unsigned.all;
 -- then write a 1 to ETH_TXDMA_ENABLE.
 -- When the Transmit DMA has read the contents of the memory, the value
 -- of ETH_TXDMA_ENABLE will be cleared to zero.
+--
+-- Optionally, the frame may be extended with a payload located elsewhere in
+-- memory, e.g. static content in ROM. To do this, write the pointer and length
+-- of the payload to ETH_TXDMA_PAYLOAD_PTR and ETH_TXDMA_PAYLOAD_LEN before
+-- enabling the DMA.  The length in the two-byte header then only covers the
+-- first part of the frame (i.e. the protocol headers), and the payload is
+-- sent immediately after. ETH_TXDMA_PAYLOAD_LEN is cleared to zero along with
+-- ETH_TXDMA_ENABLE, so ordinary frames need not touch these registers.
+--
+-- A new frame is not started while hold_i is set. This allows the hardware
+-- responder to share the Tx path. busy_o is set while a frame is being sent.
 
 entity tx_dma is
    port (
@@ -19,6 +30,12 @@ entity tx_dma is
       memio_enable_i : in  std_logic;
       memio_clear_o  : out std_logic;
 
+      memio_payload_ptr_i : in  std_logic_vector(15 downto 0);
+      memio_payload_len_i : in  std_logic_vector(15 downto 0);
+
+      hold_i         : in  std_logic;
+      busy_o         : out std_logic;
+
       rd_addr_o      : out std_logic_vector(15 downto 0);
       rd_en_o        : out std_logic;
       rd_data_i      : in  std_logic_vector( 7 downto 0);
@@ -39,6 +56,8 @@ architecture structural of tx_dma is
    signal rd_addr     : std_logic_vector(15 downto 0);
    signal rd_en       : std_logic;
    signal rd_len      : std_logic_vector(15 downto 0);
+   signal payload_ptr : std_logic_vector(15 downto 0);
+   signal payload_len : std_logic_vector(15 downto 0);
 
    signal wr_valid    : std_logic;
    signal wr_data     : std_logic_vector( 7 downto 0);
@@ -63,12 +82,14 @@ begin
 
          case fsm_state is
             when IDLE_ST =>
-               if memio_enable_i = '1' then
+               if memio_enable_i = '1' and hold_i = '0' then
                   if rd_en = '0' then  -- Only read every other clock cycle.
-                     rd_addr   <= memio_ptr_i;
-                     rd_en     <= '1';
-                     fsm_state <= LEN_LO_ST;
-                     cnt_start <= cnt_start + 1;
+                     rd_addr     <= memio_ptr_i;
+                     rd_en       <= '1';
+                     payload_ptr <= memio_payload_ptr_i;
+                     payload_len <= memio_payload_len_i;
+                     fsm_state   <= LEN_LO_ST;
+                     cnt_start   <= cnt_start + 1;
                   end if;
                end if;
 
@@ -95,7 +116,12 @@ begin
                   if rd_en = '1' then  -- Only read every other clock cycle.
                      wr_data   <= rd_data_i;
                   else
-                     if rd_len = 1 then
+                     if rd_len = 1 and payload_len /= 0 then
+                        -- Continue with the payload.
+                        rd_addr     <= payload_ptr;
+                        rd_len      <= payload_len;
+                        payload_len <= (others => '0');
+                     elsif rd_len = 1 then
                         wr_eof <= '1';
                         cnt_end <= cnt_end + 1;
                         memio_clear <= '1';
@@ -120,6 +146,7 @@ begin
 
    -- Connect output signals
    memio_clear_o <= memio_clear;
+   busy_o        <= '0' when fsm_state = IDLE_ST else '1';
    rd_addr_o     <= rd_addr;
    rd_en_o       <= rd_en;
    wr_valid_o    <= wr_valid;
@@ -13,7 +13,7 @@ entity mem is
       G_RAM_SIZE   : integer;          -- Number of bits in RAM address
       G_CHAR_SIZE  : integer;          -- Number of bits in CHAR address
       G_COL_SIZE   : integer;          -- Number of bits in COL address
-      G_MEMIO_SIZE : integer;          -- Number of bits in MEMIO address
+      G_MEMIO_SIZE : integer;          -- Number of bits in MEMIO address (at least 6)
       --
       G_ROM_MASK   : std_logic_vector(15 downto 0);  -- Value of upper bits in ROM address
       G_RAM_MASK   : std_logic_vector(15 downto 0);  -- Value of upper bits in RAM address
@@ -24,7 +24,7 @@ entity mem is
       G_ROM_FILE   : string;           -- Contains the contents of the ROM memory.
       --
       -- Initial contents of the Memory Mapped I/O
-      G_MEMIO_INIT : std_logic_vector(8*32-1 downto 0)
+      G_MEMIO_INIT : std_logic_vector(8*2**(G_MEMIO_SIZE-1)-1 downto 0)
    );
    port (
       clk_i           : in  std_logic;
@@ -36,8 +36,10 @@ entity mem is
       a_data_i        : in  std_logic_vector( 7 downto 0);
       a_wren_i        : in  std_logic;
       a_wait_o        : out std_logic;
+      a_bank_i        : in  std_logic;   -- Bank of CHAR and COL accessed by the CPU
 
       -- Port B - connected to VGA, Ethernet, and Memory Mapped I/O
+      b_bank_i        : in  std_logic;   -- Bank of CHAR and COL shown by the VGA
       b_char_addr_i   : in  std_logic_vector(12 downto 0);
       b_char_data_o   : out std_logic_vector( 7 downto 0);
       b_col_addr_i    : in  std_logic_vector(12 downto 0);
@@ -48,10 +50,11 @@ entity mem is
       b_eth_rd_en_i   : in  std_logic;
       b_eth_rd_addr_i : in  std_logic_vector(15 downto 0);
       b_eth_rd_data_o : out std_logic_vector( 7 downto 0);
-      b_memio_wr_o    : out std_logic_vector(8*32-1 downto 0);
-      b_memio_clear_i : in  std_logic_vector(  32-1 downto 0);
-      b_memio_rd_i    : in  std_logic_vector(8*32-1 downto 0);
-      b_memio_rden_o  : out std_logic_vector(  32-1 downto 0)
+      b_memio_wr_o    : out std_logic_vector(8*2**(G_MEMIO_SIZE-1)-1 downto 0);
+      b_memio_wren_o  : out std_logic_vector(  2**(G_MEMIO_SIZE-1)-1 downto 0);
+      b_memio_clear_i : in  std_logic_vector(  2**(G_MEMIO_SIZE-1)-1 downto 0);
+      b_memio_rd_i    : in  std_logic_vector(8*2**(G_MEMIO_SIZE-1)-1 downto 0);
+      b_memio_rden_o  : out std_logic_vector(  2**(G_MEMIO_SIZE-1)-1 downto 0)
    );
 end mem;
 
@@ -60,6 +63,9 @@ architecture structural of mem is
    signal rom_data  : std_logic_vector(7 downto 0);
    signal rom_cs    : std_logic;
    --
+   signal rom_b_data : std_logic_vector(7 downto 0);
+   signal rom_b_cs   : std_logic;
+   --
    signal ram_wren  : std_logic;
    signal ram_data  : std_logic_vector(7 downto 0);
    signal ram_cs    : std_logic;
@@ -75,6 +81,7 @@ architecture structural of mem is
    signal memio_wren : std_logic;
    signal memio_data : std_logic_vector(7 downto 0);
    signal memio_cs   : std_logic;
+   signal memio_addr : std_logic_vector(G_MEMIO_SIZE-1 downto 0);
    --
    signal ram_wr_en   : std_logic;
    signal ram_rd_addr : std_logic_vector(G_RAM_SIZE-1 downto 0);
@@ -96,19 +103,41 @@ begin
    col_cs   <= '1' when a_addr_i(15 downto G_COL_SIZE)   = G_COL_MASK(   15 downto G_COL_SIZE)   else '0';
    memio_cs <= '1' when a_addr_i(15 downto G_MEMIO_SIZE) = G_MEMIO_MASK( 15 downto G_MEMIO_SIZE) else '0';
 
+   -- The Ethernet Tx DMA may read from either RAM or ROM.
+   rom_b_cs <= '1' when b_eth_rd_addr_i(15 downto G_ROM_SIZE) = G_ROM_MASK(15 downto G_ROM_SIZE) else '0';
+
    ram_wren   <= (a_wren_i and ram_cs   and not (a_wait and not a_wait_d)) or b_eth_wr_en_i;
    char_wren  <=  a_wren_i and char_cs  and not (a_wait and not a_wait_d);
    col_wren   <=  a_wren_i and col_cs   and not (a_wait and not a_wait_d);
    memio_wren <=  a_wren_i and memio_cs and not (a_wait and not a_wait_d);
 
 
-   process (a_addr_i, a_rden_i, memio_cs, a_wait_d)
+   -- The MEMIO is arranged in blocks of 64 bytes, each with 32 configuration
+   -- bytes followed by 32 status bytes. The topmost block (7FC0-7FFF) is the
+   -- original one, and further blocks are added below it. Inside the memio
+   -- module all configuration bytes come first, and then all status bytes,
+   -- so the address bits are reordered here. This way the original block
+   -- keeps index 0-31 in both halves.
+   memio_addr <= a_addr_i(5) & not a_addr_i(G_MEMIO_SIZE-1 downto 6) & a_addr_i(4 downto 0);
+
+   process (memio_addr, a_rden_i, memio_cs, a_wait_d)
    begin
       b_memio_rden_o <= (others => '0');
-      b_memio_rden_o(to_integer(a_addr_i(G_MEMIO_SIZE-2 downto 0))) <=
-         a_rden_i and memio_cs and a_wait_d and a_addr_i(G_MEMIO_SIZE-1);
+      b_memio_rden_o(to_integer(memio_addr(G_MEMIO_SIZE-2 downto 0))) <=
+         a_rden_i and memio_cs and a_wait_d and memio_addr(G_MEMIO_SIZE-1);
    end process;
 
+   -- Pulse for each write to a configuration byte. This comes one clock
+   -- cycle after the write, i.e. together with the new value on b_memio_wr_o.
+   p_memio_wren : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         b_memio_wren_o <= (others => '0');
+         b_memio_wren_o(to_integer(memio_addr(G_MEMIO_SIZE-2 downto 0))) <=
+            memio_wren and not memio_addr(G_MEMIO_SIZE-1);
+      end if;
+   end process p_memio_wren;
+
    --------------------
    -- Insert wait state
    --------------------
@@ -164,7 +193,10 @@ begin
    port map (
       clk_i  => clk_i,
       addr_i => a_addr_i(G_ROM_SIZE-1 downto 0),
-      data_o => rom_data
+      data_o => rom_data,
+      --
+      b_addr_i => b_eth_rd_addr_i(G_ROM_SIZE-1 downto 0),
+      b_data_o => rom_b_data
    );
 
 
@@ -179,7 +211,7 @@ begin
    )
    port map (
       clk_i           => clk_i,
-      a_addr_i        => a_addr_i(G_MEMIO_SIZE-1 downto 0),
+      a_addr_i        => memio_addr,
       a_data_o        => memio_data,
       a_data_i        => a_data_i,
       a_wren_i        => memio_wren,
@@ -191,19 +223,21 @@ begin
 
    -----------------------------------
    -- Instantiate the character memory
+   -- The character and colour memories each contain two banks,
+   -- so the CPU can draw in one while the VGA shows the other.
    -----------------------------------
 
    i_char : entity work.dmem
    generic map (
-      G_ADDR_BITS => G_CHAR_SIZE
+      G_ADDR_BITS => G_CHAR_SIZE+1
    )
    port map (
       clk_i    => clk_i,
-      a_addr_i => a_addr_i(G_CHAR_SIZE-1 downto 0),
+      a_addr_i => a_bank_i & a_addr_i(G_CHAR_SIZE-1 downto 0),
       a_data_o => char_data,
       a_data_i => a_data_i,
       a_wren_i => char_wren,
-      b_addr_i => b_char_addr_i,
+      b_addr_i => b_bank_i & b_char_addr_i,
       b_data_o => b_char_data_o
    );
 
@@ -214,16 +248,16 @@ begin
 
    i_col : entity work.dmem
    generic map (
-      G_ADDR_BITS => G_COL_SIZE,
+      G_ADDR_BITS => G_COL_SIZE+1,
       G_INIT_VAL  => X"0F"    -- Default is white text on black background.
    )
    port map (
       clk_i    => clk_i,
-      a_addr_i => a_addr_i(G_COL_SIZE-1 downto 0),
+      a_addr_i => a_bank_i & a_addr_i(G_COL_SIZE-1 downto 0),
       a_data_o => col_data,
       a_data_i => a_data_i,
       a_wren_i => col_wren,
-      b_addr_i => b_col_addr_i,
+      b_addr_i => b_bank_i & b_col_addr_i,
       b_data_o => b_col_data_o
    );
 
@@ -247,7 +281,8 @@ begin
 
    -- Connect output signals
 
-   b_eth_rd_data_o <= ram_data when b_eth_rd_en_i = '1' else
+   b_eth_rd_data_o <= rom_b_data when b_eth_rd_en_i = '1' and rom_b_cs = '1' else
+                      ram_data   when b_eth_rd_en_i = '1' else
                       X"00";   -- Default value is needed to avoid inferring a latch.
    
    a_data_o <= rom_data   when rom_cs   = '1' else
@@ -2,10 +2,13 @@ library ieee;
 use ieee.std_logic_1164.all;
 use ieee.numeric_std_unsigned.all;
 
+-- The lower half of the address space contains configuration bytes written
+-- by the CPU, and the upper half contains status bytes read by the CPU.
+
 entity memio is
    generic (
       G_ADDR_BITS : integer;
-      G_INIT_VAL  : std_logic_vector(8*32-1 downto 0)
+      G_INIT_VAL  : std_logic_vector(8*2**(G_ADDR_BITS-1)-1 downto 0)
    );
    port (
       clk_i  : in  std_logic;
@@ -17,16 +20,18 @@ entity memio is
       a_wren_i : in  std_logic;
 
       -- Port B
-      b_memio_i       : in  std_logic_vector(8*32-1 downto 0);  -- To MEMIO
-      b_memio_clear_i : in  std_logic_vector(  32-1 downto 0);
-      b_memio_o       : out std_logic_vector(8*32-1 downto 0)   -- From MEMIO
+      b_memio_i       : in  std_logic_vector(8*2**(G_ADDR_BITS-1)-1 downto 0);  -- To MEMIO
+      b_memio_clear_i : in  std_logic_vector(  2**(G_ADDR_BITS-1)-1 downto 0);
+      b_memio_o       : out std_logic_vector(8*2**(G_ADDR_BITS-1)-1 downto 0)   -- From MEMIO
    );
 end memio;
 
 architecture structural of memio is
 
-   signal memio_r : std_logic_vector( 8*32-1 downto 0) := G_INIT_VAL;
-   signal memio_s : std_logic_vector(16*32-1 downto 0);
+   constant C_SIZE : integer := 2**(G_ADDR_BITS-1);   -- Number of bytes in each half
+
+   signal memio_r : std_logic_vector( 8*C_SIZE-1 downto 0) := G_INIT_VAL;
+   signal memio_s : std_logic_vector(16*C_SIZE-1 downto 0);
 
 begin
 
@@ -42,7 +47,7 @@ begin
          if a_wren_i = '1' and a_addr_i(G_ADDR_BITS-1) = '0' then
             memio_r(addr_v*8+7 downto addr_v*8) <= a_data_i;
          end if;
-         for i in 0 to 31 loop
+         for i in 0 to C_SIZE-1 loop
             if b_memio_clear_i(i) = '1' then
                memio_r(8*i+7 downto 8*i) <= G_INIT_VAL(8*i+7 downto 8*i);
             end if;
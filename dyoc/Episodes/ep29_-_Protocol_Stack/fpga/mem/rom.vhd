@@ -3,10 +3,10 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std_unsigned.all;
 use std.textio.all;
 
--- This module models a single-port asynchronous RAM.
--- Even though there are separate signals for data
--- input and data output, simultaneous read and write
--- will not be used in this design.
+-- This module models a dual-port asynchronous ROM.
+-- Port A is connected to the CPU, and port B is connected
+-- to the Ethernet Tx DMA, so that frame payloads can be
+-- read directly from ROM.
 --
 -- Data read is present half way through the same clock cycle.
 -- This is done by using a synchronous Block RAM, and reading
@@ -27,7 +27,11 @@ entity rom is
 
       -- Data contents at the selected address.
       -- Valid in same clock cycle.
-      data_o : out std_logic_vector(7 downto 0)
+      data_o : out std_logic_vector(7 downto 0);
+
+      -- Second read port
+      b_addr_i : in  std_logic_vector(G_ADDR_BITS-1 downto 0);
+      b_data_o : out std_logic_vector(7 downto 0)
    );
 end rom;
 
@@ -56,7 +60,8 @@ architecture structural of rom is
    signal mem : mem_t := InitRamFromFile(G_INIT_FILE);
 
    -- Data read from memory.
-   signal data : std_logic_vector(7 downto 0);
+   signal data   : std_logic_vector(7 downto 0);
+   signal b_data : std_logic_vector(7 downto 0);
 
 begin
 
@@ -70,8 +75,16 @@ begin
       end if;
    end process p_data;
 
+   p_b_data : process (clk_i)
+   begin
+      if falling_edge(clk_i) then
+         b_data <= mem(to_integer(b_addr_i));
+      end if;
+   end process p_b_data;
+
    -- Drive output signals
-   data_o <= data;
+   data_o   <= data;
+   b_data_o <= b_data;
 
 end structural;
 
@@ -3,6 +3,11 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std_unsigned.all;
 
 entity tb is
+   generic (
+      -- When true, the simulation runs until the program writes BENCH_DONE,
+      -- and then reports the value of BENCH_CYCLES. Used by bench.py.
+      G_BENCH : boolean := false
+   );
 end tb;
 
 architecture structural of tb is
@@ -45,7 +50,8 @@ architecture structural of tb is
    signal sim_rx_data : std_logic_vector(1600*8-1 downto 0);
    signal sim_rx_done : std_logic;
 
-   signal test_running : std_logic := '1';
+   signal test_running   : std_logic := '1';
+   signal bench_finished : std_logic := '0';
 
 begin
    
@@ -58,7 +64,7 @@ begin
       clk <= '1', '0' after 5 ns; -- 100 MHz
       wait for 10 ns;
 
-      if test_running = '0' then
+      if test_running = '0' or bench_finished = '1' then
          wait;
       end if;
    end process clk_gen;
@@ -193,6 +199,10 @@ begin
 
       report "Test completed";
 
+      if G_BENCH then
+         wait;                    -- The benchmark process ends the simulation.
+      end if;
+
       wait for 10 us;
 
       test_running <= '0';
@@ -200,6 +210,26 @@ begin
    end process;
 
 
+   ---------------------
+   -- Benchmark
+   ---------------------
+
+   p_bench : process
+      alias bench_done   is << signal .tb.inst_comp.bench_memio_done   : std_logic >>;
+      alias bench_cycles is << signal .tb.inst_comp.bench_memio_cycles : std_logic_vector(31 downto 0) >>;
+   begin
+      if not G_BENCH then
+         wait;
+      end if;
+
+      wait until bench_done = '1';
+      report "BENCH cycles=" & to_hstring(bench_cycles);
+
+      bench_finished <= '1';
+      wait;
+   end process p_bench;
+
+
    ---------------------
    -- Generate PS/2 data
    ---------------------
@@ -0,0 +1,183 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std_unsigned.all;
+
+-- This module contains a bitmap of 320x240 pixels with 16 colours, and shows
+-- it on top of the text screen. Each bitmap pixel covers 2x2 screen pixels.
+-- The colours are looked up in the same palette as the text, except that
+-- colour 0 is transparent, so the text screen is visible through it.
+--
+-- The bitmap memory is not accessible from the CPU. Instead it is written by
+-- the blitter, connected to port A.
+--
+-- It receives as input the current screen, and outputs the modified screen.
+-- The foreground flag is set for text pixels and for visible bitmap pixels.
+
+entity bitmap is
+   port (
+      clk_i     : in  std_logic;
+
+      enable_i  : in  std_logic;
+      palette_i : in  std_logic_vector(16*8-1 downto 0);
+
+      -- Port A
+      a_addr_i  : in  std_logic_vector(16 downto 0);
+      a_wren_i  : in  std_logic;
+      a_data_i  : in  std_logic_vector( 3 downto 0);
+      a_data_o  : out std_logic_vector( 3 downto 0);
+
+      -- Current screen
+      pix_x_i   : in  std_logic_vector(9 downto 0);
+      pix_y_i   : in  std_logic_vector(9 downto 0);
+      vga_hs_i  : in  std_logic;
+      vga_vs_i  : in  std_logic;
+      vga_col_i : in  std_logic_vector(7 downto 0);
+      fg_i      : in  std_logic;
+
+      -- Modified screen with bitmap
+      pix_x_o   : out std_logic_vector(9 downto 0);
+      pix_y_o   : out std_logic_vector(9 downto 0);
+      vga_hs_o  : out std_logic;
+      vga_vs_o  : out std_logic;
+      vga_col_o : out std_logic_vector(7 downto 0);
+      fg_o      : out std_logic
+   );
+end bitmap;
+
+architecture structural of bitmap is
+
+   -- Define visible screen size
+   constant H_PIXELS : integer := 640;
+   constant V_PIXELS : integer := 480;
+
+   -- Size of bitmap
+   constant C_SIZE : integer := (H_PIXELS/2)*(V_PIXELS/2);
+
+   type t_mem is array (0 to C_SIZE-1) of std_logic_vector(3 downto 0);
+   signal mem : t_mem := (others => (others => '0'));
+
+   -- This record contains all the registers used in the pipeline.
+   type t_vga is record
+      pix_x   : std_logic_vector(9 downto 0);
+      pix_y   : std_logic_vector(9 downto 0);
+      hs      : std_logic;
+      vs      : std_logic;
+      col     : std_logic_vector(7 downto 0);
+      fg      : std_logic;
+      addr    : std_logic_vector(16 downto 0);   -- Valid after stage 1
+      pixel   : std_logic_vector(3 downto 0);    -- Valid after stage 2
+   end record t_vga;
+
+   signal stage0 : t_vga;
+   signal stage1 : t_vga;
+   signal stage2 : t_vga;
+   signal stage3 : t_vga;
+
+begin
+
+   ---------------------------------------------
+   -- Port A
+   ---------------------------------------------
+
+   p_port_a : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if a_addr_i < C_SIZE then
+            a_data_o <= mem(to_integer(a_addr_i));
+            if a_wren_i = '1' then
+               mem(to_integer(a_addr_i)) <= a_data_i;
+            end if;
+         end if;
+      end if;
+   end process p_port_a;
+
+
+   ---------------------------------------------
+   -- Stage 0
+   -- This stage copies the input signals.
+   ---------------------------------------------
+
+   stage0.pix_x <= pix_x_i;
+   stage0.pix_y <= pix_y_i;
+   stage0.hs    <= vga_hs_i;
+   stage0.vs    <= vga_vs_i;
+   stage0.col   <= vga_col_i;
+   stage0.fg    <= fg_i;
+
+
+   ---------------------------------------------
+   -- Stage 1
+   -- Calculate address in bitmap, i.e. (y/2)*320 + x/2.
+   -- Outside the visible screen the address is not used.
+   ---------------------------------------------
+
+   p_stage1 : process (clk_i)
+      variable v_x : std_logic_vector(8 downto 0);
+      variable v_y : std_logic_vector(7 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage1 <= stage0;
+
+         v_x := stage0.pix_x(9 downto 1);
+         v_y := stage0.pix_y(8 downto 1);
+
+         stage1.addr <= ("0" & v_y & "00000000") + ("000" & v_y & "000000") + v_x;
+         if stage0.pix_x >= H_PIXELS or stage0.pix_y >= V_PIXELS then
+            stage1.addr <= (others => '0');
+         end if;
+      end if;
+   end process p_stage1;
+
+
+   ---------------------------------------------
+   -- Stage 2
+   -- Read pixel from bitmap.
+   ---------------------------------------------
+
+   p_stage2 : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage2 <= stage1;
+
+         stage2.pixel <= mem(to_integer(stage1.addr));
+      end if;
+   end process p_stage2;
+
+
+   ---------------------------------------------
+   -- Stage 3
+   -- Select colour.
+   ---------------------------------------------
+
+   p_stage3 : process (clk_i)
+      variable v_colour : integer range 0 to 15;
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage3 <= stage2;
+
+         v_colour := to_integer(stage2.pixel);
+         if enable_i = '1' and v_colour /= 0 and
+            stage2.pix_x < H_PIXELS and stage2.pix_y < V_PIXELS then
+            stage3.col <= palette_i(v_colour*8+7 downto v_colour*8);
+            stage3.fg  <= '1';
+         end if;
+      end if;
+   end process p_stage3;
+
+
+   --------------------------------------------------
+   -- Drive output signals
+   --------------------------------------------------
+
+   pix_x_o   <= stage3.pix_x;
+   pix_y_o   <= stage3.pix_y;
+   vga_hs_o  <= stage3.hs;
+   vga_vs_o  <= stage3.vs;
+   vga_col_o <= stage3.col;
+   fg_o      <= stage3.fg;
+
+end architecture structural;
+
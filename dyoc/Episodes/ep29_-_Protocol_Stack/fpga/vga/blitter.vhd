@@ -0,0 +1,198 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std_unsigned.all;
+
+-- This module draws into the 320x240 bitmap, one pixel every clock cycle.
+-- The user writes the parameters to the BLIT_* registers, and then writes
+-- the command to BLIT_CMD. When the command is finished, BLIT_CMD is
+-- cleared to zero.
+--
+-- The commands are:
+-- 1 : FILL    : Fill the rectangle (X, Y, W, H) with colour COL(3:0).
+--               Horizontal and vertical lines are rectangles with H=1 or W=1.
+-- 2 : PATTERN : Fill the rectangle with the 8x8 PATTERN. A set bit gives
+--               COL(3:0), and a cleared bit gives COL(7:4). The pattern is
+--               aligned to the screen, so adjacent rectangles match up.
+--               Byte 0 is the top row, and bit 7 is the leftmost pixel.
+-- 3 : COPY    : Copy a rectangle of size (W, H) from (SRC_X, SRC_Y) to (X, Y).
+--               The pixels are copied row by row from the top left, so
+--               overlapping areas only work when moving up or left.
+--
+-- Pixels outside the screen are not written.
+
+entity blitter is
+   port (
+      clk_i       : in  std_logic;
+
+      x_i         : in  std_logic_vector(15 downto 0);
+      y_i         : in  std_logic_vector( 7 downto 0);
+      w_i         : in  std_logic_vector(15 downto 0);
+      h_i         : in  std_logic_vector( 7 downto 0);
+      col_i       : in  std_logic_vector( 7 downto 0);
+      cmd_i       : in  std_logic_vector( 7 downto 0);
+      clear_o     : out std_logic;    -- Clears cmd_i when command is finished
+      src_x_i     : in  std_logic_vector(15 downto 0);
+      src_y_i     : in  std_logic_vector( 7 downto 0);
+      pattern_i   : in  std_logic_vector(63 downto 0);
+
+      -- Connected to bitmap memory
+      addr_o      : out std_logic_vector(16 downto 0);
+      wren_o      : out std_logic;
+      data_o      : out std_logic_vector( 3 downto 0);
+      data_i      : in  std_logic_vector( 3 downto 0)
+   );
+end blitter;
+
+architecture structural of blitter is
+
+   -- Size of bitmap
+   constant H_PIXELS : integer := 320;
+   constant V_PIXELS : integer := 240;
+
+   constant C_CMD_FILL    : std_logic_vector(7 downto 0) := X"01";
+   constant C_CMD_PATTERN : std_logic_vector(7 downto 0) := X"02";
+   constant C_CMD_COPY    : std_logic_vector(7 downto 0) := X"03";
+
+   type t_fsm_state is (IDLE_ST, DRAW_ST, READ_ST, WRITE_ST, DONE_ST);
+   signal fsm_state : t_fsm_state := IDLE_ST;
+
+   -- Copy of parameters
+   signal cmd     : std_logic_vector( 7 downto 0);
+   signal col     : std_logic_vector( 7 downto 0);
+   signal pattern : std_logic_vector(63 downto 0);
+   signal start_x : std_logic_vector(15 downto 0);
+   signal src_x0  : std_logic_vector(15 downto 0);
+   signal last_x  : std_logic_vector(15 downto 0);
+   signal last_y  : std_logic_vector( 7 downto 0);
+
+   -- Current position
+   signal cnt_x   : std_logic_vector(15 downto 0);
+   signal cnt_y   : std_logic_vector( 7 downto 0);
+   signal dst_x   : std_logic_vector(15 downto 0);
+   signal dst_y   : std_logic_vector( 8 downto 0);
+   signal src_x   : std_logic_vector(15 downto 0);
+   signal src_y   : std_logic_vector( 8 downto 0);
+
+   signal clear   : std_logic := '0';
+
+   signal dst_valid : std_logic;
+   signal src_valid : std_logic;
+   signal dst_addr  : std_logic_vector(16 downto 0);
+   signal src_addr  : std_logic_vector(16 downto 0);
+   signal pixel     : std_logic_vector( 3 downto 0);
+
+   -- Calculate y*320 + x.
+   function pix_addr(x : std_logic_vector(15 downto 0); y : std_logic_vector(8 downto 0))
+   return std_logic_vector is
+   begin
+      return ("0" & y(7 downto 0) & "00000000") + ("000" & y(7 downto 0) & "000000") + x(8 downto 0);
+   end function pix_addr;
+
+begin
+
+   dst_valid <= '1' when dst_x < H_PIXELS and dst_y < V_PIXELS else '0';
+   src_valid <= '1' when src_x < H_PIXELS and src_y < V_PIXELS else '0';
+   dst_addr  <= pix_addr(dst_x, dst_y);
+   src_addr  <= pix_addr(src_x, src_y);
+
+   -- Colour of the current pixel when filling.
+   p_pixel : process (cmd, col, pattern, dst_x, dst_y)
+      variable v_bit : integer range 0 to 63;
+   begin
+      pixel <= col(3 downto 0);
+      if cmd = C_CMD_PATTERN then
+         v_bit := to_integer(dst_y(2 downto 0))*8 + 7 - to_integer(dst_x(2 downto 0));
+         if pattern(v_bit) = '0' then
+            pixel <= col(7 downto 4);
+         end if;
+      end if;
+   end process p_pixel;
+
+
+   p_fsm : process (clk_i)
+
+      -- Move to the next pixel, and finish after the last one.
+      procedure next_pixel is
+      begin
+         if cnt_x = last_x then
+            cnt_x <= (others => '0');
+            dst_x <= start_x;
+            src_x <= src_x0;
+            if cnt_y = last_y then
+               clear     <= '1';
+               fsm_state <= DONE_ST;
+            else
+               cnt_y <= cnt_y + 1;
+               dst_y <= dst_y + 1;
+               src_y <= src_y + 1;
+            end if;
+         else
+            cnt_x <= cnt_x + 1;
+            dst_x <= dst_x + 1;
+            src_x <= src_x + 1;
+         end if;
+      end procedure next_pixel;
+
+   begin
+      if rising_edge(clk_i) then
+         clear <= '0';
+
+         case fsm_state is
+            when IDLE_ST =>
+               if cmd_i /= X"00" then
+                  cmd     <= cmd_i;
+                  col     <= col_i;
+                  pattern <= pattern_i;
+                  start_x <= x_i;
+                  src_x0  <= src_x_i;
+                  last_x  <= w_i - 1;
+                  last_y  <= h_i - 1;
+                  cnt_x   <= (others => '0');
+                  cnt_y   <= (others => '0');
+                  dst_x   <= x_i;
+                  dst_y   <= "0" & y_i;
+                  src_x   <= src_x_i;
+                  src_y   <= "0" & src_y_i;
+
+                  if w_i = 0 or h_i = 0 or
+                     (cmd_i /= C_CMD_FILL and cmd_i /= C_CMD_PATTERN and cmd_i /= C_CMD_COPY) then
+                     clear     <= '1';
+                     fsm_state <= DONE_ST;
+                  elsif cmd_i = C_CMD_COPY then
+                     fsm_state <= READ_ST;
+                  else
+                     fsm_state <= DRAW_ST;
+                  end if;
+               end if;
+
+            when DRAW_ST =>
+               next_pixel;
+
+            when READ_ST =>
+               fsm_state <= WRITE_ST;
+
+            when WRITE_ST =>
+               fsm_state <= READ_ST;
+               next_pixel;
+
+            when DONE_ST =>
+               -- Wait one clock cycle for cmd_i to be cleared.
+               fsm_state <= IDLE_ST;
+         end case;
+      end if;
+   end process p_fsm;
+
+
+   --------------------------------------------------
+   -- Drive output signals
+   --------------------------------------------------
+
+   addr_o  <= src_addr when fsm_state = READ_ST else dst_addr;
+   wren_o  <= dst_valid when fsm_state = DRAW_ST else
+              dst_valid and src_valid when fsm_state = WRITE_ST else
+              '0';
+   data_o  <= data_i when fsm_state = WRITE_ST else pixel;
+   clear_o <= clear;
+
+end architecture structural;
+
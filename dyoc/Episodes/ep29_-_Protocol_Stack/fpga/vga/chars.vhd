@@ -23,7 +23,8 @@ entity chars is
       pix_y_o     : out std_logic_vector(9 downto 0);
       vga_hs_o    : out std_logic;
       vga_vs_o    : out std_logic;
-      vga_col_o   : out std_logic_vector(7 downto 0)
+      vga_col_o   : out std_logic_vector(7 downto 0);
+      fg_o        : out std_logic     -- Pixel is part of a character
    );
 end chars;
 
@@ -65,6 +66,7 @@ architecture structural of chars is
 
       -- Valid after stage 3
       pix_col : std_logic_vector(7 downto 0);
+      fg      : std_logic;
    end record t_vga;
 
    signal stage0 : t_vga;
@@ -188,10 +190,12 @@ begin
             v_colour := to_integer(stage2.color(7 downto 4));
          end if;
          stage3.pix_col <= palette_i(v_colour*8+7 downto v_colour*8);
+         stage3.fg      <= stage2.bitmap(v_offset_bitmap);
 
          -- Make sure colour is black outside visible screen
          if stage2.pix_x >= H_PIXELS or stage2.pix_y >= V_PIXELS then
             stage3.pix_col <= (others => '0');  -- Black
+            stage3.fg      <= '0';
          end if;
 
       end if;
@@ -205,6 +209,7 @@ begin
    vga_hs_o  <= stage3.hs;
    vga_vs_o  <= stage3.vs;
    vga_col_o <= stage3.pix_col;
+   fg_o      <= stage3.fg;
    pix_x_o   <= stage3.pix_x;
    pix_y_o   <= stage3.pix_y;
 
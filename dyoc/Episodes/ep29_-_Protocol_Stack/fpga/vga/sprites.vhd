@@ -0,0 +1,279 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std_unsigned.all;
+
+-- This module shows 4 hardware sprites on top of the screen. Each sprite is
+-- a 16x16 bitmap with a single colour, where cleared bits are transparent.
+--
+-- The configuration contains, for each sprite i:
+-- * 2*i + 0x00 : X-position (2 bytes)
+-- * 2*i + 0x08 : Y-position (2 bytes)
+-- *   i + 0x10 : Colour
+-- *   i + 0x14 : Control. Bit 0 : Enable
+--                         Bit 1 : Behind foreground, i.e. text and bitmap
+--                         Bit 2 : Magnify, i.e. each bit covers 2x2 pixels
+-- The position is the top left corner of the sprite in screen pixels.
+-- When sprites overlap, sprite 0 has the highest priority.
+--
+-- The bitmaps are written through a single data port. Writing to the
+-- address port sets the internal pointer, and each write to the data port
+-- writes one byte and increments the pointer. Each sprite uses 32 bytes,
+-- two bytes per row starting with the top row. Bit 7 of the first byte is
+-- the leftmost pixel. The address is therefore sprite*32 + row*2 + byte.
+--
+-- Collisions are accumulated until the status register is read:
+-- * coll_o    : Bit i is set when sprite i has overlapped another sprite.
+-- * coll_fg_o : Bit i is set when sprite i has overlapped the foreground.
+--
+-- It receives as input the current screen, and outputs the modified screen.
+
+entity sprites is
+   port (
+      clk_i           : in  std_logic;
+
+      config_i        : in  std_logic_vector(24*8-1 downto 0);
+
+      -- Bitmap write port
+      addr_i          : in  std_logic_vector( 7 downto 0);
+      addr_wr_i       : in  std_logic;
+      data_i          : in  std_logic_vector( 7 downto 0);
+      data_wr_i       : in  std_logic;
+
+      -- Collision status
+      coll_o          : out std_logic_vector( 7 downto 0);
+      coll_clear_i    : in  std_logic;
+      coll_fg_o       : out std_logic_vector( 7 downto 0);
+      coll_fg_clear_i : in  std_logic;
+
+      -- Current screen
+      pix_x_i         : in  std_logic_vector(9 downto 0);
+      pix_y_i         : in  std_logic_vector(9 downto 0);
+      vga_hs_i        : in  std_logic;
+      vga_vs_i        : in  std_logic;
+      vga_col_i       : in  std_logic_vector(7 downto 0);
+      fg_i            : in  std_logic;   -- Current pixel is foreground
+
+      -- Modified screen with sprites
+      pix_x_o         : out std_logic_vector(9 downto 0);
+      pix_y_o         : out std_logic_vector(9 downto 0);
+      vga_hs_o        : out std_logic;
+      vga_vs_o        : out std_logic;
+      vga_col_o       : out std_logic_vector(7 downto 0)
+   );
+end sprites;
+
+architecture structural of sprites is
+
+   -- Define visible screen size
+   constant H_PIXELS : integer := 640;
+   constant V_PIXELS : integer := 480;
+
+   constant C_NUM  : integer := 4;
+
+   -- Offsets in configuration
+   constant C_XPOS : integer := 0;
+   constant C_YPOS : integer := 8;
+   constant C_COL  : integer := 16;
+   constant C_CTRL : integer := 20;
+
+   -- Sprite bitmaps, one word for each row
+   type t_mem is array (0 to 16*C_NUM-1) of std_logic_vector(15 downto 0);
+   signal mem : t_mem := (others => (others => '0'));
+   signal ptr : std_logic_vector(6 downto 0) := (others => '0');
+
+   type t_pos  is array (0 to C_NUM-1) of std_logic_vector(9 downto 0);
+   type t_byte is array (0 to C_NUM-1) of std_logic_vector(7 downto 0);
+   type t_idx  is array (0 to C_NUM-1) of std_logic_vector(3 downto 0);
+
+   signal pos_x : t_pos;
+   signal pos_y : t_pos;
+   signal col   : t_byte;
+   signal ctrl  : t_byte;
+
+   -- This record contains all the registers used in the pipeline.
+   type t_vga is record
+      pix_x   : std_logic_vector(9 downto 0);
+      pix_y   : std_logic_vector(9 downto 0);
+      hs      : std_logic;
+      vs      : std_logic;
+      col     : std_logic_vector(7 downto 0);
+      fg      : std_logic;
+      valid   : std_logic_vector(C_NUM-1 downto 0);   -- Valid after stage 1
+      row     : t_idx;                                -- Valid after stage 1
+      column  : t_idx;                                -- Valid after stage 1
+      pix     : std_logic_vector(C_NUM-1 downto 0);   -- Valid after stage 2
+   end record t_vga;
+
+   signal stage0 : t_vga;
+   signal stage1 : t_vga;
+   signal stage2 : t_vga;
+   signal stage3 : t_vga;
+
+   signal coll    : std_logic_vector(C_NUM-1 downto 0) := (others => '0');
+   signal coll_fg : std_logic_vector(C_NUM-1 downto 0) := (others => '0');
+
+begin
+
+   ---------------------------------------------
+   -- Decode configuration
+   ---------------------------------------------
+
+   gen_config : for i in 0 to C_NUM-1 generate
+      pos_x(i) <= config_i((C_XPOS+2*i)*8+9 downto (C_XPOS+2*i)*8);
+      pos_y(i) <= config_i((C_YPOS+2*i)*8+9 downto (C_YPOS+2*i)*8);
+      col(i)   <= config_i((C_COL+i)*8+7 downto (C_COL+i)*8);
+      ctrl(i)  <= config_i((C_CTRL+i)*8+7 downto (C_CTRL+i)*8);
+   end generate gen_config;
+
+
+   ---------------------------------------------
+   -- Write bitmaps
+   ---------------------------------------------
+
+   p_write : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if data_wr_i = '1' then
+            if ptr(0) = '0' then
+               mem(to_integer(ptr(6 downto 1)))(15 downto 8) <= data_i;
+            else
+               mem(to_integer(ptr(6 downto 1)))( 7 downto 0) <= data_i;
+            end if;
+            ptr <= ptr + 1;
+         end if;
+
+         if addr_wr_i = '1' then
+            ptr <= addr_i(6 downto 0);
+         end if;
+      end if;
+   end process p_write;
+
+
+   ---------------------------------------------
+   -- Stage 0
+   -- This stage copies the input signals.
+   ---------------------------------------------
+
+   stage0.pix_x <= pix_x_i;
+   stage0.pix_y <= pix_y_i;
+   stage0.hs    <= vga_hs_i;
+   stage0.vs    <= vga_vs_i;
+   stage0.col   <= vga_col_i;
+   stage0.fg    <= fg_i;
+
+
+   ---------------------------------------------
+   -- Stage 1
+   -- Calculate position inside each sprite.
+   ---------------------------------------------
+
+   p_stage1 : process (clk_i)
+      variable v_dx : std_logic_vector(9 downto 0);
+      variable v_dy : std_logic_vector(9 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage1 <= stage0;
+
+         for i in 0 to C_NUM-1 loop
+            v_dx := stage0.pix_x - pos_x(i);
+            v_dy := stage0.pix_y - pos_y(i);
+            if ctrl(i)(2) = '1' then
+               v_dx := "0" & v_dx(9 downto 1);
+               v_dy := "0" & v_dy(9 downto 1);
+            end if;
+
+            stage1.column(i) <= v_dx(3 downto 0);
+            stage1.row(i)    <= v_dy(3 downto 0);
+            stage1.valid(i)  <= '0';
+            if v_dx < 16 and v_dy < 16 and
+               stage0.pix_x < H_PIXELS and stage0.pix_y < V_PIXELS then
+               stage1.valid(i) <= ctrl(i)(0);
+            end if;
+         end loop;
+      end if;
+   end process p_stage1;
+
+
+   ---------------------------------------------
+   -- Stage 2
+   -- Read pixel of each sprite.
+   ---------------------------------------------
+
+   p_stage2 : process (clk_i)
+      variable v_row : std_logic_vector(15 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage2 <= stage1;
+
+         for i in 0 to C_NUM-1 loop
+            v_row := mem(i*16 + to_integer(stage1.row(i)));
+            stage2.pix(i) <= v_row(15 - to_integer(stage1.column(i))) and stage1.valid(i);
+         end loop;
+      end if;
+   end process p_stage2;
+
+
+   ---------------------------------------------
+   -- Stage 3
+   -- Select colour, and detect collisions.
+   ---------------------------------------------
+
+   p_stage3 : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         -- Copy signals from previous stage
+         stage3 <= stage2;
+
+         -- Loop backwards, so sprite 0 has the highest priority.
+         for i in C_NUM-1 downto 0 loop
+            if stage2.pix(i) = '1' and (stage2.fg = '0' or ctrl(i)(1) = '0') then
+               stage3.col <= col(i);
+            end if;
+         end loop;
+      end if;
+   end process p_stage3;
+
+   p_coll : process (clk_i)
+      variable v_coll    : std_logic_vector(C_NUM-1 downto 0);
+      variable v_coll_fg : std_logic_vector(C_NUM-1 downto 0);
+   begin
+      if rising_edge(clk_i) then
+         v_coll    := coll;
+         v_coll_fg := coll_fg;
+         if coll_clear_i = '1' then
+            v_coll := (others => '0');
+         end if;
+         if coll_fg_clear_i = '1' then
+            v_coll_fg := (others => '0');
+         end if;
+
+         -- More than one bit set means two or more sprites overlap.
+         if (stage2.pix and (stage2.pix - 1)) /= 0 then
+            v_coll := v_coll or stage2.pix;
+         end if;
+         if stage2.fg = '1' then
+            v_coll_fg := v_coll_fg or stage2.pix;
+         end if;
+
+         coll    <= v_coll;
+         coll_fg <= v_coll_fg;
+      end if;
+   end process p_coll;
+
+
+   --------------------------------------------------
+   -- Drive output signals
+   --------------------------------------------------
+
+   pix_x_o   <= stage3.pix_x;
+   pix_y_o   <= stage3.pix_y;
+   vga_hs_o  <= stage3.hs;
+   vga_vs_o  <= stage3.vs;
+   vga_col_o <= stage3.col;
+   coll_o    <= "0000" & coll;
+   coll_fg_o <= "0000" & coll_fg;
+
+end architecture structural;
+
@@ -7,6 +7,14 @@ use ieee.numeric_std_unsigned.all;
 -- with 256 colours.
 -- This module expects an input clock rate of approximately
 -- 25.175 MHz. It will work with a clock rate of 25.0 MHz.
+--
+-- The text screen can be overlaid with a 320x240 bitmap
+-- written by the blitter, see bitmap.vhd and blitter.vhd.
+-- On top of this are 4 hardware sprites, see sprites.vhd.
+--
+-- The character and colour memories contain two banks. The bank
+-- shown is selected by VGA_FRONT, and only changes at the start
+-- of the vertical blanking interval, to avoid tearing.
 
 entity vga is
    generic (
@@ -29,6 +37,32 @@ entity vga is
       memio_pix_y_o     : out std_logic_vector( 2*8-1 downto 0);
       irq_o             : out std_logic;
 
+      memio_front_i        : in  std_logic_vector( 1*8-1 downto 0);
+      memio_front_o        : out std_logic_vector( 1*8-1 downto 0);
+      bank_o               : out std_logic;
+
+      memio_bitmap_i       : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_x_i       : in  std_logic_vector( 2*8-1 downto 0);
+      memio_blit_y_i       : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_w_i       : in  std_logic_vector( 2*8-1 downto 0);
+      memio_blit_h_i       : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_col_i     : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_cmd_i     : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_clear_o   : out std_logic;
+      memio_blit_src_x_i   : in  std_logic_vector( 2*8-1 downto 0);
+      memio_blit_src_y_i   : in  std_logic_vector( 1*8-1 downto 0);
+      memio_blit_pattern_i : in  std_logic_vector( 8*8-1 downto 0);
+
+      memio_sprite_i          : in  std_logic_vector(24*8-1 downto 0);
+      memio_sprite_addr_i     : in  std_logic_vector( 1*8-1 downto 0);
+      memio_sprite_addr_wr_i  : in  std_logic;
+      memio_sprite_data_i     : in  std_logic_vector( 1*8-1 downto 0);
+      memio_sprite_data_wr_i  : in  std_logic;
+      memio_sprite_coll_o     : out std_logic_vector( 1*8-1 downto 0);
+      memio_sprite_coll_clr_i : in  std_logic;
+      memio_sprite_fg_o       : out std_logic_vector( 1*8-1 downto 0);
+      memio_sprite_fg_clr_i   : in  std_logic;
+
       vga_hs_o    : out std_logic;
       vga_vs_o    : out std_logic;
       vga_col_o   : out std_logic_vector(7 downto 0)
@@ -52,6 +86,9 @@ architecture structural of vga is
    signal pix_x : std_logic_vector(9 downto 0) := (others => '0');
    signal pix_y : std_logic_vector(9 downto 0) := (others => '0');
 
+   -- Bank currently shown
+   signal front : std_logic := '0';
+
    signal char_addr : std_logic_vector(12 downto 0);
    signal char_data : std_logic_vector( 7 downto 0);
    signal col_addr  : std_logic_vector(12 downto 0);
@@ -63,6 +100,28 @@ architecture structural of vga is
    signal char_hs    : std_logic;
    signal char_vs    : std_logic;
    signal char_col   : std_logic_vector(7 downto 0);
+   signal char_fg    : std_logic;
+
+   -- Output from Bitmap module.
+   signal bitmap_pix_x : std_logic_vector(9 downto 0);
+   signal bitmap_pix_y : std_logic_vector(9 downto 0);
+   signal bitmap_hs    : std_logic;
+   signal bitmap_vs    : std_logic;
+   signal bitmap_col   : std_logic_vector(7 downto 0);
+   signal bitmap_fg    : std_logic;
+
+   -- Output from Sprites module.
+   signal sprite_pix_x : std_logic_vector(9 downto 0);
+   signal sprite_pix_y : std_logic_vector(9 downto 0);
+   signal sprite_hs    : std_logic;
+   signal sprite_vs    : std_logic;
+   signal sprite_col   : std_logic_vector(7 downto 0);
+
+   -- Interface between Blitter and Bitmap.
+   signal blit_addr    : std_logic_vector(16 downto 0);
+   signal blit_wren    : std_logic;
+   signal blit_wr_data : std_logic_vector( 3 downto 0);
+   signal blit_rd_data : std_logic_vector( 3 downto 0);
 
    -- Output from Overlay module.
    signal overlay_hs  : std_logic;
@@ -101,6 +160,23 @@ begin
 
 
 
+   --------------------------------------------------
+   -- Change bank at the start of vertical blanking
+   --------------------------------------------------
+
+   p_front : process (clk_i)
+   begin
+      if rising_edge(clk_i) then
+         if pix_x = 0 and pix_y = V_PIXELS then
+            front <= memio_front_i(0);
+         end if;
+      end if;
+   end process p_front;
+
+   bank_o        <= front;
+   memio_front_o <= "0000000" & front;
+
+
    --------------------------------------------------
    -- Instantiate character display
    --------------------------------------------------
@@ -126,7 +202,90 @@ begin
       pix_y_o     => char_pix_y,
       vga_hs_o    => char_hs,
       vga_vs_o    => char_vs,
-      vga_col_o   => char_col
+      vga_col_o   => char_col,
+      fg_o        => char_fg
+   );
+
+
+   --------------------------------------------------
+   -- Instantiate bitmap display
+   --------------------------------------------------
+
+   i_bitmap : entity work.bitmap
+   port map (
+      clk_i     => clk_i,
+      enable_i  => memio_bitmap_i(0),
+      palette_i => memio_palette_i,
+      a_addr_i  => blit_addr,
+      a_wren_i  => blit_wren,
+      a_data_i  => blit_wr_data,
+      a_data_o  => blit_rd_data,
+      pix_x_i   => char_pix_x,
+      pix_y_i   => char_pix_y,
+      vga_hs_i  => char_hs,
+      vga_vs_i  => char_vs,
+      vga_col_i => char_col,
+      fg_i      => char_fg,
+      pix_x_o   => bitmap_pix_x,
+      pix_y_o   => bitmap_pix_y,
+      vga_hs_o  => bitmap_hs,
+      vga_vs_o  => bitmap_vs,
+      vga_col_o => bitmap_col,
+      fg_o      => bitmap_fg
+   );
+
+
+   --------------------------------------------------
+   -- Instantiate sprites
+   --------------------------------------------------
+
+   i_sprites : entity work.sprites
+   port map (
+      clk_i           => clk_i,
+      config_i        => memio_sprite_i,
+      addr_i          => memio_sprite_addr_i,
+      addr_wr_i       => memio_sprite_addr_wr_i,
+      data_i          => memio_sprite_data_i,
+      data_wr_i       => memio_sprite_data_wr_i,
+      coll_o          => memio_sprite_coll_o,
+      coll_clear_i    => memio_sprite_coll_clr_i,
+      coll_fg_o       => memio_sprite_fg_o,
+      coll_fg_clear_i => memio_sprite_fg_clr_i,
+      pix_x_i         => bitmap_pix_x,
+      pix_y_i         => bitmap_pix_y,
+      vga_hs_i        => bitmap_hs,
+      vga_vs_i        => bitmap_vs,
+      vga_col_i       => bitmap_col,
+      fg_i            => bitmap_fg,
+      pix_x_o         => sprite_pix_x,
+      pix_y_o         => sprite_pix_y,
+      vga_hs_o        => sprite_hs,
+      vga_vs_o        => sprite_vs,
+      vga_col_o       => sprite_col
+   );
+
+
+   --------------------------------------------------
+   -- Instantiate blitter
+   --------------------------------------------------
+
+   i_blitter : entity work.blitter
+   port map (
+      clk_i     => clk_i,
+      x_i       => memio_blit_x_i,
+      y_i       => memio_blit_y_i,
+      w_i       => memio_blit_w_i,
+      h_i       => memio_blit_h_i,
+      col_i     => memio_blit_col_i,
+      cmd_i     => memio_blit_cmd_i,
+      clear_o   => memio_blit_clear_o,
+      src_x_i   => memio_blit_src_x_i,
+      src_y_i   => memio_blit_src_y_i,
+      pattern_i => memio_blit_pattern_i,
+      addr_o    => blit_addr,
+      wren_o    => blit_wren,
+      data_o    => blit_wr_data,
+      data_i    => blit_rd_data
    );
 
 
@@ -141,20 +300,20 @@ begin
    port map (
       clk_i     => clk_i,
       digits_i  => digits_i,
-      pix_x_i   => char_pix_x,
-      pix_y_i   => char_pix_y,
-      vga_hs_i  => char_hs,
-      vga_vs_i  => char_vs,
-      vga_col_i => char_col,
+      pix_x_i   => sprite_pix_x,
+      pix_y_i   => sprite_pix_y,
+      vga_hs_i  => sprite_hs,
+      vga_vs_i  => sprite_vs,
+      vga_col_i => sprite_col,
       vga_hs_o  => overlay_hs,
       vga_vs_o  => overlay_vs,
       vga_col_o => overlay_col
    );
 
    -- Optionally enable CPU debug overlay
-   vga_hs_o  <= overlay_hs  when overlay_i = '1' else char_hs;
-   vga_vs_o  <= overlay_vs  when overlay_i = '1' else char_vs;
-   vga_col_o <= overlay_col when overlay_i = '1' else char_col;
+   vga_hs_o  <= overlay_hs  when overlay_i = '1' else sprite_hs;
+   vga_vs_o  <= overlay_vs  when overlay_i = '1' else sprite_vs;
+   vga_col_o <= overlay_col when overlay_i = '1' else sprite_col;
 
 
    --------------------
@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include <conio.h>
+
+#include "getcycles.h"
+#include "bench.h"      // bench_start()
+#include "heap.h"
+#include "pool.h"
+
+// Allocates and frees the same number of equally sized blocks from the heap
+// and from a pool, and shows the statistics and the time used by each.
+// Every other block is freed first, to fragment the heap.
+
+#define BLOCK_SIZE  16
+#define BLOCK_COUNT 32
+
+void* blocks[BLOCK_COUNT];
+
+t_pool pool;
+
+static uint32_t testHeap(void)
+{
+   uint32_t cycles = getcycles();
+   uint8_t i;
+
+   for (i=0; i<BLOCK_COUNT; i++)
+   {
+      blocks[i] = heap_alloc(BLOCK_SIZE);
+   }
+
+   for (i=0; i<BLOCK_COUNT; i+=2)
+   {
+      heap_free(blocks[i]);
+   }
+
+   gotoxy(0, 2);
+   heap_print_stats();
+
+   for (i=1; i<BLOCK_COUNT; i+=2)
+   {
+      heap_free(blocks[i]);
+   }
+
+   return getcycles() - cycles;
+} // end of testHeap
+
+static uint32_t testPool(void)
+{
+   uint32_t cycles = getcycles();
+   uint8_t i;
+
+   for (i=0; i<BLOCK_COUNT; i++)
+   {
+      blocks[i] = pool_alloc(&pool);
+   }
+
+   for (i=0; i<BLOCK_COUNT; i+=2)
+   {
+      pool_free(&pool, blocks[i]);
+   }
+
+   gotoxy(0, 8);
+   pool_print_stats(&pool, "Pool");
+
+   for (i=1; i<BLOCK_COUNT; i+=2)
+   {
+      pool_free(&pool, blocks[i]);
+   }
+
+   return getcycles() - cycles;
+} // end of testPool
+
+int main(void)
+{
+   uint32_t heapCycles;
+   uint32_t poolCycles;
+
+   // The pool memory is taken from the heap, before the heap test starts.
+   if (!pool_init(&pool, NULL, BLOCK_SIZE, BLOCK_COUNT))
+   {
+      cprintf("pool_init failed\r\n");
+      return 1;
+   }
+
+   bench_start();
+   heapCycles = testHeap();
+   poolCycles = testPool();
+
+   gotoxy(0, 11);
+   cprintf("Heap: %lu cycles\r\n", heapCycles);
+   cprintf("Pool: %lu cycles\r\n", poolCycles);
+
+   return 0;
+} // end of main
+
@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <conio.h>
+#include "bitmap.h"
+#include "getcycles.h"
+
+// This demonstrates the bitmap and the blitter.
+// A grid of tiles is drawn on top of the text screen. The first tile is drawn
+// with a few blitter commands, and the rest are copies of it.
+
+#define TILE_W  32
+#define TILE_H  24
+
+static const uint8_t checker[8] = {0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55};
+static const uint8_t stripes[8] = {0xF0, 0xE1, 0xC3, 0x87, 0x0F, 0x1E, 0x3C, 0x78};
+
+static void draw_tile(uint16_t x, uint8_t y)
+{
+   bitmap_pattern(x+2, y+2, TILE_W-4, TILE_H-4, stripes, 3, 0);
+   bitmap_rect(x+1, y+1, TILE_W-2, TILE_H-2, 15);
+   bitmap_hline(x+4, y+TILE_H/2, TILE_W-8, 9);
+   bitmap_vline(x+TILE_W/2, y+4, TILE_H-8, 9);
+} // end of draw_tile
+
+void main(void)
+{
+   uint16_t x;
+   uint8_t y;
+   uint32_t cycles;
+
+   // Fill the text screen, to show that it is visible through the bitmap.
+   for (y=0; y<59; ++y)
+   {
+      gotoxy(0, y);
+      for (x=0; x<80; x+=10)
+      {
+         cputs("Text below");
+      }
+   }
+
+   cycles = getcycles();
+
+   bitmap_clear();
+   bitmap_enable(1);
+
+   bitmap_pattern(0, 0, BITMAP_WIDTH, TILE_H, checker, 2, 0);
+   draw_tile(0, TILE_H);
+   for (y=TILE_H; y<BITMAP_HEIGHT-TILE_H; y+=TILE_H)
+   {
+      for (x=0; x<BITMAP_WIDTH; x+=TILE_W)
+      {
+         if (x || y != TILE_H)
+         {
+            bitmap_copy(0, TILE_H, x, y, TILE_W, TILE_H);
+         }
+      }
+   }
+   bitmap_wait();
+
+   cycles = getcycles() - cycles;
+
+   gotoxy(0, 59);
+   cprintf("Drawn in %lu cycles ", cycles);
+} // end of main
+
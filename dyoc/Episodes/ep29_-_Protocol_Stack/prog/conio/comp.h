@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "cputspan.h"
+
 // This declares some internal functions and variables used by the implementation of conio
 // for this platform.
 
@@ -19,6 +21,7 @@ extern uint8_t* curs_pos;
 
 void putchar(uint8_t);
 void newline(void);
+void cwrite(const uint8_t* s, unsigned count);
 
 #endif // _COMP_H_
 
@@ -1,12 +1,11 @@
 #include <stdint.h>     // uint8_t, etc.
+#include <string.h>     // strlen
 #include <conio.h>
 
+#include "comp.h"
+
 void cputs (const uint8_t* s)
 {
-   while (*s)
-   {
-      cputc(*s);
-      s++;
-   }
+   cwrite(s, strlen((const char*) s));
 }
 
@@ -0,0 +1,95 @@
+.setcpu		"6502"
+.importzp	ptr2, ptr3, ptr4, tmp1
+.importzp	_curs_pos
+.import		_pos_x
+.import		popax
+.export		_cputspan
+
+; Screen size in number of characters
+H_CHARS = 80
+
+; Offset from character memory to colour memory
+COL_OFFSET = $2000
+
+; This file must be written in assembler, for speed.
+; For the same reason as in putchar.s, ptr1 is not used.
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ cputspan(const uint8_t* s, const uint8_t* col, uint8_t len)
+; ---------------------------------------------------------------
+
+.segment	"CODE"
+
+.proc	_cputspan: near
+
+.segment	"CODE"
+
+	sta     tmp1            ; len
+	jsr     popax
+	sta     ptr4            ; col
+	stx     ptr4+1
+	jsr     popax
+	sta     ptr3            ; s
+	stx     ptr3+1
+
+	lda     #H_CHARS        ; Stop at end of line
+	sec
+	sbc     _pos_x
+	cmp     tmp1
+	bcs     :+
+	sta     tmp1
+:
+	ldy     #$00
+	lda     ptr4
+	ora     ptr4+1
+	bne     colour
+
+chars:
+	cpy     tmp1
+	beq     done
+	lda     (ptr3),y
+	cmp     #$20            ; Stop at control character
+	bcc     done
+	sta     (_curs_pos),y
+	iny
+	bne     chars           ; Always taken
+
+colour:
+	lda     _curs_pos
+	sta     ptr2
+	lda     _curs_pos+1
+	clc
+	adc     #>COL_OFFSET
+	sta     ptr2+1
+
+chars_and_colour:
+	cpy     tmp1
+	beq     done
+	lda     (ptr3),y
+	cmp     #$20            ; Stop at control character
+	bcc     done
+	sta     (_curs_pos),y
+	lda     (ptr4),y
+	sta     (ptr2),y
+	iny
+	bne     chars_and_colour ; Always taken
+
+done:
+	tya                     ; Advance cursor
+	clc
+	adc     _curs_pos
+	sta     _curs_pos
+	bcc     :+
+	inc     _curs_pos+1
+:
+	tya
+	clc
+	adc     _pos_x
+	sta     _pos_x
+
+	tya                     ; Return number of characters written
+	ldx     #$00
+	rts
+
+.endproc
+
@@ -0,0 +1,33 @@
+#include <stdint.h>     // uint8_t, etc.
+#include <conio.h>
+
+#include "comp.h"
+
+// Write count characters. Runs of regular characters are written using
+// cputspan(), and only control characters go through cputc().
+
+void cwrite(const uint8_t* s, unsigned count)
+{
+   uint8_t n;
+
+   while (count)
+   {
+      n = cputspan(s, 0, count > 0xFF ? 0xFF : count);
+
+      if (n == 0)
+      {
+         cputc(*s);        // Control character
+         n = 1;
+      }
+      else if (pos_x >= H_CHARS)
+      {
+         // End of line, just start at next line
+         pos_x = 0;
+         newline();
+      }
+
+      s += n;
+      count -= n;
+   }
+} // end of cwrite
+
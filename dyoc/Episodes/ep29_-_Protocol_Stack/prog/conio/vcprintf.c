@@ -0,0 +1,45 @@
+#include <stdint.h>     // uint8_t, etc.
+#include <stddef.h>     // size_t
+#include <stdarg.h>
+#include <conio.h>
+
+#include "comp.h"
+
+// This replaces vcprintf() from the cc65 library, which calls cputc() for
+// each character. Instead, the formatted output is passed to cwrite().
+// Since build/comp.lib is a copy of none.lib, this module replaces the one
+// in the library, and is used by cprintf() too.
+
+// The following is copied from libsrc/common/_printf.h in cc65.
+struct outdesc;
+
+typedef void __cdecl__ (* outfunc) (struct outdesc* desc, const char* buf, unsigned count);
+
+struct outdesc {
+   int      ccount;        // Character counter
+   outfunc  fout;          // Routine used to output data
+   void*    ptr;           // Data internal to print routine
+   size_t   uns;           // Data internal to print routine
+};
+
+int __fastcall__ _printf (struct outdesc* d, const char* format, va_list ap);
+
+
+static void __cdecl__ out (struct outdesc* d, const char* buf, unsigned count)
+{
+   cwrite((const uint8_t*) buf, count);
+   d->ccount += count;
+} // end of out
+
+int __fastcall__ vcprintf (const char* format, va_list ap)
+{
+   struct outdesc d;
+
+   d.ccount = 0;
+   d.fout   = out;
+
+   _printf(&d, format, ap);
+
+   return d.ccount;
+} // end of vcprintf
+
@@ -4,6 +4,9 @@
 #include <stdio.h>
 #include <assert.h>
 #include "memorymap.h"
+#include "bench.h"
+#include "eth_responder.h"
+#include "eth_filter.h"
 
 // Forward declarations.
 void eth_init(void);
@@ -57,6 +60,15 @@ void main(void)
 {
    eth_init();
 
+   // Ping is answered in hardware. ARP requests are still answered by
+   // processFrame() below.
+   eth_responder(myMacAddress, myIpAddress, ETH_RESPONDER_ICMP);
+
+   // Only IPv4 and ARP frames to us are relevant.
+   eth_filter_etype(0, 0x0800);
+   eth_filter_etype(1, 0x0806);
+   eth_filter(myMacAddress, ETH_FILTER_MAC | ETH_FILTER_ETYPE);
+
    // Wait for data to be received, and print to the screen
    while (1)
    {
@@ -66,6 +78,9 @@ void main(void)
       }
 
       processFrame();
+#ifdef BENCH
+      bench_stop();
+#endif
    }
 
 } // end of main
@@ -0,0 +1,65 @@
+// Simple web server.
+//
+// Static pages are placed in the www directory. They are converted at build
+// time by mkassets.py and served directly from ROM. Any other path returns a
+// small status page generated at run time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <conio.h>
+
+#include "ip65.h"
+#include "memorymap.h"
+
+static char status[200];
+
+void error_exit(void)
+{
+   printf("- Error $%X\n", ip65_error);
+   exit(EXIT_FAILURE);
+}
+
+void __fastcall__ callback(uint32_t client, const char* method, const char* path)
+{
+   const void* asset;
+   int len;
+
+   (void) client;
+   (void) method;
+
+   asset = httpd_find_static(path);
+   if (asset)
+   {
+      httpd_send_static(asset);
+      return;
+   }
+
+   len = sprintf(status, "Frames received : %u\r\n"
+                         "Receive errors  : %u\r\n"
+                         "Bad CRC         : %u\r\n"
+                         "Overflow        : %u\r\n",
+                         MEMIO_STATUS->ethRxCnt,
+                         MEMIO_STATUS->ethRxErr0,
+                         MEMIO_STATUS->ethRxErr1,
+                         MEMIO_STATUS->ethRxOverflow);
+   httpd_send_response(HTTPD_RESPONSE_200_TEXT, (const uint8_t*) status, len);
+}
+
+void main(void)
+{
+   printf("\nInitializing ");
+   if (ip65_init(DRV_INIT_DEFAULT))
+   {
+      error_exit();
+   }
+
+   printf("- Ok\n\nObtaining IP address ");
+   if (dhcp_init())
+   {
+      error_exit();
+   }
+
+   printf("- Ok\n\nListening on http://%s/\n", dotted_quad(cfg_ip));
+   httpd_start(80, callback);
+}
@@ -0,0 +1,16 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+// Support for the benchmark harness, see bench.py.
+//
+// The testbench waits for BENCH_DONE to be written, and then reports the
+// value in BENCH_CYCLES. On the real hardware these registers do nothing.
+//
+// If bench_start() is not called, the cycles are counted from reset.
+// bench_stop() is called automatically when main() returns.
+// The programs are built with -DBENCH when run by the harness.
+
+void bench_start(void);
+void bench_stop(void);
+
+#endif // _BENCH_H_
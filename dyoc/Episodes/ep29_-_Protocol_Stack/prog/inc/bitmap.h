@@ -0,0 +1,50 @@
+#ifndef _BITMAP_H_
+#define _BITMAP_H_
+
+#include <stdint.h>
+
+// The bitmap is 320x240 pixels with 16 colours, shown on top of the text
+// screen. Colour 0 is transparent, and the other colours are taken from
+// the text palette.
+//
+// The bitmap is only accessible through the blitter, which draws one
+// pixel per clock cycle. Each function below waits for the previous
+// command to finish, writes the registers, and starts the new command
+// without waiting for it to finish.
+// Pixels outside the bitmap are not drawn.
+
+#define BITMAP_WIDTH  320
+#define BITMAP_HEIGHT 240
+
+#define BLIT_CMD_FILL    1
+#define BLIT_CMD_PATTERN 2
+#define BLIT_CMD_COPY    3
+
+void bitmap_enable(uint8_t enable);
+
+// Fill a rectangle with a single colour.
+void bitmap_fill(uint16_t x, uint8_t y, uint16_t w, uint8_t h, uint8_t col);
+
+// Clear the entire bitmap, i.e. make it transparent.
+#define bitmap_clear() bitmap_fill(0, 0, BITMAP_WIDTH, BITMAP_HEIGHT, 0)
+
+#define bitmap_hline(x, y, w, col) bitmap_fill(x, y, w, 1, col)
+#define bitmap_vline(x, y, h, col) bitmap_fill(x, y, 1, h, col)
+
+// Draw the outline of a rectangle.
+void bitmap_rect(uint16_t x, uint8_t y, uint16_t w, uint8_t h, uint8_t col);
+
+// Fill a rectangle with an 8x8 pattern. Byte 0 is the top row, and bit 7 is
+// the leftmost pixel. Set bits get colour fg, and cleared bits get colour bg.
+// The pattern is aligned to the screen, so adjacent rectangles match up.
+void bitmap_pattern(uint16_t x, uint8_t y, uint16_t w, uint8_t h,
+                    const uint8_t* pattern, uint8_t fg, uint8_t bg);
+
+// Copy a rectangle. Overlapping areas are only copied correctly when the
+// destination is above or to the left of the source.
+void bitmap_copy(uint16_t src_x, uint8_t src_y, uint16_t x, uint8_t y, uint16_t w, uint8_t h);
+
+// Wait for the blitter to finish the current command.
+void bitmap_wait(void);
+
+#endif // _BITMAP_H_
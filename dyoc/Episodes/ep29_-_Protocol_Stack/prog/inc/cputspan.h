@@ -0,0 +1,20 @@
+#ifndef _CPUTSPAN_H_
+#define _CPUTSPAN_H_
+
+#include <stdint.h>
+
+// Write a run of characters at the current cursor position in one go.
+//
+// At most len characters are written. The run stops at the first control
+// character (below 0x20) and at the end of the current line. If col is not
+// NULL, the colour memory is written from col in the same pass.
+//
+// The cursor is advanced, but not wrapped: if the end of the line was reached
+// the cursor is left just after the last column, and the caller must move it
+// to the next line.
+//
+// Returns the number of characters written.
+uint8_t __fastcall__ cputspan(const uint8_t* s, const uint8_t* col, uint8_t len);
+
+#endif // _CPUTSPAN_H_
+
@@ -0,0 +1,36 @@
+#ifndef _ETH_FILTER_H_
+#define _ETH_FILTER_H_
+
+#include <stdint.h>
+
+// The Ethernet module can discard irrelevant frames in hardware, before
+// they are buffered and transferred by the Rx DMA. Discarded frames are
+// counted by reason, see MEMIO_STATUS4.
+//
+// The filter is disabled after reset. Table entries containing zero are
+// not used.
+
+#define ETH_FILTER_MAC   0x01   // Our MAC, broadcast, and the multicast table
+#define ETH_FILTER_ETYPE 0x02   // EtherType table
+#define ETH_FILTER_UDP   0x04   // UDP destination port table
+
+#define ETH_FILTER_NUM_MCAST 2
+#define ETH_FILTER_NUM_ETYPE 3
+#define ETH_FILTER_NUM_UDP   4
+
+// Set our MAC address, and enable the filters. The flags are a combination
+// of ETH_FILTER_MAC, ETH_FILTER_ETYPE, and ETH_FILTER_UDP. Calling with
+// flags = 0 disables the filter.
+void eth_filter(const uint8_t* mac, uint8_t flags);
+
+// Accept the IPv4 multicast group with the MAC address 01:00:5E:xx:xx:xx.
+// Only the last three bytes are given.
+void eth_filter_mcast(uint8_t num, const uint8_t* mac_low);
+
+// Accept an EtherType, e.g. 0x0800 (IPv4) or 0x0806 (ARP).
+void eth_filter_etype(uint8_t num, uint16_t etype);
+
+// Accept a UDP destination port.
+void eth_filter_udp(uint8_t num, uint16_t port);
+
+#endif // _ETH_FILTER_H_
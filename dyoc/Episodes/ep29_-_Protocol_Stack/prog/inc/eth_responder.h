@@ -0,0 +1,26 @@
+#ifndef _ETH_RESPONDER_H_
+#define _ETH_RESPONDER_H_
+
+#include <stdint.h>
+
+// The Ethernet module can answer ARP requests and ICMP echo requests (ping)
+// in hardware. Answered frames never reach the CPU, so they are not seen by
+// eth_rx(). All other frames are received as usual.
+//
+// The responder is disabled after reset.
+
+#define ETH_RESPONDER_ARP  0x01
+#define ETH_RESPONDER_ICMP 0x02
+
+// Set our MAC and IP address, and enable the responder. The flags are a
+// combination of ETH_RESPONDER_ARP and ETH_RESPONDER_ICMP. Calling with
+// flags = 0 disables the responder.
+void eth_responder(const uint8_t* mac, const uint8_t* ip, uint8_t flags);
+
+// Number of ARP replies sent by the hardware (wraps around at 256).
+uint8_t eth_responder_arp_count(void);
+
+// Number of ICMP echo replies sent by the hardware (wraps around at 256).
+uint8_t eth_responder_icmp_count(void);
+
+#endif // _ETH_RESPONDER_H_
@@ -0,0 +1,14 @@
+#ifndef _GETCYCLES_H_
+#define _GETCYCLES_H_
+
+#include <stdint.h>
+
+// Returns the number of CPU clock cycles since reset.
+// The counter runs at 25 MHz, and wraps around after approx 171 seconds.
+uint32_t getcycles(void);
+
+// The number of CPU clock cycles from reset until main() was called.
+extern uint32_t boot_cycles;
+
+#endif // _GETCYCLES_H_
+
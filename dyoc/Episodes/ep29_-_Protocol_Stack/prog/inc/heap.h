@@ -0,0 +1,36 @@
+#ifndef _HEAP_H_
+#define _HEAP_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// The heap used by malloc() and free() occupies the RAM between the end of
+// the BSS segment and the bottom of the C stack.
+//
+// heap_alloc() and heap_free() are drop-in replacements for malloc() and free()
+// that additionally record the statistics below.
+
+typedef struct
+{
+   uint16_t allocs;        // Number of successful allocations
+   uint16_t frees;         // Number of blocks freed
+   uint16_t failures;      // Number of failed allocations
+   uint16_t in_use;        // Number of bytes currently allocated
+   uint16_t peak;          // Largest value of in_use
+   uint32_t cycles_total;  // Clock cycles spent in all allocations
+   uint32_t cycles_max;    // Clock cycles spent in the slowest allocation
+} t_heap_stats;
+
+extern t_heap_stats heap_stats;
+
+void* heap_alloc(size_t size);
+void heap_free(void* block);
+
+// Returns the fragmentation of the free heap memory in percent, i.e. how
+// much of the free memory is not part of the largest free block.
+uint8_t heap_fragmentation(void);
+
+// Print the statistics on the screen.
+void heap_print_stats(void);
+
+#endif // _HEAP_H_
@@ -232,14 +232,23 @@ bool tcp_send_keep_alive(void);
 //
 uint32_t __fastcall__ sntp_get_time(uint32_t server);
 
+// Options requested for TFTP downloads
+//
+// The server may accept a larger block size (RFC 2348) and send several
+// blocks per ACK (RFC 7440). Set to 0 before a download to use classic
+// lock-step transfer with 512 byte blocks.
+//
+extern uint16_t tftp_blksize;    // Requested block size, default 1468
+extern uint8_t  tftp_windowsize; // Requested window size, default 8
+
 // Download a file from a TFTP server and provide data to user supplied vector
 //
 // Inputs: server:   IP address of server to receive file from
 //         name:     Zero terminated string containing the name of file to download
-//         callback: Vector to call once for each 512 byte packet received
+//         callback: Vector to call once for each packet received
 //                   buf: Pointer to buffer containing data received
-//                   len: 512 if buffer is full, otherwise number of bytes
-//                        in the buffer
+//                   len: The block size if buffer is full, otherwise number of
+//                        bytes in the buffer
 // Output: true if an error occured, false otherwise
 //
 bool __fastcall__ tftp_download(uint32_t server, const char* name,
@@ -348,6 +357,27 @@ void __fastcall__ httpd_start(uint16_t port,
 void __fastcall__ httpd_send_response(uint8_t response_type,
                                       const uint8_t* buf, uint16_t len);
 
+// Find static content for an HTTP path
+//
+// The static content is generated at build time by mkassets.py from the files in
+// <program>/www. Each asset holds a complete HTTP response, split into TCP segments
+// with precomputed checksums, and is sent directly from ROM without being copied.
+//
+// Inputs: path: Zero terminated string containing the HTTP path
+// Output: Pointer to asset if found, null otherwise
+//
+const void* __fastcall__ httpd_find_static(const char* path);
+
+// Send static content as HTTP response
+//
+// Calling httpd_send_static is only valid in the context of a httpd_start callback.
+// The response header is part of the asset, so no further response must be sent.
+//
+// Inputs: asset: Pointer to asset returned by httpd_find_static
+// Output: None
+//
+void __fastcall__ httpd_send_static(const void* asset);
+
 // Retrieve the value of a variable defined in the previously received HTTP request
 //
 // Calling http_get_value is only valid in the context of a httpd_start callback.
@@ -18,12 +18,15 @@ typedef struct
 {
    uint8_t  vgaPalette[16];   // 7FC0 - 7FCF
    uint16_t vgaPixYInt;       // 7FD0 - 7FD1
-   uint8_t  cpuCycLatch;      // 7FD2
+   uint8_t  cpuCycLatch;      // 7FD2 (also latches timerUsec)
    uint8_t  ethRxdmaEnable;   // 7FD3
    uint16_t ethRxdmaPtr;      // 7FD4 - 7FD5
    uint16_t ethTxdmaPtr;      // 7FD6 - 7FD7
    uint8_t  ethTxdmaEnable;   // 7FD8
-   uint8_t  _reserved[6];
+   uint16_t ethTxdmaPayloadPtr; // 7FD9 - 7FDA
+   uint16_t ethTxdmaPayloadLen; // 7FDB - 7FDC
+   uint8_t  vgaFront;         // 7FDD (bank shown from next vertical blank)
+   uint8_t  charBank;         // 7FDE (bank accessed at MEM_CHAR and MEM_COL)
    uint8_t  irqMask;          // 7FDF
 } t_memio_config;
 
@@ -38,16 +41,90 @@ typedef struct
    uint8_t  ethRxOverflow;    // 7FEB
    uint16_t ethRxCnt;         // 7FEC - 7FED
    uint8_t  ethRxPending;     // 7FEE
-   uint8_t  _reserved2[16];
+   uint8_t  timerUsec[6];     // 7FEF - 7FF4
+   uint8_t  vgaFrontActive;   // 7FF5 (bank currently shown)
+   uint8_t  _reserved2[9];
    uint8_t  irqStatus;        // 7FFF
 } t_memio_status;
 
-#define MEMIO_CONFIG ((t_memio_config *) 0x7FC0)
-#define MEMIO_STATUS ((t_memio_status *) 0x7FE0)
+// Second block of memory mapped IO, placed just below the first block.
+typedef struct
+{
+   uint8_t  timerCmp[6];      // 7F80 - 7F85
+   uint8_t  timerCmpEnable;   // 7F86
+   uint32_t benchCycles;      // 7F87 - 7F8A
+   uint8_t  benchDone;        // 7F8B
+   uint16_t blitX;            // 7F8C - 7F8D
+   uint8_t  blitY;            // 7F8E
+   uint16_t blitW;            // 7F8F - 7F90
+   uint8_t  blitH;            // 7F91
+   uint8_t  blitCol;          // 7F92
+   uint8_t  blitCmd;          // 7F93
+   uint16_t blitSrcX;         // 7F94 - 7F95
+   uint8_t  blitSrcY;         // 7F96
+   uint8_t  blitPattern[8];   // 7F97 - 7F9E
+   uint8_t  bitmapEnable;     // 7F9F
+} t_memio_config2;
+
+typedef struct
+{
+   uint8_t  _reserved[32];    // 7FA0 - 7FBF
+} t_memio_status2;
+
+// Third block of memory mapped IO, placed just below the second block.
+typedef struct
+{
+   uint16_t spriteX[4];       // 7F40 - 7F47
+   uint16_t spriteY[4];       // 7F48 - 7F4F
+   uint8_t  spriteCol[4];     // 7F50 - 7F53
+   uint8_t  spriteCtrl[4];    // 7F54 - 7F57
+   uint8_t  spriteAddr;       // 7F58
+   uint8_t  spriteData;       // 7F59
+   uint8_t  _reserved[6];     // 7F5A - 7F5F
+} t_memio_config3;
+
+typedef struct
+{
+   uint8_t  spriteColl;       // 7F60 (cleared when read)
+   uint8_t  spriteCollFg;     // 7F61 (cleared when read)
+   uint8_t  _reserved[30];    // 7F62 - 7F7F
+} t_memio_status3;
+
+// Fourth block of memory mapped IO, placed just below the third block.
+typedef struct
+{
+   uint8_t  ethRespMac[6];    // 7F00 - 7F05 (also used by the Rx filter)
+   uint8_t  ethRespIp[4];     // 7F06 - 7F09
+   uint8_t  ethRespEnable;    // 7F0A
+   uint8_t  ethFiltEnable;    // 7F0B
+   uint8_t  ethFiltMcast[2][3]; // 7F0C - 7F11
+   uint16_t ethFiltEtype[3];  // 7F12 - 7F17
+   uint16_t ethFiltUdp[4];    // 7F18 - 7F1F
+} t_memio_config4;
+
+typedef struct
+{
+   uint8_t  ethRespCntArp;    // 7F20
+   uint8_t  ethRespCntIcmp;   // 7F21
+   uint8_t  ethFiltCntMac;    // 7F22
+   uint8_t  ethFiltCntEtype;  // 7F23
+   uint8_t  ethFiltCntUdp;    // 7F24
+   uint8_t  _reserved[27];    // 7F25 - 7F3F
+} t_memio_status4;
+
+#define MEMIO_CONFIG  ((t_memio_config *)  0x7FC0)
+#define MEMIO_STATUS  ((t_memio_status *)  0x7FE0)
+#define MEMIO_CONFIG2 ((t_memio_config2 *) 0x7F80)
+#define MEMIO_STATUS2 ((t_memio_status2 *) 0x7FA0)
+#define MEMIO_CONFIG3 ((t_memio_config3 *) 0x7F40)
+#define MEMIO_STATUS3 ((t_memio_status3 *) 0x7F60)
+#define MEMIO_CONFIG4 ((t_memio_config4 *) 0x7F00)
+#define MEMIO_STATUS4 ((t_memio_status4 *) 0x7F20)
 
-#define IRQ_TIMER_NUM    0
-#define IRQ_VGA_NUM      1
-#define IRQ_KBD_NUM      2
+#define IRQ_TIMER_NUM     0
+#define IRQ_VGA_NUM       1
+#define IRQ_KBD_NUM       2
+#define IRQ_TIMER_CMP_NUM 3
 
 #endif // _MEMORY_MAP_H_
 
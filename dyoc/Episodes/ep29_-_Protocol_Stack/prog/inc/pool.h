@@ -0,0 +1,40 @@
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <stdint.h>
+
+// A pool contains a fixed number of equally sized blocks.
+// Allocating and freeing a block takes constant time, and there is no
+// fragmentation. This is useful for objects that are allocated and freed
+// often, e.g. search nodes or packet buffers.
+//
+// The free blocks are kept in a linked list, where the first two bytes of
+// each free block point to the next free block.
+
+typedef struct
+{
+   void*    free;          // First free block, or NULL
+   uint16_t size;          // Size of each block
+   uint16_t count;         // Total number of blocks
+   uint16_t used;          // Number of blocks currently allocated
+   uint16_t peak;          // Largest value of used
+   uint16_t failures;      // Number of failed allocations
+} t_pool;
+
+// Number of bytes needed for a pool of count blocks of the given size.
+#define POOL_MEM_SIZE(size, count) ((size) < 2 ? 2*(count) : (size)*(count))
+
+// Prepare a pool of count blocks of the given size.
+// If mem is NULL, the memory is allocated from the heap.
+// Returns 0 if the memory could not be allocated, or if size*count does not
+// fit in 16 bits.
+uint8_t pool_init(t_pool* pool, void* mem, uint16_t size, uint16_t count);
+
+// Returns NULL if all blocks are in use.
+void* pool_alloc(t_pool* pool);
+void pool_free(t_pool* pool, void* block);
+
+// Print the statistics on the screen.
+void pool_print_stats(const t_pool* pool, const char* name);
+
+#endif // _POOL_H_
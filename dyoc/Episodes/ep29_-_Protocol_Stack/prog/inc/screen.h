@@ -0,0 +1,41 @@
+#ifndef _SCREEN_H_
+#define _SCREEN_H_
+
+#include <stdint.h>
+
+// The character and colour memories contain two banks each. The CPU
+// accesses one bank (at MEM_CHAR and MEM_COL), while the VGA shows
+// another. The VGA only changes bank at the start of the vertical
+// blanking interval, so a frame is never shown half drawn.
+//
+// The typical use is:
+//    screen_draw_bank(1);          // Draw the first frame in bank 1.
+//    while (1)
+//    {
+//       ... draw the frame ...
+//       screen_flip();
+//    }
+//
+// Note that after screen_flip() the bank being drawn contains the frame
+// before last, not the frame just shown. Programs that only redraw the
+// changes must therefore redraw the changes of the last two frames.
+//
+// Both banks are 0 after reset, so programs that do not use this are
+// unaffected.
+
+extern volatile uint8_t vga_front;     // Bank shown, updated by the VGA interrupt.
+
+// Select the bank accessed by the CPU.
+void screen_draw_bank(uint8_t bank);
+
+// Request the bank to be shown from the next vertical blanking interval.
+void screen_show_bank(uint8_t bank);
+
+// Wait until the requested bank is shown.
+void screen_wait_flip(void);
+
+// Show the bank just drawn, wait for it to be shown, and continue drawing
+// in the other bank.
+void screen_flip(void);
+
+#endif // _SCREEN_H_
@@ -0,0 +1,39 @@
+#ifndef _SPRITE_H_
+#define _SPRITE_H_
+
+#include <stdint.h>
+
+// There are 4 hardware sprites shown on top of the text screen and the
+// bitmap. Each sprite is a 16x16 bitmap with a single colour, where
+// cleared bits are transparent. When sprites overlap, sprite 0 is shown.
+//
+// The position is the top left corner of the sprite in screen pixels,
+// i.e. 0-639 and 0-479. Moving a sprite costs only a couple of register
+// writes, and the screen below is left untouched.
+//
+// Collisions are detected by the hardware while the sprites are shown,
+// and are accumulated until read with sprite_collisions() or
+// sprite_fg_collisions().
+
+#define SPRITE_NUM 4
+
+#define SPRITE_ENABLE  0x01
+#define SPRITE_BEHIND  0x02   // Hidden by text and bitmap pixels
+#define SPRITE_MAGNIFY 0x04   // Each bit covers 2x2 pixels
+
+// Copy a bitmap of 32 bytes to a sprite. Each row is two bytes, starting
+// with the top row. Bit 7 of the first byte is the leftmost pixel.
+void sprite_bitmap(uint8_t num, const uint8_t* bitmap);
+
+// Set the colour and the control bits (SPRITE_ENABLE, etc).
+void sprite_config(uint8_t num, uint8_t col, uint8_t ctrl);
+
+void sprite_move(uint8_t num, uint16_t x, uint16_t y);
+
+// Bit i is set if sprite i has overlapped another sprite since last call.
+uint8_t sprite_collisions(void);
+
+// Bit i is set if sprite i has overlapped text or bitmap pixels since last call.
+uint8_t sprite_fg_collisions(void);
+
+#endif // _SPRITE_H_
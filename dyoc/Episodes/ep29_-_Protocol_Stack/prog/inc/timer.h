@@ -0,0 +1,30 @@
+#ifndef _TIMER_H_
+#define _TIMER_H_
+
+#include <stdint.h>
+
+// The hardware contains a free-running 48-bit microsecond counter,
+// and a one-shot compare interrupt.
+// The counter must not be read from interrupt routines.
+
+typedef struct
+{
+   uint32_t lo;
+   uint16_t hi;
+} t_usec;
+
+// Read the 48-bit microsecond counter.
+void timer_usec(t_usec* usec);
+
+// Request an interrupt when the counter reaches the given value.
+// This replaces any alarm already pending.
+void timer_set_alarm(const t_usec* usec);
+
+// Request an interrupt after the given number of microseconds.
+void timer_alarm_in(uint32_t delay);
+
+// Set to 1 by the interrupt routine when the alarm has fired.
+extern volatile uint8_t timer_alarm;
+
+#endif // _TIMER_H_
+
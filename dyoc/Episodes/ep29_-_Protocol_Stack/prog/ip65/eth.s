@@ -17,18 +17,29 @@
 .export eth_outp_len
 .export eth_inp
 .export eth_inp_len
+.export eth_outp_payload_ptr
+.export eth_outp_payload_len
 
 .import cfg_mac
 
 
-.bss
+; input and output buffers. these are always written before being read, so
+; they are not cleared at startup.
+.segment "NOINIT"
 
-; input and output buffers
 eth_inp_len:    .res    2       ; input packet length
 eth_inp:        .res 1518       ; space for input packet
 eth_outp_len:   .res    2       ; output packet length
 eth_outp:       .res 1518       ; space for output packet
 
+.bss
+
+; optional payload appended to the output packet by the driver without copying
+; it into eth_outp (e.g. static content in ROM). eth_outp_len then only covers
+; the headers. the driver clears eth_outp_payload_len after each transmission.
+eth_outp_payload_ptr: .res 2
+eth_outp_payload_len: .res 2
+
 ; ethernet packet offsets
 eth_dest =  0                   ; offset of destination address in ethernet packet
 eth_src  =  6                   ; offset of source address in ethernet packet
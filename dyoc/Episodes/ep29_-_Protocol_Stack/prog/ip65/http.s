@@ -16,9 +16,12 @@ string_ptr = ptr1
 table_ptr  = ptr2
 
 
-.bss
+.segment "NOINIT"               ; not cleared at startup
 
 var_buf:   .res $300            ; work area for storing variables extracted from query string
+
+.bss
+
 var_name:  .res 1
 hex_digit: .res 1
 
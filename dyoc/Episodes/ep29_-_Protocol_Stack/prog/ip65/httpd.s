@@ -27,20 +27,24 @@ HTTPD_TIMEOUT_SECONDS = 5       ; what's the maximum time we let 1 connection be
 .import tcp_send_data_len
 .import tcp_send
 .import tcp_close
-.import timer_seconds
+.import timer_read
+.import timer_timeout
 
 temp_ptr = ptr1
 
 
-.bss
+.segment "NOINIT"               ; not cleared at startup
 
 io_buf:                         .res $800
+
+.bss
+
 found_eol:                      .res 1
 connection_closed:              .res 1
 httpd_response_buffer_length:   .res 2
 output_buffer_length:           .res 2
 sent_header:                    .res 1
-connection_timeout_seconds:     .res 1
+connection_timeout:             .res 2
 tcp_buffer_ptr:                 .res 2
 buffer_size:                    .res 1
 
@@ -103,17 +107,13 @@ httpd_start:
   lda #0
   sta connection_closed
   sta found_eol
+  jsr timer_read                ; read current timer value
   clc
-  jsr timer_seconds             ; time of day clock: seconds (in BCD)
-  sed
-  adc #HTTPD_TIMEOUT_SECONDS
-  cmp #$60
-  bcc @timeout_set
-  sec
-  sbc #$60
-@timeout_set:
-  cld
-  sta connection_timeout_seconds
+  adc #<(HTTPD_TIMEOUT_SECONDS*1000)
+  sta connection_timeout
+  txa
+  adc #>(HTTPD_TIMEOUT_SECONDS*1000)
+  sta connection_timeout+1
 
 @main_polling_loop:
   jsr ip65_process
@@ -126,10 +126,9 @@ httpd_start:
   lda found_eol
   bne @got_eol
 
-  jsr timer_seconds             ; time of day clock: seconds
-
-  cmp connection_timeout_seconds
-  beq @connection_timed_out
+  ldax connection_timeout
+  jsr timer_timeout
+  bcc @connection_timed_out
   lda connection_closed
   beq  @main_polling_loop
 @connection_timed_out:
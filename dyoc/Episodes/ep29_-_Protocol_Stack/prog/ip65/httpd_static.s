@@ -0,0 +1,163 @@
+; serve static content for the HTTP server directly from ROM
+;
+; the content is converted at build time by mkassets.py into a table of assets.
+; each asset holds the complete HTTP response (header and body), split into
+; segments of at most one TCP MSS, together with the precomputed checksum of
+; each segment. the segments are therefore neither copied nor checksummed when
+; sent, the ethernet Tx DMA reads them directly from ROM.
+;
+; layout of the table generated by mkassets.py:
+; httpd_static_assets: .addr path, asset       ; path is zero terminated, e.g. "/index.html"
+;                      ...                      ; several paths may share an asset
+;                      .addr 0
+; asset:               .byte segments           ; number of segments
+;                      .addr data               ; first segment
+;                      .word length
+;                      .word checksum           ; non-inverted, as summed by ip_calc_cksum
+;                      ...                      ; remaining segments
+
+.include "zeropage.inc"
+.include "../inc/common.inc"
+
+.export httpd_find_static
+.export httpd_send_static
+
+.import httpd_static_assets
+.import tcp_send
+.import tcp_send_data_len
+.import tcp_send_static
+.import tcp_send_cksum
+
+
+.bss
+
+path:           .res 2
+asset:          .res 2
+table_ptr:      .res 2
+segment_ptr:    .res 2
+segment_data:   .res 2
+segment_count:  .res 1
+
+
+.code
+
+; look up static content
+; inputs:
+; AX = pointer to zero terminated path of the request
+; outputs:
+; carry flag clear if found, set otherwise
+; AX = pointer to asset (if found)
+httpd_find_static:
+  stax path
+  ldax #httpd_static_assets
+  stax table_ptr
+
+@next_asset:
+  ldax table_ptr
+  stax ptr1
+  ldy #0
+  lda (ptr1),y                  ; ptr2 = path of asset
+  sta ptr2
+  iny
+  lda (ptr1),y
+  sta ptr2+1
+  ora ptr2
+  bne :+
+  sec                           ; end of table
+  rts
+
+: iny
+  lda (ptr1),y                  ; asset
+  sta asset
+  iny
+  lda (ptr1),y
+  sta asset+1
+
+  lda table_ptr
+  clc
+  adc #4
+  sta table_ptr
+  bcc :+
+  inc table_ptr+1
+
+: ldax path                     ; ptr3 = requested path
+  stax ptr3
+
+  ldy #0
+@compare:
+  lda (ptr2),y
+  cmp (ptr3),y
+  bne @next_asset
+  tax                           ; end of both strings?
+  beq @found
+  iny
+  bne @compare
+  beq @next_asset
+
+@found:
+  ldax asset
+  clc
+  rts
+
+; send static content as response to the current HTTP request
+; inputs:
+; AX = pointer to asset (as returned by httpd_find_static)
+; outputs:
+; carry flag is set if an error occured, clear otherwise
+httpd_send_static:
+  stax ptr1
+  ldy #0
+  lda (ptr1),y                  ; number of segments
+  sta segment_count
+  lda ptr1
+  clc
+  adc #1
+  sta segment_ptr
+  lda ptr1+1
+  adc #0
+  sta segment_ptr+1
+
+@next_segment:
+  lda segment_count
+  bne :+
+  clc                           ; all segments sent
+  rts
+
+: ldax segment_ptr              ; the stack uses ptr1 while sending,
+  stax ptr1                     ; so reload it for each segment
+  ldy #0
+  lda (ptr1),y
+  sta segment_data
+  iny
+  lda (ptr1),y
+  sta segment_data+1
+  iny
+  lda (ptr1),y
+  sta tcp_send_data_len
+  iny
+  lda (ptr1),y
+  sta tcp_send_data_len+1
+  iny
+  lda (ptr1),y
+  sta tcp_send_cksum
+  iny
+  lda (ptr1),y
+  sta tcp_send_cksum+1
+
+  lda segment_ptr
+  clc
+  adc #6
+  sta segment_ptr
+  bcc :+
+  inc segment_ptr+1
+
+: lda #1
+  sta tcp_send_static
+  ldax segment_data
+  jsr tcp_send
+  bcs @done                     ; connection lost
+  dec segment_count
+  jmp @next_segment
+
+@done:
+  rts
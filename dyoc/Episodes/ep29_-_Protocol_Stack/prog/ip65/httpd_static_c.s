@@ -0,0 +1,19 @@
+.include "../inc/common.inc"
+
+.export _httpd_find_static
+.export _httpd_send_static
+
+.import httpd_find_static
+.import httpd_send_static
+
+
+.code
+
+_httpd_find_static:
+  jsr httpd_find_static
+  bcc :+
+  lda #$00
+  tax
+: rts
+
+_httpd_send_static := httpd_send_static
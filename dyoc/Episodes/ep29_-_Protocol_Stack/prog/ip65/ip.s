@@ -9,6 +9,8 @@
 .export ip_inp
 .export ip_outp
 .export ip_broadcast
+.export ip_payload_ptr
+.export ip_payload_len
 .exportzp ip_ver_ihl
 .exportzp ip_tos
 .exportzp ip_len
@@ -34,6 +36,8 @@
 .import eth_inp_len
 .import eth_outp
 .import eth_outp_len
+.import eth_outp_payload_ptr
+.import eth_outp_payload_len
 
 .importzp eth_dest
 .importzp eth_src
@@ -71,6 +75,12 @@ ip_outp = eth_outp + eth_data   ; pointer to start of IP packet in output ethern
 ; temp storage for size calculation
 len: .res 2
 
+; optional payload of the outgoing packet that is not stored in ip_outp,
+; but is sent directly from memory by the ethernet driver.
+; ip_payload_len is cleared by ip_send.
+ip_payload_ptr: .res 2
+ip_payload_len: .res 2
+
 ; flag for incoming broadcast packets
 ip_broadcast: .res 1            ; flag set when an incoming IP packet was sent to a broadcast address
 
@@ -319,6 +329,9 @@ ip_send:
 
   jsr arp_lookup
   bcc :+
+  lda #0                        ; payload is not sent
+  sta ip_payload_len
+  sta ip_payload_len + 1
   rts                           ; packet buffer nuked, fail
 : ldax #ip_outp                 ; calculate ip header checksum
   stax ip_cksum_ptr
@@ -337,6 +350,36 @@ ip_send:
   lda #eth_proto_ip             ; set type to IP
   jsr eth_set_proto
 
+  lda ip_payload_len            ; is the payload sent separately?
+  ora ip_payload_len + 1
+  beq @nopayload
+
+  ldax ip_payload_ptr           ; hand the payload over to the driver
+  stax eth_outp_payload_ptr
+  ldax ip_payload_len
+  stax eth_outp_payload_len
+
+  lda ip_outp + ip_len + 1      ; headers only: ip_len + 14 - payload length
+  sec
+  sbc ip_payload_len
+  tay
+  lda ip_outp + ip_len
+  sbc ip_payload_len + 1
+  tax
+  tya
+  clc
+  adc #eth_data
+  sta eth_outp_len
+  txa
+  adc #0
+  sta eth_outp_len + 1
+
+  lda #0
+  sta ip_payload_len
+  sta ip_payload_len + 1
+  jmp eth_tx                    ; send packet and return status
+
+@nopayload:
   lda ip_outp + ip_len + 1      ; set packet length
   lsr
   bcc @dontpad
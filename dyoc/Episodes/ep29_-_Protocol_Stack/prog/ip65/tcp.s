@@ -19,6 +19,8 @@ MAX_TCP_PACKETS_SENT = 8        ; timeout after sending 8 messages will be about
 .export tcp_callback
 .export tcp_connect_ip
 .export tcp_send_data_len
+.export tcp_send_static
+.export tcp_send_cksum
 .export tcp_send
 .export tcp_send_string
 .export tcp_close
@@ -32,6 +34,8 @@ MAX_TCP_PACKETS_SENT = 8        ; timeout after sending 8 messages will be about
 
 .import ip_calc_cksum
 .import ip_send
+.import ip_payload_ptr
+.import ip_payload_len
 .import ip_create_packet
 .import ip_inp
 .import ip_outp
@@ -114,6 +118,11 @@ tcp_data_ptr:           .res 2
 tcp_data_len:           .res 2
 tcp_send_data_ptr:      .res 2
 tcp_send_data_len:      .res 2  ; length (in bytes) of data to be sent over tcp connection
+tcp_send_static:        .res 1  ; if set, the next tcp_send sends the data without copying it
+tcp_send_cksum:         .res 2  ; precomputed (non-inverted) checksum of the static data
+tcp_data_static:        .res 1
+static_send:            .res 1
+static_cksum:           .res 2
 tcp_callback:           .res 2  ; vector to routine to be called when data is received over tcp connection
 tcp_flags:              .res 1
 tcp_fin_sent:           .res 1
@@ -240,6 +249,8 @@ tcp_connect:
   ldax tcp_connect_remote_port
   stax tcp_remote_port
 
+  lda #0                        ; the SYN never carries static data
+  sta tcp_data_static
   jsr tcp_send_packet
   lda tcp_packet_sent_count
   adc #1
@@ -401,6 +412,10 @@ tcp_send_string:
 ;   carry flag is set if an error occured, clear otherwise
 tcp_send:
   stax tcp_send_data_ptr
+  lda tcp_send_static           ; the static flag only applies to this call
+  sta static_send
+  lda #0
+  sta tcp_send_static
 
   lda tcp_state
   cmp #tcp_cxn_state_established
@@ -442,6 +457,8 @@ tcp_send:
   ldax tcp_connect_remote_port
   stax tcp_remote_port
 
+  lda static_send
+  sta tcp_data_static
   jsr tcp_send_packet
   lda tcp_packet_sent_count
   adc #1
@@ -504,9 +521,20 @@ tcp_send:
 ; tcp_flags: 6 bit flags
 ; tcp_data_ptr: pointer to data to include in this packet
 ; tcp_data_len: length of data pointed at by tcp_data_ptr
+; tcp_data_static: if set, the data is not copied into the output buffer, but
+; sent directly from tcp_data_ptr, and tcp_send_cksum holds its checksum
 ; outputs:
 ; carry flag is set if an error occured, clear otherwise
 tcp_send_packet:
+  lda tcp_data_static
+  beq @copy
+  ldax tcp_data_ptr             ; leave data where it is
+  stax ip_payload_ptr
+  ldax tcp_data_len
+  stax ip_payload_len
+  jmp @header
+
+@copy:
   ldax tcp_data_ptr
   stax copy_src                 ; copy data to output buffer
   ldax #tcp_outp + tcp_data
@@ -514,6 +542,8 @@ tcp_send_packet:
   ldax tcp_data_len
   jsr copymem
 
+@header:
+
   ldx #3                        ; copy virtual header addresses
 : lda tcp_remote_ip,x
   sta tcp_vh + tcp_vh_dest,x    ; set virtual header destination
@@ -584,8 +614,16 @@ tcp_send_packet:
   adc #12
   bcc :+
   inx
+: ldy tcp_data_static
+  beq :+
+  ldax #12 + 20                 ; static data: only headers are in the buffer
 : jsr ip_calc_cksum             ; calculate checksum
-  stax tcp_outp + tcp_checksum
+  ldy tcp_data_static
+  beq :+
+  jsr add_static_cksum          ; add precomputed checksum of the data
+: stax tcp_outp + tcp_checksum
+  lda #0
+  sta tcp_data_static
 
   ldx #3                        ; copy addresses
 : lda tcp_remote_ip,x
@@ -612,6 +650,35 @@ tcp_send_packet:
 
   jmp ip_send                   ; send packet, sec on error
 
+; combine a checksum calculated by ip_calc_cksum with the precomputed
+; checksum of static data
+; inputs:
+; AX: checksum of the headers (as returned by ip_calc_cksum)
+; tcp_send_cksum: non-inverted checksum of the data
+; outputs:
+; AX: checksum of headers and data
+add_static_cksum:
+  eor #$ff                      ; undo the inversion
+  clc
+  adc tcp_send_cksum
+  sta static_cksum
+  txa
+  eor #$ff
+  adc tcp_send_cksum + 1
+  sta static_cksum + 1
+: lda static_cksum              ; add end-around carry
+  adc #0
+  sta static_cksum
+  lda static_cksum + 1
+  adc #0
+  sta static_cksum + 1
+  bcs :-
+  eor #$ff
+  tax
+  lda static_cksum
+  eor #$ff
+  rts
+
 ; see if the ip packet we just got is for a valid (non-closed) tcp connection
 ; inputs:
 ; eth_inp: should contain an ethernet frame encapsulating an inbound tcp packet
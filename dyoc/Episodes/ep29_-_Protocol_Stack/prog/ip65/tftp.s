@@ -1,7 +1,10 @@
 ; minimal tftp implementation (client only)
 ; supports file upload and download
+; downloads negotiate the block size (RFC 2348) and window size (RFC 7440)
+; with the server, see tftp_blksize and tftp_windowsize
 
 TFTP_MAX_RESENDS = 10
+TFTP_MAX_BLKSIZE = 1468         ; largest block that fits in eth_inp
 TFTP_TIMER_MASK  = $F8          ; mask lower two bits, means we wait for 8 x1/4 seconds
 
 .include "zeropage.inc"
@@ -20,6 +23,8 @@ TFTP_TIMER_MASK  = $F8          ; mask lower two bits, means we wait for 8 x1/4
 .export tftp_filename
 .export tftp_filesize
 .export tftp_upload_from_memory
+.export tftp_blksize
+.export tftp_windowsize
 .import ip65_process
 .import ip65_error
 
@@ -88,6 +93,18 @@ tftp_filename:          .res 2  ; pointer to null terminated name of file to upl
 tftp_filesize:          .res 2  ; will be set by tftp_download, needs to be set before calling tftp_upload_from_memory
 tftp_bytes_remaining:   .res 2
 
+tftp_progress:          .res 1  ; set if the last packet was just sent by tftp_in
+tftp_received_len:      .res 2  ; length of data in the block just received
+block_size:             .res 2  ; negotiated block size (512 unless the server sent an OACK)
+window_size:            .res 1  ; negotiated window size (1 unless the server sent an OACK)
+window_count:           .res 1  ; number of blocks received since the last ACK
+nak_sent:               .res 1  ; set if the last good block was re-acked in the current window
+oack_end:               .res 2  ; end of the OACK packet being parsed
+number:                 .res 2
+number_tmp:             .res 2
+out_idx:                .res 1
+digits_started:         .res 1
+
 
 .code
 
@@ -147,6 +164,14 @@ set_tftp_opcode:
   stax tftp_opcode
   lda #tftp_initializing
   sta tftp_state
+  ldax #512                     ; until the server acknowledges our options
+  stax block_size
+  lda #1
+  sta window_size
+  lda #0
+  sta window_count
+  sta nak_sent
+  sta tftp_break_inner_loop
   ldax #0000
   stax tftp_current_block_number
   ldax tftp_load_address
@@ -170,6 +195,8 @@ set_tftp_opcode:
   txa
   and #TFTP_TIMER_MASK
   sta tftp_timer                ; we only care about the high byte
+  lda tftp_break_inner_loop     ; set if we got here because a block was just
+  sta tftp_progress             ; sent/received, rather than because of a timeout
   lda #0
   sta tftp_break_inner_loop
   lda tftp_state
@@ -203,6 +230,8 @@ set_tftp_opcode:
 @not_complete:
   cmp #tftp_transmission_in_progress
   bne @not_transmitting
+  lda tftp_progress             ; the packet has just been sent by tftp_in,
+  bne @inner_delay_loop         ; so only resend it after a timeout
   jsr send_tftp_packet
   jmp @inner_delay_loop
 @not_transmitting:
@@ -256,6 +285,48 @@ send_request_packet:
   sta tftp_outp,x
   bne @copy_mode_loop
 
+  lda tftp_opcode+1             ; options are only requested for downloads
+  cmp #1
+  bne @no_options
+
+  lda tftp_blksize
+  ora tftp_blksize+1
+  beq @no_blksize
+  ldy #$ff
+@copy_blksize_loop:
+  inx
+  iny
+  lda tftp_blksize_option,y
+  sta tftp_outp,x
+  bne @copy_blksize_loop
+  txa                           ; keep the index into tftp_outp
+  pha
+  ldax tftp_blksize
+  jsr clamp_blksize
+  stax number
+  pla
+  tax
+  inx
+  jsr append_decimal
+
+@no_blksize:
+  lda tftp_windowsize
+  beq @no_options
+  ldy #$ff
+@copy_windowsize_loop:
+  inx
+  iny
+  lda tftp_windowsize_option,y
+  sta tftp_outp,x
+  bne @copy_windowsize_loop
+  lda tftp_windowsize
+  sta number
+  lda #0
+  sta number+1
+  inx
+  jsr append_decimal
+
+@no_options:
   inx
   txa
   ldx #0
@@ -321,9 +392,10 @@ send_tftp_packet:               ; TFTP block should be created in tftp_outp, we
 got_expected_block:
   lda tftp_current_block_number
   inc tftp_current_block_number
-  bne :+
+  bne got_reply
   inc tftp_current_block_number+1
-: lda #tftp_transmission_in_progress
+got_reply:
+  lda #tftp_transmission_in_progress
   sta tftp_state
   lda #TFTP_MAX_RESENDS
   sta tftp_resend_counter
@@ -354,6 +426,16 @@ tftp_in:
   jmp @not_data_block
 : lda #0
   sta tftp_just_set_new_load_address ; clear the flag
+  ldx tftp_inp+3                ; get the (low byte) of the data block
+  dex
+  cpx tftp_current_block_number
+  beq :+
+  jmp @unexpected_data_block
+: ; this is the block we wanted
+  lda tftp_current_block_number ; only block 1 holds the load address, so a
+  ora tftp_current_block_number+1 ; lost or reordered block 1 can't move it
+  bne @dont_set_load_address
+
   clc
   lda tftp_load_address
   adc tftp_load_address+1       ; is load address currently $0000?
@@ -369,57 +451,81 @@ tftp_in:
   sta tftp_just_set_new_load_address
 
 @dont_set_load_address:
-  ldx tftp_inp+3                ; get the (low byte) of the data block
-  dex
-  cpx tftp_current_block_number
-  beq :+
-  jmp @not_expected_block_number
-: ; this is the block we wanted
   jsr got_expected_block
+  lda #0
+  sta nak_sent
 
-  lda tftp_just_set_new_load_address
-  bne @skip_first_2_bytes_in_calculating_header_length
   lda udp_inp+5                 ; get the low byte of udp packet length
   sec
   sbc #$0c                      ; take off the length of the UDP header+OPCODE + BLOCK
+  sta tftp_received_len
+  lda udp_inp+4                 ; get high byte of the length of the UDP packet
+  sbc #0
+  sta tftp_received_len+1
 
-  jmp @adjusted_header_length
-@skip_first_2_bytes_in_calculating_header_length:
-  lda udp_inp+5                 ; get the low byte of udp packet length
+  ; the data is passed to the callback without copying it. the length is
+  ; stored in the two bytes just before the data, i.e. in place of the block
+  ; number (or the memory location, if the first 2 bytes are skipped).
+  lda tftp_just_set_new_load_address
+  bne @skip_first_2_bytes
+  ldax tftp_received_len
+  stax tftp_data_block_length
+  stax udp_inp+$0a
+  ldax #udp_inp+$0a
+  jmp @got_pointer_to_tftp_data
+@skip_first_2_bytes:
+  lda tftp_received_len
   sec
-  sbc #$0e                      ; take off the length of the UDP header+OPCODE + BLOCK + first 2 bytes (memory location)
-@adjusted_header_length:
+  sbc #2                        ; take off the first 2 bytes (memory location)
   sta tftp_data_block_length
-  lda udp_inp+4                 ; get high byte of the length of the UDP packet
+  lda tftp_received_len+1
   sbc #0
   sta tftp_data_block_length+1
-
-  lda tftp_just_set_new_load_address
-  bne @skip_first_2_bytes_in_calculating_copy_src
+  ldax tftp_data_block_length
+  stax udp_inp+$0c
   ldax #udp_inp+$0c
-  jmp @got_pointer_to_tftp_data
-@skip_first_2_bytes_in_calculating_copy_src:
-  ldax #udp_inp+$0e
 @got_pointer_to_tftp_data:
-  stax copy_src
-  ldax #output_buffer+2
-  stax copy_dest
-  ldax tftp_data_block_length
-  stax output_buffer
-  jsr copymem
-  ldax #output_buffer
-
   jsr tftp_callback_vector
-  jsr send_ack
 
-  lda udp_inp+4                 ; check the length of the UDP packet
-  cmp #02
-  bne @last_block
+  clc
+  lda tftp_filesize
+  adc tftp_data_block_length
+  sta tftp_filesize
+  lda tftp_filesize+1
+  adc tftp_data_block_length+1
+  sta tftp_filesize+1
+
+  lda tftp_received_len         ; the last block is shorter than the block size
+  cmp block_size
+  lda tftp_received_len+1
+  sbc block_size+1
+  bcs :+
+  lda #tftp_complete            ; the ACK is sent by tftp_download
+  sta tftp_state
+  rts
+
+: inc window_count              ; only ACK the last block of each window
+  lda window_count
+  cmp window_size
+  bcs :+
+  rts
+: lda #0
+  sta window_count
+  jmp send_ack
+
+@unexpected_data_block:
+  lda window_size               ; in lock-step mode the server just resends
+  cmp #2                        ; the block after a timeout
+  bcc @ignore
+  lda nak_sent                  ; a block in the window was lost, so ACK the
+  bne @ignore                   ; last good block once, and the server will
+  inc nak_sent                  ; restart the window from there (RFC 7440)
+  lda #0
+  sta window_count
+  jmp send_ack
+@ignore:
+  rts
 
-  lda udp_inp+5
-  cmp #$0c
-  bne @last_block
-  beq @not_last_block
 @not_data_block:
   cmp #4                        ; ACK is opcode 4
   beq :+
@@ -449,8 +555,20 @@ tftp_in:
 @not_last_block:
   inc tftp_filesize+1           ; add $200 to file size
   inc tftp_filesize+1           ; add $200 to file size
+  rts
 
 @not_ack:
+  cmp #6                        ; OACK is opcode 6
+  bne @not_expected_block_number
+  lda tftp_state                ; only valid as reply to our request
+  cmp #tftp_initial_request_sent
+  bne @not_expected_block_number
+  jsr parse_oack
+  jsr got_reply
+  lda #0
+  sta window_count
+  jmp send_ack                  ; ACK block 0 to start the transfer
+
 @not_expected_block_number:
   rts
 
@@ -464,6 +582,198 @@ tftp_in:
   sta tftp_state
   rts
 
+; parse the options acknowledged by the server (RFC 2347)
+; inputs: tftp_inp contains an OACK packet
+; outputs: block_size and window_size are updated
+parse_oack:
+  clc
+  lda #<udp_inp
+  adc udp_inp+5                 ; add length of UDP packet
+  sta oack_end
+  lda #>udp_inp
+  adc udp_inp+4
+  sta oack_end+1
+  ldax #tftp_inp+2
+  stax ptr1
+
+@next_option:
+  lda ptr1                      ; end of packet?
+  cmp oack_end
+  lda ptr1+1
+  sbc oack_end+1
+  bcs @done
+
+  ldax #tftp_blksize_option
+  jsr match_option
+  bcs @not_blksize
+  jsr skip_string
+  jsr parse_number
+  jsr clamp_blksize
+  stax block_size
+  jmp @next_option
+
+@not_blksize:
+  ldax #tftp_windowsize_option
+  jsr match_option
+  bcs @unknown_option
+  jsr skip_string
+  jsr parse_number
+  cmp #0
+  bne :+
+  lda #1
+: sta window_size
+  jmp @next_option
+
+@unknown_option:
+  jsr skip_string               ; skip name and value
+  jsr skip_string
+  jmp @next_option
+
+@done:
+  rts
+
+; limit a block size to what fits in the receive buffer
+; inputs: AX contains the block size
+; outputs: AX contains the block size, at most TFTP_MAX_BLKSIZE
+clamp_blksize:
+  cmp #<(TFTP_MAX_BLKSIZE+1)
+  pha
+  txa
+  sbc #>(TFTP_MAX_BLKSIZE+1)
+  pla
+  bcc :+
+  ldax #TFTP_MAX_BLKSIZE
+: rts
+
+; compare option name (case insensitive)
+; inputs: ptr1 points to option name, AX points to lower case name
+; outputs: carry flag clear if the names match
+match_option:
+  stax ptr2
+  ldy #0
+@loop:
+  lda (ptr1),y
+  cmp #'A'
+  bcc :+
+  cmp #'Z'+1
+  bcs :+
+  ora #$20                      ; convert to lower case
+: cmp (ptr2),y
+  bne @no_match
+  iny
+  cmp #0
+  bne @loop
+  clc
+  rts
+@no_match:
+  sec
+  rts
+
+; advance ptr1 past the next zero terminated string
+skip_string:
+  ldy #0
+: lda (ptr1),y
+  iny
+  beq :+                        ; give up after 256 bytes
+  cmp #0
+  bne :-
+: tya
+  clc
+  adc ptr1
+  sta ptr1
+  bcc :+
+  inc ptr1+1
+: rts
+
+; parse a zero terminated decimal number and advance ptr1 past it
+; inputs: ptr1 points to the number
+; outputs: AX contains the number
+parse_number:
+  lda #0
+  sta number
+  sta number+1
+  ldy #0
+@digit:
+  lda (ptr1),y
+  sec
+  sbc #'0'
+  cmp #10
+  bcs @end
+  pha
+  asl number                    ; number = number * 10 + digit
+  rol number+1
+  lda number
+  sta number_tmp
+  lda number+1
+  sta number_tmp+1
+  asl number
+  rol number+1
+  asl number
+  rol number+1
+  clc
+  lda number
+  adc number_tmp
+  sta number
+  lda number+1
+  adc number_tmp+1
+  sta number+1
+  pla
+  clc
+  adc number
+  sta number
+  bcc :+
+  inc number+1
+: iny
+  bne @digit
+@end:
+  jsr skip_string
+  ldax number
+  rts
+
+; append a number as a zero terminated decimal string
+; inputs: number contains the value, X is the index into tftp_outp
+; outputs: X is the index of the terminating zero
+append_decimal:
+  stx out_idx
+  lda #0
+  sta digits_started
+  ldy #4                        ; start with 10000
+@next_power:
+  ldx #'0'
+@subtract:
+  lda number
+  sec
+  sbc pow10_lo,y
+  sta number_tmp
+  lda number+1
+  sbc pow10_hi,y
+  bcc @digit_done
+  sta number+1
+  lda number_tmp
+  sta number
+  inx
+  bne @subtract
+@digit_done:
+  cpx #'0'
+  bne @store
+  lda digits_started
+  bne @store
+  cpy #0
+  bne @skip                     ; suppress leading zeros
+@store:
+  stx digits_started
+  txa
+  ldx out_idx
+  sta tftp_outp,x
+  inc out_idx
+@skip:
+  dey
+  bpl @next_power
+  ldx out_idx
+  lda #0
+  sta tftp_outp,x
+  rts
+
 ; default handler when block arrives:
 ; copy to RAM
 ; assumes tftp_data_block_length has been set, and AX should point to start of data
@@ -511,14 +821,14 @@ copy_ram_to_tftp_block:
   ldax tftp_bytes_remaining
   jmp @length_is_set
 
-; set up vector of routine to be called when each 512 packet arrives from tftp server
+; set up vector of routine to be called when each packet arrives from tftp server
 ; when downloading OR for routine to be called when ready to send new block
 ; when uploading.
 ; when vector is called when downloading, AX will point to data that was downloaded,
 ; tftp_data_block_length will be set to length of downloaded data block. This will be
-; equal to $200 (512) for each block EXCEPT the final block. THe final block will
-; always be less than $200 bytes - if the file is an exact multiple if $200 bytes
-; long, then a final block will be received with length $00.
+; equal to the negotiated block size (512 by default) for each block EXCEPT the final
+; block. The final block will always be shorter - if the file is an exact multiple of
+; the block size, then a final block will be received with length $00.
 ; when vector is called when uploading, AX will point to a 512 byte buffer that
 ; should be filled with the next block. the user supplied routine should set AX
 ; to be equal to the actual number of bytes inserted into the buffer, which should
@@ -547,6 +857,11 @@ tftp_clear_callbacks:
 .rodata
 
   tftp_octet_mode: .asciiz "OCTET"
+  tftp_blksize_option: .asciiz "blksize"
+  tftp_windowsize_option: .asciiz "windowsize"
+
+pow10_lo: .byte <1, <10, <100, <1000, <10000
+pow10_hi: .byte >1, >10, >100, >1000, >10000
 
 
 .data
@@ -556,6 +871,10 @@ tftp_callback_vector:
 
 tftp_callback_address_set: .byte 0
 
+; options requested for downloads. set to 0 to use classic lock-step 512 byte blocks.
+tftp_blksize:    .word 1468     ; largest block that fits in an ethernet frame
+tftp_windowsize: .byte 8        ; number of blocks sent by the server per ACK
+
 
 
 ; -- LICENSE FOR tftp.s --
@@ -4,6 +4,8 @@
 .export _tftp_download_to_memory
 .export _tftp_upload
 .export _tftp_upload_from_memory
+.export _tftp_blksize
+.export _tftp_windowsize
 
 .import tftp_download
 .import tftp_upload
@@ -16,10 +18,15 @@
 .import tftp_current_memloc
 .import tftp_filename
 .import tftp_filesize
+.import tftp_blksize
+.import tftp_windowsize
 
 .import pushax, popax, popeax
 .importzp sreg
 
+_tftp_blksize := tftp_blksize
+_tftp_windowsize := tftp_windowsize
+
 
 .data
 
@@ -1,135 +1,228 @@
 #include <stdint.h>
 #include <stdlib.h>  // rand()
 #include <conio.h>
-#include <string.h>  // memcpy()
+#include <string.h>  // memset()
 #include "getcycles.h"  // getcycles()
+#include "memorymap.h"  // MEM_CHAR, MEM_COL
+#include "bench.h"      // bench_stop()
+#include "screen.h"     // screen_flip()
 
 #define SIZE_X 80
 #define SIZE_Y 60
 
+// Number of generations to run, when used as a benchmark.
+#define BENCH_GENERATIONS 4
+
 #define ROWS (SIZE_Y+2)
 #define COLS (SIZE_X+2)
 
-#define D  (COLS)
-#define DR (COLS+1)
-#define DL (COLS-1)
-#define R  (1)
-#define L  (-1)
-#define U  (-COLS)
-#define UR (-COLS+1)
-#define UL (-COLS-1)
+// Each cell contains the number of live neighbours in bits 4-1,
+// and the state of the cell itself in bit 0.
+#define ALIVE     1
+#define NEIGHBOUR 2
 
-const uint8_t PROP = 20;
+#define SURVIVE2  (2*NEIGHBOUR+ALIVE)
+#define SURVIVE3  (3*NEIGHBOUR+ALIVE)
+#define BIRTH     (3*NEIGHBOUR)
 
-char    board[ROWS*COLS];
-char    color[ROWS*COLS];
-char newboard[ROWS*COLS];
+const uint8_t PROP = 20;
 
-void reset(void)
+// This is cleared in reset(), so it need not be cleared at startup.
+#pragma bss-name (push, "NOINIT")
+uint8_t cells[ROWS*COLS];
+#pragma bss-name (pop)
+
+// Whether any cell changed in each row during the last generation.
+// Only rows next to a changed row need to be scanned in the next generation.
+uint8_t active_a[ROWS];
+uint8_t active_b[ROWS];
+uint8_t *active      = active_a;
+uint8_t *next_active = active_b;
+
+// Columns of the cells that change in the current row and in the previous row.
+// The changes of a row are applied after the next row has been scanned,
+// so the scan always sees the neighbour counts of the previous generation.
+#pragma bss-name (push, "NOINIT")
+uint8_t changes_a[SIZE_X];
+uint8_t changes_b[SIZE_X];
+#pragma bss-name (pop)
+
+
+// Toggle the cells in the list, update the neighbour counts,
+// and write the changed characters to the screen.
+static void apply(uint8_t y, const uint8_t* list, uint8_t n)
 {
+   register uint8_t* c;
+   register uint8_t* scr = &MEM_CHAR[(y-1)*SIZE_X-1];   // Column 1 is the left edge of the screen.
+   uint8_t* row = &cells[y*COLS-COLS-1];                // Upper left neighbour of column 0.
    uint8_t x;
-   uint8_t y;
-
-   memset(board, 0, sizeof(board));
-   memset(color, 0, sizeof(board));
-   memset(newboard, 0, sizeof(newboard));
+   uint8_t d;
 
-   for (y=1; y<=SIZE_Y; ++y)
+   while (n--)
    {
-      uint16_t iStart = y*COLS;
+      x = *list++;
+      c = row + x;
 
-      for (x=1; x<=SIZE_X; ++x)
+      if (c[COLS+1] & ALIVE)
       {
-         uint16_t idx = iStart+x;
-
-         if ((rand()%100) < PROP)
-         {
-            board[idx] = 1;
-         }
+         // Death
+         d = -NEIGHBOUR;
+         scr[x] = ' ';
       }
+      else
+      {
+         // Birth
+         d = NEIGHBOUR;
+         scr[x] = '*';
+         (scr + (MEM_COL-MEM_CHAR))[x] = 1;
+      }
+      c[COLS+1] ^= ALIVE;
+
+      c[0]        += d;     // All offsets are positive and less than 256,
+      c[1]        += d;     // which is an optimization.
+      c[2]        += d;
+      c[COLS]     += d;
+      c[COLS+2]   += d;
+      c[2*COLS]   += d;
+      c[2*COLS+1] += d;
+      c[2*COLS+2] += d;
    }
-} // end of reset
+} // end of apply
 
 
-void update(void)
+// The bank being drawn contains the frame before last, see screen.h.
+// Redraw the rows that changed in the last generation, so the bank shows
+// the current state of the cells before the next changes are applied.
+static void redraw(void)
 {
-   uint8_t x;
+   register uint8_t* scr = MEM_CHAR;
+   register uint8_t* row = &cells[COLS+1];
    uint8_t y;
+   uint8_t x;
+   uint8_t c;
 
-   for (y=1; y<=SIZE_Y; ++y)
+   for (y=1; y<=SIZE_Y; ++y, scr += SIZE_X, row += COLS)
    {
-      uint16_t iStart = y*COLS;
-
-      for (x=1; x<=SIZE_X; ++x)
+      if (!active[y])
       {
-         uint16_t idx = iStart+x;
-
-         uint8_t neighbours = 
-            (board+D)[idx]  +    // This strange construction is an optimization.
-            (board+DR)[idx] +
-            (board+DL)[idx] +
-            (board+R)[idx]  +
-            (board+L)[idx]  +
-            (board+U)[idx]  +
-            (board+UR)[idx] +
-            (board+UL)[idx];
-
-         newboard[idx] = board[idx];
-         if (board[idx] && (neighbours < 2 || neighbours > 3))
-         {
-            // Death
-            newboard[idx] = 0;
-            color[idx] = 0;
-         }
-         if (!board[idx] && (neighbours == 3))
-         {
-            // Birth
-            newboard[idx] = 1;
-            color[idx] = 1;
-         }
+         continue;
+      }
 
-         if (board[idx])
+      for (x=0; x<SIZE_X; ++x)
+      {
+         c = (row[x] & ALIVE) ? '*' : ' ';
+         if (scr[x] != c)
          {
-            if (color[idx] < 15)
+            scr[x] = c;
+            if (c == '*')
             {
-               color[idx] += 1;
+               (scr + (MEM_COL-MEM_CHAR))[x] = 1;
             }
          }
       }
    }
+} // end of redraw
 
-   memcpy(board, newboard, sizeof(board));
-} // end of update
 
+// Find the cells in row y that change in the next generation.
+// Surviving cells are aged, i.e. their colour is incremented.
+// Only the bank being drawn is aged, so each bank ages every other generation.
+static uint8_t scan(uint8_t y, uint8_t* list)
+{
+   register uint8_t* row = &cells[y*COLS];
+   register uint8_t* col = &MEM_COL[(y-1)*SIZE_X-1];
+   uint8_t n = 0;
+   uint8_t x;
+   uint8_t v;
 
-extern uint8_t* curs_pos;
-#pragma zpsym("curs_pos");    // curs_pos is in zero-page.
+   for (x=1; x<=SIZE_X; ++x)
+   {
+      v = row[x];
+      if (v == 0)
+      {
+         continue;
+      }
 
-void show(void)
+      if (v == SURVIVE2 || v == SURVIVE3)
+      {
+         if (col[x] < 15)
+         {
+            col[x] += 1;
+         }
+      }
+      else if ((v & ALIVE) || v == BIRTH)
+      {
+         list[n++] = x;
+      }
+   }
+
+   return n;
+} // end of scan
+
+
+void reset(void)
 {
    uint8_t x;
    uint8_t y;
+   uint8_t n;
+
+   memset(cells, 0, sizeof(cells));
+   clrscr();
 
    for (y=1; y<=SIZE_Y; ++y)
    {
-      uint16_t iStart = y*COLS;
-      uint8_t *p = &board[iStart];
-
-      gotoxy(0, y-1);
+      n = 0;
       for (x=1; x<=SIZE_X; ++x)
       {
-         if (p[x])
-         {
-            *(curs_pos + 0x2000) = color[iStart+x];
-            cputc('*');
-         }
-         else
+         if ((rand()%100) < PROP)
          {
-            cputc(' ');
+            changes_a[n++] = x;
          }
       }
+      apply(y, changes_a, n);
+   }
+
+   memset(active+1, 1, SIZE_Y);
+} // end of reset
+
+
+void update(void)
+{
+   uint8_t y;
+   uint8_t n;
+   uint8_t n_prev = 0;
+   uint8_t *list = changes_a;
+   uint8_t *prev_list = changes_b;
+   uint8_t *tmp;
+
+   redraw();
+
+   for (y=1; y<=SIZE_Y; ++y)
+   {
+      n = 0;
+      if (active[y-1] | active[y] | active[y+1])
+      {
+         n = scan(y, list);
+      }
+      next_active[y] = n;
+
+      if (n_prev)
+      {
+         apply(y-1, prev_list, n_prev);
+      }
+
+      n_prev = n;
+      tmp = prev_list; prev_list = list; list = tmp;
+   }
+
+   if (n_prev)
+   {
+      apply(SIZE_Y, prev_list, n_prev);
    }
-} // end of show
+
+   tmp = active; active = next_active; next_active = tmp;
+} // end of update
+
 
 uint16_t ms(void)
 {
@@ -143,20 +236,31 @@ uint16_t ms(void)
 
 void main(void)
 {
-   int16_t tim = 0;
-   uint16_t fps10;
+   uint32_t tim = 0;
+   uint32_t fps10;
+#ifdef BENCH
+   uint8_t gen = 0;
+#endif
+
+   // Draw in the bank not shown. Each generation is shown at the next
+   // vertical blank, so the screen never shows a half updated generation.
+   screen_draw_bank(1);
 
    reset();
    while (1)
    {
-      show();
-
-      tim = ms()-tim;
-      fps10 = 10000/tim;
+      // Measure in clock cycles, since a generation may take less than a millisecond.
+      tim = getcycles()-tim;
+      fps10 = 250000000UL/tim;
+      if (fps10 > 65535U)
+      {
+         fps10 = 65535U;
+      }
       gotoxy(72, 59);
-      cprintf("FPS: %d.%d", fps10/10, fps10%10);
-      tim = ms();
+      cprintf("FPS: %u.%u", (uint16_t) fps10/10, (uint16_t) fps10%10);
+      tim = getcycles();
 
+      screen_flip();
 
       if (kbhit())
       {
@@ -168,6 +272,13 @@ void main(void)
       {
          update();
       }
+
+#ifdef BENCH
+      if (++gen == BENCH_GENERATIONS)
+      {
+         bench_stop();
+      }
+#endif
    }
 } // end of main
 
@@ -1,16 +1,16 @@
 #include <stdint.h>
 #include <stdlib.h>     // rand()
-#include <time.h>       // clock()
 #include <conio.h>
+#include "bench.h"      // bench_stop()
+#include "getcycles.h"
 
 #define MAX_ROWS  28
 #define MAX_COLS  28
-#define MAX_SQUARES	(MAX_ROWS*MAX_COLS)
 
-uint8_t grid[MAX_SQUARES];
+// Each square contains a bit for each opening, and a bit when it has been visited.
+uint8_t grid[MAX_ROWS][MAX_COLS];
 
-#define GetRow(sq)	(sq % MAX_ROWS)
-#define GetCol(sq)	(sq / MAX_ROWS)
+#define BEEN_HERE (1<<7)
 
 enum
 {
@@ -20,69 +20,81 @@ enum
    DIR_SOUTH,
    MAX_DIRS
 };
-const int offset[MAX_DIRS] = {-1, MAX_ROWS, -MAX_ROWS, 1};
 
-uint8_t GetRandomDir()
-{
-   return rand() % MAX_DIRS;
-}
+// The opposite direction is (MAX_DIRS-1) - dir.
+const int8_t offsetRow[MAX_DIRS] = {-1, 0,  0, 1};
+const int8_t offsetCol[MAX_DIRS] = { 0, 1, -1, 0};
 
-uint16_t GetRandomSquare()
-{
-   return rand() % MAX_SQUARES;
-}
+// Directions taken by the fast generator, used for backtracking.
+uint8_t stack[MAX_ROWS*MAX_COLS];
+
+// Time between each step of the animated generator.
+#define STEP_CYCLES 50000UL   // 2 ms
 
 
-void DrawPos(uint16_t sq)
+void DrawPos(uint8_t row, uint8_t col)
 {
    const char wall = '#';
-   uint8_t col = 1 + 2*GetCol(sq);
-   uint8_t row = 1 + 2*GetRow(sq);
-   uint8_t g = grid[sq];
-
-   cputcxy(col+1, row+1, ' ');
-   cputcxy(col,   row,   wall);
-   cputcxy(col,   row+2, wall);
-   cputcxy(col+2, row+2, wall);
-   cputcxy(col+2, row,   wall);
-   cputcxy(col+1, row,   (g&(1<<DIR_NORTH)) ? ' ' : wall);
-   cputcxy(col+2, row+1, (g&(1<<DIR_EAST))  ? ' ' : wall);
-   cputcxy(col,   row+1, (g&(1<<DIR_WEST))  ? ' ' : wall);
-   cputcxy(col+1, row+2, (g&(1<<DIR_SOUTH)) ? ' ' : wall);
+   uint8_t x = 1 + 2*col;
+   uint8_t y = 1 + 2*row;
+   uint8_t g = grid[row][col];
+
+   cputcxy(x+1, y+1, ' ');
+   cputcxy(x,   y,   wall);
+   cputcxy(x,   y+2, wall);
+   cputcxy(x+2, y+2, wall);
+   cputcxy(x+2, y,   wall);
+   cputcxy(x+1, y,   (g&(1<<DIR_NORTH)) ? ' ' : wall);
+   cputcxy(x+2, y+1, (g&(1<<DIR_EAST))  ? ' ' : wall);
+   cputcxy(x,   y+1, (g&(1<<DIR_WEST))  ? ' ' : wall);
+   cputcxy(x+1, y+2, (g&(1<<DIR_SOUTH)) ? ' ' : wall);
 } // end of DrawPos
 
 
-void InitMaze(void)
+static void ClearMaze(void)
 {
-   int sq;
-   int count;
-   uint16_t c;
+   uint8_t row;
+   uint8_t col;
 
-   for(sq=0; sq<MAX_SQUARES; sq++)
+   for (row=0; row<MAX_ROWS; row++)
    {
-      grid[sq]=0;
+      for (col=0; col<MAX_COLS; col++)
+      {
+         grid[row][col] = 0;
+      }
    }
+} // end of ClearMaze
+
+
+// Random walk, drawing each step as it goes.
+static void InitMazeAnimated(void)
+{
+   uint8_t row = rand() % MAX_ROWS;
+   uint8_t col = rand() % MAX_COLS;
+   uint16_t count = MAX_ROWS*MAX_COLS-1;
+   uint32_t next = getcycles();
 
-   sq = GetRandomSquare();
-   count = MAX_SQUARES-1;
    while (count)
    {
-      int dir = GetRandomDir();
-      int newSq = sq + offset[dir];
+      uint8_t dir = rand() % MAX_DIRS;
+      uint8_t newRow = row + offsetRow[dir];   // Wraps around to 255 outside the maze.
+      uint8_t newCol = col + offsetCol[dir];
 
-      if ( ((GetRow(sq)==GetRow(newSq)) + (GetCol(sq)==GetCol(newSq)) == 1)
-            && (newSq>=0) && (newSq<MAX_SQUARES) )
+      if (newRow < MAX_ROWS && newCol < MAX_COLS)
       {
-         if (!grid[newSq])
+         if (!grid[newRow][newCol])
          {	/* We haven't been here before. */
 
             /* Make an opening */
-            grid[sq] += 1 << (dir); DrawPos(sq);
-            sq = newSq;
-            grid[sq] += 1 << ((MAX_DIRS-1) - dir); DrawPos(sq);
+            grid[row][col] |= 1 << dir; DrawPos(row, col);
+            row = newRow;
+            col = newCol;
+            grid[row][col] |= 1 << ((MAX_DIRS-1) - dir); DrawPos(row, col);
             count--;
             gotoxy(70, 10); cprintf("%05d", count);
-            for (c=0; c<10000; ++c)
+
+            next += STEP_CYCLES;
+            while ((int32_t) (getcycles() - next) < 0)
             {
             }
          }
@@ -90,50 +102,103 @@ void InitMaze(void)
          {
             do
             {
-               sq = GetRandomSquare();
+               row = rand() % MAX_ROWS;
+               col = rand() % MAX_COLS;
             }
-            while (!grid[sq]);
+            while (!grid[row][col]);
          }
       }
    }
-} // end of InitMaze
+} // end of InitMazeAnimated
 
 
-int main()
+// Iterative backtracker. Nothing is drawn.
+static void InitMazeFast(void)
 {
-   int curSq, printSq;
-
-   srand(clock());
-
-   InitMaze();
+   uint8_t row = rand() % MAX_ROWS;
+   uint8_t col = rand() % MAX_COLS;
+   uint16_t sp = 0;
+   uint8_t dirs[MAX_DIRS];
+   uint8_t num;
+   uint8_t dir;
+   uint8_t newRow;
+   uint8_t newCol;
+
+   while (1)
+   {
+      // Find the unvisited neighbours.
+      num = 0;
+      for (dir=0; dir<MAX_DIRS; dir++)
+      {
+         newRow = row + offsetRow[dir];
+         newCol = col + offsetCol[dir];
+         if (newRow < MAX_ROWS && newCol < MAX_COLS && !grid[newRow][newCol])
+         {
+            dirs[num++] = dir;
+         }
+      }
 
-   clrscr();
+      if (num)
+      {
+         dir = dirs[rand() % num];
+         grid[row][col] |= 1 << dir;
+         row += offsetRow[dir];
+         col += offsetCol[dir];
+         grid[row][col] |= 1 << ((MAX_DIRS-1) - dir);
+         stack[sp++] = dir;
+      }
+      else
+      {
+         if (!sp)
+            break;
 
-   /* Get random start square */
-   curSq = MAX_SQUARES - 1;
+         dir = stack[--sp];
+         row -= offsetRow[dir];
+         col -= offsetCol[dir];
+      }
+   }
+} // end of InitMazeFast
 
-   while (curSq >= 0)
-   {
-      int dir;
 
-#define BEEN_HERE 1<<7
+int main()
+{
+   uint8_t row;
+   uint8_t col;
+   uint8_t dir;
+   uint32_t cycles;
+   uint8_t animate = 0;
+
+#ifndef BENCH
+   cputsxy(1, 1, "Press space for animated generation, or any other key.");
+   animate = (cgetc() == ' ');
+   clrscr();
+#endif
+   srand(getcycles());
+
+   ClearMaze();
+   cycles = getcycles();
+   if (animate)
+      InitMazeAnimated();
+   else
+      InitMazeFast();
+   cycles = getcycles() - cycles;
+#ifdef BENCH
+   bench_stop();     // The rest needs keyboard input.
+#endif
 
-      if (!curSq)
-      {
-         cputsxy(1, 58, "You escaped!");
-      }
+   clrscr();
+   gotoxy(1, 59); cprintf("Generated in %lu cycles", cycles);
 
-      grid[curSq] |= BEEN_HERE;
+   /* Start in the bottom right corner */
+   row = MAX_ROWS-1;
+   col = MAX_COLS-1;
+   grid[row][col] |= BEEN_HERE;
+   DrawPos(row, col);
 
-      for (printSq=0; printSq<MAX_SQUARES; printSq++)
-      {
-         if (grid[printSq] & BEEN_HERE)
-         {
-            DrawPos(printSq);
-         }
-      }
-      cputcxy(2+GetCol(curSq)*2, 2+GetRow(curSq)*2, curSq ? '@' : '*');
-      gotoxy(2+GetCol(curSq)*2, 2+GetRow(curSq)*2);
+   while (1)
+   {
+      cputcxy(2+col*2, 2+row*2, (row || col) ? '@' : '*');
+      gotoxy(2+col*2, 2+row*2);
 
       dir = MAX_DIRS;
       switch (cgetc())
@@ -142,17 +207,31 @@ int main()
          case 's': case 'j': dir = DIR_SOUTH; break;
          case 'd': case 'l': dir = DIR_EAST; break;
          case 'a': case 'h': dir = DIR_WEST; break;
-         case 'q': curSq = -1; break;
+         case 'q': return 0;
       }
 
-      if (dir < MAX_DIRS)
+      if (dir < MAX_DIRS && (grid[row][col] & (1<<dir)))
       {
-         if (grid[curSq] & (1<<dir))
+         // Only the old and the new square need to be redrawn.
+         cycles = getcycles();
+         cputcxy(2+col*2, 2+row*2, ' ');
+         row += offsetRow[dir];
+         col += offsetCol[dir];
+         if (!(grid[row][col] & BEEN_HERE))
+         {
+            grid[row][col] |= BEEN_HERE;
+            DrawPos(row, col);
+         }
+         cycles = getcycles() - cycles;
+
+         gotoxy(40, 59); cprintf("Frame: %lu cycles   ", cycles);
+
+         if (!row && !col)
          {
-            curSq += offset[dir];
+            cputsxy(1, 58, "You escaped!");
          }
       }
-   } // end of while (curSq >= 0)
+   } // end of while (1)
 
    return 0;
 } // end of main
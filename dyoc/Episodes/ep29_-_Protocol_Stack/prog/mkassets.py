@@ -0,0 +1,100 @@
+#! /usr/bin/env python
+
+# This converts a list of files into an assembler source file containing the
+# static asset table used by ip65/httpd_static.s.
+#
+# Each file is turned into a complete HTTP response (header and body), which
+# is then split into TCP segments of at most one MSS. For each segment the
+# checksum is precomputed in the same byte order as ip_calc_cksum in
+# ip65/ip.s, so the segments can be sent directly from ROM.
+#
+# The file "index.html" is additionally served as "/".
+#
+# Usage: ./mkassets.py <dest> <source> ...
+
+import os
+import sys
+
+MSS = 1460
+
+CONTENT_TYPES = {
+    ".html" : "text/html",
+    ".htm"  : "text/html",
+    ".txt"  : "text/plain",
+    ".css"  : "text/css",
+    ".js"   : "application/javascript",
+    ".png"  : "image/png",
+    ".ico"  : "image/x-icon",
+}
+
+def checksum(data):
+    # Even bytes are the LSB and odd bytes are the MSB, just like ip_calc_cksum.
+    total = 0
+    for i in range(0, len(data), 2):
+        total += data[i]
+        if i+1 < len(data):
+            total += data[i+1] << 8
+    while total > 0xFFFF:
+        total = (total & 0xFFFF) + (total >> 16)
+    return total
+
+def response(filename):
+    body = bytearray(open(filename, "rb").read())
+    ext = os.path.splitext(filename)[1].lower()
+    header = "HTTP/1.0 200 OK\r\n" \
+             "Content-Type: %s\r\n" \
+             "Content-Length: %d\r\n" \
+             "Connection: Close\r\n" \
+             "Server: IP65_httpd/0.6502\r\n" \
+             "\r\n" % (CONTENT_TYPES.get(ext, "application/octet-stream"), len(body))
+    return bytearray(header.encode("ascii")) + body
+
+def bytes_lines(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  .byte " + ",".join("$%02x" % b for b in data[i:i+16]))
+    return lines
+
+destname = sys.argv[1]
+sources  = sys.argv[2:]
+
+paths = []
+for i, source in enumerate(sources):
+    name = os.path.basename(source)
+    paths.append(("/" + name, i))
+    if name == "index.html":
+        paths.append(("/", i))
+
+out = []
+out.append("; This file is generated by mkassets.py. Do not edit.")
+out.append("")
+out.append(".export httpd_static_assets")
+out.append("")
+out.append(".rodata")
+out.append("")
+out.append("httpd_static_assets:")
+for i, (path, asset) in enumerate(paths):
+    out.append("  .addr path_%d, asset_%d" % (i, asset))
+out.append("  .addr 0")
+out.append("")
+for i, (path, asset) in enumerate(paths):
+    out.append("path_%d:" % i)
+    out.append("  .byte \"%s\",0" % path)
+
+for i, source in enumerate(sources):
+    data = response(source)
+    segments = [data[j:j+MSS] for j in range(0, len(data), MSS)]
+    out.append("")
+    out.append("asset_%d: ; %s" % (i, os.path.basename(source)))
+    out.append("  .byte %d" % len(segments))
+    for j, segment in enumerate(segments):
+        out.append("  .addr data_%d_%d" % (i, j))
+        out.append("  .word %d" % len(segment))
+        out.append("  .word $%04x" % checksum(segment))
+    for j, segment in enumerate(segments):
+        out.append("data_%d_%d:" % (i, j))
+        out.extend(bytes_lines(segment))
+
+fl = open(destname, "w")
+fl.write("\n".join(out) + "\n")
+fl.close()
@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <string.h>     // memcpy
+
+#include "memorymap.h"
+#include "bitmap.h"
+
+void bitmap_wait(void)
+{
+   while (MEMIO_CONFIG2->blitCmd)
+   {
+   }
+} // end of bitmap_wait
+
+void bitmap_enable(uint8_t enable)
+{
+   MEMIO_CONFIG2->bitmapEnable = enable;
+} // end of bitmap_enable
+
+static void blit(uint16_t x, uint8_t y, uint16_t w, uint8_t h, uint8_t col, uint8_t cmd)
+{
+   bitmap_wait();
+   MEMIO_CONFIG2->blitX   = x;
+   MEMIO_CONFIG2->blitY   = y;
+   MEMIO_CONFIG2->blitW   = w;
+   MEMIO_CONFIG2->blitH   = h;
+   MEMIO_CONFIG2->blitCol = col;
+   MEMIO_CONFIG2->blitCmd = cmd;
+} // end of blit
+
+void bitmap_fill(uint16_t x, uint8_t y, uint16_t w, uint8_t h, uint8_t col)
+{
+   blit(x, y, w, h, col, BLIT_CMD_FILL);
+} // end of bitmap_fill
+
+void bitmap_rect(uint16_t x, uint8_t y, uint16_t w, uint8_t h, uint8_t col)
+{
+   bitmap_fill(x,     y,     w, 1, col);
+   bitmap_fill(x,     y+h-1, w, 1, col);
+   bitmap_fill(x,     y,     1, h, col);
+   bitmap_fill(x+w-1, y,     1, h, col);
+} // end of bitmap_rect
+
+void bitmap_pattern(uint16_t x, uint8_t y, uint16_t w, uint8_t h,
+                    const uint8_t* pattern, uint8_t fg, uint8_t bg)
+{
+   // The pattern registers are read when the command starts.
+   bitmap_wait();
+   memcpy(MEMIO_CONFIG2->blitPattern, pattern, 8);
+   blit(x, y, w, h, (bg << 4) | fg, BLIT_CMD_PATTERN);
+} // end of bitmap_pattern
+
+void bitmap_copy(uint16_t src_x, uint8_t src_y, uint16_t x, uint8_t y, uint16_t w, uint8_t h)
+{
+   bitmap_wait();
+   MEMIO_CONFIG2->blitSrcX = src_x;
+   MEMIO_CONFIG2->blitSrcY = src_y;
+   blit(x, y, w, h, 0, BLIT_CMD_COPY);
+} // end of bitmap_copy
+
@@ -1,16 +1,19 @@
 #include <stdint.h>
-#include <6502.h>       // SEI() and CLI()
+#include <time.h>
 
-extern uint16_t timer;
+#include "memorymap.h"
 
-uint32_t clock(void)
+// Returns the number of microseconds since power-up.
+// This is the lower 32 bits of the hardware timer, so it wraps after approx 71 minutes.
+clock_t clock(void)
 {
-   uint16_t ret;
+   uint32_t ret;
 
-   SEI();
-   ret = timer;
-   CLI();
+   // Freeze the counter while reading, so the four bytes are consistent.
+   MEMIO_CONFIG->cpuCycLatch = 1;
+   ret = *(uint32_t *) MEMIO_STATUS->timerUsec;
+   MEMIO_CONFIG->cpuCycLatch = 0;
 
    return ret;
-}
+} // end of clock
 
@@ -1,12 +1,15 @@
 	.setcpu		"6502"
 
    .export init, _exit
-   .import _main, _clrscr
+   .export _boot_cycles
+   .import _main, _clrscr, _bench_stop
 
    .export __STARTUP__ : absolute = 1     ; Mark as startup
    .import __RAM_START__, __RAM_SIZE__    ; Linker generated
+   .import __DATA_LOAD__, __DATA_RUN__, __DATA_SIZE__
+   .import __BSS_RUN__, __BSS_SIZE__
 
-   .import copydata, zerobss, initlib, donelib
+   .import initlib, donelib
 
    .include "zeropage.inc"
 
@@ -22,14 +25,18 @@
 
 IRQ_STATUS     = $7FFF
 IRQ_MASK       = $7FDF
+CPU_CYC_LATCH  = $7FD2
+CPU_CYC        = $7FE4
 
-IRQ_TIMER_NUM  = 0
-IRQ_VGA_NUM    = 1
-IRQ_KBD_NUM    = 2
+IRQ_TIMER_NUM      = 0
+IRQ_VGA_NUM        = 1
+IRQ_KBD_NUM        = 2
+IRQ_TIMER_CMP_NUM  = 3
 
-IRQ_TIMER_MASK = 1 << IRQ_TIMER_NUM
-IRQ_VGA_MASK   = 1 << IRQ_VGA_NUM
-IRQ_KBD_MASK   = 1 << IRQ_KBD_NUM
+IRQ_TIMER_MASK     = 1 << IRQ_TIMER_NUM
+IRQ_VGA_MASK       = 1 << IRQ_VGA_NUM
+IRQ_KBD_MASK       = 1 << IRQ_KBD_NUM
+IRQ_TIMER_CMP_MASK = 1 << IRQ_TIMER_CMP_NUM
 
 ; ---------------------------------------------------------------------------
 ; Entry point for a hardware reset. Referenced in lib/vectors.s
@@ -57,17 +64,33 @@ init:
 
    JSR zerobss             ; Clear BSS segment
    JSR copydata            ; Initialize DATA segment
-   JSR initlib             ; Run constructors
+   JSR initlib             ; Run constructors, including heap setup
    JSR _clrscr             ; Clear screen
 
 ; ---------------------------------------------------------------------------
-; Enable timer interrupt
+; Enable interrupts
+; The periodic timer interrupt is not needed, since the timer is read directly
+; from the hardware. Only the one-shot timer compare interrupt is used.
 
    LDA IRQ_STATUS          ; Clear any pending interrupts, before enabling them.
-   LDA #IRQ_TIMER_MASK | IRQ_VGA_MASK | IRQ_KBD_MASK
-   STA IRQ_MASK            ; Enable timer, VGA, and keyboard interrupt
+   LDA #IRQ_TIMER_CMP_MASK | IRQ_VGA_MASK | IRQ_KBD_MASK
+   STA IRQ_MASK            ; Enable timer compare, VGA, and keyboard interrupt
    CLI                     ; Enable interrupt handling
 
+; ---------------------------------------------------------------------------
+; Record the number of clock cycles used by the startup code.
+
+   LDA #1
+   STA CPU_CYC_LATCH
+   LDX #3
+@cyc:
+   LDA CPU_CYC,X
+   STA _boot_cycles,X
+   DEX
+   BPL @cyc
+   INX
+   STX CPU_CYC_LATCH
+
 ; ---------------------------------------------------------------------------
 ; Call C-function main()
 
@@ -79,6 +102,94 @@ init:
 _exit:
    SEI                     ; Disable interrupts
    JSR donelib             ; Run destructors
+   JSR _bench_stop         ; Tell the testbench we are done
 halt:
    JMP halt
 
+
+; ---------------------------------------------------------------------------
+; Clear the BSS segment and copy the DATA segment.
+; These replace the generic routines in the cc65 library. The full pages are
+; handled by a loop unrolled eight times, since this is where most of the
+; time is spent. Large buffers that need no clearing can be placed in the
+; NOINIT segment instead, see ld.cfg.
+
+zerobss:
+   LDA #<__BSS_RUN__
+   STA ptr1
+   LDA #>__BSS_RUN__
+   STA ptr1+1
+   LDA #0
+   TAY
+
+   LDX #>__BSS_SIZE__      ; Number of full pages
+   BEQ @rest
+@page:
+   .repeat 8
+   STA (ptr1),Y
+   INY
+   .endrepeat
+   BNE @page
+   INC ptr1+1
+   DEX
+   BNE @page
+
+@rest:
+   LDX #<__BSS_SIZE__      ; Remaining bytes
+   BEQ @done
+@byte:
+   STA (ptr1),Y
+   INY
+   DEX
+   BNE @byte
+@done:
+   RTS
+
+
+; ---------------------------------------------------------------------------
+; Copy the DATA segment from ROM to RAM.
+
+copydata:
+   LDA #<__DATA_LOAD__
+   STA ptr1
+   LDA #>__DATA_LOAD__
+   STA ptr1+1
+   LDA #<__DATA_RUN__
+   STA ptr2
+   LDA #>__DATA_RUN__
+   STA ptr2+1
+   LDY #0
+
+   LDX #>__DATA_SIZE__     ; Number of full pages
+   BEQ @rest
+@page:
+   .repeat 8
+   LDA (ptr1),Y
+   STA (ptr2),Y
+   INY
+   .endrepeat
+   BNE @page
+   INC ptr1+1
+   INC ptr2+1
+   DEX
+   BNE @page
+
+@rest:
+   LDX #<__DATA_SIZE__     ; Remaining bytes
+   BEQ @done
+@byte:
+   LDA (ptr1),Y
+   STA (ptr2),Y
+   INY
+   DEX
+   BNE @byte
+@done:
+   RTS
+
+
+.segment	"BSS"
+
+; Number of clock cycles from reset until main() is called.
+_boot_cycles:
+   .res 4
+
@@ -13,11 +13,17 @@
 .import eth_outp_len
 .import eth_outp
 
+; Optional payload sent directly from memory after eth_outp.
+.import eth_outp_payload_ptr
+.import eth_outp_payload_len
+
 ethRxdmaEnable  = $7FD3
 ethRxdmaPtr     = $7FD4
 ethRxPending    = $7FEE
 ethTxdmaPtr     = $7FD6
 ethTxdmaEnable  = $7FD8
+ethTxdmaPayloadPtr = $7FD9
+ethTxdmaPayloadLen = $7FDB
 
 .code
 
@@ -61,11 +67,27 @@ eth_rx:
 ; inputs:
 ; eth_outp: packet to send
 ; eth_outp_len: length of packet to send
+; eth_outp_payload_ptr: optional payload to append to packet
+; eth_outp_payload_len: length of payload, or zero if none
 ; outputs:
 ; if there was an error sending the packet then carry flag is set
 ; otherwise carry flag is cleared
 eth_tx:
-      lda #1
+      lda eth_outp_payload_len
+      ora eth_outp_payload_len+1
+      beq @0                  ; Jump if no payload
+      lda eth_outp_payload_ptr
+      ldx eth_outp_payload_ptr+1
+      sta ethTxdmaPayloadPtr
+      stx ethTxdmaPayloadPtr+1
+      lda eth_outp_payload_len
+      ldx eth_outp_payload_len+1
+      sta ethTxdmaPayloadLen
+      stx ethTxdmaPayloadLen+1
+      lda #0
+      sta eth_outp_payload_len   ; The payload is only used once.
+      sta eth_outp_payload_len+1
+@0:   lda #1
       sta ethTxdmaEnable      ; Start transfer of packet
 @1:   lda ethTxdmaEnable
       bne @1                  ; Wait until transfer is complete
@@ -0,0 +1,28 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "memorymap.h"
+#include "eth_filter.h"
+
+void eth_filter(const uint8_t* mac, uint8_t flags)
+{
+   // Disable while the address is changed.
+   MEMIO_CONFIG4->ethFiltEnable = 0;
+   memcpy(MEMIO_CONFIG4->ethRespMac, mac, 6);
+   MEMIO_CONFIG4->ethFiltEnable = flags;
+} // end of eth_filter
+
+void eth_filter_mcast(uint8_t num, const uint8_t* mac_low)
+{
+   memcpy(MEMIO_CONFIG4->ethFiltMcast[num], mac_low, 3);
+} // end of eth_filter_mcast
+
+void eth_filter_etype(uint8_t num, uint16_t etype)
+{
+   MEMIO_CONFIG4->ethFiltEtype[num] = etype;
+} // end of eth_filter_etype
+
+void eth_filter_udp(uint8_t num, uint16_t port)
+{
+   MEMIO_CONFIG4->ethFiltUdp[num] = port;
+} // end of eth_filter_udp
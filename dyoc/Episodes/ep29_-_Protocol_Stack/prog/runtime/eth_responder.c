@@ -0,0 +1,24 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "memorymap.h"
+#include "eth_responder.h"
+
+void eth_responder(const uint8_t* mac, const uint8_t* ip, uint8_t flags)
+{
+   // Disable while the addresses are changed.
+   MEMIO_CONFIG4->ethRespEnable = 0;
+   memcpy(MEMIO_CONFIG4->ethRespMac, mac, 6);
+   memcpy(MEMIO_CONFIG4->ethRespIp, ip, 4);
+   MEMIO_CONFIG4->ethRespEnable = flags;
+} // end of eth_responder
+
+uint8_t eth_responder_arp_count(void)
+{
+   return MEMIO_STATUS4->ethRespCntArp;
+} // end of eth_responder_arp_count
+
+uint8_t eth_responder_icmp_count(void)
+{
+   return MEMIO_STATUS4->ethRespCntIcmp;
+} // end of eth_responder_icmp_count
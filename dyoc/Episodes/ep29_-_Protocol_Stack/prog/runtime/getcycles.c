@@ -0,0 +1,17 @@
+#include <stdint.h>
+
+#include "memorymap.h"
+#include "getcycles.h"
+
+uint32_t getcycles(void)
+{
+   uint32_t cycles;
+
+   // Freeze the counter while reading, so the four bytes are consistent.
+   MEMIO_CONFIG->cpuCycLatch = 1;
+   cycles = MEMIO_STATUS->cpuCyc;
+   MEMIO_CONFIG->cpuCycLatch = 0;
+
+   return cycles;
+} // end of getcycles
+
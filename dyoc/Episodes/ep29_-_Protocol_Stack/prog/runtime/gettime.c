@@ -2,25 +2,36 @@
 #include <time.h>
 
 #include "gettime.h"
+#include "timer.h"
 
 int clock_gettime(clockid_t clk_id, struct timespec *tp)
 {
-   uint32_t now;
+   t_usec now;
+   uint8_t *p = (uint8_t *) &now;
+   uint32_t sec = 0;
+   uint32_t rem = 0;
+   int8_t i;
 
    (void) clk_id; // This line avoid compiler warning about unused variable.
 
    if (tp)
    {
-      now = clock();
-
-      tp->tv_sec = now / 1000;
-      now -= tp->tv_sec*1000;
-
-      tp->tv_nsec = now;
+      timer_usec(&now);
+
+      // Divide the 48-bit value by one million, one byte at a time
+      // starting from the most significant byte.
+      for (i = 5; i >= 0; --i)
+      {
+         rem = (rem << 8) | p[i];
+         sec = (sec << 8) | (rem / 1000000UL);
+         rem %= 1000000UL;
+      }
+
+      tp->tv_sec  = sec;
+      tp->tv_nsec = rem * 1000;
    }
 
    return 0;
 
 } // end of clock_gettime
 
-
@@ -0,0 +1,84 @@
+#include <stdint.h>
+#include <stdlib.h>     // malloc, free, _heapblocksize, _heapmemavail, _heapmaxavail
+#include <conio.h>
+
+#include "getcycles.h"
+#include "heap.h"
+
+t_heap_stats heap_stats;
+
+void* heap_alloc(size_t size)
+{
+   uint32_t cycles;
+   void* block;
+
+   cycles = getcycles();
+   block = malloc(size);
+   cycles = getcycles() - cycles;
+
+   if (block == NULL)
+   {
+      heap_stats.failures++;
+      return NULL;
+   }
+
+   heap_stats.allocs++;
+   heap_stats.cycles_total += cycles;
+   if (cycles > heap_stats.cycles_max)
+   {
+      heap_stats.cycles_max = cycles;
+   }
+
+   // The allocator may round up the size, so use the actual block size.
+   heap_stats.in_use += _heapblocksize(block);
+   if (heap_stats.in_use > heap_stats.peak)
+   {
+      heap_stats.peak = heap_stats.in_use;
+   }
+
+   return block;
+} // end of heap_alloc
+
+void heap_free(void* block)
+{
+   if (block == NULL)
+   {
+      return;
+   }
+
+   heap_stats.frees++;
+   heap_stats.in_use -= _heapblocksize(block);
+   free(block);
+} // end of heap_free
+
+uint8_t heap_fragmentation(void)
+{
+   size_t avail = _heapmemavail();
+
+   if (avail == 0)
+   {
+      return 0;
+   }
+
+   return ((uint32_t) (avail - _heapmaxavail()) * 100) / avail;
+} // end of heap_fragmentation
+
+void heap_print_stats(void)
+{
+   uint32_t avg = 0;
+
+   if (heap_stats.allocs)
+   {
+      avg = heap_stats.cycles_total / heap_stats.allocs;
+   }
+
+   cprintf("Heap: %u allocs, %u frees, %u failed\r\n",
+         heap_stats.allocs, heap_stats.frees, heap_stats.failures);
+   cprintf("      %u bytes in use, %u peak\r\n",
+         heap_stats.in_use, heap_stats.peak);
+   cprintf("      %u bytes free, %u largest, %u%% fragmented\r\n",
+         _heapmemavail(), _heapmaxavail(), heap_fragmentation());
+   cprintf("      %lu cycles avg, %lu max per alloc\r\n",
+         avg, heap_stats.cycles_max);
+} // end of heap_print_stats
+
@@ -1,7 +1,7 @@
 .setcpu "6502"
 
 .export nmi_int, irq_int   ; Used by lib/vectors.s
-.import timer_isr          ; See lib/timer_isr.s
+.import timer_cmp_isr      ; See lib/timer_isr.s
 .import vga_isr            ; See lib/vga_isr.s
 .import kbd_isr            ; See lib/kbd_isr.s
 
@@ -20,10 +20,10 @@ isr_ptr:
 .segment "DATA"
 
 _isr_jump_table:
-   .addr timer_isr         ; IRQ 0  (TIMER)
+   .addr unhandled_irq     ; IRQ 0  (TIMER, not used)
    .addr vga_isr           ; IRQ 1  (VGA)
    .addr kbd_isr           ; IRQ 2  (Keyboard)
-   .addr unhandled_irq     ; IRQ 3  (Reserved)
+   .addr timer_cmp_isr     ; IRQ 3  (TIMER_CMP)
    .addr unhandled_irq     ; IRQ 4  (Reserved)
    .addr unhandled_irq     ; IRQ 5  (Reserved)
    .addr unhandled_irq     ; IRQ 6  (Reserved)
@@ -0,0 +1,88 @@
+#include <stdint.h>
+#include <stdlib.h>     // malloc
+#include <conio.h>
+
+#include "pool.h"
+
+uint8_t pool_init(t_pool* pool, void* mem, uint16_t size, uint16_t count)
+{
+   uint8_t* block;
+
+   // Each free block must be able to hold the pointer to the next.
+   if (size < 2)
+   {
+      size = 2;
+   }
+
+   // The total size must fit in 16 bits.
+   if (count != 0 && size > 0xFFFFU / count)
+   {
+      return 0;
+   }
+
+   if (mem == NULL)
+   {
+      mem = malloc(size*count);
+      if (mem == NULL)
+      {
+         return 0;
+      }
+   }
+
+   pool->size     = size;
+   pool->count    = count;
+   pool->used     = 0;
+   pool->peak     = 0;
+   pool->failures = 0;
+   pool->free     = NULL;
+
+   // Link all the blocks into the free list. The list is built backwards,
+   // so that the blocks are handed out in increasing address order.
+   block = (uint8_t*) mem + size*count;
+   while (count--)
+   {
+      block -= size;
+      *(void**) block = pool->free;
+      pool->free = block;
+   }
+
+   return 1;
+} // end of pool_init
+
+void* pool_alloc(t_pool* pool)
+{
+   void* block = pool->free;
+
+   if (block == NULL)
+   {
+      pool->failures++;
+      return NULL;
+   }
+
+   pool->free = *(void**) block;
+   if (++pool->used > pool->peak)
+   {
+      pool->peak = pool->used;
+   }
+
+   return block;
+} // end of pool_alloc
+
+void pool_free(t_pool* pool, void* block)
+{
+   if (block == NULL)
+   {
+      return;
+   }
+
+   *(void**) block = pool->free;
+   pool->free = block;
+   pool->used--;
+} // end of pool_free
+
+void pool_print_stats(const t_pool* pool, const char* name)
+{
+   cprintf("%s: %u of %u blocks of %u bytes in use, %u peak, %u failed\r\n",
+         name, pool->used, pool->count, pool->size, pool->peak, pool->failures);
+} // end of pool_print_stats
+
@@ -0,0 +1,33 @@
+#include <stdint.h>
+
+#include "memorymap.h"
+#include "screen.h"
+
+void screen_draw_bank(uint8_t bank)
+{
+   MEMIO_CONFIG->charBank = bank;
+} // end of screen_draw_bank
+
+void screen_show_bank(uint8_t bank)
+{
+   MEMIO_CONFIG->vgaFront = bank;
+} // end of screen_show_bank
+
+void screen_wait_flip(void)
+{
+   // The VGA interrupt occurs after the bank has changed, so it is
+   // enough to wait for the interrupt routine to copy the new value.
+   while (vga_front != MEMIO_CONFIG->vgaFront)
+   {
+   }
+} // end of screen_wait_flip
+
+void screen_flip(void)
+{
+   uint8_t bank = MEMIO_CONFIG->charBank;
+
+   screen_show_bank(bank);
+   screen_wait_flip();
+   screen_draw_bank(bank ^ 1);
+} // end of screen_flip
+
@@ -0,0 +1,39 @@
+#include <stdint.h>
+
+#include "memorymap.h"
+#include "sprite.h"
+
+void sprite_bitmap(uint8_t num, const uint8_t* bitmap)
+{
+   uint8_t i;
+
+   // Each write to spriteData increments the address.
+   MEMIO_CONFIG3->spriteAddr = num*32;
+   for (i=0; i<32; ++i)
+   {
+      MEMIO_CONFIG3->spriteData = bitmap[i];
+   }
+} // end of sprite_bitmap
+
+void sprite_config(uint8_t num, uint8_t col, uint8_t ctrl)
+{
+   MEMIO_CONFIG3->spriteCol[num]  = col;
+   MEMIO_CONFIG3->spriteCtrl[num] = ctrl;
+} // end of sprite_config
+
+void sprite_move(uint8_t num, uint16_t x, uint16_t y)
+{
+   MEMIO_CONFIG3->spriteX[num] = x;
+   MEMIO_CONFIG3->spriteY[num] = y;
+} // end of sprite_move
+
+uint8_t sprite_collisions(void)
+{
+   return MEMIO_STATUS3->spriteColl;
+} // end of sprite_collisions
+
+uint8_t sprite_fg_collisions(void)
+{
+   return MEMIO_STATUS3->spriteCollFg;
+} // end of sprite_fg_collisions
+
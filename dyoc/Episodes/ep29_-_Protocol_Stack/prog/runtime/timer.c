@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include <string.h>     // memcpy
+
+#include "memorymap.h"
+#include "timer.h"
+
+void timer_usec(t_usec* usec)
+{
+   // Freeze the counter while reading, so the six bytes are consistent.
+   MEMIO_CONFIG->cpuCycLatch = 1;
+   memcpy(usec, MEMIO_STATUS->timerUsec, 6);
+   MEMIO_CONFIG->cpuCycLatch = 0;
+} // end of timer_usec
+
+void timer_set_alarm(const t_usec* usec)
+{
+   MEMIO_CONFIG2->timerCmpEnable = 0;
+   timer_alarm = 0;
+   memcpy(MEMIO_CONFIG2->timerCmp, usec, 6);
+   MEMIO_CONFIG2->timerCmpEnable = 1;
+} // end of timer_set_alarm
+
+void timer_alarm_in(uint32_t delay)
+{
+   t_usec usec;
+
+   timer_usec(&usec);
+   usec.lo += delay;
+   if (usec.lo < delay)
+   {
+      usec.hi++;
+   }
+   timer_set_alarm(&usec);
+} // end of timer_alarm_in
+
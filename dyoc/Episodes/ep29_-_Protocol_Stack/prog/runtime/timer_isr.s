@@ -1,9 +1,20 @@
 .setcpu		"6502"
-.export		timer_isr      ; Used in lib/irq.s
-.export     _timer         ; 16-bit counter
+.export		timer_cmp_isr  ; Used in lib/irq.s
+.export     _timer_alarm   ; Set when the compare interrupt has fired
 .export     timer_init
 .export     timer_read
 
+; The timer is a free-running 48-bit microsecond counter in hardware, so no
+; periodic interrupt is needed to keep track of time.
+; Writing 1 to CPU_CYC_LATCH freezes the value read from TIMER_USEC, so all
+; bytes are consistent, and writing 0 lets it track the counter again.
+; The latch is not used from interrupt routines, so no interrupt masking is
+; needed when reading the timer.
+
+; These must be the same addresses defined in prog/memorymap.h
+CPU_CYC_LATCH = $7FD2
+TIMER_USEC    = $7FEF
+
 ; The interrupt routine must be written entirely in assembler, because the C
 ; code is not re-entrant.
 ; Therefore, one shouldn't call C functions from this routine.
@@ -14,25 +25,46 @@
 
 .segment	"BSS"
 
-_timer:
-	.res	2,$00       ; 16-bit counter
+_timer_alarm:
+	.res	1,$00
 
+tmp:
+	.res	2,$00
 
-.segment	"CODE"
 
-timer_isr:
-   INC _timer
-   BNE nowrap
-   INC _timer+1
-nowrap:
+.segment	"CODE"
 
+; The compare interrupt is a one-shot. The hardware has already cleared
+; TIMER_CMP_ENABLE.
+timer_cmp_isr:
+   LDX #1
+   STX _timer_alarm
    RTS
 
 timer_init:
    RTS
 
+; Used by ip65. Returns a 16-bit counter in AX, incremented every 1024
+; microseconds, i.e. about 1000 units per second.
 timer_read:
-   LDX _timer+1
-   LDA _timer
+   LDA #1
+   STA CPU_CYC_LATCH
+   LDA TIMER_USEC+1
+   STA tmp
+   LDA TIMER_USEC+2
+   STA tmp+1
+   LDA TIMER_USEC+3
+   LDX #0
+   STX CPU_CYC_LATCH
+
+   LSR                     ; Divide by 1024
+   ROR tmp+1
+   ROR tmp
+   LSR
+   ROR tmp+1
+   ROR tmp
+
+   LDA tmp
+   LDX tmp+1
    RTS
 
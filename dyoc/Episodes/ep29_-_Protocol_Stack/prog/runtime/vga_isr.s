@@ -1,6 +1,7 @@
 .setcpu		"6502"
 .export     vga_isr     ; Used in lib/irq.s
 .export     _curs_enable, _curs_cnt, _curs_inverted
+.export     _vga_front
 .exportzp   _curs_pos
 
 ; The interrupt routine must be written entirely in assembler, because the C code is not re-entrant.
@@ -9,6 +10,8 @@
 
 BLINK_TIME = $10     ; 60 units in a second.
 
+VGA_FRONT_ACTIVE = $7FF5
+
 
 .segment	"DATA"
 
@@ -18,6 +21,8 @@ _curs_inverted:
 	.byte	$00
 _curs_cnt:
 	.byte	$00
+_vga_front:
+	.byte	$00      ; Copy of VGA_FRONT_ACTIVE, updated once every frame.
 
 
 .segment	"ZEROPAGE"
@@ -30,6 +35,9 @@ _curs_pos:
 
 vga_isr:
 
+	LDX     VGA_FRONT_ACTIVE
+	STX     _vga_front
+
 	LDX     _curs_enable
 	BEQ     end
 
@@ -1,49 +1,53 @@
 #include <stdint.h>     // uint8_t, etc.
 #include <string.h>     // memmove
 #include "memorymap.h"  // MEM_CHAR
+#include "../conio/comp.h"
 
 // This is just a very simple implementation of the write() function.
 // The only control character it supports is newline.
-
-// Screen size in number of characters
-#define H_CHARS 80   // Horizontal
-#define V_CHARS 60   // Vertical
-
-// Current cursor position
-static uint8_t x = 0;
-static uint8_t y = 0;
+// It shares the cursor position with conio, but scrolls the screen
+// instead of wrapping around to the top.
 
 // For now, we just ignore the file descriptor fd.
 int write (int fd, const uint8_t* buf, const unsigned count)
 {
    unsigned cnt = count;
+   uint8_t n;
    (void) fd;                // Hack to avoid warning about unused variable.
 
-   while (cnt--)
+   while (cnt)
    {
-      uint8_t ch = *(buf++);
-      switch (ch)
-      {
-         case '\n' :    // Newline
-            x = 0;
-            y++;
-            break;
+      curs_pos = &MEM_CHAR[H_CHARS*pos_y+pos_x];
 
-         default:       // Any other character is considered a regular character.
-            MEM_CHAR[H_CHARS*y+x] = ch;
-            x++;
-            break;
-      } // end of switch
+      if (*buf == '\n')      // Newline
+      {
+         pos_x = 0;
+         pos_y++;
+         n = 1;
+      }
+      else
+      {
+         // Copy a run of regular characters up to the end of the line.
+         n = cputspan(buf, 0, cnt > 0xFF ? 0xFF : cnt);
+         if (n == 0)         // Any other character is considered a regular character.
+         {
+            putchar(*buf);
+            pos_x++;
+            n = 1;
+         }
+      }
+      buf += n;
+      cnt -= n;
 
       // End of line, just start at next line
-      if (x >= H_CHARS)
+      if (pos_x >= H_CHARS)
       {
-         x = 0;
-         y++;
+         pos_x = 0;
+         pos_y++;
       }
 
       // End of screen, so scroll.
-      if (y >= V_CHARS)
+      if (pos_y >= V_CHARS)
       {
          // Move screen up one line
          memmove(MEM_CHAR, MEM_CHAR+H_CHARS, H_CHARS*(V_CHARS-1));
@@ -51,8 +55,8 @@ int write (int fd, const uint8_t* buf, const unsigned count)
          // Clean bottom line
          memset(MEM_CHAR+H_CHARS*(V_CHARS-1), ' ', H_CHARS);
 
-         x = 0;
-         y = V_CHARS-1;
+         pos_x = 0;
+         pos_y = V_CHARS-1;
       }
    }
 
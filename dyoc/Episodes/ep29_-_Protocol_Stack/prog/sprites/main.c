@@ -0,0 +1,96 @@
+#include <stdint.h>
+#include <conio.h>
+#include "memorymap.h"
+#include "sprite.h"
+
+// This demonstrates the hardware sprites.
+// Four balls bounce around the screen. A ball changes colour when it
+// touches another ball, and the number of frames where it touches the text
+// is counted.
+
+static const uint8_t ball[32] = {
+   0x07, 0xE0,
+   0x1F, 0xF8,
+   0x3F, 0xFC,
+   0x7F, 0xFE,
+   0x7F, 0xFE,
+   0xFF, 0xFF,
+   0xFF, 0xFF,
+   0xFF, 0xFF,
+   0xFF, 0xFF,
+   0xFF, 0xFF,
+   0xFF, 0xFF,
+   0x7F, 0xFE,
+   0x7F, 0xFE,
+   0x3F, 0xFC,
+   0x1F, 0xF8,
+   0x07, 0xE0};
+
+static const uint8_t colours[SPRITE_NUM] = {0xE0, 0x1C, 0x03, 0xFC};
+
+static int16_t  x[SPRITE_NUM];
+static int16_t  y[SPRITE_NUM];
+static int8_t   dx[SPRITE_NUM];
+static int8_t   dy[SPRITE_NUM];
+
+static void wait_frame(void)
+{
+   // Wait until the start of the vertical blanking interval.
+   while (MEMIO_STATUS->vgaPixY < 480)
+   {
+   }
+   while (MEMIO_STATUS->vgaPixY >= 480)
+   {
+   }
+} // end of wait_frame
+
+void main(void)
+{
+   uint8_t i;
+   uint8_t coll;
+   uint8_t fg;
+   uint16_t text_hits = 0;
+
+   gotoxy(30, 29);
+   cputs("Hardware sprites");
+
+   for (i=0; i<SPRITE_NUM; ++i)
+   {
+      sprite_bitmap(i, ball);
+      x[i]  = 100 + i*120;
+      y[i]  = 50 + i*90;
+      dx[i] = i+1;
+      dy[i] = 4-i;
+      sprite_move(i, x[i], y[i]);
+      sprite_config(i, colours[i], SPRITE_ENABLE);
+   }
+
+   while (1)
+   {
+      wait_frame();
+
+      coll = sprite_collisions();
+      fg   = sprite_fg_collisions();
+      if (fg)
+      {
+         ++text_hits;
+      }
+
+      for (i=0; i<SPRITE_NUM; ++i)
+      {
+         sprite_config(i, (coll & (1<<i)) ? 0xFF : colours[i], SPRITE_ENABLE);
+
+         x[i] += dx[i];
+         y[i] += dy[i];
+         if (x[i] <= 0 || x[i] >= 640-16)
+            dx[i] = -dx[i];
+         if (y[i] <= 0 || y[i] >= 480-16)
+            dy[i] = -dy[i];
+         sprite_move(i, x[i], y[i]);
+      }
+
+      gotoxy(0, 59);
+      cprintf("Text hits: %u ", text_hits);
+   }
+} // end of main
+
@@ -20,251 +20,330 @@
  *
  * $Id: sudoku.c,v 1.1.1.1 2007/10/21 17:38:24 pullmoll Exp $
  ******************************************************************************/
+#include <stdint.h>
 #include <conio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
+#include "getcycles.h"  // getcycles()
 
-typedef struct sudoku_s {
-        struct  sudoku_s *next;
-        int f[9][9];
-        int p[9][9];
-}       sudoku_t;
+/*
+ * The board is stored as one 16-bit mask per cell, with bit n-1 set for
+ * the digit n, and 0 for an empty cell. The digits used in each row,
+ * column and box are kept as masks too, so the candidates of a cell are
+ * found with a few table lookups.
+ *
+ * All state lives in fixed size arrays. Every placed cell is recorded on
+ * a trail, so backing up is done by undoing the trail down to the length
+ * saved in the branch stack.
+ */
+
+#define CELLS   81
+#define UNITS   27
+#define ALL     0x1ff
+#define SOLVED  0xff
+
+static uint16_t f[CELLS];
+
+static uint16_t row_used[9];
+static uint16_t col_used[9];
+static uint16_t box_used[9];
+
+static uint8_t row_of[CELLS];
+static uint8_t col_of[CELLS];
+static uint8_t box_of[CELLS];
+static uint8_t units[UNITS][9];
+
+static uint8_t ones_tab[256];
+
+static uint8_t trail[CELLS];
+static uint8_t trail_len;
+
+typedef struct frame_s {
+        uint8_t  trail_len;     /* trail length before this branch */
+        uint8_t  cell;          /* the cell being tried */
+        uint16_t mask;          /* the candidates not yet tried */
+}       frame_t;
+
+static frame_t stack[CELLS];
 
-#define SETP(s,x,y,n) do { s->p[y][x] |= (1 << (n)); } while (0)
-#define CLRP(s,x,y,n) do { s->p[y][x] &= ~(1 << (n)); } while (0)
-#define ISP(s,x,y,n) (s->p[y][x] & (1 << (n)))
+static uint16_t nodes;
 
 /**
- * @brief return number of 1 bits in a 32 bit value
- *
- * 32-bit recursive reduction using SWAR,
- * but first step is mapping 2-bit values
- * into sum of 2 1-bit values in sneaky way.
+ * @brief set up the lookup tables
  */
-static int ones(long val)
+static void init_tables(void)
 {
-        val -= ((val >> 1) & 0x55555555);
-        val = (((val >> 2) & 0x33333333) + (val & 0x33333333));
-        val = (((val >> 4) + val) & 0x0f0f0f0f);
-        val += (val >> 8);
-        val += (val >> 16);
-        return (val & 0x3f);
+        uint8_t x, y, i, b;
+        uint16_t n;
+
+        for (n = 0; n < 256; n++)
+                ones_tab[n] = (n & 1) + ones_tab[n >> 1];
+
+        for (y = 0, i = 0; y < 9; y++) {
+                for (x = 0; x < 9; x++, i++) {
+                        b = (y / 3) * 3 + x / 3;
+                        row_of[i] = y;
+                        col_of[i] = x;
+                        box_of[i] = b;
+                        units[y][x] = i;
+                        units[9 + x][y] = i;
+                        units[18 + b][(y % 3) * 3 + x % 3] = i;
+                }
+        }
 }
 
 /**
- * @brief solve one step
+ * @brief return number of 1 bits in a 9 bit mask
+ */
+#define ones(m) (ones_tab[(uint8_t) (m)] + ((m) >> 8))
+
+/**
+ * @brief return the candidates of an empty cell
+ */
+#define cand(i) (~(row_used[row_of[i]] | col_used[col_of[i]] | box_used[box_of[i]]) & ALL)
+
+/**
+ * @brief place a digit (given as mask) in a cell and record it on the trail
+ */
+static void place(uint8_t i, uint16_t m)
+{
+        f[i] = m;
+        row_used[row_of[i]] |= m;
+        col_used[col_of[i]] |= m;
+        box_used[box_of[i]] |= m;
+        trail[trail_len++] = i;
+}
+
+/**
+ * @brief remove the cells placed since the trail had length len
+ */
+static void undo(uint8_t len)
+{
+        uint8_t i;
+        uint16_t m;
+
+        while (trail_len > len) {
+                i = trail[--trail_len];
+                m = ~f[i];
+                f[i] = 0;
+                row_used[row_of[i]] &= m;
+                col_used[col_of[i]] &= m;
+                box_used[box_of[i]] &= m;
+        }
+}
+
+/**
+ * @brief fill in naked and hidden singles until nothing changes
  *
- * find the crossing with the lowest number of possibilities
- * and try all possible numbers on it, recursively calling
- * solve_step() until the puzzle is solved.
+ * returns 0 if a contradiction was found.
  */
-static int solve_step(sudoku_t *s)
+static uint8_t propagate(void)
 {
-        int min_x, min_y, min_n;
-        int x, y, n, rc;
+        uint8_t i, u, k, changed;
+        uint16_t m, once, twice, used;
+        uint8_t *unit;
 
-        /* find the crossing with the lowest number of possibilities */
-        for (y = 0, min_n = 10, min_x = 0, min_y = 0; y < 9; y++) {
-                for (x = 0; x < 9; x++) {
-                        if (s->f[y][x])
+        do {
+                changed = 0;
+
+                /* naked singles: cells with only one candidate */
+                for (i = 0; i < CELLS; i++) {
+                        if (f[i])
                                 continue;
-                        n = ones(s->p[y][x]);
-                        if (n > min_n)
+                        m = cand(i);
+                        if (0 == m)
+                                return 0;
+                        if (0 == (m & (m - 1))) {
+                                place(i, m);
+                                changed = 1;
+                        }
+                }
+
+                /* hidden singles: digits with only one place in a unit */
+                for (u = 0; u < UNITS; u++) {
+                        unit = units[u];
+                        once = twice = used = 0;
+                        for (k = 0; k < 9; k++) {
+                                i = unit[k];
+                                if (f[i]) {
+                                        used |= f[i];
+                                        continue;
+                                }
+                                m = cand(i);
+                                twice |= once & m;
+                                once |= m;
+                        }
+                        if ((once | used) != ALL)
+                                return 0;
+                        once &= ~twice;
+                        if (0 == once)
                                 continue;
-                        min_n = n;
-                        min_x = x;
-                        min_y = y;
+                        for (k = 0; k < 9; k++) {
+                                i = unit[k];
+                                if (f[i])
+                                        continue;
+                                m = cand(i) & once;
+                                if (0 == m)
+                                        continue;
+                                if (m & (m - 1))
+                                        return 0;
+                                place(i, m);
+                                changed = 1;
+                        }
                 }
-        }
+        } while (changed);
+
+        return 1;
+}
 
-        /* solved? */
-        if (10 == min_n) {
-                cprintf("solved");
-                return 1;
+/**
+ * @brief find the empty cell with the lowest number of candidates
+ */
+static uint8_t pick(void)
+{
+        uint8_t i, n, min_i, min_n;
+        uint16_t m;
+
+        for (i = 0, min_i = SOLVED, min_n = 10; i < CELLS; i++) {
+                if (f[i])
+                        continue;
+                m = cand(i);
+                n = ones(m);
+                if (n >= min_n)
+                        continue;
+                min_n = n;
+                min_i = i;
+                if (2 == n)
+                        break;
         }
+        return min_i;
+}
+
+/**
+ * @brief solve the puzzle
+ *
+ * propagate singles, then try the candidates of the cell with the
+ * lowest number of possibilities, backing up on contradictions.
+ */
+static uint8_t solve(void)
+{
+        uint8_t sp, i;
+        uint16_t m;
+        frame_t *fr;
 
-        x = min_x;
-        y = min_y;
-        if (0 == min_n) {
-                cprintf("%d,%d: impossible, backing up ", x, y);
+        if (!propagate())
                 return 0;
-        }
 
-        cprintf("%d,%d: %d possible: ", x, y, min_n);
-        for (n = 1; n <= 9; n++) {
-                if (ISP(s, x, y, n))
-                        cprintf(" %d", n);
-        }
-        cprintf("\n");
-
-        s->next = calloc(1, sizeof(sudoku_t));
-        for (n = 1; n <= 9; n++) {
-                memcpy(s->next, s, sizeof(*s));
-                s->next->next = NULL;
-                if (ISP(s, x, y, n)) {
-                        CLRP(s->next,0,y,n);
-                        CLRP(s->next,1,y,n);
-                        CLRP(s->next,2,y,n);
-                        CLRP(s->next,3,y,n);
-                        CLRP(s->next,4,y,n);
-                        CLRP(s->next,5,y,n);
-                        CLRP(s->next,6,y,n);
-                        CLRP(s->next,7,y,n);
-                        CLRP(s->next,8,y,n);
-                        CLRP(s->next,x,0,n);
-                        CLRP(s->next,x,1,n);
-                        CLRP(s->next,x,2,n);
-                        CLRP(s->next,x,3,n);
-                        CLRP(s->next,x,4,n);
-                        CLRP(s->next,x,5,n);
-                        CLRP(s->next,x,6,n);
-                        CLRP(s->next,x,7,n);
-                        CLRP(s->next,x,8,n);
-                        s->next->f[y][x] = n;
-                        cprintf("trying %d,%d = %d\n", x, y, n);
-                        rc = solve_step(s->next);
-                        if (rc)
-                                return rc;
+        for (sp = 0; ; ) {
+                i = pick();
+                if (SOLVED == i)
+                        return 1;
+
+                fr = &stack[sp++];
+                fr->trail_len = trail_len;
+                fr->cell = i;
+                fr->mask = cand(i);
+
+                /* try the next candidate, backing up as needed */
+                for (;;) {
+                        undo(fr->trail_len);
+                        if (fr->mask) {
+                                m = fr->mask & (~fr->mask + 1);
+                                fr->mask &= ~m;
+                                nodes++;
+                                place(fr->cell, m);
+                                if (propagate())
+                                        break;
+                        } else {
+                                if (0 == --sp)
+                                        return 0;
+                                fr = &stack[sp - 1];
+                        }
                 }
         }
-        /* it did not solve, so discard this branch */
-        free(s->next);
-        s->next = NULL;
-        return 0;
 }
 
-static int sudoku_read(sudoku_t *s, const char *src)
+/**
+ * @brief read a puzzle given as 81 characters, '1' to '9' or '0'/'.' for empty
+ */
+static uint8_t sudoku_read(const char *src)
 {
-        int x, y, n;
-
-        x = 0;
-        y = 0;
-        while (*src) {
-                while (isspace(*src))
-                        src++;
-                n = 0;
-                while (isdigit(*src)) {
-                        n = n * 10 + *src - '0';
-                        src++;
-                }
-                s->f[y][x] = n;
-                while (isspace(*src))
-                        src++;
-                if (*src == ',' || *src == '\n')
-                        src++;
-                x++;
-                if (x == 9) {
-                        x = 0;
-                        y++;
-                        if (y == 9)
-                                break;
-                }
-        }
+        uint8_t i;
+        uint16_t m;
 
-        for (y = 0; y < 9; y++) {
-                for (x = 0; x < 9; x++) {
-                        for (n = 1; n <= 9; n++)
-                                SETP(s,x,y,n);
-                }
-        }
+        trail_len = 0;
+        nodes = 0;
+        for (i = 0; i < 9; i++)
+                row_used[i] = col_used[i] = box_used[i] = 0;
+        for (i = 0; i < CELLS; i++)
+                f[i] = 0;
 
-        for (y = 0; y < 9; y++) {
-                for (x = 0; x < 9; x++) {
-                        n = s->f[y][x];
-                        if (0 == n)
-                                continue;
-                        CLRP(s,0,y,n);
-                        CLRP(s,1,y,n);
-                        CLRP(s,2,y,n);
-                        CLRP(s,3,y,n);
-                        CLRP(s,4,y,n);
-                        CLRP(s,5,y,n);
-                        CLRP(s,6,y,n);
-                        CLRP(s,7,y,n);
-                        CLRP(s,8,y,n);
-                        CLRP(s,x,0,n);
-                        CLRP(s,x,1,n);
-                        CLRP(s,x,2,n);
-                        CLRP(s,x,3,n);
-                        CLRP(s,x,4,n);
-                        CLRP(s,x,5,n);
-                        CLRP(s,x,6,n);
-                        CLRP(s,x,7,n);
-                        CLRP(s,x,8,n);
-                }
+        for (i = 0; i < CELLS; i++) {
+                if (src[i] < '1' || src[i] > '9')
+                        continue;
+                m = 1 << (src[i] - '1');
+                if (cand(i) & m)
+                        place(i, m);
+                else
+                        return 0;
         }
-
-        return 0;
+        return 1;
 }
 
-static const char *sudoku_row(sudoku_t *s, int y)
+static const char *sudoku_row(uint8_t y)
 {
         static char buff[2*9+1];
-        int x;
+        uint8_t x, n;
+        uint16_t m;
 
         for (x = 0; x < 9; x++) {
-                buff[2*x+0] = s->f[y][x] ? s->f[y][x] + '0' : '-';
+                m = f[y * 9 + x];
+                for (n = 0; m; n++)
+                        m >>= 1;
+                buff[2*x+0] = n ? n + '0' : '-';
                 buff[2*x+1] = ',';
         }
         buff[2*9 - 1] = '\0';
         return buff;
 }
 
+static void sudoku_print(void)
+{
+        uint8_t y;
+
+        for (y = 0; y < 9; y++)
+                cprintf("%s\r\n", sudoku_row(y));
+}
+
+/* The benchmark set. The first one is the original puzzle of this program. */
+static const char *puzzles[] = {
+        "020030065003268700804000000200006187100807092907300004008000900000693500350080010",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        "85...24..72......9..4.........1.7..23.5...9...4...........8..7..17..........36.4.",
+        "800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+};
+
+#define NUM_PUZZLES (sizeof(puzzles) / sizeof(puzzles[0]))
+
 int main(void)
 {
-        sudoku_t *s, *s0;
-        const char *src =
-                "0,2,0,0,3,0,0,6,5\n"
-                "0,0,3,2,6,8,7,0,0\n"
-                "8,0,4,0,0,0,0,0,0\n"
-                "2,0,0,0,0,6,1,8,7\n"
-                "1,0,0,8,0,7,0,9,2\n"
-                "9,0,7,3,0,0,0,0,4\n"
-                "0,0,8,0,0,0,9,0,0\n"
-                "0,0,0,6,9,3,5,0,0\n"
-                "3,5,0,0,8,0,0,1,0\n";
-
-/* The solution for this one is:
- *              "7,2,1,4,3,9,8,6,5\n"
- *              "5,9,3,2,6,8,7,4,1\n"
- *              "8,6,4,1,7,5,2,3,9\n"
- *              "2,3,5,9,4,6,1,8,7\n"
- *              "1,4,6,8,5,7,3,9,2\n"
- *              "9,8,7,3,2,1,6,5,4\n"
- *              "6,7,8,5,1,4,9,2,3\n"
- *              "4,1,2,6,9,3,5,7,8\n"
- *              "3,5,9,7,8,2,4,1,6\n";
- */
-        s0 = s = calloc(1, sizeof(sudoku_t));
-        sudoku_read(s, src);
-        cprintf("\n");
-        cprintf(sudoku_row(s, 0));
-        cprintf(sudoku_row(s, 1));
-        cprintf(sudoku_row(s, 2));
-        cprintf(sudoku_row(s, 3));
-        cprintf(sudoku_row(s, 4));
-        cprintf(sudoku_row(s, 5));
-        cprintf(sudoku_row(s, 6));
-        cprintf(sudoku_row(s, 7));
-        cprintf(sudoku_row(s, 8));
-        cprintf("\n");
-
-        solve_step(s);
-        while (s->next)
-                s = s->next;
-
-        cprintf("\n");
-        cprintf(sudoku_row(s, 0));
-        cprintf(sudoku_row(s, 1));
-        cprintf(sudoku_row(s, 2));
-        cprintf(sudoku_row(s, 3));
-        cprintf(sudoku_row(s, 4));
-        cprintf(sudoku_row(s, 5));
-        cprintf(sudoku_row(s, 6));
-        cprintf(sudoku_row(s, 7));
-        cprintf(sudoku_row(s, 8));
-        cprintf("\n");
+        uint8_t p, rc;
+        uint32_t cycles;
+        uint32_t total = 0;
+
+        init_tables();
+
+        for (p = 0; p < NUM_PUZZLES; p++) {
+                cprintf("\r\nPuzzle %d:\r\n", p + 1);
+                cycles = getcycles();
+                rc = sudoku_read(puzzles[p]) && solve();
+                cycles = getcycles() - cycles;
+                total += cycles;
+
+                sudoku_print();
+                cprintf("%s: %lu cycles, %u nodes\r\n",
+                        rc ? "solved" : "impossible", cycles, nodes);
+        }
+
+        cprintf("\r\nTotal: %lu cycles\r\n", total);
 
         return 0;
 }
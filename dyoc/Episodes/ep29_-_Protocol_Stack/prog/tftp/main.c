@@ -0,0 +1,74 @@
+// TFTP download benchmark.
+//
+// Downloads the same file twice from a TFTP server: first using classic
+// lock-step transfer with 512 byte blocks, and then negotiating a larger
+// block size and window size. The server can be e.g. tftpd.py running on
+// the host.
+
+///////////////////////////////////////////
+
+#define TFTP_SERVER "192.168.1.100"
+#define TFTP_FILE   "rom.bin"
+
+///////////////////////////////////////////
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ip65.h"
+
+static uint32_t bytes;
+
+void error_exit(void)
+{
+   printf("- Error $%X\n", ip65_error);
+   exit(EXIT_FAILURE);
+}
+
+void __fastcall__ callback(const uint8_t* buf, uint16_t len)
+{
+   (void) buf;
+   bytes += len;
+}
+
+void download(uint16_t blksize, uint8_t windowsize)
+{
+   uint32_t server;
+   clock_t start;
+   uint32_t elapsed;
+
+   tftp_blksize    = blksize;
+   tftp_windowsize = windowsize;
+   bytes = 0;
+
+   printf("\nblksize %u, windowsize %u ", blksize, windowsize);
+   server = parse_dotted_quad(TFTP_SERVER);
+   start = clock();
+   if (tftp_download(server, TFTP_FILE, callback))
+   {
+      error_exit();
+   }
+   elapsed = (clock() - start) / 1000;    // clock() counts microseconds
+
+   printf("- %lu bytes in %lu ms\n", bytes, elapsed);
+}
+
+void main(void)
+{
+   printf("\nInitializing ");
+   if (ip65_init(DRV_INIT_DEFAULT))
+   {
+      error_exit();
+   }
+
+   printf("- Ok\n\nObtaining IP address ");
+   if (dhcp_init())
+   {
+      error_exit();
+   }
+   printf("- Ok\n");
+
+   download(0, 0);
+   download(1468, 8);
+}
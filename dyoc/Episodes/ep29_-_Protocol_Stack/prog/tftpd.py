@@ -0,0 +1,121 @@
+#! /usr/bin/env python
+
+# This is a minimal TFTP server, used for testing the TFTP client in
+# ip65/tftp.s. It only supports downloads (read requests), but supports the
+# blksize (RFC 2348) and windowsize (RFC 7440) options.
+#
+# The time taken for each transfer is printed.
+#
+# Usage: ./tftpd.py [directory] [port]
+
+import os
+import sys
+import time
+import socket
+import struct
+
+OP_RRQ   = 1
+OP_DATA  = 3
+OP_ACK   = 4
+OP_ERROR = 5
+OP_OACK  = 6
+
+TIMEOUT  = 1.0
+RETRIES  = 5
+
+def send_error(sock, addr, code, message):
+    sock.sendto(struct.pack("!HH", OP_ERROR, code) + message.encode("ascii") + b"\0", addr)
+
+def parse_request(packet):
+    fields = packet[2:].split(b"\0")
+    filename = fields[0].decode("ascii")
+    options = {}
+    for i in range(2, len(fields) - 1, 2):
+        options[fields[i].decode("ascii").lower()] = fields[i+1].decode("ascii")
+    return filename, options
+
+def wait_for_ack(sock, addr):
+    while True:
+        packet, peer = sock.recvfrom(65536)
+        if peer != addr or len(packet) < 4:
+            continue
+        opcode, block = struct.unpack("!HH", packet[:4])
+        if opcode == OP_ACK:
+            return block
+        if opcode == OP_ERROR:
+            raise IOError("client error: %r" % packet[4:])
+
+def transfer(addr, filename, options, directory):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(TIMEOUT)
+
+    path = os.path.join(directory, os.path.basename(filename))
+    if not os.path.isfile(path):
+        send_error(sock, addr, 1, "File not found")
+        return
+    data = open(path, "rb").read()
+
+    blksize = 512
+    windowsize = 1
+    accepted = []
+    if "blksize" in options:
+        blksize = max(8, min(int(options["blksize"]), 65464))
+        accepted += [b"blksize", str(blksize).encode("ascii")]
+    if "windowsize" in options:
+        windowsize = max(1, min(int(options["windowsize"]), 65535))
+        accepted += [b"windowsize", str(windowsize).encode("ascii")]
+
+    start = time.time()
+    if accepted:
+        oack = struct.pack("!H", OP_OACK) + b"\0".join(accepted) + b"\0"
+        for retry in range(RETRIES):
+            sock.sendto(oack, addr)
+            try:
+                if wait_for_ack(sock, addr) == 0:
+                    break
+            except socket.timeout:
+                pass
+        else:
+            print("%s: timeout waiting for ACK of OACK" % filename)
+            return
+
+    blocks = len(data) // blksize + 1   # The last block is always short
+    acked = 0
+    retries = 0
+    while acked < blocks:
+        for block in range(acked + 1, min(acked + windowsize, blocks) + 1):
+            chunk = data[(block-1)*blksize : block*blksize]
+            sock.sendto(struct.pack("!HH", OP_DATA, block & 0xFFFF) + chunk, addr)
+        try:
+            ack = wait_for_ack(sock, addr)
+        except socket.timeout:
+            retries += 1
+            if retries == RETRIES:
+                print("%s: timeout" % filename)
+                return
+            continue
+        retries = 0
+        # The ACK may be for any block in the window. Go back and resend from there.
+        offset = (ack - acked) & 0xFFFF
+        if offset <= windowsize:
+            acked += offset
+
+    duration = time.time() - start
+    print("%s: %d bytes, blksize %d, windowsize %d, %.3f s, %.1f kB/s" %
+          (filename, len(data), blksize, windowsize, duration, len(data) / duration / 1000.0))
+
+directory = sys.argv[1] if len(sys.argv) > 1 else "."
+port      = int(sys.argv[2]) if len(sys.argv) > 2 else 69
+
+server = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+server.bind(("", port))
+print("Serving %s on port %d" % (directory, port))
+
+while True:
+    packet, addr = server.recvfrom(65536)
+    if len(packet) < 4 or struct.unpack("!H", packet[:2])[0] != OP_RRQ:
+        send_error(server, addr, 4, "Only read requests are supported")
+        continue
+    filename, options = parse_request(packet)
+    print("%s requests %s %s" % (addr[0], filename, options))
+    transfer(addr, filename, options, directory)